@@ -28,10 +28,11 @@ FakeOptiMatrix::FakeOptiMatrix() : OptiData(0.03) {
             
             for (set<int>::iterator it = close.begin(); it != close.end(); it++) {
                 //add close sequences to each sequence in this set, do not include self
-                for (int j = 0; j < 10; j++) { if ((j+count) != *it) {   closeness[j+count].insert(*it);  } }
+                for (int j = 0; j < 10; j++) { if ((j+count) != *it) {   closeness[j+count].push_back(*it);  } }
             }
             count += 10;
         }
+        packCloseness();
     }
     catch(exception& e) {
         m->errorOut(e, "FakeOptiMatrix", "FakeOptiMatrix");
@@ -0,0 +1,113 @@
+//
+//  testbitplanedist.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testbitplanedist.hpp"
+
+/**************************************************************************************************/
+TestBitPlaneDist::TestBitPlaneDist() {  //setup
+    util.setRandomStream(1);
+    
+    //150 columns, so the masks span three words and the last one is partly filled
+    string bases = "ACGT";
+    string temp = "";
+    for (int j = 0; j < 150; j++) { temp += bases[util.getRandomIndex(3)]; }
+    
+    //hand made cases for the gap runs and the terminal gaps, all aligned to the same 150 columns
+    string dots(150, '.'); string dashes(150, '-');
+    db.push_back(Sequence("template", temp));
+    db.push_back(Sequence("sameAsTemplate", temp));
+    db.push_back(Sequence("allDots", dots));
+    db.push_back(Sequence("allDashes", dashes));
+    db.push_back(Sequence("leadingDots", dots.substr(0, 70) + temp.substr(70)));
+    db.push_back(Sequence("trailingDashes", temp.substr(0, 100) + dashes.substr(100)));
+    db.push_back(Sequence("mixedEnds", "..--.-" + temp.substr(6, 120) + "-.-.--..--..-.-.-..-.-.-"));
+    db.push_back(Sequence("noOverlap", temp.substr(0, 40) + dots.substr(40)));
+    db.push_back(Sequence("noOverlapOther", dots.substr(0, 60) + temp.substr(60)));
+    db.push_back(Sequence("gapAcrossWord", temp.substr(0, 50) + dashes.substr(50, 30) + temp.substr(80)));
+    db.push_back(Sequence("gapsAtWordEdge", temp.substr(0, 63) + "--" + temp.substr(65, 62) + "-" + temp.substr(128)));
+    db.push_back(Sequence("ambiguous", "NNRY" + temp.substr(4, 60) + "NNNNWSKMBDHV" + temp.substr(76)));
+    
+    //mutated copies of the template with substitutions, ambiguous bases, gap runs and ragged ends
+    for (int i = 0; i < 30; i++) {
+        string seq = mutate(temp, 2 + i);
+        
+        int front = util.getRandomIndex(20);
+        int back = util.getRandomIndex(20);
+        char frontChar = (i % 3 == 0) ? '-' : '.';
+        char backChar = (i % 2 == 0) ? '.' : '-';
+        for (int j = 0; j < front; j++) { seq[j] = frontChar; }
+        for (int j = 0; j < back; j++)  { seq[seq.length()-1-j] = backChar; }
+        
+        db.push_back(Sequence("seq" + toString(i), seq));
+    }
+}
+/**************************************************************************************************/
+TestBitPlaneDist::~TestBitPlaneDist() {}
+/**************************************************************************************************/
+//changes about one column in percent to a substitution, an ambiguous base or a run of gaps, keeping the length
+string TestBitPlaneDist::mutate(string seq, int percent) {
+    string bases = "ACGT";
+    string ambigs = "NRYWSKM";
+    for (int i = 0; i < seq.length(); i++) {
+        if (util.getRandomIndex(99) < percent) {
+            int type = util.getRandomIndex(2);
+            if (type == 0)      { seq[i] = bases[util.getRandomIndex(3)];    }
+            else if (type == 1) { seq[i] = ambigs[util.getRandomIndex(6)];   }
+            else {
+                int runLength = 1 + util.getRandomIndex(5);
+                for (int j = i; (j < seq.length()) && (j < i + runLength); j++) { seq[j] = '-'; }
+                i += runLength;
+            }
+        }
+    }
+    return seq;
+}
+/**************************************************************************************************/
+int TestBitPlaneDist::countDifferences(string calc, bool countends, double cutoff) {
+    DistCalc* distCalculator = nullptr;
+    if (calc == "nogaps")           { distCalculator = new ignoreGaps(cutoff);                  }
+    else if (countends) {
+        if (calc == "eachgap")      { distCalculator = new eachGapDist(cutoff);                 }
+        else if (calc == "onegap")  { distCalculator = new oneGapDist(cutoff);                  }
+    }else {
+        if (calc == "eachgap")      { distCalculator = new eachGapIgnoreTermGapDist(cutoff);    }
+        else if (calc == "onegap")  { distCalculator = new oneGapIgnoreTermGapDist(cutoff);     }
+    }
+    
+    AlignedBitPlanes planes(&db);
+    BitPlaneDist bitPlaneDist(&planes, calc, countends, cutoff);
+    
+    int numDifferent = 0;
+    for (int i = 0; i < db.getNumSeqs(); i++) {
+        for (int j = 0; j < i; j++) {
+            double dist = distCalculator->calcDist(db.getSeq(i), db.getSeq(j));
+            double bitDist = bitPlaneDist.calcDist(i, j);
+            
+            //bit identical, not just close
+            if (memcmp(&dist, &bitDist, sizeof(double)) != 0) { numDifferent++; }
+        }
+    }
+    delete distCalculator;
+    
+    return numDifferent;
+}
+/**************************************************************************************************/
+TEST(Test_BitPlaneDist, SameAsStringCalculators) {
+    TestBitPlaneDist test;
+    ASSERT_TRUE(test.db.sameLength());
+    
+    string calcs[3] = { "nogaps", "eachgap", "onegap" };
+    double cutoffs[4] = { 1.0, 0.3, 0.1, 0.03 };
+    
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 4; j++) {
+            EXPECT_EQ(0, test.countDifferences(calcs[i], true, cutoffs[j])) << calcs[i] << " countends=T cutoff=" << cutoffs[j];
+            EXPECT_EQ(0, test.countDifferences(calcs[i], false, cutoffs[j])) << calcs[i] << " countends=F cutoff=" << cutoffs[j];
+        }
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,38 @@
+//
+//  testbitplanedist.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef testbitplanedist_hpp
+#define testbitplanedist_hpp
+
+#include "gtest.h"
+#include "bitplanedist.h"
+#include "sequencedb.h"
+#include "ignoregaps.h"
+#include "eachgapdist.h"
+#include "onegapdist.h"
+#include "eachgapignore.h"
+#include "onegapignore.h"
+
+class TestBitPlaneDist {
+    
+public:
+    
+    TestBitPlaneDist();
+    ~TestBitPlaneDist();
+    
+    SequenceDB db;
+    
+    //finds the distance between every pair with both calculators, returns the number of pairs that differ
+    int countDifferences(string, bool, double);
+    
+private:
+    Utils util;
+    
+    string mutate(string, int);
+};
+
+#endif /* testbitplanedist_hpp */
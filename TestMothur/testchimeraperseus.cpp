@@ -0,0 +1,85 @@
+//
+//  testchimeraperseus.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testchimeraperseus.hpp"
+
+/**************************************************************************************************/
+TestChimeraPerseus::TestChimeraPerseus() {  //setup
+    util.setRandomStream(11);
+    string bases = "ACGT";
+    
+    //abundant parents, their chimeras and a few substitutions of each, with abundances spread over many tiers
+    vector<string> parents;
+    for (int i = 0; i < 10; i++) {
+        string temp = "";
+        for (int j = 0; j < 100; j++) { temp += bases[util.getRandomIndex(3)]; }
+        parents.push_back(temp);
+        sequences.push_back(seqData("parent" + toString(i), temp, 2000 + util.getRandomIndex(3000)));
+    }
+    for (int i = 0; i < 60; i++) {
+        string temp = "";
+        if (i % 3 == 0) {
+            int left = util.getRandomIndex(9); int right = util.getRandomIndex(9);
+            int breakPoint = 20 + util.getRandomIndex(60);
+            temp = parents[left].substr(0, breakPoint) + parents[right].substr(breakPoint);
+        }else {
+            temp = parents[util.getRandomIndex(9)];
+            int numChanges = 1 + util.getRandomIndex(4);
+            for (int j = 0; j < numChanges; j++) { temp[util.getRandomIndex(99)] = bases[util.getRandomIndex(3)]; }
+        }
+        sequences.push_back(seqData("seq" + toString(i), temp, 1 + util.getRandomIndex(300)));
+    }
+    
+    sort(sequences.rbegin(), sequences.rend());
+}
+/**************************************************************************************************/
+TestChimeraPerseus::~TestChimeraPerseus() {}
+/**************************************************************************************************/
+vector<string> TestChimeraPerseus::readLines(string filename) {
+    vector<string> lines;
+    ifstream in; util.openInputFile(filename, in, "noerror");
+    string line;
+    while (getline(in, line)) { lines.push_back(line); }
+    in.close();
+    util.mothurRemove(filename);
+    return lines;
+}
+/**************************************************************************************************/
+int TestChimeraPerseus::run(int processors, vector<string>& chimeraLines, vector<string>& accnosLines) {
+    perseusData* params = new perseusData("tempPerseus.chimeras", "tempPerseus.accnos", 0.5, 0.5, 0.5);
+    params->sequences = sequences;
+    params->processors = processors;
+    
+    driver(params);
+    
+    int numChimeras = params->numChimeras;
+    delete params;
+    
+    chimeraLines = readLines("tempPerseus.chimeras");
+    accnosLines = readLines("tempPerseus.accnos");
+    
+    return numChimeras;
+}
+/**************************************************************************************************/
+TEST(Test_ChimeraPerseus, ThreadedTiersSameAsSerial) {
+    TestChimeraPerseus test;
+    
+    vector<string> serialChimeras, serialAccnos;
+    int numChimeras = test.run(1, serialChimeras, serialAccnos);
+    
+    EXPECT_GT(numChimeras, 0);
+    EXPECT_EQ(test.sequences.size()+1, serialChimeras.size()); //header line
+    
+    int processors[3] = { 2, 3, 8 };
+    for (int i = 0; i < 3; i++) {
+        vector<string> chimeras, accnos;
+        EXPECT_EQ(numChimeras, test.run(processors[i], chimeras, accnos));
+        EXPECT_EQ(serialChimeras, chimeras);
+        EXPECT_EQ(serialAccnos, accnos);
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,32 @@
+//
+//  testchimeraperseus.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef testchimeraperseus_hpp
+#define testchimeraperseus_hpp
+
+#include "gtest.h"
+#include "chimeraperseuscommand.h"
+
+class TestChimeraPerseus {
+    
+public:
+    
+    TestChimeraPerseus();
+    ~TestChimeraPerseus();
+    
+    vector<seqData> sequences;  //sorted by abundance, as the command reads them
+    
+    //checks the sequences on the processors, fills in the lines of the chimera and accnos files, returns the number of chimeras
+    int run(int, vector<string>&, vector<string>&);
+    
+private:
+    Utils util;
+    
+    vector<string> readLines(string);
+};
+
+#endif /* testchimeraperseus_hpp */
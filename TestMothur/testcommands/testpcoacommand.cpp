@@ -0,0 +1,110 @@
+//
+//  testpcoacommand.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testpcoacommand.h"
+
+/**************************************************************************************************/
+TestPCoACommand::TestPCoACommand(int numPoints) : PCOACommand("category") {  //setup
+    util.setRandomStream(7);
+    
+    //the dimensions are scaled differently so the leading axes are well separated
+    int numDims = 8;
+    vector<vector<double> > points(numPoints, vector<double>(numDims, 0.0));
+    for (int i = 0; i < numPoints; i++) {
+        for (int k = 0; k < numDims; k++) { points[i][k] = (1 << (numDims - k)) * util.getRandomDouble0to1(); }
+    }
+    
+    D.assign(numPoints, vector<double>(numPoints, 0.0));
+    for (int i = 0; i < numPoints; i++) {
+        for (int j = 0; j < i; j++) {
+            double dist = 0.0;
+            for (int k = 0; k < numDims; k++) { dist += fabs(points[i][k] - points[j][k]); }
+            D[i][j] = D[j][i] = dist;
+        }
+    }
+}
+/**************************************************************************************************/
+TestPCoACommand::~TestPCoACommand() { }
+/**************************************************************************************************/
+void TestPCoACommand::getAllAxes(vector<vector<double> >& G, vector<double>& d, double& dsum) {
+    double offset = 0.0000;
+    vector<double> e;
+    
+    for(int count=0;count<2;count++){
+        linearCalc.recenter(offset, D, G);
+        linearCalc.tred2(G, d, e);
+        linearCalc.qtli(d, e, G);
+        offset = d[d.size()-1];
+        if(offset > 0.0) break;
+    }
+    
+    dsum = 0.0;
+    for(int i=0;i<d.size();i++){ dsum += d[i]; }
+}
+/**************************************************************************************************/
+TEST(Test_PCoACommand, LeadingAxesSameAsFullDecomposition) {
+    //the seed mothur starts with, so the points and the lanczos start vector are the same in every run
+    MothurOut::getInstance()->setRandomSeed(19760620);
+    TestPCoACommand test(60);
+    
+    vector<vector<double> > allG; vector<double> allD; double allDsum;
+    test.getAllAxes(allG, allD, allDsum);
+    
+    vector<vector<double> > centered; //the eigenvectors of the centered matrix are the axes
+    test.linearCalc.recenter(0.0, test.D, centered);
+    
+    int rank = test.D.size();
+    test.axes = 4;
+    
+    for (int processors = 1; processors <= 3; processors += 2) {
+        test.processors = processors;
+        
+        vector<vector<double> > G; vector<double> d; double dsum = 0.0;
+        test.getLeadingAxes(test.D, G, d, dsum);
+        
+        ASSERT_EQ(d.size(), test.axes);
+        //qtli stops once the off diagonal is within 0.1% of the diagonal, so the full decomposition is only good to
+        //about 1e-5 in the eigenvalues and 1e-3 in the eigenvectors
+        EXPECT_NEAR(dsum, allDsum, 1e-5 * allDsum);
+        for (int j = 0; j < test.axes; j++) {
+            EXPECT_NEAR(d[j], allD[j], 1e-4 * allD[0]);
+            EXPECT_NEAR(d[j] * 100.0 / dsum, allD[j] * 100.0 / allDsum, 1e-3); //loadings
+            
+            //the eigenvectors are the same up to sign
+            double dot = 0.0;
+            for (int i = 0; i < rank; i++) { dot += G[i][j] * allG[i][j]; }
+            double sign = (dot < 0.0) ? -1.0 : 1.0;
+            for (int i = 0; i < rank; i++) { EXPECT_NEAR(G[i][j], sign * allG[i][j], 5e-3); }
+            
+            //and the lanczos axes are eigenvectors to well within that
+            double lambda = 0.0, residual = 0.0;
+            vector<double> product(rank, 0.0);
+            for (int i = 0; i < rank; i++) {
+                for (int l = 0; l < rank; l++) { product[i] += centered[i][l] * G[l][j]; }
+                lambda += G[i][j] * product[i];
+            }
+            for (int i = 0; i < rank; i++) { residual += (product[i] - lambda * G[i][j]) * (product[i] - lambda * G[i][j]); }
+            EXPECT_LT(sqrt(residual), 1e-8 * allD[0]);
+        }
+    }
+}
+/**************************************************************************************************/
+TEST(Test_PCoACommand, LeadingAxesSameForAnyProcessors) {
+    MothurOut::getInstance()->setRandomSeed(19760620);
+    TestPCoACommand test1(300), test3(300); //each starts lanczos from the same random vector, 300 points is several blocks of rows
+    test1.axes = 4; test1.processors = 1;
+    test3.axes = 4; test3.processors = 3;
+    
+    vector<vector<double> > G1, G3; vector<double> d1, d3; double dsum1 = 0.0, dsum3 = 0.0;
+    test1.getLeadingAxes(test1.D, G1, d1, dsum1);
+    test3.getLeadingAxes(test3.D, G3, d3, dsum3);
+    
+    EXPECT_EQ(d1, d3);
+    EXPECT_EQ(G1, G3);
+    EXPECT_EQ(dsum1, dsum3);
+}
+/**************************************************************************************************/
@@ -0,0 +1,32 @@
+//
+//  testpcoacommand.h
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef testpcoacommand_h
+#define testpcoacommand_h
+
+#include "gtest.h"
+#include "pcoacommand.h"
+
+class TestPCoACommand : public PCOACommand {
+    
+public:
+    
+    using PCOACommand::axes;
+    using PCOACommand::processors;
+    using PCOACommand::getLeadingAxes;
+    using PCOACommand::linearCalc;
+    
+    TestPCoACommand(int); //number of points
+    ~TestPCoACommand();
+    
+    Utils util;
+    vector<vector<double> > D; //manhattan distances between random points, which are not euclidean so the smallest eigenvalue is negative
+    
+    void getAllAxes(vector<vector<double> >&, vector<double>&, double&); //the decomposition execute does for a few samples
+};
+
+#endif /* testpcoacommand_h */
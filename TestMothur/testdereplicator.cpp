@@ -0,0 +1,108 @@
+//
+//  testdereplicator.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testdereplicator.hpp"
+
+/**************************************************************************************************/
+TestDereplicator::TestDereplicator() {  //setup
+    util.setRandomStream(7);
+    fastaFile = "tempDereplicator.fasta";
+    
+    //200 sequences of different lengths, some the prefix of another, drawn 5000 times
+    string bases = "ACGT";
+    vector<string> uniques;
+    for (int i = 0; i < 200; i++) {
+        if ((i % 10 == 9) && (uniques[i-1].length() > 1)) { uniques.push_back(uniques[i-1].substr(0, uniques[i-1].length()-1)); continue; }
+        string temp = "";
+        int length = 1 + util.getRandomIndex(300);
+        for (int j = 0; j < length; j++) { temp += bases[util.getRandomIndex(3)]; }
+        uniques.push_back(temp);
+    }
+    
+    map<string, int> seen;
+    ofstream out; util.openOutputFile(fastaFile, out);
+    for (int i = 0; i < 5000; i++) {
+        string name = "seq" + toString(i);
+        string seq = uniques[util.getRandomIndex(199)];
+        out << ">" << name << endl << seq << endl;
+        
+        map<string, int>::iterator it = seen.find(seq);
+        if (it == seen.end()) {
+            seen[seq] = expectedLabels.size();
+            expectedLabels.push_back(vector<string>(1, name));
+            expectedFasta.push_back(">" + name); expectedFasta.push_back(seq);
+        }else { expectedLabels[it->second].push_back(name); }
+    }
+    out.close();
+}
+/**************************************************************************************************/
+TestDereplicator::~TestDereplicator() { util.mothurRemove(fastaFile); }
+/**************************************************************************************************/
+long long TestDereplicator::run(int processors, double budget, vector<string>& fasta, vector< vector<string> >& labels) {
+    Dereplicator dereplicator(processors, true, budget);
+    return run(dereplicator, fasta, labels);
+}
+/**************************************************************************************************/
+long long TestDereplicator::run(Dereplicator& dereplicator, vector<string>& fasta, vector< vector<string> >& labels) {
+    string outFastaFile = "tempDereplicator.unique.fasta";
+    
+    long long numSeqs = dereplicator.dereplicate(fastaFile, outFastaFile, nullptr);
+    
+    labels.clear();
+    vector<string> names; long long count;
+    while (dereplicator.nextUnique(names, count)) {
+        if (count != names.size()) { numSeqs = -1; } //counts must match the labels
+        labels.push_back(names);
+    }
+    
+    fasta.clear();
+    ifstream in; util.openInputFile(outFastaFile, in);
+    string line;
+    while (getline(in, line)) { if (line != "") { fasta.push_back(line); } }
+    in.close();
+    util.mothurRemove(outFastaFile);
+    
+    return numSeqs;
+}
+/**************************************************************************************************/
+TEST(Test_Dereplicator, InMemoryAndPartitioned) {
+    TestDereplicator test;
+    
+    vector<string> fasta; vector< vector<string> > labels;
+    
+    //in memory, then a budget of 1 byte so the first batch spills to partition files
+    int processors[2] = { 1, 3 };
+    for (int i = 0; i < 2; i++) {
+        EXPECT_EQ(5000, test.run(processors[i], 1e9, fasta, labels));
+        EXPECT_EQ(test.expectedFasta, fasta);
+        EXPECT_EQ(test.expectedLabels, labels);
+        
+        EXPECT_EQ(5000, test.run(processors[i], 1, fasta, labels));
+        EXPECT_EQ(test.expectedFasta, fasta);
+        EXPECT_EQ(test.expectedLabels, labels);
+    }
+}
+/**************************************************************************************************/
+TEST(Test_Dereplicator, CollisionsAcrossBatches) {
+    TestDereplicator test;
+    
+    vector<string> fasta; vector< vector<string> > labels;
+    
+    //batches of 7 sequences, so most duplicates are compared with uniques written by an earlier batch, and the
+    //uniques share 4 fingerprints, so each one is found by comparing bases along the next keys
+    int processors[2] = { 1, 3 };
+    double budgets[2] = { 1e9, 1 };
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) {
+            CollidingDereplicator dereplicator(processors[i], true, budgets[j], 7);
+            EXPECT_EQ(5000, test.run(dereplicator, fasta, labels));
+            EXPECT_EQ(test.expectedFasta, fasta);
+            EXPECT_EQ(test.expectedLabels, labels);
+        }
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,43 @@
+//
+//  testdereplicator.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef testdereplicator_hpp
+#define testdereplicator_hpp
+
+#include "gtest.h"
+#include "dereplicator.hpp"
+
+//gives every sequence starting with the same base the same fingerprint, and reads a few sequences at a time
+class CollidingDereplicator : public Dereplicator {
+    
+public:
+    
+    CollidingDereplicator(int p, bool k, double b, int size) : Dereplicator(p, k, b) { batchSize = size; }
+    
+    Fingerprint getFingerprint(const string& bases) { return Fingerprint(bases.substr(0, 1)); }
+};
+
+class TestDereplicator {
+    
+public:
+    
+    TestDereplicator();
+    ~TestDereplicator();
+    
+    string fastaFile;
+    vector<string> expectedFasta;               //lines of the unique fasta file, uniques in the order they first appear
+    vector< vector<string> > expectedLabels;    //names of each unique
+    
+    //dereplicates the fasta file, fills in the lines of the output fasta file and the names of each unique
+    long long run(int, double, vector<string>&, vector< vector<string> >&); //processors, memory budget
+    long long run(Dereplicator&, vector<string>&, vector< vector<string> >&);
+    
+private:
+    Utils util;
+};
+
+#endif /* testdereplicator_hpp */
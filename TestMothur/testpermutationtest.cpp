@@ -0,0 +1,187 @@
+//
+//  testpermutationtest.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testpermutationtest.hpp"
+
+/**************************************************************************************************/
+TestPermutationTest::TestPermutationTest() {  //setup
+    m = MothurOut::getInstance();
+    oldSeed = m->getRandomSeed();
+    m->setRandomSeed(12345);
+    
+    xFile = "tempPermutation.x.dist";       writeMatrix(xFile, 0);
+    yFile = "tempPermutation.y.dist";       writeMatrix(yFile, 1);
+    distFile = "tempPermutation.d.dist";    writeMatrix(distFile, 2);
+    
+    //3 groups of 4 samples
+    designFile = "tempPermutation.design";
+    ofstream out; util.openOutputFile(designFile, out);
+    out << "group\ttreatment" << endl;
+    for (int i = 0; i < 12; i++) { out << "s" << i << "\tg" << (i / 4) << endl; }
+    out.close();
+    
+    D.resize(12, vector<double>(12, 0.0));
+    for (int i = 0; i < 12; i++) {
+        for (int j = 0; j < 12; j++) { D[i][j] = getCell(i, j, 2) / 10000.0; }
+    }
+}
+/**************************************************************************************************/
+TestPermutationTest::~TestPermutationTest() {
+    util.mothurRemove(xFile); util.mothurRemove(yFile); util.mothurRemove(distFile); util.mothurRemove(designFile);
+    m->setRandomSeed(oldSeed);
+}
+/**************************************************************************************************/
+//the x matrix has many ties and pairs 0.0003 apart, the y matrix has many ties, the distances have no ties and are
+//smaller within groups, with a larger spread in each group
+long long TestPermutationTest::getCell(int i, int j, int matrix) {
+    if (i == j) { return 0; }
+    if (i < j) { swap(i, j); }
+    
+    if (matrix == 0)        { return (((i*j + i + j) % 9) * 1000) + ((((i + j) % 4) == 0) ? 3 : 0); }
+    else if (matrix == 1)   { return ((2*i + 5*j + i*j) % 11) * 1000; }
+    
+    long long base = 3000;
+    if ((i / 4) == (j / 4)) { base = 1000 * (1 + (i / 4)); }
+    return base + (((7*i + 3*j) % 10) * 300) + (i * 12) + j;
+}
+/**************************************************************************************************/
+void TestPermutationTest::writeMatrix(string fileName, int matrix) {
+    ofstream out; util.openOutputFile(fileName, out);
+    out << 12 << endl;
+    for (int i = 0; i < 12; i++) {
+        out << "s" << i;
+        for (int j = 0; j < 12; j++) { out << '\t' << (getCell(i, j, matrix) / 10000.0); }
+        out << endl;
+    }
+    out.close();
+}
+/**************************************************************************************************/
+void TestPermutationTest::runMantel(string method, int processors, double& mantel, double& pValue) {
+    MantelCommand command("phylip1=" + xFile + ", phylip2=" + yFile + ", method=" + method + ", processors=" + toString(processors));
+    command.execute();
+    
+    string outputFile = "tempPermutation.x.mantel";
+    ifstream in; util.openInputFile(outputFile, in);
+    string header; getline(in, header);
+    in >> mantel >> pValue;
+    in.close();
+    util.mothurRemove(outputFile);
+}
+/**************************************************************************************************/
+void TestPermutationTest::runDesignCommand(string name, int processors, vector<double>& values, vector<string>& pValues) {
+    string options = "phylip=" + distFile + ", design=" + designFile + ", processors=" + toString(processors);
+    values.clear(); pValues.clear();
+    
+    Command* command = nullptr;
+    if (name == "anosim")       { command = new AnosimCommand(options); }
+    else if (name == "amova")   { command = new AmovaCommand(options);  }
+    else                        { command = new HomovaCommand(options); }
+    command->execute();
+    delete command;
+    
+    string outputFile = "tempPermutation.d." + name;
+    ifstream in; util.openInputFile(outputFile, in);
+    string line;
+    while (getline(in, line)) {
+        vector<string> pieces = util.splitWhiteSpace(line);
+        if (pieces.size() == 0) { continue; }
+        
+        //amova prints each comparison as a table, anosim and homova as a line
+        if (name == "amova") {
+            if (pieces[0] == "Fs:")             { double value; util.mothurConvert(pieces[1], value); values.push_back(value); }
+            else if (pieces[0] == "p-value:")   { pValues.push_back(pieces[1]); }
+        }else if ((pieces[0] != "comparison") && (pieces[0] != "HOMOVA")) {
+            double value; util.mothurConvert(pieces[1], value);
+            values.push_back(value); pValues.push_back(pieces[2]);
+        }
+    }
+    in.close();
+    util.mothurRemove(outputFile);
+}
+/**************************************************************************************************/
+TEST(Test_PermutationTest, RanksAverageTies) {
+    vector< vector<double> > matrix(4, vector<double>(4, 0.0));
+    matrix[1][0] = 0.3; matrix[2][0] = 0.1; matrix[2][1] = 0.3; matrix[3][0] = 0.2; matrix[3][1] = 0.3; matrix[3][2] = 0.1;
+    
+    CondensedMatrix ranks(matrix);
+    double ties = ranks.convertToRanks();
+    
+    //0.1 twice, 0.2 once and the largest value three times, which are the last cells
+    double expected[6] = { 5.0, 1.5, 5.0, 3.0, 5.0, 1.5 };
+    for (int i = 0; i < 6; i++) { EXPECT_EQ(expected[i], ranks.cells[i]); }
+    EXPECT_EQ(((8.0 - 2.0) / 12.0) + ((27.0 - 3.0) / 12.0), ties);
+    
+    //the rows and columns of a subset of the samples
+    vector<int> samples; samples.push_back(3); samples.push_back(1);
+    CondensedMatrix sub(CondensedMatrix(matrix), samples);
+    EXPECT_EQ(1, sub.getNumCells());
+    EXPECT_EQ(0.3, sub.get(0, 1));
+}
+/**************************************************************************************************/
+TEST(Test_PermutationTest, CountsSameForAnyProcessors) {
+    TestPermutationTest test;
+    CondensedMatrix matrix(test.D);
+    HalfSum statistic(matrix);
+    
+    //each PermutationTest starts from the first stream, and a second run uses new streams
+    vector<int> counts;
+    int processors[3] = { 1, 3, 7 };
+    for (int i = 0; i < 3; i++) {
+        PermutationTest permutations(processors[i]);
+        double observed = permutations.getObserved(&statistic, 12);
+        counts.push_back(permutations.run(&statistic, 12, 1001, observed, true));
+        counts.push_back(permutations.run(&statistic, 12, 1001, observed, false));
+        counts.push_back(permutations.run(&statistic, 12, 5, observed, false));
+    }
+    for (int i = 3; i < counts.size(); i++) { EXPECT_EQ(counts[i % 3], counts[i]); }
+    
+    //the first half holds the samples with the smallest distances, so most orders have larger sums
+    EXPECT_GT(counts[0], counts[1]);
+}
+/**************************************************************************************************/
+TEST(Test_PermutationTest, MantelSameAsReference) {
+    TestPermutationTest test;
+    
+    //pearson is the value before the permutations were shared, spearman with exact ties and kendall's tau-a are from
+    //a separate calculation of the correlations of the cells
+    string methods[3] = { "pearson", "spearman", "kendall" };
+    double expected[3] = { 0.119520, 0.1023767870, 0.0638694639 };
+    
+    for (int i = 0; i < 3; i++) {
+        double mantel1, pValue1, mantel3, pValue3;
+        test.runMantel(methods[i], 1, mantel1, pValue1);
+        test.runMantel(methods[i], 3, mantel3, pValue3);
+        
+        //mantel is written with 6 decimals
+        EXPECT_NEAR(expected[i], mantel1, 0.0000005) << methods[i];
+        EXPECT_EQ(mantel1, mantel3) << methods[i];
+        EXPECT_EQ(pValue1, pValue3) << methods[i];
+    }
+}
+/**************************************************************************************************/
+TEST(Test_PermutationTest, DesignCommandsSameAsBefore) {
+    TestPermutationTest test;
+    
+    //values before the permutations were shared, for all groups and then each pair of groups
+    string commands[3] = { "anosim", "amova", "homova" };
+    double expected[3][4] = { { 0.511574, 0.84375, 0.416667, 0.322917 },
+                              { 3.12072, 5.44358, 2.94792, 1.93417 },
+                              { 0.844951, 0.277208, 0.826085, 0.160066 } };
+    
+    for (int i = 0; i < 3; i++) {
+        vector<double> values1, values3; vector<string> pValues1, pValues3;
+        test.runDesignCommand(commands[i], 1, values1, pValues1);
+        test.runDesignCommand(commands[i], 3, values3, pValues3);
+        
+        //the values are written with 6 significant digits
+        ASSERT_EQ(4, values1.size()) << commands[i];
+        for (int j = 0; j < 4; j++) { EXPECT_NEAR(expected[i][j], values1[j], expected[i][j] * 0.000005) << commands[i] << " " << j; }
+        EXPECT_EQ(values1, values3) << commands[i];
+        EXPECT_EQ(pValues1, pValues3) << commands[i];
+    }
+}
+/**************************************************************************************************/
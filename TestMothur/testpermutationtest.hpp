@@ -0,0 +1,62 @@
+//
+//  testpermutationtest.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef testpermutationtest_hpp
+#define testpermutationtest_hpp
+
+#include "gtest.h"
+#include "permutationtest.hpp"
+#include "mantelcommand.h"
+#include "anosimcommand.h"
+#include "amovacommand.h"
+#include "homovacommand.h"
+
+//the sum of the cells of the first half of the samples, so small orders give small values
+class HalfSum : public PermutationStatistic {
+    
+public:
+    
+    HalfSum(CondensedMatrix& d) : matrix(d) {}
+    
+    double getValue(const vector<int>& order) {
+        double sum = 0.0;
+        for (int i = 1; i < order.size()/2; i++) {
+            for (int j = 0; j < i; j++) { sum += matrix.get(order[i], order[j]); }
+        }
+        return sum;
+    }
+    
+private:
+    CondensedMatrix& matrix;
+};
+
+class TestPermutationTest {
+    
+public:
+    
+    TestPermutationTest();
+    ~TestPermutationTest();
+    
+    string xFile, yFile, distFile, designFile;
+    vector< vector<double> > D;
+    
+    //runs mantel, fills in the mantel value and its pValue
+    void runMantel(string, int, double&, double&);  //method, processors
+    
+    //runs anosim, amova or homova on the distances, fills in the statistic and pValue of each comparison
+    void runDesignCommand(string, int, vector<double>&, vector<string>&); //command, processors
+    
+private:
+    MothurOut* m;
+    Utils util;
+    unsigned oldSeed;
+    
+    void writeMatrix(string, int);  //file, matrix
+    long long getCell(int, int, int); //row, column, matrix. In units of 0.0001.
+};
+
+#endif /* testpermutationtest_hpp */
@@ -0,0 +1,91 @@
+//
+//  teststripedneedleman.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "teststripedneedleman.hpp"
+
+/**************************************************************************************************/
+TestStripedNeedleman::TestStripedNeedleman() {  //setup
+    util.setRandomStream(1);
+    
+    string bases = "ACGT";
+    
+    //templates of different lengths, so the striped layout is padded differently
+    int lengths[5] = { 1, 17, 64, 253, 400 };
+    for (int i = 0; i < 5; i++) {
+        string temp = "";
+        for (int j = 0; j < lengths[i]; j++) { temp += bases[util.getRandomIndex(3)]; }
+        templates.push_back(temp);
+    }
+    
+    //candidates are pieces of the templates with substitutions, insertions and deletions, plus a few unrelated sequences
+    for (int i = 1; i < templates.size(); i++) {
+        candidates.push_back(templates[i]);
+        candidates.push_back(mutate(templates[i], 5));
+        candidates.push_back(mutate(templates[i].substr(templates[i].length()/4, templates[i].length()/2), 10));
+    }
+    for (int i = 0; i < 4; i++) {
+        string temp = "";
+        for (int j = 0; j < 50 + 40 * i; j++) { temp += bases[util.getRandomIndex(3)]; }
+        candidates.push_back(temp);
+    }
+    candidates.push_back(templates[4] + "ACGTACGT"); //longer than the longest template, so the template is the shorter sequence
+}
+/**************************************************************************************************/
+TestStripedNeedleman::~TestStripedNeedleman() {}
+/**************************************************************************************************/
+//changes about one base in percent, a third each substitutions, insertions and deletions
+string TestStripedNeedleman::mutate(string seq, int percent) {
+    string bases = "ACGT";
+    string mutated = "";
+    for (int i = 0; i < seq.length(); i++) {
+        if (util.getRandomIndex(99) < percent) {
+            int type = util.getRandomIndex(2);
+            if (type == 0)      { mutated += bases[util.getRandomIndex(3)];             } //substitution
+            else if (type == 1) { mutated += seq[i]; mutated += bases[util.getRandomIndex(3)]; } //insertion
+        }else { mutated += seq[i]; }
+    }
+    return mutated;
+}
+/**************************************************************************************************/
+int TestStripedNeedleman::countDifferences(float gap, float match, float mismatch, int longest) {
+    NeedlemanOverlap needleman(gap, match, mismatch, longest);
+    StripedNeedleman striped(gap, match, mismatch, longest);
+    
+    int numDifferent = 0;
+    for (int i = 0; i < candidates.size(); i++) {
+        for (int j = 0; j < templates.size(); j++) {
+            needleman.align(candidates[i], templates[j], true);
+            striped.align(candidates[i], templates[j], true);
+            
+            bool same = (needleman.getSeqAAln() == striped.getSeqAAln()) && (needleman.getSeqBAln() == striped.getSeqBAln());
+            same = same && (needleman.getCandidateStartPos() == striped.getCandidateStartPos()) && (needleman.getCandidateEndPos() == striped.getCandidateEndPos());
+            same = same && (needleman.getTemplateStartPos() == striped.getTemplateStartPos()) && (needleman.getTemplateEndPos() == striped.getTemplateEndPos());
+            same = same && (needleman.getPairwiseLength() == striped.getPairwiseLength());
+            same = same && (needleman.getSeqAAlnBaseMap() == striped.getSeqAAlnBaseMap()) && (needleman.getSeqBAlnBaseMap() == striped.getSeqBAlnBaseMap());
+            
+            if (!same) { numDifferent++; }
+        }
+    }
+    
+    return numDifferent;
+}
+/**************************************************************************************************/
+TEST(Test_StripedNeedleman, SameAsNeedlemanOverlap) {
+    TestStripedNeedleman test;
+    
+    int longest = 0;
+    for (int i = 0; i < test.candidates.size(); i++) { longest = max(longest, (int)test.candidates[i].length()); }
+    
+    //align.seqs defaults, then scores with more ties between the directions
+    EXPECT_EQ(0, test.countDifferences(-2.0, 1.0, -1.0, longest+1));
+    EXPECT_EQ(0, test.countDifferences(-1.0, 1.0, -1.0, longest+1));
+    EXPECT_EQ(0, test.countDifferences(-3.0, 2.0, -2.0, longest+1));
+    
+    //fractional scores are handed to NeedlemanOverlap
+    EXPECT_EQ(0, test.countDifferences(-1.5, 1.0, -0.5, longest+1));
+}
+/**************************************************************************************************/
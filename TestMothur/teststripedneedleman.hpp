@@ -0,0 +1,33 @@
+//
+//  teststripedneedleman.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef teststripedneedleman_hpp
+#define teststripedneedleman_hpp
+
+#include "gtest.h"
+#include "stripedneedleman.hpp"
+#include "needlemanoverlap.hpp"
+
+class TestStripedNeedleman {
+    
+public:
+    
+    TestStripedNeedleman();
+    ~TestStripedNeedleman();
+    
+    vector<string> candidates, templates;
+    
+    //aligns each candidate to each template with both aligners, returns the number of pairs that differ
+    int countDifferences(float, float, float, int);
+    
+private:
+    Utils util;
+    
+    string mutate(string, int);
+};
+
+#endif /* teststripedneedleman_hpp */
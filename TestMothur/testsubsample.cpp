@@ -11,10 +11,18 @@
 /**************************************************************************************************/
 TestSubSample::TestSubSample()  {  //setup
     m = MothurOut::getInstance();
+    
+    int sizes[12] = { 1, 0, 5, 10, 1000, 3, 0, 250, 1, 77, 2, 40 }; //1389 reads
+    abunds.assign(sizes, sizes+12);
 }
 /**************************************************************************************************/
 TestSubSample::~TestSubSample() { }
 /**************************************************************************************************/
+vector<int> TestSubSample::draw(const vector<int>& binSizes, long long num, bool withReplacement) {
+    if (withReplacement) { return drawCountsWithReplacement(binSizes, num); }
+    return drawCounts(binSizes, num);
+}
+/**************************************************************************************************/
 TEST(Test_SubSample, getWeightedSample) {
     TestSubSample test;
     
@@ -42,3 +50,68 @@ TEST(Test_SubSample, getWeightedSample) {
 }
 
 /**************************************************************************************************/
+TEST(Test_SubSample, drawCounts) {
+    TestSubSample test;
+    test.setIteration(3);
+    
+    //fewer than half the reads are drawn, then more than half are, so the reads left out are drawn instead
+    long long nums[5] = { 1, 100, 694, 695, 1388 };
+    for (int i = 0; i < 5; i++) {
+        vector<int> counts = test.draw(test.abunds, nums[i], false);
+        
+        ASSERT_EQ(test.abunds.size(), counts.size());
+        long long sum = 0;
+        for (int j = 0; j < counts.size(); j++) {
+            EXPECT_GE(counts[j], 0);
+            EXPECT_LE(counts[j], test.abunds[j]);
+            sum += counts[j];
+        }
+        EXPECT_EQ(nums[i], sum);
+    }
+    
+    //all the reads, or more, returns the abundances
+    EXPECT_EQ(test.abunds, test.draw(test.abunds, 1389, false));
+    EXPECT_EQ(test.abunds, test.draw(test.abunds, 5000, false));
+}
+/**************************************************************************************************/
+TEST(Test_SubSample, drawCountsWithReplacement) {
+    TestSubSample test;
+    test.setIteration(3);
+    
+    long long nums[4] = { 1, 100, 1389, 5000 };
+    for (int i = 0; i < 4; i++) {
+        vector<int> counts = test.draw(test.abunds, nums[i], true);
+        
+        ASSERT_EQ(test.abunds.size(), counts.size());
+        long long sum = 0;
+        for (int j = 0; j < counts.size(); j++) {
+            EXPECT_GE(counts[j], 0);
+            if (test.abunds[j] == 0) { EXPECT_EQ(0, counts[j]); } //empty bins are never drawn
+            sum += counts[j];
+        }
+        EXPECT_EQ(nums[i], sum);
+    }
+    
+    //nothing to draw from
+    EXPECT_EQ(vector<int>(3, 0), test.draw(vector<int>(3, 0), 10, true));
+}
+/**************************************************************************************************/
+TEST(Test_SubSample, drawCountsSameForSeed) {
+    TestSubSample test, test2;
+    
+    for (int r = 0; r < 2; r++) {
+        bool withReplacement = (r == 1);
+        
+        test.setIteration(42); test2.setIteration(42);
+        vector<int> first = test.draw(test.abunds, 500, withReplacement);
+        EXPECT_EQ(first, test2.draw(test2.abunds, 500, withReplacement));
+        
+        //reseeding the same object repeats the draw, a different stream doesn't
+        test.setIteration(42);
+        EXPECT_EQ(first, test.draw(test.abunds, 500, withReplacement));
+        
+        test.setIteration(43);
+        EXPECT_NE(first, test.draw(test.abunds, 500, withReplacement));
+    }
+}
+/**************************************************************************************************/
@@ -20,6 +20,10 @@ public:
     ~TestSubSample();
     
     MothurOut* m;
+    
+    vector<int> draw(const vector<int>&, long long, bool); //abundances, num to sample, with replacement
+    
+    vector<int> abunds; //bins of different sizes, including empty ones
 };
 
 #endif /* testsubsample_hpp */
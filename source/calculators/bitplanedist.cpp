@@ -0,0 +1,186 @@
+//
+//  bitplanedist.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "bitplanedist.h"
+
+/***********************************************************************/
+inline int countBits(unsigned long long x)      { return __builtin_popcountll(x);   }
+inline int lowestBit(unsigned long long x)      { return __builtin_ctzll(x);        } //x != 0
+inline int highestBit(unsigned long long x)     { return 63 - __builtin_clzll(x);   } //x != 0
+/***********************************************************************/
+BitPlaneDist::BitPlaneDist(AlignedBitPlanes* s, string calc, bool countends, double c) : seqs(s), cutoff(c) {
+    try {
+        m = MothurOut::getInstance();
+        numWords = seqs->getNumWords();
+        numPlanes = seqs->getNumPlanes();
+
+        if (calc == "nogaps")           {   method = NOGAPS;                                    }
+        else if (calc == "eachgap")     {   method = countends ? EACHGAP : EACHGAPIGNORE;       }
+        else                            {   method = countends ? ONEGAP : ONEGAPIGNORE;         }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BitPlaneDist", "BitPlaneDist");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//columns that can be the first or last column compared, same as setStart/setEnd, the nogaps search and setStartIgnoreTermGap/setEndIgnoreTermGap
+unsigned long long BitPlaneDist::getStartEndMask(const unsigned long long* dotsA, const unsigned long long* dashesA, const unsigned long long* dotsB, const unsigned long long* dashesB, int w) {
+    if ((method == EACHGAP) || (method == ONEGAP))  {   return ~(dotsA[w] & dotsB[w]);                                  }
+    else if (method == NOGAPS)                      {   return ~dotsA[w] & ~dotsB[w];                                   }
+    else                                            {   return ~(dotsA[w] | dashesA[w]) & ~(dotsB[w] | dashesB[w]);     }
+}
+/***********************************************************************/
+//returns the gap columns plus the columns of unset that follow a gap column or follow the start of the word when open is
+//true. Adding 1 just past each gap column carries through the run of unset columns after it, clearing them.
+unsigned long long BitPlaneDist::fillGapRuns(unsigned long long gaps, unsigned long long unset, bool open) {
+    unsigned long long carries = ((gaps << 1) | (open ? 1ULL : 0ULL)) & unset;
+    unsigned long long sum = unset + carries;
+    return gaps | (unset & ~sum);
+}
+/***********************************************************************/
+double BitPlaneDist::calcDist(int a, int b) {
+    try {
+        const unsigned long long* dotsA = seqs->getDots(a);
+        const unsigned long long* dashesA = seqs->getDashes(a);
+        const unsigned long long* codesA = seqs->getCodes(a);
+        const unsigned long long* dotsB = seqs->getDots(b);
+        const unsigned long long* dashesB = seqs->getDashes(b);
+        const unsigned long long* codesB = seqs->getCodes(b);
+
+        //find the first and last columns to compare
+        int start = 0; int end = 0; bool overlap = false;
+        for (int w = 0; w < numWords; w++) {
+            unsigned long long mask = getStartEndMask(dotsA, dashesA, dotsB, dashesB, w);
+            if (mask != 0) { start = w*64 + lowestBit(mask); overlap = true; break; }
+        }
+        for (int w = numWords-1; w >= 0; w--) {
+            unsigned long long mask = getStartEndMask(dotsA, dashesA, dotsB, dashesB, w);
+            if (mask != 0) { end = w*64 + highestBit(mask); break; }
+        }
+
+        //non-overlapping sequences
+        if ((!overlap) && ((method == NOGAPS) || (method == EACHGAPIGNORE) || (method == ONEGAPIGNORE))) { return 1.0000; }
+
+        int maxMinLength = end - start + 1;
+        if (method == ONEGAPIGNORE) { maxMinLength = end - start; }
+
+        int lastWord = numWords-1;
+        if (method == ONEGAPIGNORE) { lastWord = end / 64; }
+
+        int difference = 0;
+        bool openGapA = false;
+        bool openGapB = false;
+        bool testEachColumn = false;
+
+        for (int w = start / 64; w <= lastWord; w++) {
+            unsigned long long range = ~0ULL;
+            if (w == (start / 64)) { range &= (~0ULL << (start % 64)); }
+            if ((method == ONEGAPIGNORE) && (w == lastWord) && ((end % 64) != 63)) { range &= ((1ULL << ((end % 64) + 1)) - 1); }
+
+            unsigned long long dotA = dotsA[w]; unsigned long long dashA = dashesA[w];
+            unsigned long long dotB = dotsB[w]; unsigned long long dashB = dashesB[w];
+            unsigned long long gapA = dotA | dashA;
+            unsigned long long gapB = dotB | dashB;
+            unsigned long long baseA = ~gapA;
+            unsigned long long baseB = ~gapB;
+
+            //stop at the first column where the string calculators break out of their loop
+            unsigned long long stops = 0;
+            if ((method == EACHGAP) || (method == ONEGAP))              {   stops = dotA & dotB;    }
+            else if ((method == NOGAPS) || (method == EACHGAPIGNORE))   {   stops = dotA | dotB;    }
+            stops &= range;
+
+            bool done = false;
+            if (stops != 0) { range &= ((stops & (~stops + 1)) - 1); done = true; }
+
+            unsigned long long codeDiffs = 0;
+            for (int p = 0; p < numPlanes; p++) { codeDiffs |= (codesA[p*numWords + w] ^ codesB[p*numWords + w]); }
+            unsigned long long baseDiffs = baseA & baseB & codeDiffs;
+
+            if ((method == NOGAPS) || (method == EACHGAP) || (method == EACHGAPIGNORE)) {
+                unsigned long long ignored, mismatches;
+                if (method == NOGAPS) {
+                    ignored = (dashA | dashB) & range;
+                    mismatches = baseDiffs & range;
+                }else if (method == EACHGAP) {
+                    ignored = gapA & gapB & range;
+                    mismatches = ((gapA ^ gapB) | baseDiffs) & range;
+                }else {
+                    ignored = dashA & dashB & range;
+                    mismatches = ((dashA ^ dashB) | baseDiffs) & range;
+                }
+
+                //eachGapIgnoreTermGapDist keeps going past the last column where both are bases, so maxMinLength can
+                //reach 0 or go negative. Once that can happen the distance is no longer growing, so test every column.
+                if (!testEachColumn && ((maxMinLength - countBits(ignored)) > 0)) {
+                    difference += countBits(mismatches);
+                    maxMinLength -= countBits(ignored);
+                }else {
+                    testEachColumn = true;
+                    for (int i = 0; i < 64; i++) {
+                        unsigned long long bit = 1ULL << i;
+                        if ((range & bit) == 0) { continue; }
+
+                        if (ignored & bit)          { maxMinLength--;   }
+                        else if (mismatches & bit)  { difference++;     }
+
+                        double dist = (double)difference / maxMinLength;
+                        if (dist > cutoff) { return 1.0000; }
+                    }
+                }
+            }else {
+                unsigned long long bothGaps, gapsA, gapsB, mismatches;
+                if (method == ONEGAP) {
+                    bothGaps = gapA & gapB & range;
+                    gapsA = gapA & baseB & range;
+                    gapsB = baseA & gapB & range;
+                    mismatches = baseDiffs & range;
+                }else {
+                    bothGaps = dashA & dashB & range;
+                    gapsA = dashA & ~dashB & range;
+                    gapsB = ~dashA & dashB & range;
+                    mismatches = ((dotA ^ dotB) | baseDiffs) & ~dashA & ~dashB & range;
+                }
+
+                //a gap column continues the gap if the last column that was not a gap in both was the same kind of gap
+                unsigned long long unset = ~(range & ~bothGaps);
+                unsigned long long filledA = fillGapRuns(gapsA, unset, openGapA);
+                unsigned long long filledB = fillGapRuns(gapsB, unset, openGapB);
+                unsigned long long continuedA = gapsA & ((filledA << 1) | (openGapA ? 1ULL : 0ULL));
+                unsigned long long continuedB = gapsB & ((filledB << 1) | (openGapB ? 1ULL : 0ULL));
+
+                difference += countBits(mismatches) + countBits(gapsA & ~continuedA) + countBits(gapsB & ~continuedB);
+                maxMinLength -= countBits(bothGaps) + countBits(continuedA) + countBits(continuedB);
+
+                openGapA = (filledA >> 63) != 0;
+                openGapB = (filledB >> 63) != 0;
+            }
+
+            //the distance only grows as columns are added, so once it is over the cutoff it stays there
+            if (!testEachColumn && (maxMinLength > 0)) {
+                double dist = (double)difference / maxMinLength;
+                if (dist > cutoff) { return 1.0000; }
+            }
+
+            if (done) { break; }
+        }
+
+        double dist = 1.0000;
+        if (maxMinLength != 0) {
+            dist = (double)difference / maxMinLength;
+            if (dist > cutoff) { dist = 1.0000; } //only possible if the loop above stopped before any columns
+        }
+
+        return dist;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "BitPlaneDist", "calcDist");
+        exit(1);
+    }
+}
+/***********************************************************************/
@@ -0,0 +1,43 @@
+#ifndef BITPLANEDIST_H
+#define BITPLANEDIST_H
+//
+//  bitplanedist.h
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "alignedbitplanes.hpp"
+
+/**************************************************************************************************/
+
+/* Computes the same distances as ignoreGaps, eachGapDist, oneGapDist, eachGapIgnoreTermGapDist and
+ oneGapIgnoreTermGapDist from sequences encoded by AlignedBitPlanes. Every column class the string calculators
+ branch on is built as a 64 column mask and counted with popcount. The one gap calculators only count the first
+ column of a gap, so the open gap state is carried through runs of columns that are gaps in both sequences with a
+ carry propagating add. The counts, the cutoff test and the final division are the same as the string calculators,
+ so the distances are bit identical. */
+
+class BitPlaneDist {
+
+public:
+    BitPlaneDist(AlignedBitPlanes*, string, bool, double);  //sequences, calc, countends, cutoff
+    ~BitPlaneDist() = default;
+
+    double calcDist(int, int);  //distance between sequences i and j
+
+private:
+    enum { NOGAPS, EACHGAP, ONEGAP, EACHGAPIGNORE, ONEGAPIGNORE };
+
+    MothurOut* m;
+    AlignedBitPlanes* seqs;
+    int method, numWords, numPlanes;
+    double cutoff;
+
+    unsigned long long getStartEndMask(const unsigned long long*, const unsigned long long*, const unsigned long long*, const unsigned long long*, int);
+    unsigned long long fillGapRuns(unsigned long long, unsigned long long, bool);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,117 @@
+//
+//  kmerprefilter.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "kmerprefilter.h"
+
+/***********************************************************************/
+KmerPrefilter::KmerPrefilter(StorageDatabase* db, double c, int k) : kmerSize(k), cutoff(c) {
+    try {
+        m = MothurOut::getInstance();
+
+        int numSeqs = db->getNumSeqs();
+        numBases.resize(numSeqs, 0); firstBase.resize(numSeqs, 0); lastBase.resize(numSeqs, -1);
+        firstColumn.resize(numSeqs, 0); lastColumn.resize(numSeqs, -1); usable.resize(numSeqs, true);
+        extraKmers.resize(numSeqs, 0);
+
+        Kmer kmer(kmerSize);
+        vector<bool> anyBase;
+        vector< vector<int> > allKmers(numSeqs);
+        int maxKmers = 0;
+        for (int i = 0; i < numSeqs; i++) {
+            if (m->getControl_pressed()) { break; }
+
+            string aligned = db->getSeq(i).getAligned();
+            if (aligned.length() > anyBase.size()) { anyBase.resize(aligned.length(), false); }
+
+            string bases = "";
+            int first = -1; int last = -1;
+            for (int j = 0; j < aligned.length(); j++) {
+                if (aligned[j] == '.') { continue; }
+                if (first == -1) { first = j; }
+                last = j;
+
+                if (aligned[j] == '-') { continue; }
+                if (bases.length() == 0) { firstBase[i] = j; }
+                lastBase[i] = j;
+                anyBase[j] = true;
+                bases += aligned[j];
+            }
+            if (first != -1) { firstColumn[i] = first; lastColumn[i] = last; }
+            numBases[i] = bases.length();
+
+            for (int j = first+1; j < last; j++) { if (aligned[j] == '.') { usable[i] = false; break; } }
+
+            kmer.getKmerNumbers(bases, allKmers[i]);
+            if (allKmers[i].size() > maxKmers) { maxKmers = allKmers[i].size(); }
+        }
+
+        //2 bins per kmer keeps chance matches between unrelated sequences low
+        binBits = 8;
+        while (((1 << binBits) < (2 * maxKmers)) && (binBits < 16)) { binBits++; }
+        numWords = (1 << binBits) / 64;
+
+        bins.assign((long long)numSeqs * 2 * numWords, 0);
+        for (int i = 0; i < numSeqs; i++) {
+            if (m->getControl_pressed()) { break; }
+
+            unsigned long long* once = &bins[(long long)i * 2 * numWords];
+            unsigned long long* twice = once + numWords;
+            for (int j = 0; j < allKmers[i].size(); j++) {
+                unsigned int bin = ((unsigned int)allKmers[i][j] * 2654435761u) >> (32 - binBits);
+                unsigned long long bit = 1ULL << (bin % 64);
+                if ((once[bin / 64] & bit) == 0)        {   once[bin / 64] |= bit;  }
+                else if ((twice[bin / 64] & bit) == 0)  {   twice[bin / 64] |= bit; }
+                else                                    {   extraKmers[i]++;        }
+            }
+            vector<int>().swap(allKmers[i]);
+        }
+
+        baseColumns.resize(anyBase.size()+1, 0);
+        for (int j = 0; j < anyBase.size(); j++) { baseColumns[j+1] = baseColumns[j] + (anyBase[j] ? 1 : 0); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "KmerPrefilter", "KmerPrefilter");
+        exit(1);
+    }
+}
+/***********************************************************************/
+bool KmerPrefilter::isValid(string calc, bool countends) {
+    return ((calc == "onegap") || ((calc == "eachgap") && countends));
+}
+/***********************************************************************/
+bool KmerPrefilter::isFar(int a, int b) {
+    try {
+        if (!usable[a] || !usable[b]) { return false; }
+
+        //a column of '.' in both sequences between them stops the calculators
+        if (max(firstColumn[a], firstColumn[b]) > (min(lastColumn[a], lastColumn[b]) + 1)) { return false; }
+
+        //fewest columns where both can have a base
+        int low = min(firstBase[a], firstBase[b]);
+        int high = max(lastBase[a], lastBase[b]);
+        if (high < low) { return false; }
+        long long bothBases = numBases[a] + numBases[b] - (baseColumns[high+1] - baseColumns[low]);
+        if (bothBases <= 0) { return false; }
+
+        //the distance is over the cutoff if fewer than this many kmers are shared
+        double needed = bothBases - kmerSize + 1 - (kmerSize * bothBases * (cutoff + 1e-9));
+        if (needed <= 0) { return false; }
+
+        //most shared kmers possible, min(countA, countB) summed over the bins
+        const unsigned long long* binsA = &bins[(long long)a * 2 * numWords];
+        const unsigned long long* binsB = &bins[(long long)b * 2 * numWords];
+        long long shared = extraKmers[a] + extraKmers[b];
+        for (int w = 0; w < 2 * numWords; w++) { shared += __builtin_popcountll(binsA[w] & binsB[w]); }
+
+        return (shared < needed);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "KmerPrefilter", "isFar");
+        exit(1);
+    }
+}
+/***********************************************************************/
@@ -0,0 +1,59 @@
+#ifndef KMERPREFILTER_H
+#define KMERPREFILTER_H
+//
+//  kmerprefilter.h
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "storagedatabase.hpp"
+#include "kmer.hpp"
+
+/**************************************************************************************************/
+
+/* Finds pairs of aligned sequences whose onegap or eachgap distance must be above the cutoff from the number of
+ kmers they share, so dist.seqs can skip them without comparing the alignments.
+
+ A kmer of B is kept in A when its bases line up with the same bases of A with no gap columns between them. A
+ mismatch column breaks at most k of B's kmers, a run of gaps in B breaks the k-1 kmers that span it and a run of g
+ bases across from gaps in A breaks g+k-1. So with AB columns where both sequences have a base, m mismatches and r
+ gap runs, the shared kmer count S is at least AB - k + 1 - k*m - (k-1)*r. The onegap distance is (m+r) / (AB+r)
+ (one less in the denominator with countends=F) and the eachgap distance is at least that, and the smallest value
+ that fits the kmer inequality is (AB - S - k + 1) / (k*AB), which grows with AB. AB is at least the sum of the
+ base counts minus the number of columns between the outer ends of the two sequences where any sequence in the
+ file has a base.
+
+ Merging the sorted kmer lists of every pair costs more than comparing the alignments, so each sequence's kmers are
+ hashed into about 2 bins per kmer and kept as two bit masks, bins with at least one kmer and bins with at least
+ two, plus the count of kmers past the second in a bin. The matching bits of the masks plus both extra counts is
+ never less than the shared kmer count, so it stands in for S.
+
+ nogaps and eachgap with countends=F don't count every gap, so the prefilter can't be used with them. Sequences
+ with a '.' between their bases, or pairs with a column of '.' in both between them, are always compared because
+ the distance calculators stop at those columns. */
+
+class KmerPrefilter {
+
+public:
+    KmerPrefilter(StorageDatabase*, double, int);  //sequences, cutoff, kmer size
+    ~KmerPrefilter() = default;
+
+    static bool isValid(string, bool);  //calc, countends
+    bool isFar(int, int);  //true if the distance between sequences i and j must be above the cutoff
+
+private:
+    MothurOut* m;
+    int kmerSize, binBits, numWords;
+    double cutoff;
+
+    vector<unsigned long long> bins;    //for each sequence, numWords words of bins with a kmer then numWords with two
+    vector<int> extraKmers;             //kmers past the second in their bin
+    vector<int> numBases, firstBase, lastBase, firstColumn, lastColumn;  //first and last base and non '.' columns
+    vector<bool> usable;                //false if the sequence has a '.' between its bases
+    vector<int> baseColumns;            //baseColumns[c] is the number of columns before c where any sequence has a base
+};
+
+/**************************************************************************************************/
+
+#endif
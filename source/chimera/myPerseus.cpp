@@ -48,7 +48,7 @@ vector<vector<double> > Perseus::binomial(int maxOrder){
 }
 
 /**************************************************************************************************/
-double Perseus::basicPairwiseAlignSeqs(string query, string reference, string& qAlign, string& rAlign, pwModel model){
+double Perseus::basicPairwiseAlignSeqs(const string& query, const string& reference, string& qAlign, string& rAlign, pwModel model){
 	try {
 		double GAP = model.GAP_OPEN;
 		double MATCH = model.MATCH;
@@ -57,64 +57,61 @@ double Perseus::basicPairwiseAlignSeqs(string query, string reference, string& q
 		int queryLength = query.size();
 		int refLength = reference.size();
 		
-		vector<vector<double> > alignMatrix(queryLength + 1);
-		vector<vector<char> > alignMoves(queryLength + 1);
+		int cols = refLength + 1;
+		double* alignMatrix = getMatrix(queryLength + 1, cols);
+		char* alignMoves = &moveBuffer[0];
 		
 		for(int i=0;i<=queryLength;i++){
-			if (m->getControl_pressed()) { return 0; }
-			alignMatrix[i].resize(refLength + 1, 0);
-			alignMoves[i].resize(refLength + 1, 'x');
-		}
-		
-		for(int i=0;i<=queryLength;i++){
-			if (m->getControl_pressed()) { return 0; }
-			alignMatrix[i][0] = GAP * i;
-			alignMoves[i][0] = 'u';
+			alignMatrix[i * cols] = GAP * i;
+			alignMoves[i * cols] = 'u';
 		}
 		
 		for(int i=0;i<=refLength;i++){
-			if (m->getControl_pressed()) { return 0; }
-			alignMatrix[0][i] = GAP * i;
-			alignMoves[0][i] = 'l';
+			alignMatrix[i] = GAP * i;
+			alignMoves[i] = 'l';
 		}
 		
 		for(int i=1;i<=queryLength;i++){
 			
 			if (m->getControl_pressed()) { return 0; }
 			
+			double* row = alignMatrix + (i * cols);
+			double* lastRow = row - cols;
+			char* moves = alignMoves + (i * cols);
+			
 			for(int j=1;j<=refLength;j++){
 				
 				double nogapScore;		
-				if(query[i-1] == reference[j-1]){	nogapScore = alignMatrix[i-1][j-1] + MATCH;		}
-				else							{	nogapScore = alignMatrix[i-1][j-1] + MISMATCH;	}
+				if(query[i-1] == reference[j-1]){	nogapScore = lastRow[j-1] + MATCH;		}
+				else							{	nogapScore = lastRow[j-1] + MISMATCH;	}
 				
 				double leftScore;
-				if(i == queryLength)			{	leftScore = alignMatrix[i][j-1];				}
-				else							{	leftScore = alignMatrix[i][j-1] + GAP;			}
+				if(i == queryLength)			{	leftScore = row[j-1];				}
+				else							{	leftScore = row[j-1] + GAP;			}
 				
 				
 				double upScore;
-				if(j == refLength)				{	upScore = alignMatrix[i-1][j];					}
-				else							{	upScore = alignMatrix[i-1][j] + GAP;			}
+				if(j == refLength)				{	upScore = lastRow[j];					}
+				else							{	upScore = lastRow[j] + GAP;			}
 				
 				if(nogapScore > leftScore){
 					if(nogapScore > upScore){
-						alignMoves[i][j] = 'd';
-						alignMatrix[i][j] = nogapScore;
+						moves[j] = 'd';
+						row[j] = nogapScore;
 					}
 					else{
-						alignMoves[i][j] = 'u';
-						alignMatrix[i][j] = upScore;
+						moves[j] = 'u';
+						row[j] = upScore;
 					}
 				}
 				else{
 					if(leftScore > upScore){
-						alignMoves[i][j] = 'l';
-						alignMatrix[i][j] = leftScore;
+						moves[j] = 'l';
+						row[j] = leftScore;
 					}
 					else{
-						alignMoves[i][j] = 'u';
-						alignMatrix[i][j] = upScore;
+						moves[j] = 'u';
+						row[j] = upScore;
 					}
 				}
 			}
@@ -123,6 +120,7 @@ double Perseus::basicPairwiseAlignSeqs(string query, string reference, string& q
 		int i = queryLength;
 		int j = refLength;
 		
+		//the alignment is built backwards and reversed at the end
 		qAlign = "";
 		rAlign = "";
 			
@@ -131,11 +129,10 @@ double Perseus::basicPairwiseAlignSeqs(string query, string reference, string& q
 		
 		while(i > 0 && j > 0){
 			
-			if (m->getControl_pressed()) { return 0; }
-			
-			if(alignMoves[i][j] == 'd'){
-				qAlign = query[i-1] + qAlign;
-				rAlign = reference[j-1] + rAlign;
+			char move = alignMoves[i * cols + j];
+			if(move == 'd'){
+				qAlign += query[i-1];
+				rAlign += reference[j-1];
 
 				if(query[i-1] != reference[j-1]){	diffs++;	}
 				length++;
@@ -143,41 +140,36 @@ double Perseus::basicPairwiseAlignSeqs(string query, string reference, string& q
 				i--;
 				j--;
 			}
-			else if(alignMoves[i][j] == 'u'){
-				qAlign = query[i-1] + qAlign;
+			else if(move == 'u'){
+				qAlign += query[i-1];
 				
-				if(j != refLength)	{	rAlign = '-' + rAlign;	diffs++;	length++;	}
-				else				{	rAlign = '.' + rAlign;	}
+				if(j != refLength)	{	rAlign += '-';	diffs++;	length++;	}
+				else				{	rAlign += '.';	}
 				i--;
 			}
-			else if(alignMoves[i][j] == 'l'){
-				rAlign = reference[j-1] + rAlign;
+			else if(move == 'l'){
+				rAlign += reference[j-1];
 				
-				if(i != queryLength){	qAlign = '-' + qAlign;	diffs++;	length++;	}
-				else				{	qAlign = '.' + qAlign;	}
+				if(i != queryLength){	qAlign += '-';	diffs++;	length++;	}
+				else				{	qAlign += '.';	}
 				j--;
 			}
 		}
 		
 		while(i>0){
-			
-			if (m->getControl_pressed()) { return 0; }
-			
-			rAlign = '.' + rAlign;
-			qAlign = query[i-1] + qAlign;
+			rAlign += '.';
+			qAlign += query[i-1];
 			i--;
 		}
 		
 		while(j>0){
-			
-			if (m->getControl_pressed()) { return 0; }
-			
-			rAlign = reference[j-1] + rAlign;
-			qAlign = '.' + qAlign;
+			rAlign += reference[j-1];
+			qAlign += '.';
 			j--;
 		}
 		
-		
+		reverse(qAlign.begin(), qAlign.end());
+		reverse(rAlign.begin(), rAlign.end());
 
 		return double(diffs)/double(length);
 	}
@@ -188,7 +180,21 @@ double Perseus::basicPairwiseAlignSeqs(string query, string reference, string& q
 	
 }
 /**************************************************************************************************/
-int Perseus::getDiffs(string qAlign, string rAlign, vector<int>& leftDiffs, vector<int>& leftMap, vector<int>& rightDiffs, vector<int>& rightMap){
+//the score matrix, with the moves matrix the same size, reused between alignments
+double* Perseus::getMatrix(int rows, int cols){
+	try {
+		size_t size = (size_t)rows * cols;
+		if (scoreBuffer.size() < size) { scoreBuffer.resize(size); moveBuffer.resize(size); }
+		
+		return &scoreBuffer[0];
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Perseus", "getMatrix");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+int Perseus::getDiffs(const string& qAlign, const string& rAlign, vector<int>& leftDiffs, vector<int>& leftMap, vector<int>& rightDiffs, vector<int>& rightMap){
 	try {
 		int alignLength = qAlign.length();
 		
@@ -250,14 +256,12 @@ int Perseus::getDiffs(string qAlign, string rAlign, vector<int>& leftDiffs, vect
 	}
 }
 /**************************************************************************************************/
-int Perseus::getLastMatch(char direction, vector<vector<char> >& alignMoves, int i, int j, string& seqA, string& seqB){
+int Perseus::getLastMatch(char direction, const char* alignMoves, int cols, int i, int j, string& seqA, string& seqB){
 	try {
 		char nullReturn = -1;
 		
 		while(i>=1 && j>=1){
 			
-			if (m->getControl_pressed()) { return 0; }
-			
 			if(direction == 'd'){
 				if(seqA[i-1] == seqB[j-1])	{	return seqA[i-1];	}
 				else						{	return nullReturn;	}
@@ -266,7 +270,7 @@ int Perseus::getLastMatch(char direction, vector<vector<char> >& alignMoves, int
 			else if(direction == 'l')		{	j--;				}
 			else							{	i--;				}
 			
-			direction = alignMoves[i][j];
+			direction = alignMoves[i * cols + j];
 		}
 		
 		return nullReturn;
@@ -300,88 +304,90 @@ double Perseus::modeledPairwiseAlignSeqs(string query, string reference, string&
 		int queryLength = query.size();
 		int refLength = reference.size();
 		
-		vector<vector<double> > alignMatrix(queryLength + 1);
-		vector<vector<char> > alignMoves(queryLength + 1);
+		vector<int> queryBases(queryLength), refBases(refLength);
+		for(int i=0;i<queryLength;i++){	queryBases[i] = toInt(query[i]);	}
+		for(int i=0;i<refLength;i++){	refBases[i] = toInt(reference[i]);	}
 		
-		for(int i=0;i<=queryLength;i++){
-			if (m->getControl_pressed()) { return 0; }
-			alignMatrix[i].resize(refLength + 1, 0);
-			alignMoves[i].resize(refLength + 1, 'x');
-		}
+		int cols = refLength + 1;
+		double* alignMatrix = getMatrix(queryLength + 1, cols);
+		char* alignMoves = &moveBuffer[0];
 		
 		for(int i=0;i<=queryLength;i++){
-			if (m->getControl_pressed()) { return 0; }
-			alignMatrix[i][0] = 15.0 * i;
-			alignMoves[i][0] = 'u';
+			alignMatrix[i * cols] = 15.0 * i;
+			alignMoves[i * cols] = 'u';
 		}
 		
 		for(int i=0;i<=refLength;i++){
-			if (m->getControl_pressed()) { return 0; }
-			alignMatrix[0][i] = 15.0 * i;
-			alignMoves[0][i] = 'l';
+			alignMatrix[i] = 15.0 * i;
+			alignMoves[i] = 'l';
 		}
 		
 		for(int i=1;i<=queryLength;i++){
 			
 			if (m->getControl_pressed()) { return 0; }
 			
+			double* row = alignMatrix + (i * cols);
+			double* lastRow = row - cols;
+			char* moves = alignMoves + (i * cols);
+			vector<double>& correctRow = correctMatrix[queryBases[i-1]];
+			
 			for(int j=1;j<=refLength;j++){
 				
 				double nogap;		
-				nogap = alignMatrix[i-1][j-1] + correctMatrix[toInt(query[i-1])][toInt(reference[j-1])];			
+				nogap = lastRow[j-1] + correctRow[refBases[j-1]];			
 				
 				double gap;
 				
 				double left;
 				if(i == queryLength){ //terminal gap
-					left = alignMatrix[i][j-1];
+					left = row[j-1];
 				}
 				else{
-					if(reference[j-1] == getLastMatch('l', alignMoves, i, j, query, reference)){
+					if(reference[j-1] == getLastMatch('l', alignMoves, cols, i, j, query, reference)){
 						gap = 4.0;
 					}
 					else{
 						gap = 15.0;
 					}
 					
-					left = alignMatrix[i][j-1] + gap;
+					left = row[j-1] + gap;
 				}
 				
 				double up;
 				if(j == refLength){ //terminal gap
-					up = alignMatrix[i-1][j];
+					up = lastRow[j];
 				}
 				else{
 					
-					if(query[i-1] == getLastMatch('u', alignMoves, i, j, query, reference)){
+					if(query[i-1] == getLastMatch('u', alignMoves, cols, i, j, query, reference)){
 						gap = 4.0;
 					}
 					else{
 						gap = 15.0;
 					}
 					
-					up = alignMatrix[i-1][j] + gap;
+					up = lastRow[j] + gap;
 				}
 				
 				
 				if(nogap < left){
 					if(nogap < up){
-						alignMoves[i][j] = 'd';
-						alignMatrix[i][j] = nogap;
+						moves[j] = 'd';
+						row[j] = nogap;
 					}
 					else{
-						alignMoves[i][j] = 'u';
-						alignMatrix[i][j] = up;
+						moves[j] = 'u';
+						row[j] = up;
 					}
 				}
 				else{
 					if(left < up){
-						alignMoves[i][j] = 'l';
-						alignMatrix[i][j] = left;
+						moves[j] = 'l';
+						row[j] = left;
 					}
 					else{
-						alignMoves[i][j] = 'u';
-						alignMatrix[i][j] = up;
+						moves[j] = 'u';
+						row[j] = up;
 					}
 				}
 			}
@@ -391,39 +397,44 @@ double Perseus::modeledPairwiseAlignSeqs(string query, string reference, string&
 		int j = refLength;
 		
 		int alignLength = 0;
+		string qReverse, rReverse; //built backwards, and put in front of qAlign and rAlign at the end
 		
 		while(i > 0 && j > 0){
 			
-			if (m->getControl_pressed()) { return 0; }
-			
-			if(alignMoves[i][j] == 'd'){
-				qAlign = query[i-1] + qAlign;
-				rAlign = reference[j-1] + rAlign;
+			char move = alignMoves[i * cols + j];
+			if(move == 'd'){
+				qReverse += query[i-1];
+				rReverse += reference[j-1];
 				alignLength++;
 				i--;
 				j--;
 			}
-			else if(alignMoves[i][j] == 'u'){
+			else if(move == 'u'){
 				if(j != refLength){
-					qAlign = query[i-1] + qAlign;
-					rAlign = '-' + rAlign;
+					qReverse += query[i-1];
+					rReverse += '-';
 					alignLength++;
 				}
 				
 				i--;
 			}
-			else if(alignMoves[i][j] == 'l'){
+			else if(move == 'l'){
 				if(i != queryLength){
-					qAlign = '-' + qAlign;
-					rAlign = reference[j-1] + rAlign;
+					qReverse += '-';
+					rReverse += reference[j-1];
 					alignLength++;				
 				}
 				
 				j--;
 			}
 		}
+		
+		reverse(qReverse.begin(), qReverse.end());
+		reverse(rReverse.begin(), rReverse.end());
+		qAlign = qReverse + qAlign;
+		rAlign = rReverse + rAlign;
 
-		return alignMatrix[queryLength][refLength] / (double)alignLength;
+		return alignMatrix[queryLength * cols + refLength] / (double)alignLength;
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Perseus", "modeledPairwiseAlignSeqs");
@@ -432,12 +443,13 @@ double Perseus::modeledPairwiseAlignSeqs(string query, string reference, string&
 }
 
 /**************************************************************************************************/
-int Perseus::getAlignments(int curSequenceIndex, vector<seqData> sequences, vector<pwAlign>& alignments, vector<vector<int> >& leftDiffs, vector<vector<int> >& leftMaps, vector<vector<int> >& rightDiffs, vector<vector<int> >& rightMaps, int& bestRefSeq, int& bestRefDiff, vector<bool>& restricted){
+//aligns the query to the more abundant sequences that aren't chimeras, restricted is set for the sequences it skips
+int Perseus::getAlignments(int curSequenceIndex, const vector<seqData>& sequences, const vector<bool>& chimeras, vector<pwAlign>& alignments, vector<vector<int> >& leftDiffs, vector<vector<int> >& leftMaps, vector<vector<int> >& rightDiffs, vector<vector<int> >& rightMaps, int& bestRefSeq, int& bestRefDiff, vector<bool>& restricted){
 	try {
 		int numSeqs = sequences.size();
 		//int bestSequenceMismatch = PERSEUSMAXINT;
 
-		string curSequence = sequences[curSequenceIndex].sequence;
+		const string& curSequence = sequences[curSequenceIndex].sequence;
 		int curFrequency = sequences[curSequenceIndex].frequency; 
 
 		bestRefSeq = -1;
@@ -452,8 +464,8 @@ int Perseus::getAlignments(int curSequenceIndex, vector<seqData> sequences, vect
 			
 			if (m->getControl_pressed()) { return 0; }
 			
-			if(i != curSequenceIndex && restricted[i] != 1 && sequences[i].frequency >= 2 * curFrequency){
-				string refSequence = sequences[i].sequence;
+			if(i != curSequenceIndex && !chimeras[i] && sequences[i].frequency >= 2 * curFrequency){
+				const string& refSequence = sequences[i].sequence;
 				
 				leftDiffs[i].assign(curSequence.length(), 0);
 				leftMaps[i].assign(curSequence.length(), 0);
@@ -490,7 +502,7 @@ int Perseus::getAlignments(int curSequenceIndex, vector<seqData> sequences, vect
 	}
 }
 /**************************************************************************************************/
-int Perseus::getChimera(vector<seqData> sequences,
+int Perseus::getChimera(const vector<seqData>& sequences,
 			   vector<vector<int> >& leftDiffs, 
 			   vector<vector<int> >& rightDiffs,
 			   int& leftParent, 
@@ -500,7 +512,7 @@ int Perseus::getChimera(vector<seqData> sequences,
 			   vector<int>& bestLeft, 
 			   vector<int>& singleRight, 
 			   vector<int>& bestRight, 
-			   vector<bool> restricted){
+			   const vector<bool>& restricted){
 	try {
 		int numRefSeqs = restricted.size();
 		int seqLength = leftDiffs[0].size();
@@ -607,7 +619,7 @@ string Perseus::stitchBimera(vector<pwAlign>& alignments, int leftParent, int ri
 	}
 }
 /**************************************************************************************************/
-int Perseus::getTrimera(vector<seqData>& sequences,
+int Perseus::getTrimera(const vector<seqData>& sequences,
 			   vector<vector<int> >& leftDiffs,
 			   int& leftParent,
 			   int& middleParent,
@@ -618,7 +630,7 @@ int Perseus::getTrimera(vector<seqData>& sequences,
 			   vector<int>& bestLeft, 
 			   vector<int>& singleRight,
 			   vector<int>& bestRight,
-			   vector<bool> restricted){
+			   const vector<bool>& restricted){
 	try {
 		int numRefSeqs = leftDiffs.size();
 		int alignLength = leftDiffs[0].size();
@@ -680,7 +692,7 @@ int Perseus::getTrimera(vector<seqData>& sequences,
 
 /**************************************************************************************************/
 
-string Perseus::stitchTrimera(vector<pwAlign> alignments, int leftParent, int middleParent, int rightParent, int breakPointA, int breakPointB, vector<vector<int> >& leftMaps, vector<vector<int> >& rightMaps){
+string Perseus::stitchTrimera(vector<pwAlign>& alignments, int leftParent, int middleParent, int rightParent, int breakPointA, int breakPointB, vector<vector<int> >& leftMaps, vector<vector<int> >& rightMaps){
 	try {
 		int p1SplitPoint = leftMaps[leftParent][breakPointA];
 		int p2SplitPoint = leftMaps[middleParent][breakPointB];
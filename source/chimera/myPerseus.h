@@ -52,6 +52,20 @@ struct pwAlign {
 	
 };
 /**************************************************************************************************/
+//a query's alignments and diffs to each sequence, kept between queries so each thread only allocates them once
+struct perseusBuffers {
+	void resize(int numSeqs) {
+		alignments.resize(numSeqs);
+		leftDiffs.resize(numSeqs); leftMaps.resize(numSeqs);
+		rightDiffs.resize(numSeqs); rightMaps.resize(numSeqs);
+		restricted.resize(numSeqs);
+	}
+	
+	vector<pwAlign> alignments;
+	vector<vector<int> > leftDiffs, leftMaps, rightDiffs, rightMaps;
+	vector<bool> restricted;	//sequences the query wasn't compared to
+};
+/**************************************************************************************************/
 class Perseus {
 	
 public:
@@ -60,20 +74,24 @@ public:
 	
 	vector<vector<double> > binomial(int);
 	double modeledPairwiseAlignSeqs(string, string, string&, string&, vector<vector<double> >&);
-	int getAlignments(int, vector<seqData>, vector<pwAlign>&, vector<vector<int> >& , vector<vector<int> >&, vector<vector<int> >&, vector<vector<int> >&, int&, int&, vector<bool>&);
-	int getChimera(vector<seqData>,vector<vector<int> >&, vector<vector<int> >&,int&, int&, int&,vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<bool>);
+	int getAlignments(int, const vector<seqData>&, const vector<bool>&, vector<pwAlign>&, vector<vector<int> >& , vector<vector<int> >&, vector<vector<int> >&, vector<vector<int> >&, int&, int&, vector<bool>&);
+	int getChimera(const vector<seqData>&,vector<vector<int> >&, vector<vector<int> >&,int&, int&, int&,vector<int>&, vector<int>&, vector<int>&, vector<int>&, const vector<bool>&);
 	string stitchBimera(vector<pwAlign>&, int, int, int, vector<vector<int> >&, vector<vector<int> >&);
-	int getTrimera(vector<seqData>&, vector<vector<int> >&, int&, int&, int&, int&, int&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<bool>);
-	string stitchTrimera(vector<pwAlign>, int, int, int, int, int, vector<vector<int> >&, vector<vector<int> >&);
+	int getTrimera(const vector<seqData>&, vector<vector<int> >&, int&, int&, int&, int&, int&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, const vector<bool>&);
+	string stitchTrimera(vector<pwAlign>&, int, int, int, int, int, vector<vector<int> >&, vector<vector<int> >&);
 	double calcLoonIndex(string, string, string, int, vector<vector<double> >&);
 	double classifyChimera(double, double, double, double, double);
 	
 private:
 	MothurOut* m;
+	vector<double> scoreBuffer;		//alignment matrices, kept between alignments so each Perseus only allocates them once
+	vector<char> moveBuffer;
+	
+	double* getMatrix(int, int);
 	int toInt(char);
-	double basicPairwiseAlignSeqs(string, string, string&, string&, pwModel);
-	int getDiffs(string, string, vector<int>&, vector<int>&, vector<int>&, vector<int>&);
-	int getLastMatch(char, vector<vector<char> >&, int, int, string&, string&);
+	double basicPairwiseAlignSeqs(const string&, const string&, string&, string&, pwModel);
+	int getDiffs(const string&, const string&, vector<int>&, vector<int>&, vector<int>&, vector<int>&);
+	int getLastMatch(char, const char*, int, int, int, string&, string&);
 	int threeWayAlign(string, string, string, string&, string&, string&);
 	double calcBestDistance(string, string);
 
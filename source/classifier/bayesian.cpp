@@ -11,9 +11,12 @@
 #include "kmer.hpp"
 #include "phylosummary.h"
 
+#define WANGDB_FORMAT_VERSION 1
+static const char wangDBMagic[8] = { 'M', 'W', 'A', 'N', 'G', 'D', 'B', '\0' };
+
 /**************************************************************************************************/
 Bayesian::Bayesian(string txfile, string tempFile, string method, int ksize, int cutoff, int i, int tid, bool f, bool sh, string version) :
-Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
+Classify(), genusProbs(nullptr), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 	try {
 		
 		threadID = tid;
@@ -31,9 +34,6 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
         string probFileName = tfileroot + tempfileroot + char('0'+ kmerSize) + "mer.prob";
         string probFileName2 = tfileroot + tempfileroot + char('0'+ kmerSize) + "mer.numNonZero";
         
-        ofstream out;
-        ofstream out2;
-        
         vector<ifstream*> files;
         ifstream* phyloTreeTest = new ifstream(phyloTreeName.c_str()); files.push_back(phyloTreeTest);
 		ifstream* probFileTest2 = new ifstream(probFileName2.c_str()); files.push_back(probFileTest2);
@@ -42,11 +42,19 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 		
 		long start = time(nullptr);
 		
+		//a binary probability file made by this release has everything needed to classify
+		bool BinaryGood = false;
+		vector<ifstream*> binaryFiles; binaryFiles.push_back(probFileTest);
+		if (checkReleaseDate(binaryFiles, version)) { BinaryGood = readBinaryProbFile(probFileName); }
+		
 		//if they are there make sure they were created after this release date
 		bool FilesGood = false;
-		if(probFileTest && probFileTest2 && phyloTreeTest && probFileTest3){ FilesGood = checkReleaseDate(files, version); }
+		if(!BinaryGood && probFileTest && probFileTest2 && phyloTreeTest && probFileTest3){ FilesGood = checkReleaseDate(files, version); }
 
-		if(probFileTest && probFileTest2 && phyloTreeTest && probFileTest3 && FilesGood){
+		if (BinaryGood) {
+			m->mothurOut("Reading template probabilities...     "); cout.flush();
+			
+		}else if(probFileTest && probFileTest2 && phyloTreeTest && probFileTest3 && FilesGood){
 			
 			m->mothurOut("Reading template taxonomy...     "); cout.flush();
 			
@@ -57,10 +65,17 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 			
 			genusNodes = phyloTree->getGenusNodes(); 
 			genusTotals = phyloTree->getGenusTotals();
+			numGenus = genusNodes.size();
 			
             m->mothurOut("Reading template probabilities...     "); cout.flush();
             readProbFile(*probFileTest, *probFileTest2, probFileName, probFileName2);
 			
+			generateWordPairDiffArr();
+			flattenTree();
+			
+			//replace the text files with the binary file, so the next run can map it
+			if (shortcuts && !m->getControl_pressed()) { writeBinaryProbFile(probFileName, version); util.mothurRemove(probFileName2); }
+			
         }else{
 		
 			//create search database and names vector
@@ -71,6 +86,7 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 			else{ 
 				genusNodes = phyloTree->getGenusNodes(); 
 				genusTotals = phyloTree->getGenusTotals();
+				numGenus = genusNodes.size();
 				
 				m->mothurOut("Calculating template taxonomy tree...     "); cout.flush();
 				
@@ -83,34 +99,15 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 				numKmers = database->getMaxKmer() + 1;
 			
 				//initialze probabilities
-				wordGenusProb.resize(numKmers);
+				wordGenusProb.resize(((size_t)numKmers)*numGenus, 0.0);
                 for (int j = 0; j < numKmers; j++) {  diffPair tempDiffPair; WordPairDiffArr.push_back(tempDiffPair); }
 			
-                for (int j = 0; j < wordGenusProb.size(); j++) {	wordGenusProb[j].resize(genusNodes.size(), 0.0);		}
-                ofstream out; ofstream out2;
-
-                if (shortcuts) { 
-                    util.openOutputFile(probFileName, out); 
-				
-                    //output mothur version
-                    out << "#" << version << endl;
-				
-                    out << numKmers << endl;
-				
-                    util.openOutputFile(probFileName2, out2);
-				
-                    //output mothur version
-                    out2 << "#" << version << endl;
-                }
-
 				//for each word
 				for (int i = 0; i < numKmers; i++) {
                     //m->mothurOut("[DEBUG]: kmer = " + toString(i) + "\n");
                     
 					if (m->getControl_pressed()) {  break; }
 
-                    if (shortcuts) {  out << i << '\t'; }
-					
 					vector<int> seqsWithWordi = database->getSequencesWithKmer(i);
 					
 					//for each sequence with that word
@@ -125,27 +122,17 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 					diffPair tempProb(log(probabilityInTemplate), 0.0);
 					WordPairDiffArr[i] = tempProb;
 						
-					int numNotZero = 0;
+					float* wordProb = &wordGenusProb[((size_t)i)*numGenus];
 					for (int k = 0; k < genusNodes.size(); k++) {
 						//probabilityInThisTaxonomy = (# of seqs with that word in this taxonomy + probabilityInTemplate) / (total number of seqs in this taxonomy + 1);
 						
 						
-						wordGenusProb[i][k] = log((count[k] + probabilityInTemplate) / (float) (genusTotals[k] + 1));  
+						wordProb[k] = log((count[k] + probabilityInTemplate) / (float) (genusTotals[k] + 1));  
 									
-						if (count[k] != 0) {
-                            if (shortcuts) { out << k << '\t' << wordGenusProb[i][k] << '\t' ; }
-							numNotZero++;
-						}
 					}
 					
                     
-                    if (shortcuts) {
-                        out << endl;
-                        out2 << probabilityInTemplate << '\t' << numNotZero << '\t' << log(probabilityInTemplate) << endl;
-                    }
-                    
 				}
-                if (shortcuts) { out.close(); out2.close();  }
 				
 				//read in new phylotree with less info. - its faster
 				ifstream phyloTreeTest(phyloTreeName.c_str());
@@ -153,12 +140,20 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 				
 				phyloTree = new PhyloTree(phyloTreeTest, phyloTreeName);
                 maxLevel = phyloTree->getMaxLevel();
+				
+                if (m->getDebug()) { m->mothurOut("[DEBUG]: about to generateWordPairDiffArr\n"); }
+				generateWordPairDiffArr();
+                if (m->getDebug()) { m->mothurOut("[DEBUG]: done generateWordPairDiffArr\n"); }
+				
+				flattenTree();
+				
+				if (shortcuts && !m->getControl_pressed()) { writeBinaryProbFile(probFileName, version); util.mothurRemove(probFileName2); }
 			}
 		}
 		
-        if (m->getDebug()) { m->mothurOut("[DEBUG]: about to generateWordPairDiffArr\n"); }
-		generateWordPairDiffArr();
-        if (m->getDebug()) { m->mothurOut("[DEBUG]: done generateWordPairDiffArr\n"); }
+        if (!mappedProbs.isOpen()) { genusProbs = wordGenusProb.data(); }
+        
+        if (!m->getControl_pressed()) { fillGenusAncestors(); }
         
         for (int i = 0; i < files.size(); i++) { delete files[i]; }
 			
@@ -220,7 +215,9 @@ string Bayesian::getTaxonomy(Sequence* seq, string& simpleTax, bool& flipped) {
 		if (queryKmers.size() == 0) {  m->mothurOut(seq->getName() + " is bad. It has no kmers of length " + toString(kmerSize) + ".\n");  simpleTax = "unknown;";  return "unknown;"; }
 		
 		
-		int index = getMostProbableTaxonomy(queryKmers);
+		vector<int> genus;
+		getMostProbableGenus(queryKmers, 1, queryKmers.size(), genus);
+		int index = genus[0];
 		
 		if (m->getControl_pressed()) { return tax; }
 					
@@ -241,83 +238,55 @@ string Bayesian::getTaxonomy(Sequence* seq, string& simpleTax, bool& flipped) {
 	}
 }
 /**************************************************************************************************/
-string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect, string& simpleTax) {
+string Bayesian::bootstrapResults(vector<int>& kmers, int tax, int numToSelect, string& simpleTax) {
 	try {
-				
-		map<int, int> confidenceScores; 
-		
-		//initialize confidences to 0 
-		int seqIndex = tax;
-		TaxNode seq = phyloTree->get(tax);
-		confidenceScores[tax] = 0;
 		
-		while (seq.level != 0) { //while you are not at the root
-			seqIndex = seq.parent;
-			confidenceScores[seqIndex] = 0;
-			seq = phyloTree->get(seq.parent);
-		}
-				
-		map<int, int>::iterator itBoot;
-		map<int, int>::iterator itBoot2;
-		map<int, int>::iterator itConvert;
+		//confidenceScores[i] = number of samples classified to genusAncestors[tax][i]
+		vector<int>& ancestors = genusAncestors[tax];
+		vector<int> confidenceScores(ancestors.size(), 0);
         
+        //draw the kmers of all the samples, then classify them together
         int numKmers = kmers.size()-1;
         Utils util;
+        vector<int> samples; samples.reserve(iters*numToSelect);
 		for (int i = 0; i < iters; i++) {
-			if (m->getControl_pressed()) { return "control"; }
-			
-            vector<int> temp;
 			for (int j = 0; j < numToSelect; j++) {
 				int index = util.getRandomIndex(numKmers);
                 
 				//add word to temp
-				temp.push_back(kmers[index]);
+				samples.push_back(kmers[index]);
 			}
-            
-			//get taxonomy
-			int newTax = getMostProbableTaxonomy(temp);
-			//int newTax = 1;
-			TaxNode taxonomyTemp = phyloTree->get(newTax);
+		}
+        
+		vector<int> newTax;
+		getMostProbableGenus(samples, iters, numToSelect, newTax);
+		
+		if (m->getControl_pressed()) { return "control"; }
+		
+		//add to confidence results, the taxonomies share ancestors down to the first level they differ
+		for (int i = 0; i < iters; i++) {
+			vector<int>& sampleAncestors = genusAncestors[newTax[i]];
 			
-			//add to confidence results
-			while (taxonomyTemp.level != 0) { //while you are not at the root
-				itBoot2 = confidenceScores.find(newTax); //is this a classification we already have a count on
-				
-				if (itBoot2 != confidenceScores.end()) { //this is a classification we need a confidence for
-					(itBoot2->second)++;
-				}
-				
-				newTax = taxonomyTemp.parent;
-				taxonomyTemp = phyloTree->get(newTax);
+			for (int j = 0; (j < ancestors.size()) && (j < sampleAncestors.size()); j++) {
+				if (sampleAncestors[j] != ancestors[j]) { break; }
+				confidenceScores[j]++;
 			}
-	
 		}
 		
 		string confidenceTax = "";
 		simpleTax = "";
 		
-		int seqTaxIndex = tax;
-		TaxNode seqTax = phyloTree->get(tax);
-		
-        
-		while (seqTax.level != 0) { //while you are not at the root
-					
-				itBoot2 = confidenceScores.find(seqTaxIndex); //is this a classification we already have a count on
+		for (int j = ancestors.size()-1; j >= 0; j--) { //from the genus up to the root
 				
-				int confidence = 0;
-				if (itBoot2 != confidenceScores.end()) { //already in confidence scores
-					confidence = itBoot2->second;
-				}
+				int confidence = confidenceScores[j];
+				string name = nodeNames[ancestors[j]];
 				
-                if (m->getDebug()) { m->mothurOut(seqTax.name + "(" + toString(((confidence/(float)iters) * 100)) + ");"); }
+                if (m->getDebug()) { m->mothurOut(name + "(" + toString(((confidence/(float)iters) * 100)) + ");"); }
             
 				if (((confidence/(float)iters) * 100) >= confidenceThreshold) {
-					confidenceTax = seqTax.name + "(" + toString(((confidence/(float)iters) * 100)) + ");" + confidenceTax;
-					simpleTax = seqTax.name + ";" + simpleTax;
+					confidenceTax = name + "(" + toString(((confidence/(float)iters) * 100)) + ");" + confidenceTax;
+					simpleTax = name + ";" + simpleTax;
 				}
-            
-				seqTaxIndex = seqTax.parent;
-				seqTax = phyloTree->get(seqTax.parent);
 		}
 		
 		if (confidenceTax == "") { confidenceTax = "unknown;"; simpleTax = "unknown;";  }
@@ -331,30 +300,213 @@ string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect, s
 	}
 }
 /**************************************************************************************************/
-int Bayesian::getMostProbableTaxonomy(vector<int> queryKmer) {
+//scores the genera in blocks, each block for every sample, so the block of each kmer's row stays in cache while the
+//samples are scored. The inner loops run along the genus axis of the rows, so the compiler can vectorize them. Each
+//genus' probability is summed in the order of the sample's kmers, as if the samples were scored one at a time.
+void Bayesian::getMostProbableGenus(vector<int>& kmers, int numSamples, int numPerSample, vector<int>& genus) {
 	try {
-		int indexofGenus = 0;
+		const int blockSize = 512;
 		
-		double maxProbability = -1000000.0;
-		//find taxonomy with highest probability that this sequence is from it
-
-        for (int k = 0; k < genusNodes.size(); k++) {
-			//for each taxonomy calc its probability
+		genus.assign(numSamples, 0);
+		vector<double> maxProbability(numSamples, -1000000.0);
+		vector<double> blockProb(blockSize, 0.0);
+		
+		const float* probs = genusProbs;
+		const int* sampleKmers = kmers.data();
+		double* prob = blockProb.data();
+		
+		for (int start = 0; start < numGenus; start += blockSize) {
+			int end = min(start+blockSize, numGenus);
+			int thisBlockSize = end - start;
 			
-			double prob = 0.0000;
-			for (int i = 0; i < queryKmer.size(); i++) { prob += wordGenusProb[queryKmer[i]][k]; }
-
-			//is this the taxonomy with the greatest probability?
-			if (prob > maxProbability) { 
-				indexofGenus = genusNodes[k];
-				maxProbability = prob;
+			for (int s = 0; s < numSamples; s++) {
+				if (m->getControl_pressed()) { return; }
+				
+				for (int k = 0; k < thisBlockSize; k++) { prob[k] = 0.0000; }
+				
+				//for each taxonomy calc its probability
+				for (int i = s*numPerSample; i < (s+1)*numPerSample; i++) {
+					const float* wordProb = probs + (((size_t)sampleKmers[i])*numGenus) + start;
+					for (int k = 0; k < thisBlockSize; k++) { prob[k] += wordProb[k]; }
+				}
+				
+				//is this the taxonomy with the greatest probability?
+				for (int k = 0; k < thisBlockSize; k++) {
+					if (prob[k] > maxProbability[s]) {
+						genus[s] = start+k;
+						maxProbability[s] = prob[k];
+					}
+				}
 			}
 		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "getMostProbableGenus");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//the taxonomy of each genus, so bootstrapResults can compare taxonomies without walking the tree
+void Bayesian::fillGenusAncestors() {
+	try {
+		genusAncestors.clear(); genusAncestors.resize(numGenus);
+		
+		for (int k = 0; k < numGenus; k++) {
+			vector<int> ancestors;
+			for (int index = genusNodes[k]; nodeLevels[index] != 0; index = nodeParents[index]) { //while you are not at the root
+				ancestors.push_back(index);
+			}
+			reverse(ancestors.begin(), ancestors.end());
 			
-		return indexofGenus;
+			genusAncestors[k] = ancestors;
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "fillGenusAncestors");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//copies the parts of the taxonomy tree classifying needs, so they can be saved in the binary shortcut file
+void Bayesian::flattenTree() {
+	try {
+		int numNodes = phyloTree->getNumNodes();
+		nodeParents.resize(numNodes); nodeLevels.resize(numNodes); nodeNames.resize(numNodes);
+		
+		for (int i = 0; i < numNodes; i++) {
+			TaxNode node = phyloTree->get(i);
+			nodeParents[i] = node.parent;
+			nodeLevels[i] = node.level;
+			nodeNames[i] = node.name;
+		}
 	}
 	catch(exception& e) {
-		m->errorOut(e, "Bayesian", "getMostProbableTaxonomy");
+		m->errorOut(e, "Bayesian", "flattenTree");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void Bayesian::writeBinaryProbFile(string probFileName, string version) {
+	try {
+		ofstream out;
+		string tempName = MappedFile::openOutput(probFileName, version, wangDBMagic, out);
+		
+		vector<unsigned long long> nameOffsets(1, 0);
+		for (int i = 0; i < nodeNames.size(); i++) { nameOffsets.push_back(nameOffsets.back() + nodeNames[i].length()); }
+		
+		unsigned int formatVersion = WANGDB_FORMAT_VERSION;
+		unsigned int kSize = kmerSize;
+		unsigned long long numKmersOut = numKmers;
+		unsigned long long numGenusOut = numGenus;
+		unsigned long long numNodes = nodeNames.size();
+		unsigned long long namesLength = nameOffsets.back();
+		unsigned int maxLevelOut = maxLevel;
+		unsigned int pad = 0;
+		
+		out.write((char*)&formatVersion, sizeof(unsigned int));
+		out.write((char*)&kSize, sizeof(unsigned int));
+		out.write((char*)&numKmersOut, sizeof(unsigned long long));
+		out.write((char*)&numGenusOut, sizeof(unsigned long long));
+		out.write((char*)&numNodes, sizeof(unsigned long long));
+		out.write((char*)&namesLength, sizeof(unsigned long long));
+		out.write((char*)&maxLevelOut, sizeof(unsigned int));
+		out.write((char*)&pad, sizeof(unsigned int));
+		out.write((char*)nameOffsets.data(), nameOffsets.size() * sizeof(unsigned long long));
+		out.write((char*)wordGenusProb.data(), numKmersOut * numGenusOut * sizeof(float));
+		
+		for (int i = 0; i < numKmers; i++) {
+			out.write((char*)&WordPairDiffArr[i].prob, sizeof(float));
+			out.write((char*)&WordPairDiffArr[i].reverseProb, sizeof(float));
+		}
+		
+		out.write((char*)genusNodes.data(), numGenusOut * sizeof(int));
+		out.write((char*)nodeParents.data(), numNodes * sizeof(int));
+		out.write((char*)nodeLevels.data(), numNodes * sizeof(int));
+		for (int i = 0; i < nodeNames.size(); i++) { out.write(nodeNames[i].c_str(), nodeNames[i].length()); }
+		
+		MappedFile::closeOutput(tempName, probFileName, out);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "writeBinaryProbFile");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//maps the shortcut file, returns false if it is not a binary shortcut file
+bool Bayesian::readBinaryProbFile(string probFileName) {
+	try {
+		if (!mappedProbs.open(probFileName)) { return false; }
+		
+		unsigned long long headerSize = 4*sizeof(unsigned int) + 4*sizeof(unsigned long long);
+		const char* header = mappedProbs.findHeader(wangDBMagic, headerSize);
+		if (header == nullptr) { mappedProbs.close(); return false; }
+		
+		unsigned int formatVersion, kSize, maxLevelIn;
+		unsigned long long numKmersIn, numGenusIn, numNodes, namesLength;
+		memcpy(&formatVersion, header, sizeof(unsigned int));		header += sizeof(unsigned int);
+		memcpy(&kSize, header, sizeof(unsigned int));				header += sizeof(unsigned int);
+		memcpy(&numKmersIn, header, sizeof(unsigned long long));	header += sizeof(unsigned long long);
+		memcpy(&numGenusIn, header, sizeof(unsigned long long));	header += sizeof(unsigned long long);
+		memcpy(&numNodes, header, sizeof(unsigned long long));		header += sizeof(unsigned long long);
+		memcpy(&namesLength, header, sizeof(unsigned long long));	header += sizeof(unsigned long long);
+		memcpy(&maxLevelIn, header, sizeof(unsigned int));			header += 2*sizeof(unsigned int);
+		
+		unsigned long long maxKmer = 1;
+		for (int i = 0; i < kmerSize; i++) { maxKmer *= 4; }
+		
+		unsigned long long remaining = mappedProbs.getData() + mappedProbs.getSize() - header;
+		unsigned long long expectedSize = (numNodes+1) * sizeof(unsigned long long) + (numKmersIn*numGenusIn + numKmersIn*2) * sizeof(float) + (numGenusIn + 2*numNodes) * sizeof(int) + namesLength;
+		
+		if ((formatVersion != WANGDB_FORMAT_VERSION) || (kSize != kmerSize) || (numKmersIn != (maxKmer+1)) || (numGenusIn > numNodes) || (numNodes > remaining) || (namesLength > remaining) || (remaining < expectedSize)) {
+			m->mothurOut("[ERROR]: " + probFileName + " is damaged or was made by a different version of mothur, please remove it and run the command again.\n"); m->setControl_pressed(true);
+			mappedProbs.close();
+			return true;
+		}
+		
+		const unsigned long long* nameOffsets = (const unsigned long long*)header;		header += (numNodes+1) * sizeof(unsigned long long);
+		genusProbs = (const float*)header;												header += numKmersIn * numGenusIn * sizeof(float);
+		const float* wordPairDiffs = (const float*)header;								header += numKmersIn * 2 * sizeof(float);
+		const int* genusNodesIn = (const int*)header;									header += numGenusIn * sizeof(int);
+		const int* nodeParentsIn = (const int*)header;									header += numNodes * sizeof(int);
+		const int* nodeLevelsIn = (const int*)header;									header += numNodes * sizeof(int);
+		const char* names = header;
+		
+		//the names and tree must be usable before fillGenusAncestors walks them
+		bool damaged = (nameOffsets[0] != 0) || (nameOffsets[numNodes] != namesLength);
+		for (unsigned long long i = 0; (i < numNodes) && !damaged; i++) {
+			if ((nameOffsets[i] > nameOffsets[i+1]) || (nodeLevelsIn[i] < 0)) { damaged = true; }
+			else if (nodeLevelsIn[i] != 0) { //every node but the root needs a parent above it, so walking up always ends at the root
+				int parent = nodeParentsIn[i];
+				if ((parent < 0) || ((unsigned long long)parent >= numNodes) || (nodeLevelsIn[parent] >= nodeLevelsIn[i])) { damaged = true; }
+			}
+		}
+		for (unsigned long long i = 0; (i < numGenusIn) && !damaged; i++) {
+			if ((genusNodesIn[i] < 0) || ((unsigned long long)genusNodesIn[i] >= numNodes)) { damaged = true; }
+		}
+		
+		if (damaged) {
+			m->mothurOut("[ERROR]: " + probFileName + " is damaged, please remove it and run the command again.\n"); m->setControl_pressed(true);
+			genusProbs = nullptr; mappedProbs.close();
+			return true;
+		}
+		
+		numKmers = numKmersIn;
+		numGenus = numGenusIn;
+		maxLevel = maxLevelIn;
+		
+		WordPairDiffArr.resize(numKmers);
+		for (int i = 0; i < numKmers; i++) { WordPairDiffArr[i] = diffPair(wordPairDiffs[2*i], wordPairDiffs[2*i+1]); }
+		
+		genusNodes.assign(genusNodesIn, genusNodesIn + numGenus);
+		nodeParents.assign(nodeParentsIn, nodeParentsIn + numNodes);
+		nodeLevels.assign(nodeLevelsIn, nodeLevelsIn + numNodes);
+		nodeNames.resize(numNodes);
+		for (int i = 0; i < numNodes; i++) { nodeNames[i] = string(names + nameOffsets[i], nameOffsets[i+1] - nameOffsets[i]); }
+		
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "readBinaryProbFile");
 		exit(1);
 	}
 }
@@ -408,8 +560,7 @@ void Bayesian::readProbFile(ifstream& in, ifstream& inNum, string inName, string
         in >> numKmers; gobble(in);
         //initialze probabilities
         
-        wordGenusProb.resize(numKmers);
-        for (int j = 0; j < wordGenusProb.size(); j++) {	wordGenusProb[j].resize(genusNodes.size());		}
+        wordGenusProb.resize(((size_t)numKmers)*numGenus);
         
         int kmer, name, count;  count = 0;
         vector<int> num; num.resize(numKmers);
@@ -436,15 +587,17 @@ void Bayesian::readProbFile(ifstream& in, ifstream& inNum, string inName, string
         while(in) {
             in >> kmer;
             
+            float* wordProb = &wordGenusProb[((size_t)kmer)*numGenus];
+            
             //set them all to zero value
             for (int i = 0; i < genusNodes.size(); i++) {
-                wordGenusProb[kmer][i] = log(zeroCountProb[kmer] / (float) (genusTotals[i]+1));
+                wordProb[i] = log(zeroCountProb[kmer] / (float) (genusTotals[i]+1));
             }
            
             //get probs for nonzero values
             for (int i = 0; i < num[kmer]; i++) {
                 in >> name >> prob;
-                wordGenusProb[kmer][name] = prob;
+                wordProb[name] = prob;
                 if (m->getDebug()) { m->mothurOut("[DEBUG]: " + toString(name) + '\t' + toString(prob) + '\t' + toString(kmer) + "\n"); }
             }
             
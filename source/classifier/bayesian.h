@@ -12,9 +12,35 @@
 
 #include "mothur.h"
 #include "classify.h"
+#include "mappedfile.hpp"
 
 /**************************************************************************************************/
 
+/* The probability shortcut file (*mer.prob) holds everything needed to classify, so it can be memory mapped instead
+ of parsed and many mothur processes using the same reference share one copy of the probabilities:
+ 
+	#version\n						so the release version checks still work
+	zero padding					to the next 8 byte boundary
+	char[8]	magic					"MWANGDB" followed by a null
+	uint32	format version
+	uint32	kmer size
+	uint64	number of kmers (4^kmerSize + 1)
+	uint64	number of genera
+	uint64	number of nodes in the taxonomy tree
+	uint64	length of the node names
+	uint32	max level
+	uint32	zero padding
+	uint64	nameOffsets[numNodes+1]	node i's name is names[nameOffsets[i]] to names[nameOffsets[i+1]]
+	float	wordGenusProb[numKmers*numGenus]
+	float	wordPairDiffs[numKmers*2]	prob and reverseProb of each kmer
+	int32	genusNodes[numGenus]
+	int32	nodeParents[numNodes]
+	int32	nodeLevels[numNodes]
+	char	names[namesLength]
+ 
+ Numbers are written in the byte order of the machine that made the file.  A file from a machine with a different
+ byte order fails the format version check.  Text shortcut files from older versions of mothur can still be read. */
+
 class Bayesian : public Classify {
 	
 public:
@@ -24,19 +50,28 @@ public:
 	string getTaxonomy(Sequence*, string&, bool&);
 	
 private:
-	vector< vector<float> > wordGenusProb;	//vector of maps from genus to probability
-										//wordGenusProb[0][392] = probability that a sequence within genus that's index in the tree is 392 would contain kmer 0;
+	vector<float> wordGenusProb;	//one row of genus probabilities for each kmer, in one block so a row is contiguous
+									//wordGenusProb[(0*numGenus)+392] = probability that a sequence within the genus at genusNodes[392] would contain kmer 0;
+	const float* genusProbs;		//points into wordGenusProb or the mapped shortcut file
+	MappedFile mappedProbs;
 	
 	vector<int> genusTotals;
 	vector<int> genusNodes;  //indexes in phyloTree where genus' are located
+	vector< vector<int> > genusAncestors; //genusAncestors[genus] = indexes in phyloTree of the genus' taxonomy from level 1 down to the genus
+	vector<int> nodeParents, nodeLevels; //the taxonomy tree by index in phyloTree, so it can be saved in the shortcut file
+	vector<string> nodeNames;
 	
 	vector<diffPair> WordPairDiffArr; 
 	
-	int kmerSize, numKmers, confidenceThreshold, iters;
+	int kmerSize, numKmers, numGenus, confidenceThreshold, iters;
 	
-	string bootstrapResults(vector<int>, int, int, string&);
-	int getMostProbableTaxonomy(vector<int>);
+	string bootstrapResults(vector<int>&, int, int, string&);
+	void getMostProbableGenus(vector<int>&, int, int, vector<int>&); //kmers of each sample in turn, number of samples, number of kmers in each sample, most probable genus of each sample
+	void flattenTree();
+	void fillGenusAncestors();
 	void readProbFile(ifstream&, ifstream&, string, string);
+	bool readBinaryProbFile(string); //returns false if the file is not a binary shortcut file
+	void writeBinaryProbFile(string, string);
 	bool isReversed(vector<int>&);
 	vector<int> createWordIndexArr(Sequence*);
 	int generateWordPairDiffArr();
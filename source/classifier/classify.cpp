@@ -81,12 +81,30 @@ void Classify::generateDatabaseAndNames(string tfile, string tempFile, string me
                 
                 ifstream fastaFile; util.openInputFile(tempFile, fastaFile);
                 
+                unsigned long long checksum = 0;
                 while (!fastaFile.eof()) {
                     Sequence temp(fastaFile); gobble(fastaFile);
                     
                     names.push_back(temp.getName());
+                    checksum = KmerDB::addToChecksum(checksum, temp.getUnaligned());
                 }
                 fastaFile.close();
+                
+                //make sure the shortcut file was made from this template
+                unsigned long long shortcutChecksum = ((KmerDB*)database)->getTemplateChecksum();
+                if ((shortcutChecksum != 0) && (shortcutChecksum != checksum)) {
+                    m->mothurOut(dBName + " was not made from " + tempFile + ", rebuilding it.\n");
+                    delete database; database = new KmerDB(tempFile, kmerSize);
+                    
+                    util.openInputFile(tempFile, fastaFile);
+                    while (!fastaFile.eof()) {
+                        Sequence temp(fastaFile); gobble(fastaFile);
+                        database->addSequence(temp);
+                    }
+                    fastaFile.close();
+                    
+                    if (shortcuts) { database->generateDB(); }
+                }
             }
             database->setNumSeqs(names.size());
             
@@ -57,6 +57,8 @@ void Cluster::clusterNames(){
 	}
 }
 /***********************************************************************/
+inline bool isLargerIndex(const PDistCell& cell, ull index) { return (cell.index > index); }
+/***********************************************************************/
 bool Cluster::update(double& cutOFF){
 	try {
         smallCol = dMatrix->getSmallestCell(smallRow);
@@ -76,7 +78,9 @@ bool Cluster::update(double& cutOFF){
                 search = dMatrix->seqVec[smallRow][i].index;
                 
 				bool merged = false;
-				for (int j=0;j<nColCells;j++) {  //go through each distance the smallCol has looking for matching distance to find
+                //the column's indexes are sorted from largest to smallest, so start at the first index that isn't larger than search
+                int firstJ = lower_bound(dMatrix->seqVec[smallCol].begin(), dMatrix->seqVec[smallCol].end(), search, isLargerIndex) - dMatrix->seqVec[smallCol].begin();
+				for (int j=firstJ;j<nColCells;j++) {  //go through each distance the smallCol has looking for matching distance to find
                     
 					if (dMatrix->seqVec[smallCol][j].index != smallRow) {  //if you are not the smallest distance
 						if (dMatrix->seqVec[smallCol][j].index == search) {  //we found a distance for the merge
@@ -15,6 +15,7 @@
  */
 
 #include "aligncommand.h"
+#include "sequencepipeline.hpp"
 
 //**********************************************************************************************************************
 vector<string> AlignCommand::setParameters(){	
@@ -24,7 +25,7 @@ vector<string> AlignCommand::setParameters(){
 		CommandParameter psearch("search", "Multiple", "kmer-suffix", "kmer", "", "", "","",false,false,true); parameters.push_back(psearch);
 		CommandParameter pksize("ksize", "Number", "", "8", "", "", "","",false,false); parameters.push_back(pksize);
 		CommandParameter pmatch("match", "Number", "", "1.0", "", "", "","",false,false); parameters.push_back(pmatch);
-		CommandParameter palign("align", "Multiple", "needleman-gotoh-noalign", "needleman", "", "", "","",false,false,true); parameters.push_back(palign);
+		CommandParameter palign("align", "Multiple", "needleman-gotoh-noalign-striped", "needleman", "", "", "","",false,false,true); parameters.push_back(palign);
 		CommandParameter pmismatch("mismatch", "Number", "", "-1.0", "", "", "","",false,false); parameters.push_back(pmismatch);
 		CommandParameter pgapopen("gapopen", "Number", "", "-5.0", "", "", "","",false,false); parameters.push_back(pgapopen);
 		CommandParameter pgapextend("gapextend", "Number", "", "-2.0", "", "", "","",false,false); parameters.push_back(pgapextend);
@@ -59,7 +60,7 @@ string AlignCommand::getHelpString(){
 		helpString += "The align.seqs command parameters are " + getCommandParameters() + ".\n";
 		helpString += "The reference and fasta parameters are required. You may leave fasta blank if you have a valid fasta file.\n";
 		helpString += "The search parameter allows you to specify the method to find most similar reference sequence.  Your options are: suffix or kmer. The default is kmer.\n";
-		helpString += "The align parameter allows you to specify the alignment method to use.  Your options are: gotoh, needleman and noalign. The default is needleman.\n";
+		helpString += "The align parameter allows you to specify the alignment method to use.  Your options are: gotoh, needleman, striped and noalign. The default is needleman. The striped option gives the same alignments as needleman using a faster SIMD implementation.\n";
 		helpString += "The ksize parameter allows you to specify the kmer size for finding most similar reference to a given sequence.  The default is 8.\n";
 		helpString += "The match parameter allows you to specify the bonus for having the same base. Default=1.0.\n";
 		helpString += "The mistmatch parameter allows you to specify the penalty for having different bases. Default=-1.0.\n";
@@ -182,7 +183,7 @@ AlignCommand::AlignCommand(string option) : Command()  {
 			if ((search != "suffix") && (search != "kmer")) { m->mothurOut("invalid search option: choices are kmer or suffix.\n");  abort=true; }
 			
 			align = validParameter.valid(parameters, "align");		if (align == "not found"){	align = "needleman";	}
-			if ((align != "needleman") && (align != "gotoh") && (align != "noalign")) { m->mothurOut("invalid align option: choices are needleman, gotoh or noalign.\n");  abort=true; }
+			if ((align != "needleman") && (align != "gotoh") && (align != "noalign") && (align != "striped")) { m->mothurOut("invalid align option: choices are needleman, gotoh, striped or noalign.\n");  abort=true; }
 		}
 		
 	}
@@ -261,268 +262,160 @@ int AlignCommand::execute(){
 	}
 }
 //**********************************************************************************************************************
-struct alignStruct {
-    OutputWriter* alignWriter;
-    OutputWriter* reportWriter;
-    OutputWriter* accnosWriter;
-    string inputFilename;
-    string alignMethod, search, templateFileName;
-    float match, misMatch, gapOpen, gapExtend, threshold;
-    bool flip;
-    long long numSeqs;
-    int kmerSize;
-    
-    vector<long long> flippedResults;
-    linePair filePos;
-    
-    MothurOut* m;
-    Utils util;
-    AlignmentDB* templateDB;
-    Alignment* alignment;
-    
-    alignStruct (linePair fP, OutputWriter* aFName, OutputWriter* reFName, OutputWriter* ac, string fname, AlignmentDB* tfn, string al, float ma, float misMa, float gOpen, float gExtend, float thr, bool fl, int ks, string se) {
-        
-        filePos.start = fP.start;
-        filePos.end = fP.end;
-        alignWriter = aFName;
-        reportWriter = reFName;
-        accnosWriter = ac;
-        inputFilename = fname;
-        numSeqs = 0;
-        m = MothurOut::getInstance();
-        match = ma;
-        misMatch = misMa;
-        gapOpen = gOpen;
-        gapExtend = gExtend;
-        threshold = thr;
-        flip = fl;
-        search = se;
-        kmerSize = ks;
+class AlignWorker : public PipelineWorker {
+public:
+    AlignWorker(AlignmentDB* tfn, string al, float ma, float misMa, float gOpen, float gExtend, float thr, bool fl, string se) : templateDB(tfn), alignMethod(al), search(se), threshold(thr), flip(fl) {
         flippedResults.resize(2, 0);
-        alignMethod = al;
-        
-        templateDB = tfn;
         
         int longestBase = templateDB->getLongestBase();
         if (m->getDebug()) { m->mothurOut("[DEBUG]: template longest base = "  + toString(longestBase) + " \n");            }
-        if(al == "gotoh")            {    alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);   }
-        else if(al == "needleman")    {    alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);         }
+        if(al == "gotoh")            {    alignment = new GotohOverlap(gOpen, gExtend, ma, misMa, longestBase);   }
+        else if(al == "needleman")    {    alignment = new NeedlemanOverlap(gOpen, ma, misMa, longestBase);         }
+        else if(al == "striped")      {    alignment = new StripedNeedleman(gOpen, ma, misMa, longestBase);         }
         else if(al == "noalign")        {    alignment = new NoAlign();                                                     }
         else {
             m->mothurOut(al + " is not a valid alignment option. I will run the command using needleman.\n");
-            alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);
+            alignment = new NeedlemanOverlap(gOpen, ma, misMa, longestBase);
         }
     }
-    ~alignStruct() { delete alignment;  }
+    ~AlignWorker() { delete alignment;  }
+    
+    void process(PipelineBatch*);  //output 0 is the alignment, 1 the report and 2 the flipped accnos
+    
+    vector<long long> flippedResults;
     
+private:
+    AlignmentDB* templateDB;
+    Alignment* alignment;
+    string alignMethod, search;
+    float threshold;
+    bool flip;
 };
 //**********************************************************************************************************************
-void alignDriver(alignStruct* params) {
+void AlignWorker::process(PipelineBatch* batch) {
 	try {
         AlignReport report;
 		
-		ifstream inFASTA; params->util.openInputFile(params->inputFilename, inFASTA);
-		inFASTA.seekg(params->filePos.start);
-
-		bool done = false;
-        
-		long long count = 0;
-        long long numFlipped_0 = 0;
-        long long numFlipped_1 = 0;
-		
-		while (!done) {
+		for (int i = 0; i < batch->seqs.size(); i++) {
 			
-			if (params->m->getControl_pressed()) {  break; }
+			if (m->getControl_pressed()) {  break; }
 			
-			Sequence* candidateSeq = new Sequence(inFASTA); gobble(inFASTA);
+			Sequence* candidateSeq = &batch->seqs[i];
 			report.setCandidate(candidateSeq);
 
 			int origNumBases = candidateSeq->getNumBases();
 			string originalUnaligned = candidateSeq->getUnaligned();
-			int numBasesNeeded = origNumBases * params->threshold;
-	
-			if (candidateSeq->getName() != "") { //incase there is a commented sequence at the end of a file
-				if (candidateSeq->getUnaligned().length()+1 > params->alignment->getnRows()) {
-                    if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: " + candidateSeq->getName() + " " + toString(candidateSeq->getUnaligned().length()) + " " + toString(params->alignment->getnRows()) + " \n"); }
-					params->alignment->resize(candidateSeq->getUnaligned().length()+2);
-				}
-                
-                float searchScore;
-				Sequence temp = params->templateDB->findClosestSequence(candidateSeq, searchScore);
-				Sequence* templateSeq = new Sequence(temp.getName(), temp.getAligned());
-								
-				Nast* nast = new Nast(params->alignment, candidateSeq, templateSeq);
-		
-				Sequence* copy;
-				
-				Nast* nast2;
-				bool needToDeleteCopy = false;  //this is needed in case you have you enter the ifs below
-												//since nast does not make a copy of hte sequence passed, and it is used by the reporter below
-												//you can't delete the copy sequence til after you report, but you may choose not to create it in the first place
-												//so this bool tells you if you need to delete it
-												
-				//if there is a possibility that this sequence should be reversed
-				if (candidateSeq->getNumBases() < numBasesNeeded) {
-					numFlipped_1++;
-					//if the user wants you to try the reverse
-					if (params->flip) {
-				
-						//get reverse compliment
-						copy = new Sequence(candidateSeq->getName(), originalUnaligned);
-						copy->reverseComplement();
-                        
-                        if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: flipping "  + candidateSeq->getName() + " \n"); }
-						
-						//rerun alignment
-						Sequence temp2 = params->templateDB->findClosestSequence(copy, searchScore);
-						Sequence* templateSeq2 = new Sequence(temp2.getName(), temp2.getAligned());
-                        
-                        if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: closest template "  + temp2.getName() + " \n"); }
-						
-						nast2 = new Nast(params->alignment, copy, templateSeq2);
-                        
-                        if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: completed Nast2 "  + candidateSeq->getName() + " flipped numBases = " + toString(copy->getNumBases()) + " old numbases = " + toString(candidateSeq->getNumBases()) +" \n"); }
-			
-						//check if any better
-						if (copy->getNumBases() > candidateSeq->getNumBases()) {
-							candidateSeq->setAligned(copy->getAligned());  //use reverse compliments alignment since its better
-                            delete templateSeq;
-							templateSeq = templateSeq2;
-							delete nast;
-							nast = nast2;
-							needToDeleteCopy = true;
-                            params->accnosWriter->write(candidateSeq->getName()+ '\n');
-                            numFlipped_0++;
-						}else{
-							delete nast2;
-                            delete templateSeq2;
-							delete copy;	
-						}
-                        if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: done.\n"); }
-					}
-				}
-				
-				report.setTemplate(templateSeq);
-				report.setSearchParameters(params->search, searchScore);
-				report.setAlignmentParameters(params->alignMethod, params->alignment);
-				report.setNastParameters(*nast);
+			int numBasesNeeded = origNumBases * threshold;
 	
-				params->alignWriter->write('>' + candidateSeq->getName() + '\n' + candidateSeq->getAligned() + '\n');
-				params->reportWriter->write(report.getSeqReport());
-				delete nast;
-                delete templateSeq;
-				if (needToDeleteCopy) {   delete copy;   }
-                
-				count++;
-			}
-			delete candidateSeq;
-			
-			#if defined NON_WINDOWS
-				unsigned long long pos = inFASTA.tellg();
-				if ((pos == -1) || (pos >= params->filePos.end)) { break; }
-			#else
-				if (count == params->filePos.end) { break; }
-			#endif
-			
-			//report progress
-			if((count) % 1000 == 0){	params->m->mothurOutJustToScreen(toString(count) + "\n"); 		}
-			
+            if (candidateSeq->getUnaligned().length()+1 > alignment->getnRows()) {
+                if (m->getDebug()) { m->mothurOut("[DEBUG]: " + candidateSeq->getName() + " " + toString(candidateSeq->getUnaligned().length()) + " " + toString(alignment->getnRows()) + " \n"); }
+                alignment->resize(candidateSeq->getUnaligned().length()+2);
+            }
+            
+            float searchScore;
+            Sequence temp = templateDB->findClosestSequence(candidateSeq, searchScore);
+            Sequence* templateSeq = new Sequence(temp.getName(), temp.getAligned());
+                            
+            Nast* nast = new Nast(alignment, candidateSeq, templateSeq);
+    
+            Sequence* copy;
+            
+            Nast* nast2;
+            bool needToDeleteCopy = false;  //this is needed in case you have you enter the ifs below
+                                            //since nast does not make a copy of hte sequence passed, and it is used by the reporter below
+                                            //you can't delete the copy sequence til after you report, but you may choose not to create it in the first place
+                                            //so this bool tells you if you need to delete it
+                                            
+            //if there is a possibility that this sequence should be reversed
+            if (candidateSeq->getNumBases() < numBasesNeeded) {
+                flippedResults[1]++;
+                //if the user wants you to try the reverse
+                if (flip) {
+            
+                    //get reverse compliment
+                    copy = new Sequence(candidateSeq->getName(), originalUnaligned);
+                    copy->reverseComplement();
+                    
+                    if (m->getDebug()) { m->mothurOut("[DEBUG]: flipping "  + candidateSeq->getName() + " \n"); }
+                    
+                    //rerun alignment
+                    Sequence temp2 = templateDB->findClosestSequence(copy, searchScore);
+                    Sequence* templateSeq2 = new Sequence(temp2.getName(), temp2.getAligned());
+                    
+                    if (m->getDebug()) { m->mothurOut("[DEBUG]: closest template "  + temp2.getName() + " \n"); }
+                    
+                    nast2 = new Nast(alignment, copy, templateSeq2);
+                    
+                    if (m->getDebug()) { m->mothurOut("[DEBUG]: completed Nast2 "  + candidateSeq->getName() + " flipped numBases = " + toString(copy->getNumBases()) + " old numbases = " + toString(candidateSeq->getNumBases()) +" \n"); }
+        
+                    //check if any better
+                    if (copy->getNumBases() > candidateSeq->getNumBases()) {
+                        candidateSeq->setAligned(copy->getAligned());  //use reverse compliments alignment since its better
+                        delete templateSeq;
+                        templateSeq = templateSeq2;
+                        delete nast;
+                        nast = nast2;
+                        needToDeleteCopy = true;
+                        batch->output[2] += candidateSeq->getName()+ '\n';
+                        flippedResults[0]++;
+                    }else{
+                        delete nast2;
+                        delete templateSeq2;
+                        delete copy;	
+                    }
+                    if (m->getDebug()) { m->mothurOut("[DEBUG]: done.\n"); }
+                }
+            }
+            
+            report.setTemplate(templateSeq);
+            report.setSearchParameters(search, searchScore);
+            report.setAlignmentParameters(alignMethod, alignment);
+            report.setNastParameters(*nast);
+
+            batch->output[0] += '>' + candidateSeq->getName() + '\n' + candidateSeq->getAligned() + '\n';
+            batch->output[1] += report.getSeqReport();
+            delete nast;
+            delete templateSeq;
+            if (needToDeleteCopy) {   delete copy;   }
 		}
-		//report progress
-		if((count) % 1000 != 0){	params->m->mothurOutJustToScreen(toString(count) + "\n"); 		}
-        
-        params->numSeqs += count;
-        params->flippedResults[0] += numFlipped_0;
-        params->flippedResults[1] += numFlipped_1;
-        
-		inFASTA.close();
-		
 	}
 	catch(exception& e) {
-		params->m->errorOut(e, "AlignCommand", "driver");
+		m->errorOut(e, "AlignCommand", "driver");
 		exit(1);
 	}
 }
 /**************************************************************************************************/
-//void alignDriver(linePair* filePos, string alignFName, string reportFName, string accnosFName, string filename, vector<long long>& numFlipped,MothurOut* m, string align, float match, float misMatch, float gapOpen, float gapExtend, float threshold, bool flip, AlignmentDB* templateDB, string search, long long& count) {
 long long AlignCommand::createProcesses(string alignFileName, string reportFileName, string accnosFName, string filename, vector<long long>& numFlipped) {
 	try {
-        
-        vector<linePair> lines;
-        vector<double> positions;
-#if defined NON_WINDOWS
-        positions = util.divideFile(filename, processors);
-        for (int i = 0; i < (positions.size()-1); i++) {	lines.push_back(linePair(positions[i], positions[(i+1)]));	}
-#else
-        long long numFastaSeqs = 0;
-        positions = util.setFilePosFasta(filename, numFastaSeqs);
-        if (numFastaSeqs < processors) { processors = numFastaSeqs; m->mothurOut("Reducing processors to " + toString(numFastaSeqs) + ".\n");  }
-        
-        //figure out how many sequences you have to process
-        int numSeqsPerProcessor = numFastaSeqs / processors;
+        vector<PipelineWorker*> workers;
+        vector<AlignWorker*> alignWorkers;
         for (int i = 0; i < processors; i++) {
-            int startIndex =  i * numSeqsPerProcessor;
-            if(i == (processors - 1)){	numSeqsPerProcessor = numFastaSeqs - i * numSeqsPerProcessor; 	}
-            lines.push_back(linePair(positions[startIndex], numSeqsPerProcessor));
+            AlignWorker* worker = new AlignWorker(templateDB, align, match, misMatch, gapOpen, gapExtend, threshold, flip, search);
+            alignWorkers.push_back(worker); workers.push_back(worker);
         }
-#endif
-
-        //create array of worker threads
-        vector<std::thread*> workerThreads;
-        vector<alignStruct*> data;
-        
-        long long num = 0;
-        for (int i = 0; i < numFlipped.size(); i++) { numFlipped[i] = 0; }
         
         time_t start, end;
         time(&start);
         
-        AlignReport nast; ofstream out; util.openOutputFile(reportFileName, out);
-        nast.printHeaders(out); out.close();
+        ofstream outAlign; util.openOutputFile(alignFileName, outAlign);
+        ofstream outReport; util.openOutputFile(reportFileName, outReport);
+        ofstream outAccnos; util.openOutputFile(accnosFName, outAccnos);
         
-        auto synchronizedOutputAlignFile = std::make_shared<SynchronizedOutputFile>(alignFileName);
-        auto synchronizedOutputReportFile = std::make_shared<SynchronizedOutputFile>(reportFileName, true);
-        auto synchronizedOutputAccnosFile = std::make_shared<SynchronizedOutputFile>(accnosFName);
-
-        for (int i = 0; i < processors-1; i++) {
-            
-            OutputWriter* threadAlignWriter = new OutputWriter(synchronizedOutputAlignFile);
-            OutputWriter* threadReportWriter = new OutputWriter(synchronizedOutputReportFile);
-            OutputWriter* threadAccnosWriter = new OutputWriter(synchronizedOutputAccnosFile);
-
-            
-            alignStruct* dataBundle = new alignStruct(lines[i+1], threadAlignWriter, threadReportWriter, threadAccnosWriter, filename, templateDB, align, match, misMatch, gapOpen, gapExtend, threshold, flip, kmerSize, search);
-            data.push_back(dataBundle);
-
-            workerThreads.push_back(new std::thread(alignDriver, dataBundle));
-         }
-        
-        OutputWriter* threadAlignWriter = new OutputWriter(synchronizedOutputAlignFile);
-        OutputWriter* threadReportWriter = new OutputWriter(synchronizedOutputReportFile);
-        OutputWriter* threadAccnosWriter = new OutputWriter(synchronizedOutputAccnosFile);
-        
-        alignStruct* dataBundle = new alignStruct(lines[0], threadAlignWriter, threadReportWriter, threadAccnosWriter, filename, templateDB, align, match, misMatch, gapOpen, gapExtend, threshold, flip, kmerSize, search);
-        alignDriver(dataBundle);
-        numFlipped[0] = dataBundle->flippedResults[0];
-        numFlipped[1] = dataBundle->flippedResults[1];
-        num = dataBundle->numSeqs;
-        
-        for (int i = 0; i < processors-1; i++) {
-            workerThreads[i]->join();
-            num += data[i]->numSeqs;
-            numFlipped[0] += data[i]->flippedResults[0];
-            numFlipped[1] += data[i]->flippedResults[1];
-            
-            delete data[i]->alignWriter;
-            delete data[i]->reportWriter;
-            delete data[i]->accnosWriter;
-            
-            delete data[i];
-            delete workerThreads[i];
+        AlignReport nast; nast.printHeaders(outReport);
+        
+        vector<ostream*> outputs; outputs.push_back(&outAlign); outputs.push_back(&outReport); outputs.push_back(&outAccnos);
+        
+        SequencePipeline pipeline(filename);
+        long long num = pipeline.run(workers, outputs);
+        
+        outAlign.close(); outReport.close(); outAccnos.close();
+        
+        for (int i = 0; i < numFlipped.size(); i++) { numFlipped[i] = 0; }
+        for (int i = 0; i < alignWorkers.size(); i++) {
+            numFlipped[0] += alignWorkers[i]->flippedResults[0];
+            numFlipped[1] += alignWorkers[i]->flippedResults[1];
+            delete alignWorkers[i];
         }
-        synchronizedOutputAlignFile->close(); synchronizedOutputReportFile->close(); synchronizedOutputAccnosFile->close();
-        delete threadAlignWriter; delete threadAccnosWriter; delete threadReportWriter;
-        delete dataBundle;
         
         time(&end);
         m->mothurOut("It took " + toString(difftime(end, start)) + " secs to align " + toString(num) + " sequences.\n\n");
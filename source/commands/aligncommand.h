@@ -16,6 +16,7 @@
 #include "sequence.hpp"
 #include "gotohoverlap.hpp"
 #include "needlemanoverlap.hpp"
+#include "stripedneedleman.hpp"
 #include "noalign.hpp"
 #include "nast.hpp"
 #include "alignreport.hpp"
@@ -11,6 +11,34 @@
 #include "readphylipvector.h"
 #include "designmap.h"
 
+//**********************************************************************************************************************
+//the sum of squares within the groups, with the samples in the given order. Group g is the samples at positions
+//groupStarts[g] to groupStarts[g+1].
+class AmovaSSWithin : public PermutationStatistic {
+public:
+    AmovaSSWithin(CondensedMatrix& d, vector<int>& g) : dists(d), groupStarts(g) {}
+    
+    double getValue(const vector<int>& order) {
+        double ssWithin = 0.0;
+        
+        for (int g = 0; g < groupStarts.size()-1; g++) {
+            double withinGroup = 0;
+            
+            for (int i = groupStarts[g]; i < groupStarts[g+1]; i++) {
+                for (int j = groupStarts[g]; j < i; j++) { withinGroup += dists.get(order[i], order[j]); }
+            }
+            
+            ssWithin += withinGroup / (double) (groupStarts[g+1] - groupStarts[g]);
+        }
+        
+        return ssWithin;
+    }
+    
+private:
+    CondensedMatrix& dists;
+    vector<int>& groupStarts;
+};
+
 
 
 //**********************************************************************************************************************
@@ -21,6 +49,7 @@ vector<string> AmovaCommand::setParameters(){
 		CommandParameter pphylip("phylip", "InputTypes", "", "", "none", "none", "none","amova",false,true,true); parameters.push_back(pphylip);
 		CommandParameter piters("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter palpha("alpha", "Number", "", "0.05", "", "", "","",false,false); parameters.push_back(palpha);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -49,6 +78,7 @@ string AmovaCommand::getHelpString(){
 		helpString += "The design parameter allows you to assign your samples to groups when you are running amova. It is required.\n";
         helpString += "The sets parameter allows you to specify which of the sets in your designfile you would like to analyze. The set names are separated by dashes. The default is all sets in the design file.\n";
 		helpString += "The iters parameter allows you to set number of randomization for the P value.  The default is 1000.\n";
+		helpString += "The processors parameter allows you to specify the number of processors to use. The default is all available.\n";
 		helpString += "The amova command should be in the following format: amova(phylip=file.dist, design=file.design).\n";
 		
         getCommonQuestions();
@@ -132,6 +162,9 @@ AmovaCommand::AmovaCommand(string option) : Command() {
 			temp = validParameter.valid(parameters, "alpha");
 			if (temp == "not found") { temp = "0.05"; }
 			util.mothurConvert(temp, experimentwiseAlpha); 
+			
+			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
             
             string sets = validParameter.valid(parameters, "sets");			
 			if (sets == "not found") { sets = ""; }
@@ -187,6 +220,8 @@ int AmovaCommand::execute(){
 				distanceMatrix[i][j] *= distanceMatrix[i][j];	
 			}
 		}
+		distances = CondensedMatrix(distanceMatrix);
+		distanceMatrix.clear();
 		
 		//link designMap to rows/columns in distance matrix
 		map<string, vector<int> > origGroupSampleMap;
@@ -210,7 +245,8 @@ int AmovaCommand::execute(){
 		util.openOutputFile(AMOVAFileName, AMOVAFile);
 		outputNames.push_back(AMOVAFileName); outputTypes["amova"].push_back(AMOVAFileName);
 		
-		double fullANOVAPValue = runAMOVA(AMOVAFile, origGroupSampleMap, experimentwiseAlpha);
+		PermutationTest test(processors);
+		double fullANOVAPValue = runAMOVA(AMOVAFile, test, origGroupSampleMap, experimentwiseAlpha);
 		if(fullANOVAPValue <= experimentwiseAlpha && numGroups > 2){
 			
 			int numCombos = numGroups * (numGroups-1) / 2;
@@ -227,7 +263,7 @@ int AmovaCommand::execute(){
 					pairwiseGroupSampleMap[itA->first] = itA->second;
 					pairwiseGroupSampleMap[itB->first] = itB->second;
 					
-					runAMOVA(AMOVAFile, pairwiseGroupSampleMap, pairwiseAlpha);
+					runAMOVA(AMOVAFile, test, pairwiseGroupSampleMap, pairwiseAlpha);
 				}			
 			}
 			m->mothurOut("Experiment-wise error rate: " + toString(experimentwiseAlpha) + '\n');
@@ -254,27 +290,32 @@ int AmovaCommand::execute(){
 
 //**********************************************************************************************************************
 
-double AmovaCommand::runAMOVA(ofstream& AMOVAFile, map<string, vector<int> > groupSampleMap, double alpha) {
+double AmovaCommand::runAMOVA(ofstream& AMOVAFile, PermutationTest& test, map<string, vector<int> > groupSampleMap, double alpha) {
 	try {
 		map<string, vector<int> >::iterator it;
 
 		int numGroups = groupSampleMap.size();
-		int totalNumSamples = 0;
-
+		
+		//the distances between this comparison's samples, with each group's samples next to each other
+		vector<int> samples; vector<int> groupStarts;
 		for(it = groupSampleMap.begin();it!=groupSampleMap.end();it++){
-			totalNumSamples += it->second.size();			
+			groupStarts.push_back(samples.size());
+			samples.insert(samples.end(), it->second.begin(), it->second.end());
 		}
-
-		double ssTotalOrig = calcSSTotal(groupSampleMap);
-		double ssWithinOrig = calcSSWithin(groupSampleMap);
+		groupStarts.push_back(samples.size());
+		int totalNumSamples = samples.size();
+		
+		CondensedMatrix dists(distances, samples);
+		
+		double ssTotalOrig = 0.0;
+		for (long long i = 0; i < dists.getNumCells(); i++) { ssTotalOrig += dists.cells[i]; }
+		ssTotalOrig /= totalNumSamples;
+		
+		AmovaSSWithin ssWithin(dists, groupStarts);
+		double ssWithinOrig = test.getObserved(&ssWithin, totalNumSamples);
 		double ssAmongOrig = ssTotalOrig - ssWithinOrig;
 		
-		double counter = 0;
-		for(int i=0;i<iters;i++){
-			map<string, vector<int> > randomizedGroup = getRandomizedGroups(groupSampleMap);
-			double ssWithinRand = calcSSWithin(randomizedGroup);
-			if(ssWithinRand <= ssWithinOrig){	counter++;	}
-		}
+		int counter = test.run(&ssWithin, totalNumSamples, iters, ssWithinOrig, false);
 		
 		double pValue = (double)counter / (double) iters;
 		string pString = "";
@@ -323,105 +364,3 @@ double AmovaCommand::runAMOVA(ofstream& AMOVAFile, map<string, vector<int> > gro
 }
 
 //**********************************************************************************************************************
-
-map<string, vector<int> > AmovaCommand::getRandomizedGroups(map<string, vector<int> > origMapping){
-	try{
-		vector<int> sampleIndices;
-		vector<int> samplesPerGroup;
-		
-		map<string, vector<int> >::iterator it;
-		for(it=origMapping.begin();it!=origMapping.end();it++){
-			vector<int> indices = it->second;
-			samplesPerGroup.push_back(indices.size());
-			sampleIndices.insert(sampleIndices.end(), indices.begin(), indices.end());
-		}
-		
-		util.mothurRandomShuffle(sampleIndices);
-		
-		int index = 0;
-		map<string, vector<int> > randomizedGroups = origMapping;
-		for(it=randomizedGroups.begin();it!=randomizedGroups.end();it++){
-			for(int i=0;i<it->second.size();i++){
-				it->second[i] = sampleIndices[index++];				
-			}
-		}
-
-		return randomizedGroups;		
-	}
-	catch (exception& e) {
-		m->errorOut(e, "AmovaCommand", "getRandomizedGroups");
-		exit(1);
-	}
-}
-
-//**********************************************************************************************************************
-
-double AmovaCommand::calcSSTotal(map<string, vector<int> >& groupSampleMap) {
-	try {
-		
-		vector<int> indices;
-		map<string, vector<int> >::iterator it;
-		for(it=groupSampleMap.begin();it!=groupSampleMap.end();it++){
-			indices.insert(indices.end(), it->second.begin(), it->second.end());			
-		}
-		sort(indices.begin(), indices.end());
-			
- 		int numIndices =indices.size();
-		double ssTotal = 0.0;
-		
-		for(int i=1;i<numIndices;i++){
-			int row = indices[i];
-			
-			for(int j=0;j<i;j++){
-				ssTotal += distanceMatrix[row][indices[j]];
-			}
-		}
-		ssTotal /= numIndices;
-			
-		return ssTotal;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "AmovaCommand", "calcSSTotal");
-		exit(1);
-	}
-}
-
-//**********************************************************************************************************************
-
-double AmovaCommand::calcSSWithin(map<string, vector<int> >& groupSampleMap) {
-	try {
-
-		double ssWithin = 0.0;
-		
-		map<string, vector<int> >::iterator it;
-		for(it=groupSampleMap.begin();it!=groupSampleMap.end();it++){
-			
-			double withinGroup = 0;
-			
-			vector<int> samples = it->second;
-			
-			for(int i=0;i<samples.size();i++){
-				int row = samples[i];
-
-				for(int j=0;j<samples.size();j++){
-					int col = samples[j];
-
-					if(col < row){
-						withinGroup += distanceMatrix[row][col];
-					}
-					
-				}
-			}
-
-			ssWithin += withinGroup / samples.size();
-		}
-
-		return ssWithin;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "AmovaCommand", "calcSSWithin");
-		exit(1);
-	}
-}
-
-//**********************************************************************************************************************
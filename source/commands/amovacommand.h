@@ -11,6 +11,7 @@
  */
 
 #include "command.hpp"
+#include "permutationtest.hpp"
 class DesignMap;
 
 class AmovaCommand : public Command {
@@ -33,10 +34,7 @@ public:
 	void help() { m->mothurOut(getHelpString()); }
 	
 private:
-	double runAMOVA(ofstream&, map<string, vector<int> >, double);
-	double calcSSWithin(map<string, vector<int> >&);
-	double calcSSTotal(map<string, vector<int> >&);
-	map<string, vector<int> > getRandomizedGroups(map<string, vector<int> >);
+	double runAMOVA(ofstream&, PermutationTest&, map<string, vector<int> >, double);
 
 	bool abort;
 	vector<string> outputNames, Sets;
@@ -44,7 +42,8 @@ private:
 	string inputDir, designFileName, phylipFileName;
 	DesignMap* designMap;
 	vector< vector<double> > distanceMatrix;
-	int iters;
+	CondensedMatrix distances;
+	int iters, processors;
 	double experimentwiseAlpha;
 };
 
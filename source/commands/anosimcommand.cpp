@@ -12,6 +12,47 @@
 #include "readphylipvector.h"
 #include "designmap.h"
 
+//**********************************************************************************************************************
+//R from the ranks of the distances, with the samples in the given order. Group g is the samples at positions
+//groupStarts[g] to groupStarts[g+1]. The ranks of all pairs add up to the same total in any order, so only the pairs
+//within groups are summed.
+class AnosimR : public PermutationStatistic {
+public:
+    AnosimR(CondensedMatrix& r, vector<int>& g) : ranks(r), groupStarts(g) {
+        totalRanks = 0.0;
+        for (long long i = 0; i < ranks.getNumCells(); i++) { totalRanks += ranks.cells[i]; }
+        
+        numWithinComps = 0;
+        for (int g = 0; g < groupStarts.size()-1; g++) {
+            long long numSamplesInGroup = groupStarts[g+1] - groupStarts[g];
+            numWithinComps += (numSamplesInGroup * (numSamplesInGroup-1)) / 2;
+        }
+    }
+    
+    double getValue(const vector<int>& order) {
+        double within = 0.0;
+        for (int g = 0; g < groupStarts.size()-1; g++) {
+            for (int i = groupStarts[g]; i < groupStarts[g+1]; i++) {
+                for (int j = groupStarts[g]; j < i; j++) { within += ranks.get(order[i], order[j]); }
+            }
+        }
+        
+        double between = (totalRanks - within) / (double) (ranks.getNumCells() - numWithinComps);
+        within /= (double) numWithinComps;
+        
+        double numSamples = ranks.getNumRows();
+        double Rvalue = (between - within)/(numSamples * (numSamples-1) / 4.0);
+        
+        return Rvalue;
+    }
+    
+private:
+    CondensedMatrix& ranks;
+    vector<int>& groupStarts;
+    double totalRanks;
+    long long numWithinComps;
+};
+
 //**********************************************************************************************************************
 vector<string> AnosimCommand::setParameters(){	
 	try {
@@ -19,6 +60,7 @@ vector<string> AnosimCommand::setParameters(){
 		CommandParameter pphylip("phylip", "InputTypes", "", "", "none", "none", "none","anosim",false,true,true); parameters.push_back(pphylip);
 		CommandParameter piters("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter palpha("alpha", "Number", "", "0.05", "", "", "","",false,false); parameters.push_back(palpha);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -47,6 +89,7 @@ string AnosimCommand::getHelpString(){
 		helpString += "The design parameter allows you to assign your samples to groups when you are running anosim. It is required. \n";
 		helpString += "The design file looks like the group file.  It is a 2 column tab delimited file, where the first column is the sample name and the second column is the group the sample belongs to.\n";
 		helpString += "The iters parameter allows you to set number of randomization for the P value.  The default is 1000. \n";
+		helpString += "The processors parameter allows you to specify the number of processors to use. The default is all available.\n";
 		helpString += "The anosim command should be in the following format: anosim(phylip=file.dist, design=file.design).\n";
 		return helpString;
 	}
@@ -112,6 +155,9 @@ AnosimCommand::AnosimCommand(string option) : Command() {
 			temp = validParameter.valid(parameters, "alpha");
 			if (temp == "not found") { temp = "0.05"; }
 			util.mothurConvert(temp, experimentwiseAlpha); 
+			
+			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
 		}
 		
 	}
@@ -140,6 +186,8 @@ int AnosimCommand::execute(){
 				distanceMatrix[i][j] *= distanceMatrix[i][j];	
 			}
 		}
+		distances = CondensedMatrix(distanceMatrix);
+		distanceMatrix.clear();
 		
 		//link designMap to rows/columns in distance matrix
 		map<string, vector<int> > origGroupSampleMap;
@@ -165,7 +213,8 @@ int AnosimCommand::execute(){
 		ANOSIMFile << "comparison\tR-value\tP-value\n";
 		
 		
-		double fullANOSIMPValue = runANOSIM(ANOSIMFile, distanceMatrix, origGroupSampleMap, experimentwiseAlpha);
+		PermutationTest test(processors);
+		double fullANOSIMPValue = runANOSIM(ANOSIMFile, test, origGroupSampleMap, experimentwiseAlpha);
 		
 		
 		if(fullANOSIMPValue <= experimentwiseAlpha && numGroups > 2){
@@ -183,26 +232,7 @@ int AnosimCommand::execute(){
 					subGroupSampleMap[itA->first] = itA->second;	string groupA = itA->first;
 					subGroupSampleMap[itB->first] = itB->second;	string groupB = itB->first;
 			
-					vector<int> subIndices;
-					for(map<string, vector<int> >::iterator it=subGroupSampleMap.begin();it!=subGroupSampleMap.end();it++){
-						subIndices.insert(subIndices.end(), it->second.begin(), it->second.end());
-					}
-					int subNumSamples = subIndices.size();
-
-					sort(subIndices.begin(), subIndices.end());		
-					
-					vector<vector<double> > subDistMatrix(distanceMatrix.size());
-					for(int i=0;i<distanceMatrix.size();i++){
-						subDistMatrix[i].assign(distanceMatrix.size(), -1);
-					}
-
-					for(int i=0;i<subNumSamples;i++){
-						for(int j=0;j<i;j++){
-							subDistMatrix[subIndices[i]][subIndices[j]] = distanceMatrix[subIndices[i]][subIndices[j]];
-						}
-					}
-
-					runANOSIM(ANOSIMFile, subDistMatrix, subGroupSampleMap, pairwiseAlpha);
+					runANOSIM(ANOSIMFile, test, subGroupSampleMap, pairwiseAlpha);
 
 				}
 			}
@@ -230,18 +260,23 @@ int AnosimCommand::execute(){
 }
 //**********************************************************************************************************************
 
-double AnosimCommand::runANOSIM(ofstream& ANOSIMFile, vector<vector<double> > dMatrix, map<string, vector<int> > groupSampleMap, double alpha) {
+double AnosimCommand::runANOSIM(ofstream& ANOSIMFile, PermutationTest& test, map<string, vector<int> > groupSampleMap, double alpha) {
 	try {
-
-		vector<vector<double> > rankMatrix = convertToRanks(dMatrix);
-		double RValue = calcR(rankMatrix, groupSampleMap);
-		
-		int pCount = 0;
-		for(int i=0;i<iters;i++){
-			map<string, vector<int> > randGroupSampleMap = getRandomizedGroups(groupSampleMap);
-			double RValueRand = calcR(rankMatrix, randGroupSampleMap);
-			if(RValue <= RValueRand){	pCount++;	}
+		//the ranks of the distances between this comparison's samples, with each group's samples next to each other
+		vector<int> samples; vector<int> groupStarts;
+		for(map<string, vector<int> >::iterator it=groupSampleMap.begin();it!=groupSampleMap.end();it++){
+			groupStarts.push_back(samples.size());
+			samples.insert(samples.end(), it->second.begin(), it->second.end());
 		}
+		groupStarts.push_back(samples.size());
+		
+		CondensedMatrix rankMatrix(distances, samples);
+		rankMatrix.convertToRanks();
+		
+		AnosimR R(rankMatrix, groupStarts);
+		double RValue = test.getObserved(&R, samples.size());
+		
+		int pCount = test.run(&R, samples.size(), iters, RValue, true);
 
 		double pValue = (double)pCount / (double) iters;
 		string pString = "";
@@ -273,154 +308,3 @@ double AnosimCommand::runANOSIM(ofstream& ANOSIMFile, vector<vector<double> > dM
 }
 
 //**********************************************************************************************************************
-
-double AnosimCommand::calcR(vector<vector<double> > rankMatrix, map<string, vector<int> > groupSampleMap){
-	try {
-
-		int numSamples = 0;
-		for(map<string, vector<int> >::iterator it=groupSampleMap.begin();it!=groupSampleMap.end();it++){
-			numSamples += it->second.size();
-		}
-		
-		
-		double within = 0.0;
-		int numWithinComps = 0;		
-		
-		for(map<string, vector<int> >::iterator it=groupSampleMap.begin();it!=groupSampleMap.end();it++){
-			vector<int> indices = it->second;
-			for(int i=0;i<indices.size();i++){
-				for(int j=0;j<i;j++){
-					if(indices[i] > indices[j])	{	within += rankMatrix[indices[i]][indices[j]];	}
-					else						{	within += rankMatrix[indices[j]][indices[i]];	}
-					numWithinComps++;
-				}
-			}
-		}
-		
-		within /= (float) numWithinComps;
-		
-		double between = 0.0;
-		int numBetweenComps = 0;
-
-		map<string, vector<int> >::iterator itB;
-		
-		for(map<string, vector<int> >::iterator itA=groupSampleMap.begin();itA!=groupSampleMap.end();itA++){
-
-			for(int i=0;i<itA->second.size();i++){
-				int A = itA->second[i];
-				map<string, vector<int> >::iterator itB = itA;
-				itB++;
-				for(;itB!=groupSampleMap.end();itB++){
-					for(int j=0;j<itB->second.size();j++){
-						int B = itB->second[j];
-						if(A>B)	{	between += rankMatrix[A][B];	}
-						else	{	between += rankMatrix[B][A];	}
-						numBetweenComps++;
-					}					
-				}
-			}
-		}
-		
-		between /= (float) numBetweenComps;
-		
-		double Rvalue = (between - within)/(numSamples * (numSamples-1) / 4.0);
-				
-		return Rvalue;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "AnosimCommand", "calcWithinBetween");
-		exit(1);
-	}
-}
-
-//**********************************************************************************************************************
-
-vector<vector<double> > AnosimCommand::convertToRanks(vector<vector<double> > dist) {
-	try {
-		vector<seqDist> cells;
-		vector<vector<double> > ranks = dist;
-		
-		for (int i = 0; i < dist.size(); i++) {
-			for (int j = 0; j < i; j++) {
-				if(dist[i][j] != -1){
-					seqDist member(i, j, dist[i][j]);
-					cells.push_back(member);
-				}
-			}
-		}
-		
-		//sort distances
-		sort(cells.begin(), cells.end(), compareSequenceDistance); 	
-
-		//find ranks of distances
-		int index = 0;
-		int indexSum = 0;
-		for(int i=0;i<cells.size()-1;i++){
-
-			index = i;
-			indexSum = i + 1;
-			while(dist[cells[index].seq1][cells[index].seq2] == dist[cells[index+1].seq1][cells[index+1].seq2]){
-				index++;				
-				indexSum += index + 1;
-			}
-			
-			if(index == i){
-				ranks[cells[i].seq1][cells[i].seq2] = i+1;
-			}
-			else{
-				double aveIndex = (double)indexSum / (double)(index - i + 1);
-				for(int j=i;j<=index;j++){
-					ranks[cells[j].seq1][cells[j].seq2] = aveIndex;
-				}					
-				i = index;
-			}
-		}
-		
-		if(indexSum == cells.size() - 1){
-			ranks[cells[cells.size()-1].seq1][cells[cells.size()-1].seq2] = indexSum + 1;
-		}
-
-		return ranks;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "AnosimCommand", "convertToRanks");
-		exit(1);
-	}
-}
-
-//**********************************************************************************************************************
-
-map<string, vector<int> > AnosimCommand::getRandomizedGroups(map<string, vector<int> > origMapping){
-	try{
-		vector<int> sampleIndices;
-		vector<int> samplesPerGroup;
-		
-		map<string, vector<int> >::iterator it;
-		for(it=origMapping.begin();it!=origMapping.end();it++){
-			vector<int> indices = it->second;
-			samplesPerGroup.push_back(indices.size());
-			sampleIndices.insert(sampleIndices.end(), indices.begin(), indices.end());
-		}
-		
-		util.mothurRandomShuffle(sampleIndices);
-		
-		int index = 0;
-		map<string, vector<int> > randomizedGroups = origMapping;
-		for(it=randomizedGroups.begin();it!=randomizedGroups.end();it++){
-			for(int i=0;i<it->second.size();i++){
-				it->second[i] = sampleIndices[index++];				
-			}
-		}
-		
-		return randomizedGroups;		
-	}
-	catch (exception& e) {
-		m->errorOut(e, "AnosimCommand", "randomizeGroups");
-		exit(1);
-	}
-}
-
-//**********************************************************************************************************************
-
-
-
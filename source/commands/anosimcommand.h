@@ -12,6 +12,7 @@
 
 
 #include "command.hpp"
+#include "permutationtest.hpp"
 
 class DesignMap;
 
@@ -38,14 +39,12 @@ private:
 	DesignMap* designMap;
 	string inputDir, designFileName, phylipFileName;
 	
-	vector<vector<double> > convertToRanks(vector<vector<double> >);
-	double calcR(vector<vector<double> >, map<string, vector<int> >);
-	map<string, vector<int> > getRandomizedGroups(map<string, vector<int> >);
-	double runANOSIM(ofstream&, vector<vector<double> >, map<string, vector<int> >, double);
+	double runANOSIM(ofstream&, PermutationTest&, map<string, vector<int> >, double);
 	
 	vector< vector<double> > distanceMatrix;
+	CondensedMatrix distances;
 	vector<string> outputNames;
-	int iters;
+	int iters, processors;
 	double experimentwiseAlpha;
 	vector< vector<string> > namesOfGroupCombos;
 	
@@ -58,7 +58,7 @@ string ChimeraPerseusCommand::getHelpString(){
 		helpString += "The name parameter allows you to provide a name file associated with your fasta file.\n";
         helpString += "The count parameter allows you to provide a count file associated with your fasta file. A count or name file is required. When you use a count file with group info and dereplicate=T, mothur will create a *.pick.count_table file containing seqeunces after chimeras are removed.\n";
 		helpString += "The group parameter allows you to provide a group file.  When checking sequences, only sequences from the same group as the query sequence will be used as the reference. \n";
-		helpString += "The processors parameter allows you to specify how many processors you would like to use.  The default is 1. \n";
+		helpString += "The processors parameter allows you to specify the number of processors to use. The default is all available.\n";
         helpString += "If the dereplicate parameter is false, then if one group finds the seqeunce to be chimeric, then all groups find it to be chimeric, default=f.\n";
         helpString += "The removechimeras parameter allows you to indicate you would like to automatically remove the sequences that are flagged as chimeric. Default=t.\n";
 		helpString += "The alpha parameter ....  The default is -5.54. \n";
@@ -196,30 +196,120 @@ ChimeraPerseusCommand::ChimeraPerseusCommand(string option) : Command()  {
 		exit(1);
 	}
 }
-/**************************************************************************************************/
-struct perseusData {
-    Utils util;
-    MothurOut* m;
-    vector<seqData> sequences;
-    string group;
-    int count, numChimeras;
-    string chimeraFileName;
-    string accnosFileName;
-    double alpha, beta, cutoff;
-    
-    perseusData(string cf, string ac, double a, double b, double c){
-        m = MothurOut::getInstance();
-        count = 0;
-        numChimeras = 0;
-        accnosFileName = ac;
-        chimeraFileName = cf;
-        alpha = a;
-        beta = b;
-        cutoff = c;
+//**********************************************************************************************************************
+//checks sequence i against the more abundant sequences not found to be chimeras, returns its line of the chimera file
+string checkSequence(perseusData* params, Perseus& myPerseus, perseusBuffers& buffers, int i, const vector<bool>& chimeras, vector<vector<double> >& correctModel, vector<vector<double> >& binMatrix, bool& isChimera){
+    try {
+        isChimera = false;
+        
+        vector<bool>& restricted = buffers.restricted;
+        vector<vector<int> >& leftDiffs = buffers.leftDiffs;
+        vector<vector<int> >& leftMaps = buffers.leftMaps;
+        vector<vector<int> >& rightDiffs = buffers.rightDiffs;
+        vector<vector<int> >& rightMaps = buffers.rightMaps;
+        vector<pwAlign>& alignments = buffers.alignments;
+        
+        vector<int> singleLeft, bestLeft;
+        vector<int> singleRight, bestRight;
+        
+        int bestSingleIndex, bestSingleDiff;
+        
+        int comparisons = myPerseus.getAlignments(i, params->sequences, chimeras, alignments, leftDiffs, leftMaps, rightDiffs, rightMaps, bestSingleIndex, bestSingleDiff, restricted);
+        if (params->m->getControl_pressed()) { return ""; }
+        
+        int minMismatchToChimera, leftParentBi, rightParentBi, breakPointBi;
+        
+        string dummyA, dummyB;
+        ostringstream chimeraFile;
+        
+        if (params->sequences[i].sequence.size() < 3) {
+            chimeraFile << i << '\t' << params->sequences[i].seqName << "\t0\t0\tNull\t0\t0\t0\tNull\tNull\t0.0\t0.0\t0.0\t0\t0\t0\t0.0\t0.0\tgood" << endl;
+        }else if(comparisons >= 2){
+            minMismatchToChimera = myPerseus.getChimera(params->sequences, leftDiffs, rightDiffs, leftParentBi, rightParentBi, breakPointBi, singleLeft, bestLeft, singleRight, bestRight, restricted);
+            if (params->m->getControl_pressed()) { return ""; }
+            
+            int minMismatchToTrimera = numeric_limits<int>::max();
+            int leftParentTri, middleParentTri, rightParentTri, breakPointTriA, breakPointTriB;
+            
+            if(minMismatchToChimera >= 3 && comparisons >= 3){
+                minMismatchToTrimera = myPerseus.getTrimera(params->sequences, leftDiffs, leftParentTri, middleParentTri, rightParentTri, breakPointTriA, breakPointTriB, singleLeft, bestLeft, singleRight, bestRight, restricted);
+                if (params->m->getControl_pressed()) { return ""; }
+            }
+            
+            double singleDist = myPerseus.modeledPairwiseAlignSeqs(params->sequences[i].sequence, params->sequences[bestSingleIndex].sequence, dummyA, dummyB, correctModel);
+            
+            if (params->m->getControl_pressed()) { return ""; }
+            
+            string type;
+            string chimeraRefSeq;
+            
+            if(minMismatchToChimera - minMismatchToTrimera >= 3){
+                type = "trimera";
+                chimeraRefSeq = myPerseus.stitchTrimera(alignments, leftParentTri, middleParentTri, rightParentTri, breakPointTriA, breakPointTriB, leftMaps, rightMaps);
+            }
+            else{
+                type = "chimera";
+                chimeraRefSeq = myPerseus.stitchBimera(alignments, leftParentBi, rightParentBi, breakPointBi, leftMaps, rightMaps);
+            }
+            
+            if (params->m->getControl_pressed()) { return ""; }
+            
+            double chimeraDist = myPerseus.modeledPairwiseAlignSeqs(params->sequences[i].sequence, chimeraRefSeq, dummyA, dummyB, correctModel);
+            
+            if (params->m->getControl_pressed()) { return ""; }
+            
+            double cIndex = chimeraDist;//modeledPairwiseAlignSeqs(sequences[i].sequence, chimeraRefSeq);
+            double loonIndex = myPerseus.calcLoonIndex(params->sequences[i].sequence, params->sequences[leftParentBi].sequence, params->sequences[rightParentBi].sequence, breakPointBi, binMatrix);
+            
+            if (params->m->getControl_pressed()) { return ""; }
+            
+            chimeraFile << i << '\t' << params->sequences[i].seqName << '\t' << bestSingleDiff << '\t' << bestSingleIndex << '\t' << params->sequences[bestSingleIndex].seqName << '\t';
+            chimeraFile << minMismatchToChimera << '\t' << leftParentBi << '\t' << rightParentBi << '\t' << params->sequences[leftParentBi].seqName << '\t' << params->sequences[rightParentBi].seqName << '\t';
+            chimeraFile << singleDist << '\t' << cIndex << '\t' << (cIndex - singleDist) << '\t' << loonIndex << '\t';
+            chimeraFile << minMismatchToChimera << '\t' << minMismatchToTrimera << '\t' << breakPointBi << '\t';
+            
+            double probability = myPerseus.classifyChimera(singleDist, cIndex, loonIndex, params->alpha, params->beta);
+            
+            chimeraFile << probability << '\t';
+            
+            if(probability > params->cutoff){
+                chimeraFile << type << endl;
+                isChimera = true;
+            }
+            else{ chimeraFile << "good" << endl; }
+        }
+        else{
+            chimeraFile << i << '\t' << params->sequences[i].seqName << "\t0\t0\tNull\t0\t0\t0\tNull\tNull\t0.0\t0.0\t0.0\t0\t0\t0\t0.0\t0.0\tgood" << endl;
+        }
+        
+        return chimeraFile.str();
     }
-};
+    catch(exception& e) {
+        params->m->errorOut(e, "ChimeraPerseusCommand", "checkSequence");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+//checks sequences start+offset, start+offset+step, ... before end. Each thread has its own Perseus and buffers, so the alignment matrices and diffs are reused.
+void driverTier(perseusData* params, Perseus* myPerseus, perseusBuffers* buffers, int start, int end, int offset, int step, const vector<bool>* chimeras, vector<vector<double> >* correctModel, vector<vector<double> >* binMatrix, vector<string>* lines, vector<char>* isChimera){
+    try {
+        for (int i = start+offset; i < end; i += step) {
+            if (params->m->getControl_pressed()) { break; }
+            
+            bool chimera = false;
+            (*lines)[i-start] = checkSequence(params, *myPerseus, *buffers, i, *chimeras, *correctModel, *binMatrix, chimera);
+            (*isChimera)[i-start] = chimera;
+        }
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "ChimeraPerseusCommand", "driverTier");
+        exit(1);
+    }
+}
 //**********************************************************************************************************************
-//void driver(string chimeraFileName, vector<seqData>& sequences, string accnosFileName, int& numChimeras){
+/* A sequence is only compared to sequences at least twice as abundant, so the chimeras found among the sequences being
+ checked don't change the result of a sequence less than twice as abundant as them. The sequences are sorted by
+ abundance, and each tier where the first sequence is less than twice as abundant as the last is checked in parallel. */
 void driver(perseusData* params){
     try {
         vector<vector<double> > correctModel(4);	//could be an option in the future to input own model matrix
@@ -249,106 +339,58 @@ void driver(perseusData* params){
         params->util.openOutputFile(params->chimeraFileName, chimeraFile);
         params->util.openOutputFile(params->accnosFileName, accnosFile);
         
-        Perseus myPerseus;
-        vector<vector<double> > binMatrix = myPerseus.binomial(alignLength);
+        vector<Perseus> myPerseus(params->processors);
+        vector<perseusBuffers> buffers(params->processors);
+        for (int i = 0; i < params->processors; i++) { buffers[i].resize(numSeqs); }
+        vector<vector<double> > binMatrix = myPerseus[0].binomial(alignLength);
         
         chimeraFile << "SequenceIndex\tName\tDiffsToBestMatch\tBestMatchIndex\tBestMatchName\tDiffstToChimera\tIndexofLeftParent\tIndexOfRightParent\tNameOfLeftParent\tNameOfRightParent\tDistanceToBestMatch\tcIndex\t(cIndex - singleDist)\tloonIndex\tMismatchesToChimera\tMismatchToTrimera\tChimeraBreakPoint\tLogisticProbability\tTypeOfSequence\n";
         
         vector<bool> chimeras(numSeqs, 0);
         
-        for(int i=0;i<numSeqs;i++){
-            if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
-            
-            vector<bool> restricted = chimeras;
-            
-            vector<vector<int> > leftDiffs(numSeqs);
-            vector<vector<int> > leftMaps(numSeqs);
-            vector<vector<int> > rightDiffs(numSeqs);
-            vector<vector<int> > rightMaps(numSeqs);
+        int start = 0;
+        while (start < numSeqs) {
+            if (params->m->getControl_pressed()) { break; }
             
-            vector<int> singleLeft, bestLeft;
-            vector<int> singleRight, bestRight;
+            int end = start + 1;
+            while ((end < numSeqs) && ((end - start) < (100 * params->processors)) && (params->sequences[start].frequency < 2 * params->sequences[end].frequency)) { end++; }
             
-            int bestSingleIndex, bestSingleDiff;
-            vector<pwAlign> alignments(numSeqs);
+            vector<string> lines(end - start);
+            vector<char> isChimera(end - start, 0);
             
-            int comparisons = myPerseus.getAlignments(i, params->sequences, alignments, leftDiffs, leftMaps, rightDiffs, rightMaps, bestSingleIndex, bestSingleDiff, restricted);
-            if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
+            int numThreads = min(params->processors, end - start);
+            vector<std::thread*> workerThreads;
+            for (int i = 1; i < numThreads; i++) {
+                workerThreads.push_back(new std::thread(driverTier, params, &myPerseus[i], &buffers[i], start, end, i, numThreads, &chimeras, &correctModel, &binMatrix, &lines, &isChimera));
+            }
+            driverTier(params, &myPerseus[0], &buffers[0], start, end, 0, numThreads, &chimeras, &correctModel, &binMatrix, &lines, &isChimera);
             
-            int minMismatchToChimera, leftParentBi, rightParentBi, breakPointBi;
+            for (int i = 0; i < workerThreads.size(); i++) {
+                workerThreads[i]->join();
+                delete workerThreads[i];
+            }
             
-            string dummyA, dummyB;
+            if (params->m->getControl_pressed()) { break; }
             
-            if (params->sequences[i].sequence.size() < 3) {
-                chimeraFile << i << '\t' << params->sequences[i].seqName << "\t0\t0\tNull\t0\t0\t0\tNull\tNull\t0.0\t0.0\t0.0\t0\t0\t0\t0.0\t0.0\tgood" << endl;
-            }else if(comparisons >= 2){
-                minMismatchToChimera = myPerseus.getChimera(params->sequences, leftDiffs, rightDiffs, leftParentBi, rightParentBi, breakPointBi, singleLeft, bestLeft, singleRight, bestRight, restricted);
-                if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
-                
-                int minMismatchToTrimera = numeric_limits<int>::max();
-                int leftParentTri, middleParentTri, rightParentTri, breakPointTriA, breakPointTriB;
-                
-                if(minMismatchToChimera >= 3 && comparisons >= 3){
-                    minMismatchToTrimera = myPerseus.getTrimera(params->sequences, leftDiffs, leftParentTri, middleParentTri, rightParentTri, breakPointTriA, breakPointTriB, singleLeft, bestLeft, singleRight, bestRight, restricted);
-                    if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
-                }
-                
-                double singleDist = myPerseus.modeledPairwiseAlignSeqs(params->sequences[i].sequence, params->sequences[bestSingleIndex].sequence, dummyA, dummyB, correctModel);
-                
-                if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
-                
-                string type;
-                string chimeraRefSeq;
-                
-                if(minMismatchToChimera - minMismatchToTrimera >= 3){
-                    type = "trimera";
-                    chimeraRefSeq = myPerseus.stitchTrimera(alignments, leftParentTri, middleParentTri, rightParentTri, breakPointTriA, breakPointTriB, leftMaps, rightMaps);
-                }
-                else{
-                    type = "chimera";
-                    chimeraRefSeq = myPerseus.stitchBimera(alignments, leftParentBi, rightParentBi, breakPointBi, leftMaps, rightMaps);
-                }
-                
-                if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
-                
-                double chimeraDist = myPerseus.modeledPairwiseAlignSeqs(params->sequences[i].sequence, chimeraRefSeq, dummyA, dummyB, correctModel);
-                
-                if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
-                
-                double cIndex = chimeraDist;//modeledPairwiseAlignSeqs(sequences[i].sequence, chimeraRefSeq);
-                double loonIndex = myPerseus.calcLoonIndex(params->sequences[i].sequence, params->sequences[leftParentBi].sequence, params->sequences[rightParentBi].sequence, breakPointBi, binMatrix);
-                
-                if (params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); break; }
-                
-                chimeraFile << i << '\t' << params->sequences[i].seqName << '\t' << bestSingleDiff << '\t' << bestSingleIndex << '\t' << params->sequences[bestSingleIndex].seqName << '\t';
-                chimeraFile << minMismatchToChimera << '\t' << leftParentBi << '\t' << rightParentBi << '\t' << params->sequences[leftParentBi].seqName << '\t' << params->sequences[rightParentBi].seqName << '\t';
-                chimeraFile << singleDist << '\t' << cIndex << '\t' << (cIndex - singleDist) << '\t' << loonIndex << '\t';
-                chimeraFile << minMismatchToChimera << '\t' << minMismatchToTrimera << '\t' << breakPointBi << '\t';
-                
-                double probability = myPerseus.classifyChimera(singleDist, cIndex, loonIndex, params->alpha, params->beta);
-                
-                chimeraFile << probability << '\t';
-                
-                if(probability > params->cutoff){
-                    chimeraFile << type << endl;
+            for (int i = start; i < end; i++) {
+                chimeraFile << lines[i-start];
+                if (isChimera[i-start]) {
                     accnosFile << params->sequences[i].seqName << endl;
                     chimeras[i] = 1;
                     params->numChimeras++;
                 }
-                else{ chimeraFile << "good" << endl; }
-            }
-            else{
-                chimeraFile << i << '\t' << params->sequences[i].seqName << "\t0\t0\tNull\t0\t0\t0\tNull\tNull\t0.0\t0.0\t0.0\t0\t0\t0\t0.0\t0.0\tgood" << endl;
+                
+                //report progress
+                if((i+1) % 100 == 0){ 	params->m->mothurOutJustToScreen("Processing sequence: " + toString(i+1) + "\n");		}
+                params->count++; //# of sequences completed. Used by calling function to check for failure
             }
             
-            //report progress
-            if((i+1) % 100 == 0){ 	params->m->mothurOutJustToScreen("Processing sequence: " + toString(i+1) + "\n");		}
-            params->count++; //# of sequences completed. Used by calling function to check for failure
+            start = end;
         }
         
         if((numSeqs) % 100 != 0){ 	params->m->mothurOutJustToScreen("Processing sequence: " + toString(numSeqs) + "\n");		}
         
-        if (!params->m->getControl_pressed()) { chimeraFile.close(); accnosFile.close(); }
+        chimeraFile.close(); accnosFile.close();
     }
     catch(exception& e) {
         params->m->errorOut(e, "ChimeraPerseusCommand", "driver");
@@ -443,8 +485,6 @@ int ChimeraPerseusCommand::execute(){
                 if (m->getControl_pressed()) {   for (int j = 0; j < outputNames.size(); j++) {	util.mothurRemove(outputNames[j]);	}  return 0;  }
                 
             }else {
-                if (processors != 1) { m->mothurOut("Your count file does not contain group information, mothur can only use 1 processor, continuing.\n");  processors = 1; }
-                
                 //read sequences and store sorted by frequency
                 ct.readTable(countfile, false, false);
                 vector<seqData> sequences = readFiles(fastafile, ct.getNameMap());
@@ -453,6 +493,7 @@ int ChimeraPerseusCommand::execute(){
                 
                 perseusData* dataBundle = new perseusData(outputFileName, accnosFileName, alpha, beta, cutoff);
                 dataBundle->sequences = sequences;
+                dataBundle->processors = processors;
                 driver(dataBundle);
                 numSeqs = dataBundle->count; numChimeras = dataBundle->numChimeras;
                 delete dataBundle;
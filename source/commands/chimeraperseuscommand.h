@@ -20,6 +20,31 @@
 #include "myPerseus.h"
 #include "counttable.h"
 
+/***********************************************************/
+struct perseusData {
+    Utils util;
+    MothurOut* m;
+    vector<seqData> sequences;
+    string group;
+    int count, numChimeras, processors;
+    string chimeraFileName;
+    string accnosFileName;
+    double alpha, beta, cutoff;
+    
+    perseusData(string cf, string ac, double a, double b, double c){
+        m = MothurOut::getInstance();
+        count = 0;
+        numChimeras = 0;
+        processors = 1;
+        accnosFileName = ac;
+        chimeraFileName = cf;
+        alpha = a;
+        beta = b;
+        cutoff = c;
+    }
+};
+/***********************************************************/
+void driver(perseusData*);  //checks the sequences of a group, sorted by abundance, and writes the chimera and accnos files
 /***********************************************************/
 class ChimeraPerseusCommand : public Command {
 public:
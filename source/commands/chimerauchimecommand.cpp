@@ -10,7 +10,6 @@
 #include "chimerauchimecommand.h"
 #include "uniqueseqscommand.h"
 #include "sequence.hpp"
-#include "systemcommand.h"
 #include "removeseqscommand.h"
 
 //**********************************************************************************************************************
@@ -71,7 +70,7 @@ string ChimeraUchimeCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The chimera.uchime command reads a fastafile and referencefile and outputs potentially chimeric sequences.\n";
-		helpString += "This command is a wrapper for uchime written by Robert C. Edgar.\n";
+		helpString += "This command runs uchime written by Robert C. Edgar, which is built into mothur.\n";
 		helpString += "The chimera.uchime command parameters are fasta, name, count, reference, processors, dereplicate, removechimeras abskew, chimealns, minh, mindiv, xn, dn, xa, chunks, minchunk, idsmoothwindow, minsmoothid, maxp, skipgaps, skipgaps2, minlen, maxlen, ucl, strand and queryfact.\n";
 		helpString += "The fasta parameter allows you to enter the fasta file containing your potentially chimeric sequences, and is required, unless you have a valid current fasta file. \n";
 		helpString += "The name parameter allows you to provide a name file, if you are using template=self. \n";
@@ -79,9 +78,9 @@ string ChimeraUchimeCommand::getHelpString(){
 		helpString += "The group parameter allows you to provide a group file. The group file can be used with a namesfile and reference=self. When checking sequences, only sequences from the same group as the query sequence will be used as the reference. \n";
         helpString += "If the dereplicate parameter is false, then if one group finds the sequence to be chimeric, then all groups find it to be chimeric, default=f.\n";
 		helpString += "The reference parameter allows you to enter a reference file containing known non-chimeric sequences, and is required. You may also set template=self, in this case the abundant sequences will be used as potential parents. \n";
-		helpString += "The processors parameter allows you to specify how many processors you would like to use.  The default is 1. \n";
+		helpString += "The processors parameter allows you to specify the number of processors to use. The default is all available.\n";
         helpString += "The removechimeras parameter allows you to indicate you would like to automatically remove the sequences that are flagged as chimeric. Default=t.\n";
-        helpString += "The uchime parameter allows you to specify the name and location of your uchime executable. By default mothur will look in your path and mothur's executable and mothur tools locations.  You can set the uchime location as follows, uchime=/usr/bin/uchime.\n";
+        helpString += "The uchime parameter is no longer used, uchime is built into mothur.\n";
 		helpString += "The abskew parameter can only be used with template=self. Minimum abundance skew. Default 1.9. Abundance skew is: min [ abund(parent1), abund(parent2) ] / abund(query).\n";
 		helpString += "The chimealns parameter allows you to indicate you would like a file containing multiple alignments of query sequences to parents in human readable format. Alignments show columns with differences that support or contradict a chimeric model.\n";
 		helpString += "The minh parameter - mininum score to report chimera. Default 0.3. Values from 0.1 to 5 might be reasonable. Lower values increase sensitivity but may report more false positives. If you decrease xn you may need to increase minh, and vice versa.\n";
@@ -116,9 +115,6 @@ string ChimeraUchimeCommand::getCommonQuestions(){
     try {
         vector<string> questions, issues, qanswers, ianswers, howtos, hanswers;
         
-        string issue = "... uchime file does not exist. mothur requires the uchime executable."; issues.push_back(issue);
-        string ianswer = "\tThe chimera.uchime command is a wrapper for the uchime program, http://drive5.com/usearch/manual/uchime_algo.html. We distribute the uchime executable with the executable versions of mothur. By default, mothur will look for uchime in the same location mothur's executable is as well as looking in your $PATH variable.\n"; ianswers.push_back(ianswer);
-        
         string howto = "How do I use the dereplicate parameter?"; howtos.push_back(howto);
         string hanswer = "\tThe dereplicate parameter can be used when checking for chimeras by group. If the dereplicate parameter is false, then if one group finds the sequence to be chimeric, then all groups find it to be chimeric, default=f. If you set dereplicate=t, and then when a sequence is found to be chimeric it is removed from it’s group, not the entire dataset.\n\nNote: When you set dereplicate=t, mothur generates a new count table with the chimeras removed and counts adjusted by sample. It is important to note if you set dereplicate=true, do NOT include the count file with the remove.seqs command. For a detailed example, please reference https://mothur.org/wiki/chimera_dereplicate_example/\n"; hanswers.push_back(hanswer);
         
@@ -166,6 +162,8 @@ ChimeraUchimeCommand::ChimeraUchimeCommand(string option) : Command()  {
 			map<string,string> parameters = parser.getParameters();
 			
             ValidParameters validParameter;
+            if (parameters.count("uchime") != 0) { m->mothurOut("[WARNING]: The uchime parameter is no longer used, uchime is built into mothur. Ignoring.\n"); }
+            
             fastafile = validParameter.validFile(parameters, "fasta");
             if (fastafile == "not found") {
                 fastafile = current->getFastaFile();
@@ -243,6 +241,14 @@ ChimeraUchimeCommand::ChimeraUchimeCommand(string option) : Command()  {
 			queryfract = validParameter.valid(parameters, "queryfract");			if (queryfract == "not found")		{ useQueryfract = false; queryfract = "0.5";		}	else{ useQueryfract = true;		}
 			if (!ucl && useQueryfract) { m->mothurOut("queryfact may only be used when ucl=t, ignoring.\n");  useQueryfract = false; }
 			
+			//uchime exits if these aren't whole numbers
+			if (useChunks && !util.isPositiveNumeric(chunks))                   { m->mothurOut("[ERROR]: chunks must be a whole number, aborting.\n");            abort = true; }
+			if (useMinchunk && !util.isPositiveNumeric(minchunk))               { m->mothurOut("[ERROR]: minchunk must be a whole number, aborting.\n");          abort = true; }
+			if (useIdsmoothwindow && !util.isPositiveNumeric(idsmoothwindow))   { m->mothurOut("[ERROR]: idsmoothwindow must be a whole number, aborting.\n");    abort = true; }
+			if (useMaxp && !util.isPositiveNumeric(maxp))                       { m->mothurOut("[ERROR]: maxp must be a whole number, aborting.\n");              abort = true; }
+			if (useMinlen && !util.isPositiveNumeric(minlen))                   { m->mothurOut("[ERROR]: minlen must be a whole number, aborting.\n");            abort = true; }
+			if (useMaxlen && !util.isPositiveNumeric(maxlen))                   { m->mothurOut("[ERROR]: maxlen must be a whole number, aborting.\n");            abort = true; }
+			
 			temp = validParameter.valid(parameters, "skipgaps");					if (temp == "not found") { temp = "t"; }
 			skipgaps = util.isTrue(temp); 
 
@@ -261,31 +267,6 @@ ChimeraUchimeCommand::ChimeraUchimeCommand(string option) : Command()  {
             if (hasCount && (templatefile != "self")) { m->mothurOut("You have provided a countfile and the reference parameter is not set to self. I am not sure what reference you are trying to use, aborting.\n");  abort=true; }
 			if (hasGroup && (templatefile != "self")) { m->mothurOut("You have provided a group file and the reference parameter is not set to self. I am not sure what reference you are trying to use, aborting.\n");  abort=true; }
 			
-            vector<string> versionOutputs;
-            bool foundTool = false;
-            string programName = "uchime"; programName += EXECUTABLE_EXT;
-            
-            uchimeLocation = validParameter.validFile(parameters, "uchime");
-            if (uchimeLocation == "not found") {
-                uchimeLocation = "";
-                foundTool = util.findTool(programName, uchimeLocation, versionOutputs, current->getLocations());
-            }
-            else {
-                //test to make sure uchime exists
-                ifstream in;
-                uchimeLocation = util.getFullPathName(uchimeLocation);
-                foundTool = util.openInputFile(uchimeLocation, in, "no error"); in.close();
-                if(!foundTool) {
-                    m->mothurOut(uchimeLocation + " file does not exist or cannot be opened, ignoring.\n"); uchimeLocation = "";
-                    foundTool = util.findTool(programName, uchimeLocation, versionOutputs, current->getLocations());
-                }
-            }
-            
-            if (!foundTool) { abort = true; }
-            
-            uchimeLocation = util.getFullPathName(uchimeLocation);
-            if (m->getDebug()) { m->mothurOut("[DEBUG]: uchime location using " + uchimeLocation + "\n"); }
-            
             if (!abort) {
                 if ((namefile != "") || (groupfile != "")) { //convert to count
                     
@@ -315,22 +296,21 @@ struct uchimeData {
     string fastafile;
     string dupsfile;
     string outputFName;
-    string accnos, alns, formattedFastaFilename, templatefile, uchimeLocation;
+    string accnos, alns, templatefile;
     string driverAccnos, driverAlns, driverOutputFName;
     map<string, vector<string> > parsedFiles;
     map<string, vector<string> > seqs2RemoveByGroup;
     
-    int count, numChimeras;
+    int count, numChimeras, processors;
     vector<string> groups;
     uchimeVariables* vars;
     MothurOut* m;
     Utils util;
     
     uchimeData(){}
-    uchimeData(map<string, vector<string> > g2f, string o, string uloc, string t, string file, string f, string n, string ac,  string al, vector<string> gr, uchimeVariables* vs) {
+    uchimeData(map<string, vector<string> > g2f, string o, string t, string f, string n, string ac,  string al, vector<string> gr, uchimeVariables* vs, int p) {
         fastafile = f;
         dupsfile = n;
-        formattedFastaFilename = file;
         outputFName = o;
         templatefile = t;
         accnos = ac;
@@ -339,7 +319,7 @@ struct uchimeData {
         groups = gr;
         count = 0;
         numChimeras = 0;
-        uchimeLocation = uloc;
+        processors = p;
         vars = vs;
         driverAccnos = ac;
         driverAlns = al;
@@ -354,212 +334,56 @@ struct uchimeData {
     
 };
 //**********************************************************************************************************************
-int driver(uchimeData* params){
+//uchime queries for template=self, labeled with their abundance in order of decreasing abundance
+void getSelfQueries(vector<seqPriorityNode>& nameMapCount, vector<UChimeSeq>& queries){
+    sort(nameMapCount.begin(), nameMapCount.end(), compareSeqPriorityNodes);
+    
+    queries.resize(nameMapCount.size());
+    for (int i = 0; i < nameMapCount.size(); i++) {
+        queries[i].Label = nameMapCount[i].name + "/ab=" + toString(nameMapCount[i].numIdentical) + "/";
+        queries[i].Seq = nameMapCount[i].seq;
+    }
+}
+//**********************************************************************************************************************
+//runs uchime on the queries with params->processors threads, returns the number of sequences checked
+int driver(uchimeData* params, vector<UChimeSeq>& queries){
     try {
-        
-        params->driverOutputFName = params->util.getFullPathName(params->driverOutputFName);
-        params->formattedFastaFilename = params->util.getFullPathName(params->formattedFastaFilename);
-        params->driverAlns = params->util.getFullPathName(params->driverAlns);
-        
-        //to allow for spaces in the path
-        params->driverOutputFName = "\"" + params->driverOutputFName + "\"";
-        params->formattedFastaFilename = "\"" + params->formattedFastaFilename + "\"";
-        params->driverAlns = "\"" + params->driverAlns + "\"";
-        
-        if (params->formattedFastaFilename.length() > 257) {
-            params->m->mothurOut("[ERROR]: " + params->formattedFastaFilename + " filename is " + toString(params->formattedFastaFilename.length()) + " long. The uchime program can't handle files with a full path longer than 257 characters, please correct.\n"); params->m->setControl_pressed(true); return 0;
-        }else if ((params->driverAlns.length() > 257) && (params->vars->chimealns)) {
-            params->m->mothurOut("[ERROR]: " + params->driverAlns + " filename is " + toString(params->driverAlns.length()) + " long. The uchime program can't handle files with a full path longer than 257 characters, please correct.\n"); params->m->setControl_pressed(true); return 0;
-        }else if (params->driverOutputFName.length() > 257) {
-            params->m->mothurOut("[ERROR]: " + params->driverOutputFName + " filename is " + toString(params->driverOutputFName.length()) + " long. The uchime program can't handle files with a full path longer than 257 characters, please correct input file name.\n"); params->m->setControl_pressed(true); return 0;
-        }
-        
-        vector<char*> cPara;
-        
-        string uchimeCommand = params->uchimeLocation;
-        uchimeCommand = "\"" + uchimeCommand + "\" ";
-        cPara.push_back(params->util.mothurConvert(uchimeCommand));
-        
-        //are you using a reference file
-        if (params->templatefile != "self") {
-            string outputFileName = params->formattedFastaFilename.substr(1, params->formattedFastaFilename.length()-2) + ".uchime_formatted";
-            
-            ifstream in; params->util.openInputFile(params->formattedFastaFilename.substr(1, params->formattedFastaFilename.length()-2), in);
-            ofstream out; params->util.openOutputFile(outputFileName, out);
-            
-            while (!in.eof()) {
-                if (params->m->getControl_pressed()) { break;  }
-                
-                Sequence seq(in); gobble(in);
-                
-                if (seq.getName() != "") { seq.printSequence(out); }
-            }
-            in.close(); out.close();
-            
-            params->formattedFastaFilename = outputFileName;
-            params->formattedFastaFilename = "\"" + params->formattedFastaFilename + "\"";
-            
-            cPara.push_back(params->util.mothurConvert("--db"));
-            cPara.push_back(params->util.mothurConvert(params->templatefile));
-        }
-        
-        //input filename
-        cPara.push_back(params->util.mothurConvert("--input"));
-        cPara.push_back(params->util.mothurConvert(params->formattedFastaFilename));
-        
-        //output filename
-        cPara.push_back(params->util.mothurConvert("--uchimeout"));
-        cPara.push_back(params->util.mothurConvert(params->driverOutputFName));
-        
-        if (params->vars->chimealns) {
-            //output alns filename
-            cPara.push_back(params->util.mothurConvert("--uchimealns"));
-            cPara.push_back(params->util.mothurConvert(params->driverAlns));
-        }
-        
-        //strand
-        if (params->vars->strand != "") {
-            cPara.push_back(params->util.mothurConvert("--strand"));
-            cPara.push_back(params->util.mothurConvert(params->vars->strand));
-        }
-        
-        if (params->vars->useAbskew) {
-            cPara.push_back(params->util.mothurConvert("--abskew"));
-            cPara.push_back(params->util.mothurConvert(params->vars->abskew));
-        }
-        
-        if (params->vars->useMinH) {
-            cPara.push_back(params->util.mothurConvert("--minh"));
-            cPara.push_back(params->util.mothurConvert(params->vars->minh));
-        }
-        
-        if (params->vars->useMindiv) {
-            cPara.push_back(params->util.mothurConvert("--mindiv"));
-            cPara.push_back(params->util.mothurConvert(params->vars->mindiv));
-        }
-        
-        if (params->vars->useXn) {
-            cPara.push_back(params->util.mothurConvert("--xn"));
-            cPara.push_back(params->util.mothurConvert(params->vars->xn));
-        }
-        
-        if (params->vars->useDn) {
-            cPara.push_back(params->util.mothurConvert("--dn"));
-            cPara.push_back(params->util.mothurConvert(params->vars->dn));
+        vector<UChimeHit> hits;
+        string error = "";
+        if (!UChime(queries, params->processors, params->vars->chimealns, hits, error)) {
+            params->m->mothurOut("[ERROR]: uchime failed: " + error + "\n"); params->m->setControl_pressed(true); return 0;
         }
         
-        if (params->vars->useXa) {
-            cPara.push_back(params->util.mothurConvert("--xa"));
-            cPara.push_back(params->util.mothurConvert(params->vars->xa));
-        }
-        
-        if (params->vars->useChunks) {
-            cPara.push_back(params->util.mothurConvert("--chunks"));
-            cPara.push_back(params->util.mothurConvert(params->vars->chunks));
-        }
-        
-        if (params->vars->useMinchunk) {
-            cPara.push_back(params->util.mothurConvert("--minchunk"));
-            cPara.push_back(params->util.mothurConvert(params->vars->minchunk));
-        }
-        
-        if (params->vars->useIdsmoothwindow) {
-            cPara.push_back(params->util.mothurConvert("--idsmoothwindow"));
-            cPara.push_back(params->util.mothurConvert(params->vars->idsmoothwindow));
-        }
-        
-        if (params->vars->useMaxp) {
-            cPara.push_back(params->util.mothurConvert("--maxp"));
-            cPara.push_back(params->util.mothurConvert(params->vars->maxp));
-        }
-        
-        if (!params->vars->skipgaps) {
-            cPara.push_back(params->util.mothurConvert("--noskipgaps"));
-        }
-        
-        if (!params->vars->skipgaps2) {
-            cPara.push_back(params->util.mothurConvert("--noskipgaps2"));
-        }
-        
-        if (params->vars->useMinlen) {
-            cPara.push_back(params->util.mothurConvert("--minlen"));
-            cPara.push_back(params->util.mothurConvert(params->vars->minlen));
-        }
-        
-        if (params->vars->useMaxlen) {
-            cPara.push_back(params->util.mothurConvert("--maxlen"));
-            cPara.push_back(params->util.mothurConvert(params->vars->maxlen));
-        }
-        
-        if (params->vars->ucl) {
-            cPara.push_back(params->util.mothurConvert("--ucl"));
-        }
-        
-        if (params->vars->useQueryfract) {
-            cPara.push_back(params->util.mothurConvert("--queryfract"));
-            cPara.push_back(params->util.mothurConvert(params->vars->queryfract));
-        }
-        
-        
-        char** uchimeParameters;
-        uchimeParameters = new char*[cPara.size()];
-        string commandString = "";
-        for (int i = 0; i < cPara.size(); i++) {  uchimeParameters[i] = cPara[i];  commandString += toString(cPara[i]) + " "; }
-        
-        //int numArgs = cPara.size();
-        //uchime_main(numArgs, uchimeParameters);
-        
-#if defined NON_WINDOWS
-#else
-        commandString = "\"" + commandString + "\"";
-#endif
-        if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: uchime command = " + commandString + ".\n"); }
-        system(commandString.c_str());
-        
-        //free memory
-        for(int i = 0; i < cPara.size(); i++)  {  delete cPara[i];  }
-        delete[] uchimeParameters;
-        
-        //remove "" from filenames
-        params->driverOutputFName = params->driverOutputFName.substr(1, params->driverOutputFName.length()-2);
-        params->formattedFastaFilename = params->formattedFastaFilename.substr(1, params->formattedFastaFilename.length()-2);
-        params->driverAlns = params->driverAlns.substr(1, params->driverAlns.length()-2);
-        
         if (params->m->getControl_pressed()) { return 0; }
         
-        //create accnos file from uchime results
-        ifstream in; params->util.openInputFile(params->driverOutputFName, in);
-        ofstream out; params->util.openOutputFile(params->driverAccnos, out);
+        //create output and accnos file from uchime results
+        ofstream out; params->util.openOutputFile(params->driverOutputFName, out);
+        ofstream outAccnos; params->util.openOutputFile(params->driverAccnos, outAccnos);
+        ofstream outAlns; if (params->vars->chimealns) { params->util.openOutputFile(params->driverAlns, outAlns); }
         
-        int num = 0;
         params->numChimeras = 0;
-        while(!in.eof()) {
+        for (int i = 0; i < hits.size(); i++) {
             
             if (params->m->getControl_pressed()) { break; }
             
-            string name = ""; string chimeraFlag = "";
-            
-            string line = params->util.getline(in); gobble(in);
+            out << hits[i].Line;
+            if (params->vars->chimealns) { outAlns << hits[i].Alns; }
             
-            vector<string> pieces = params->util.splitWhiteSpace(line);
-            if (pieces.size() > 2) {
-                name = pieces[1];
+            if (hits[i].Chimera) {
+                string name = hits[i].Label.substr(0, hits[i].Label.find_first_of(" \t"));
                 //fix name if needed
                 if (params->templatefile == "self") {
                     name = name.substr(0, name.length()-1); //rip off last /
                     name = name.substr(0, name.find_last_of('/'));
                 }
-                
-                chimeraFlag = pieces[pieces.size()-1];
+                outAccnos << name << endl; params->numChimeras++;
             }
-            
-            if (chimeraFlag == "Y") { out << name << endl; params->numChimeras++; }
-            num++;
         }
-        in.close();
         out.close();
+        outAccnos.close();
+        if (params->vars->chimealns) { outAlns.close(); }
         
-        return num;
+        return hits.size();
     }
     catch(exception& e) {
         params->m->errorOut(e, "ChimeraUchimeCommand", "driver");
@@ -578,6 +402,10 @@ int ChimeraUchimeCommand::execute(){
         vars = new uchimeVariables();
         vars->setBooleans(dups, useAbskew, chimealns, useMinH, useMindiv, useXn, useDn, useXa, useChunks, useMinchunk, useIdsmoothwindow, useMinsmoothid, useMaxp, skipgaps, skipgaps2, useMinlen, useMaxlen, ucl, useQueryfract, hasCount);
         vars->setVariables(abskew, minh, mindiv, xn, dn, xa, chunks, minchunk, idsmoothwindow, minsmoothid, maxp, minlen, maxlen, queryfract, strand);
+        
+        //uchime's options are shared by all threads, so they are set before any are started
+        string uchimeError = "";
+        if (!UChimeSetOpts(vars->getOptions(templatefile), uchimeError)) { m->mothurOut("[ERROR]: " + uchimeError + ", aborting.\n"); delete vars; return 0; }
 
         m->mothurOut("Checking sequences from " + fastafile + " ...\n" ); 
         
@@ -590,7 +418,6 @@ int ChimeraUchimeCommand::execute(){
         string outputFileName = getOutputFileName("chimera", variables);
         string accnosFileName = getOutputFileName("accnos", variables);
         string alnsFileName = getOutputFileName("alns", variables);
-        string newFasta = util.getRootName(fastafile) + "temp";
         string newCountFile = "";
         
         //you provided a groupfile
@@ -603,10 +430,9 @@ int ChimeraUchimeCommand::execute(){
             newCountFile = getOutputFileName("count", variables);
         }
         
+        vector<UChimeSeq> queries;
         if ((templatefile == "self") && (!hasGroups)) { //you want to run uchime with a template=self and no groups
             
-            if (processors != 1) { m->mothurOut("When using template=self, mothur can only use 1 processor, continuing.\n"); processors = 1; }
-            
             if (hasCount) { }
             else { countfile = getCountFile(fastafile); hasCount = true; }
             
@@ -634,8 +460,21 @@ int ChimeraUchimeCommand::execute(){
             if (error == 1) { for (int j = 0; j < outputNames.size(); j++) {	util.mothurRemove(outputNames[j]);	}  return 0; }
             if (seqs.size() != nameMapCount.size()) { m->mothurOut( "The number of sequences in your fastafile does not match the number of sequences in your countfile, aborting.\n"); for (int j = 0; j < outputNames.size(); j++) {	util.mothurRemove(outputNames[j]);	}  return 0; }
             
-            util.printVsearchFile(nameMapCount, newFasta, "/ab=", "/");
-            fastafile = newFasta;
+            getSelfQueries(nameMapCount, queries);
+        }else if (templatefile != "self") {
+            ifstream in; util.openInputFile(fastafile, in);
+            
+            while (!in.eof()) {
+                if (m->getControl_pressed()) { break;  }
+                
+                Sequence seq(in); gobble(in);
+                
+                if (seq.getName() != "") {
+                    UChimeSeq query; query.Label = seq.getName() + seq.getComment(); query.Seq = seq.getAligned();
+                    queries.push_back(query);
+                }
+            }
+            in.close();
         }
         
         if (m->getControl_pressed()) {  for (int j = 0; j < outputNames.size(); j++) {	util.mothurRemove(outputNames[j]);	} delete vars; return 0;	}
@@ -661,7 +500,7 @@ int ChimeraUchimeCommand::execute(){
             if (chimealns) { util.openOutputFile(alnsFileName, out2); out2.close(); }
             
             map<string, vector<string> > seqs2RemoveByGroup;
-            int totalSeqs = createProcessesGroups(group2Files, outputFileName, newFasta, accnosFileName, alnsFileName, groups, seqs2RemoveByGroup);
+            int totalSeqs = createProcessesGroups(group2Files, outputFileName, accnosFileName, alnsFileName, groups, seqs2RemoveByGroup);
             
             if (hasCount && dups) {
                 CountTable newCount; newCount.readTable(countfile, true, false);
@@ -707,9 +546,9 @@ int ChimeraUchimeCommand::execute(){
             int numChimeras = 0;
             map<string, vector<string> > dummy;
             
-            uchimeData* dataBundle = new uchimeData(dummy, outputFileName, uchimeLocation, templatefile, fastafile, fastafile, countfile, accnosFileName, alnsFileName, nullVector, vars);
+            uchimeData* dataBundle = new uchimeData(dummy, outputFileName, templatefile, fastafile, countfile, accnosFileName, alnsFileName, nullVector, vars, processors);
             
-            numSeqs = driver(dataBundle);
+            numSeqs = driver(dataBundle, queries);
             numChimeras = dataBundle->numChimeras;
             delete dataBundle;
             
@@ -724,9 +563,6 @@ int ChimeraUchimeCommand::execute(){
             
             if (m->getControl_pressed()) { for (int j = 0; j < outputNames.size(); j++) {	util.mothurRemove(outputNames[j]);	} delete vars; return 0; }
             
-            //remove file made for uchime
-            if (templatefile == "self") {  util.mothurRemove(fastafile); }
-            
             m->mothurOut("\nIt took " + toString(time(nullptr) - start) + " secs to check " + toString(numSeqs) + " sequences. " + toString(numChimeras) + " chimeras were found.\n");
         }
         
@@ -1111,7 +947,7 @@ string ChimeraUchimeCommand::getCountFile(string& inputFile){
 }
 //**********************************************************************************************************************
 
-int getSeqs(map<string, int>& nameMap, string thisGroupsFormattedOutputFilename, string tag, string tag2, long long& numSeqs, string thisGroupsFastaFile, MothurOut* m){
+int getSeqs(map<string, int>& nameMap, vector<UChimeSeq>& queries, long long& numSeqs, string thisGroupsFastaFile, MothurOut* m){
     try {
         int error = 0;
         ifstream in; Utils util; util.openInputFile(thisGroupsFastaFile, in);
@@ -1141,7 +977,7 @@ int getSeqs(map<string, int>& nameMap, string thisGroupsFormattedOutputFilename,
         
         numSeqs = nameVector.size();
         
-        util.printVsearchFile(nameVector, thisGroupsFormattedOutputFilename, tag, tag2);
+        getSelfQueries(nameVector, queries);
         
         return error;
     }
@@ -1171,19 +1007,16 @@ void driverGroups(uchimeData* params){
             }
             else { nameMap = params->util.readNames(it->second[1]); }
             
-            error = getSeqs(nameMap, params->formattedFastaFilename, "/ab=", "/", numSeqs, it->second[0], params->m); if ((error == 1) || params->m->getControl_pressed()) {  break; }
+            vector<UChimeSeq> queries;
+            error = getSeqs(nameMap, queries, numSeqs, it->second[0], params->m); if ((error == 1) || params->m->getControl_pressed()) {  break; }
             
 			totalSeqs += numSeqs;
             
             params->setDriverNames((params->outputFName + thisGroup), (params->alns+thisGroup), (params->accnos+thisGroup));
-			driver(params);
+			driver(params, queries);
 			
             if (params->m->getControl_pressed()) { break; }
 			
-			//remove file made for uchime
-			if (!params->m->getDebug()) {  params->util.mothurRemove(params->formattedFastaFilename);  }
-            else { params->m->mothurOut("[DEBUG]: saving file: " + params->formattedFastaFilename + ".\n"); }
-			
             //if we provided a count file with group info and set dereplicate=t, then we want to create a *.pick.count_table
             //This table will zero out group counts for seqs determined to be chimeric by that group.
             if (params->vars->dups) {
@@ -1237,11 +1070,17 @@ void driverGroups(uchimeData* params){
 }	
 /**************************************************************************************************/
 
-int ChimeraUchimeCommand::createProcessesGroups(map<string, vector<string> >& groups2Files, string outputFName, string filename, string accnos, string alns, vector<string> groups, map<string, vector<string> >& seqs2RemoveByGroup) {
+int ChimeraUchimeCommand::createProcessesGroups(map<string, vector<string> >& groups2Files, string outputFName, string accnos, string alns, vector<string> groups, map<string, vector<string> >& seqs2RemoveByGroup) {
 	try {
+        //each group is checked on one thread, and the processors left over check the queries of a group in parallel
+        int totalProcessors = processors;
+        
         //sanity check
         if (groups.size() < processors) { processors = groups.size(); m->mothurOut("Reducing processors to " + toString(groups.size()) + ".\n"); }
         
+        vector<int> threadsPerGroup(processors, totalProcessors / processors);
+        for (int i = 0; i < (totalProcessors % processors); i++) { threadsPerGroup[i]++; }
+        
         //divide the groups between the processors
         vector<linePair> lines;
         int remainingPairs = groups.size();
@@ -1276,7 +1115,7 @@ int ChimeraUchimeCommand::createProcessesGroups(map<string, vector<string> >& gr
                 }
                 else { m->mothurOut("[ERROR]: missing files for group " + groups[j] + ", skipping\n"); }
             }
-            uchimeData* dataBundle = new uchimeData(thisGroupsParsedFiles, outputFName+extension, uchimeLocation, templatefile, filename+extension, fastafile, countfile,  accnos+extension, alns+extension, thisGroups, vars);
+            uchimeData* dataBundle = new uchimeData(thisGroupsParsedFiles, outputFName+extension, templatefile, fastafile, countfile,  accnos+extension, alns+extension, thisGroups, vars, threadsPerGroup[i+1]);
             data.push_back(dataBundle);
             
             workerThreads.push_back(new std::thread(driverGroups, dataBundle));
@@ -1292,7 +1131,7 @@ int ChimeraUchimeCommand::createProcessesGroups(map<string, vector<string> >& gr
             }
             else { m->mothurOut("[ERROR]: missing files for group " + groups[j] + ", skipping\n"); }
         }
-        uchimeData* dataBundle = new uchimeData(thisGroupsParsedFiles, outputFName, uchimeLocation, templatefile, filename, fastafile, countfile, accnos, alns, thisGroups, vars);
+        uchimeData* dataBundle = new uchimeData(thisGroupsParsedFiles, outputFName, templatefile, fastafile, countfile, accnos, alns, thisGroups, vars, threadsPerGroup[0]);
         driverGroups(dataBundle);
         num = dataBundle->count;
         int numChimeras = dataBundle->numChimeras;
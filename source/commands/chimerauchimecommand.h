@@ -15,6 +15,7 @@
 #include "sequenceparser.h"
 #include "counttable.h"
 #include "sequencecountparser.h"
+#include "uchimelib.h"
 
 /***********************************************************/
 struct uchimeVariables {
@@ -62,6 +63,33 @@ struct uchimeVariables {
         maxlen = maxle;
         queryfract = queryfrac;
     }
+    
+    //uchime command line options, without the input and output files
+    vector<string> getOptions(string templatefile) {
+        vector<string> options;
+        options.push_back("--quiet");
+        
+        if (templatefile != "self")     { options.push_back("--db");            options.push_back(templatefile);    }
+        if (strand != "")               { options.push_back("--strand");        options.push_back(strand);          }
+        if (useAbskew)                  { options.push_back("--abskew");        options.push_back(abskew);          }
+        if (useMinH)                    { options.push_back("--minh");          options.push_back(minh);            }
+        if (useMindiv)                  { options.push_back("--mindiv");        options.push_back(mindiv);          }
+        if (useXn)                      { options.push_back("--xn");            options.push_back(xn);              }
+        if (useDn)                      { options.push_back("--dn");            options.push_back(dn);              }
+        if (useXa)                      { options.push_back("--xa");            options.push_back(xa);              }
+        if (useChunks)                  { options.push_back("--chunks");        options.push_back(chunks);          }
+        if (useMinchunk)                { options.push_back("--minchunk");      options.push_back(minchunk);        }
+        if (useIdsmoothwindow)          { options.push_back("--idsmoothwindow"); options.push_back(idsmoothwindow); }
+        if (useMaxp)                    { options.push_back("--maxp");          options.push_back(maxp);            }
+        if (!skipgaps)                  { options.push_back("--noskipgaps");                                        }
+        if (!skipgaps2)                 { options.push_back("--noskipgaps2");                                       }
+        if (useMinlen)                  { options.push_back("--minlen");        options.push_back(minlen);          }
+        if (useMaxlen)                  { options.push_back("--maxlen");        options.push_back(maxlen);          }
+        if (ucl)                        { options.push_back("--ucl");                                               }
+        if (useQueryfract)              { options.push_back("--queryfract");    options.push_back(queryfract);      }
+        
+        return options;
+    }
 };
 
 /***********************************************************/
@@ -86,7 +114,7 @@ public:
 	
 private:
 	bool abort, useAbskew, chimealns, useMinH, useMindiv, useXn, useDn, useXa, useChunks, useMinchunk, useIdsmoothwindow, useMinsmoothid, useMaxp, skipgaps, skipgaps2, useMinlen, useMaxlen, ucl, useQueryfract, hasCount, dups, removeChimeras;
-	string fastafile, templatefile, countfile, abskew, minh, mindiv, xn, dn, xa, chunks, minchunk, idsmoothwindow, minsmoothid, maxp, minlen, maxlen, queryfract, uchimeLocation, strand;
+	string fastafile, templatefile, countfile, abskew, minh, mindiv, xn, dn, xa, chunks, minchunk, idsmoothwindow, minsmoothid, maxp, minlen, maxlen, queryfract, strand;
 	int processors;
 	vector<string> outputNames;
     uchimeVariables* vars;
@@ -94,7 +122,7 @@ private:
 	string getCountFile(string&);
 	int readFasta(string, map<string, string>&);
 	int deconvoluteResults(string, string, string);
-	int createProcessesGroups(map<string, vector<string> >&, string, string, string, string, vector<string>, map<string, vector<string> >&);
+	int createProcessesGroups(map<string, vector<string> >&, string, string, string, vector<string>, map<string, vector<string> >&);
 };
 /**************************************************************************************************/
 
@@ -8,6 +8,7 @@
  */
 
 #include "classifyseqscommand.h"
+#include "sequencepipeline.hpp"
 
 
 
@@ -316,7 +317,6 @@ int ClassifySeqsCommand::execute(){
         variables["[tag2]"] = outputMethodTag;
         string newTaxonomyFile = getOutputFileName("taxonomy", variables);
         string newaccnosFile = getOutputFileName("accnos", variables);
-        string tempTaxonomyFile = outputdir + util.getRootName(util.getSimpleName(fastafile)) + "taxonomy.temp";
         string taxSummary = getOutputFileName("taxsummary", variables);
         
         if ((method == "knn") && (search == "distance")) {
@@ -328,7 +328,7 @@ int ClassifySeqsCommand::execute(){
         outputNames.push_back(taxSummary);	outputTypes["taxsummary"].push_back(taxSummary);
         
         long start = time(nullptr);
-        int numFastaSeqs = createProcesses(newTaxonomyFile, tempTaxonomyFile, newaccnosFile, fastafile);
+        int numFastaSeqs = createProcesses(newTaxonomyFile, newaccnosFile, fastafile);
         
         if (!util.isBlank(newaccnosFile)) { m->mothurOut("\n[WARNING]: mothur reversed some your sequences for a better classification.  If you would like to take a closer look, please check " + newaccnosFile + " for the list of the sequences.\n");
             outputNames.push_back(newaccnosFile); outputTypes["accnos"].push_back(newaccnosFile);
@@ -412,7 +412,6 @@ int ClassifySeqsCommand::execute(){
         
         if (ct != nullptr) { delete ct; }
         if (groupMap != nullptr) { delete groupMap; } delete taxaSum;
-        util.mothurRemove(tempTaxonomyFile);
         delete classify;
         
         m->mothurOut("\nIt took " + toString(time(nullptr) - start) + " secs to create the summary file for " + toString(numFastaSeqs) + " sequences.\n\n");
@@ -438,165 +437,61 @@ int ClassifySeqsCommand::execute(){
 	}
 }
 /**************************************************************************************************/
-struct classifyData {
-    OutputWriter* taxTWriter;
-    OutputWriter* taxWriter;
-    OutputWriter* accnosWriter;
-    string search, taxonomyFileName, templateFileName, method, filename;
-    unsigned long long start;
-    unsigned long long end;
-    MothurOut* m;
-    Classify* classify;
-    float match, misMatch, gapOpen, gapExtend;
-    int count, kmerSize, threadID, cutoff, iters, numWanted;
-    bool probs, flip, writeShortcuts;
-    Utils util;
+//the classifier is shared by the threads
+class ClassifyWorker : public PipelineWorker {
+public:
+    ClassifyWorker(Classify* c, bool p) : classify(c), probs(p) {}
+    ~ClassifyWorker() = default;
     
-    classifyData(){}
-    classifyData(OutputWriter* acc, bool p, OutputWriter* a, OutputWriter* r, string f, unsigned long long st, unsigned long long en, bool fli, Classify* c) {
-        accnosWriter = acc;
-        taxWriter = a;
-        taxTWriter = r;
-        filename = f;
-        m = MothurOut::getInstance();
-        start = st;
-        end = en;
-        probs = p;
-        flip = fli;
-        count = 0;
-        classify = c;
-    }
+    void process(PipelineBatch*);  //output 0 is the taxonomy and 1 the flipped accnos
+    
+private:
+    Classify* classify;
+    bool probs;
 };
 //**********************************************************************************************************************
-void driverClassifier(classifyData* params){
+void ClassifyWorker::process(PipelineBatch* batch){
     try {
-        ifstream inFASTA; params->util.openInputFile(params->filename, inFASTA); inFASTA.seekg(params->start);
-        
-        string taxonomy;
-        bool done = false;
-        string taxBuffer = ""; string taxTBuffer = ""; string accnosBuffer = "";
-        while (!done) {
-            if (params->m->getControl_pressed()) { break; }
+        for (int i = 0; i < batch->seqs.size(); i++) {
+            if (m->getControl_pressed()) { break; }
             
-            Sequence* candidateSeq = new Sequence(inFASTA); gobble(inFASTA);
+            Sequence* candidateSeq = &batch->seqs[i];
             
-            if (candidateSeq->getName() != "") {
-                
-                string simpleTax = ""; bool flipped = false;
-                taxonomy = params->classify->getTaxonomy(candidateSeq, simpleTax, flipped);
-                
-                if (params->m->getControl_pressed()) { delete candidateSeq; break; }
-                
-                if (taxonomy == "unknown;") { params->m->mothurOut("[WARNING]: " + candidateSeq->getName() + " could not be classified. You can use the remove.lineage command with taxon=unknown; to remove such sequences.\n");  }
-                
-                //output confidence scores or not
-                if (params->probs)  { taxBuffer += candidateSeq->getName() + '\t' + taxonomy + '\n';    }
-                else                { taxBuffer += candidateSeq->getName() + '\t' + simpleTax + '\n';   }
-                
-                if (flipped) { accnosBuffer += candidateSeq->getName() + '\n'; }
-                
-                taxTBuffer = candidateSeq->getName() + '\t' + simpleTax + '\n';
-                
-                params->count++;
-            }
-            delete candidateSeq;
+            string simpleTax = ""; bool flipped = false;
+            string taxonomy = classify->getTaxonomy(candidateSeq, simpleTax, flipped);
             
-            //report progress
-            if((params->count) % 100 == 0){
-                params->m->mothurOutJustToScreen(toString(params->count) +"\n");
-                params->taxTWriter->write(taxTBuffer); taxTBuffer = "";
-                params->taxWriter->write(taxBuffer); taxBuffer = "";
-                if (accnosBuffer != "") { params->accnosWriter->write(accnosBuffer); accnosBuffer = ""; }
-            }
+            if (m->getControl_pressed()) { break; }
             
-#if defined NON_WINDOWS
-            unsigned long long pos = inFASTA.tellg();
-            if ((pos == -1) || (pos >= params->end)) { break; }
-#else
-            if (params->count == params->end) { break; }
-#endif
+            if (taxonomy == "unknown;") { m->mothurOut("[WARNING]: " + candidateSeq->getName() + " could not be classified. You can use the remove.lineage command with taxon=unknown; to remove such sequences.\n");  }
             
-    }
-        //report progress
-        if((params->count) % 100 != 0){
-            params->m->mothurOutJustToScreen(toString(params->count)+"\n");
-            params->taxTWriter->write(taxTBuffer); taxTBuffer = "";
-            params->taxWriter->write(taxBuffer); taxBuffer = "";
-            if (accnosBuffer != "") { params->accnosWriter->write(accnosBuffer); accnosBuffer = ""; }
+            //output confidence scores or not
+            if (probs)  { batch->output[0] += candidateSeq->getName() + '\t' + taxonomy + '\n';    }
+            else        { batch->output[0] += candidateSeq->getName() + '\t' + simpleTax + '\n';   }
+            
+            if (flipped) { batch->output[1] += candidateSeq->getName() + '\n'; }
         }
-        
-        inFASTA.close();
     }
     catch(exception& e) {
-        params->m->errorOut(e, "ClassifySeqsCommand", "driver");
+        m->errorOut(e, "ClassifySeqsCommand", "driver");
         exit(1);
     }
 }
 /**************************************************************************************************/
 
-int ClassifySeqsCommand::createProcesses(string taxFileName, string tempTaxFile, string accnos, string filename) {
+int ClassifySeqsCommand::createProcesses(string taxFileName, string accnos, string filename) {
 	try {
-        //create array of worker threads
-        vector<std::thread*> workerThreads;
-        vector<classifyData*> data;
-        
-        long long num = 0;
-
-        vector<double> positions;
-        vector<linePair> lines;
-#if defined NON_WINDOWS
-        positions = util.divideFile(filename, processors);
-        for (int i = 0; i < (positions.size()-1); i++) {	lines.push_back(linePair(positions[i], positions[(i+1)]));	}
-#else
-        positions = util.setFilePosFasta(filename, num);
-        if (num < processors) { processors = num; }
-            
-        //figure out how many sequences you have to process
-        int numSeqsPerProcessor = num / processors;
-        for (int i = 0; i < processors; i++) {
-            int startIndex =  i * numSeqsPerProcessor;
-            if(i == (processors - 1)){	numSeqsPerProcessor = num - i * numSeqsPerProcessor; 	}
-            lines.push_back(linePair(positions[startIndex], numSeqsPerProcessor));
-        }
-#endif
-        auto synchronizedAccnosFile = std::make_shared<SynchronizedOutputFile>(accnos);
-        auto synchronizedTaxFile = std::make_shared<SynchronizedOutputFile>(taxFileName);
-        auto synchronizedTaxTFile = std::make_shared<SynchronizedOutputFile>(tempTaxFile);
-
-        //Lauch worker threads
-        for (int i = 0; i < processors-1; i++) {
-            OutputWriter* threadTaxWriter = new OutputWriter(synchronizedTaxFile);
-            OutputWriter* threadTaxTWriter = new OutputWriter(synchronizedTaxTFile);
-            OutputWriter* threadAccnosWriter = new OutputWriter(synchronizedAccnosFile);
-            
-            classifyData* dataBundle = new classifyData(threadAccnosWriter, probs, threadTaxWriter, threadTaxTWriter, filename, lines[i+1].start, lines[i+1].end, flip, classify);
-            data.push_back(dataBundle);
-            
-            workerThreads.push_back(new std::thread(driverClassifier, dataBundle));
-        }
+        vector<PipelineWorker*> workers;
+        for (int i = 0; i < processors; i++) { workers.push_back(new ClassifyWorker(classify, probs)); }
         
-        OutputWriter* threadTaxWriter = new OutputWriter(synchronizedTaxFile);
-        OutputWriter* threadTaxTWriter = new OutputWriter(synchronizedTaxTFile);
-        OutputWriter* threadAccnosWriter = new OutputWriter(synchronizedAccnosFile);
+        ofstream outTax; util.openOutputFile(taxFileName, outTax);
+        ofstream outAccnos; util.openOutputFile(accnos, outAccnos);
+        vector<ostream*> outputs; outputs.push_back(&outTax); outputs.push_back(&outAccnos);
         
-        classifyData* dataBundle = new classifyData(threadAccnosWriter, probs, threadTaxWriter, threadTaxTWriter, filename, lines[0].start, lines[0].end, flip, classify);
-        driverClassifier(dataBundle);
-        num = dataBundle->count;
+        SequencePipeline pipeline(filename);
+        long long num = pipeline.run(workers, outputs);
         
-        for (int i = 0; i < processors-1; i++) {
-            workerThreads[i]->join();
-            num += data[i]->count;
-            
-            delete data[i]->taxTWriter;
-            delete data[i]->taxWriter;
-            delete data[i]->accnosWriter;
-
-            delete data[i];
-            delete workerThreads[i];
-        }
-        synchronizedTaxTFile->close(); synchronizedTaxFile->close(); synchronizedAccnosFile->close();
-        delete threadTaxWriter; delete threadTaxTWriter; delete threadAccnosWriter;
-        delete dataBundle;
+        outTax.close(); outAccnos.close();
+        for (int i = 0; i < workers.size(); i++) { delete workers[i]; }
         
         return num;
 	}
@@ -63,7 +63,7 @@ private:
 	float match, misMatch, gapOpen, gapExtend;
 	bool abort, probs, save, flip, hasName, hasCount, writeShortcuts, relabund;
 	
-	int createProcesses(string, string, string, string); 
+	int createProcesses(string, string, string); 
 };
 
 /**************************************************************************************************/
@@ -718,7 +718,7 @@ ListVector* ClusterFitCommand::clusterRefs(OptiData*& refsMatrix, ClusterMetric*
         
         ListVector* list = nullptr;
         
-        OptiCluster cluster(refsMatrix, metric, 0);
+        OptiCluster cluster(refsMatrix, metric, 0, 1);
         
         int iters = 0;
         double listVectorMetric = 0; //worst state
@@ -97,7 +97,7 @@ string ClusterSplitCommand::getHelpString(){
 		helpString += "The method parameter allows you to enter your clustering mothod. Options are furthest, nearest, average, weighted, agc, dgc and opti. Default=opti.  The agc and dgc methods require a fasta file.";
         helpString += "The taxlevel parameter allows you to specify the taxonomy level you want to use to split the dataset, default=3.\n";
         helpString += "The classic parameter allows you to indicate that you want to run your files with cluster.classic. Default=f.\n";
-        helpString += "The processors parameter allows you to specify the number of processors to use. The default is all available.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use. The default is all available. When you set processors and there are fewer distance files than processors, the opti method uses the extra processors to cluster each file, which may give slightly different OTUs.\n";
          helpString += "The vsearch parameter allows you to specify the name and location of your vsearch executable if using agc or dgc clustering methods. By default mothur will look in your path, mothur's executable and mothur tools locations.  You can set the vsearch location as follows, vsearch=/usr/bin/vsearch.\n";
 		helpString += "The cluster.split command should be in the following format: \n";
 		helpString += "cluster.split(fasta=yourFastaFile, count=yourCountFile, method=yourMethod, cutoff=yourCutoff, taxonomy=yourTaxonomyfile, taxlevel=yourtaxlevel) \n";
@@ -241,7 +241,8 @@ ClusterSplitCommand::ClusterSplitCommand(string option) : Command()  {
 			length = temp.length();
 			util.mothurConvert(temp, precision); 
 			
-			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			setProcessors = true;
+			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	setProcessors = false;	temp = current->getProcessors();	}
 			processors = current->setProcessors(temp);
 			
             temp = validParameter.valid(parameters, "classic");			if (temp == "not found") { temp = "F"; }
@@ -714,7 +715,7 @@ int ClusterSplitCommand::mergeLists(vector<string> listNames, map<double, int> u
 struct clusterData {
     MothurOut* m;
     Utils util;
-    int count, precision, length, maxIters; //numSingletons,
+    int count, precision, length, maxIters, optiProcessors; //numSingletons,
     bool showabund, classic, useName, useCount, deleteFiles, cutoffNotSet;
     double cutoff, stableMetric;
     ofstream outList, outRabund, outSabund;
@@ -741,13 +742,15 @@ struct clusterData {
         type = ty;
         useName = false;
         useCount = false;
+        optiProcessors = 1;
         //numSingletons = 0;
     }
-    void setOptiOptions(string metn, double stabMet, string init, int mxi ) {
+    void setOptiOptions(string metn, double stabMet, string init, int mxi, int op) {
         metricName = metn;
         stableMetric = stabMet;
         maxIters = mxi;
         initialize = init;
+        optiProcessors = op;
     }
     void setNamesCount(string cnf) {
         useName = false;
@@ -908,7 +911,7 @@ string runOptiCluster(string thisDistFile, string thisNamefile, double& smallest
         else if (params->metricName == "fdr")        { metric = new FDR();              }
         else if (params->metricName == "fpfn")       { metric = new FPFN();             }
         
-        OptiCluster cluster(&matrix, metric, 0);
+        OptiCluster cluster(&matrix, metric, 0, params->optiProcessors);
         params->tag = cluster.getTag();
         
         params->m->mothurOut("\nClustering " + thisDistFile + "\n");
@@ -1324,8 +1327,12 @@ void printData(ListVector* oldList, clusterData* params){
 //**********************************************************************************************************************
 vector<string> ClusterSplitCommand::createProcesses(vector< map<string, string> > distName, set<string>& labels){
 	try {
-        //sanity check
-        if (processors > distName.size()) { processors = distName.size(); }
+        //sanity check, when asked for, extra processors go to the opti clustering of each file. batch moves change the OTUs, so only then
+        int optiProcessors = 1;
+        if ((distName.size() != 0) && (processors > distName.size())) {
+            if (setProcessors) { optiProcessors = processors / distName.size(); }
+            processors = distName.size();
+        }
         deleteFiles = false; //so if we need to recalc the processors the files are still there
         vector<string> listFiles;
         vector < vector < map<string, string> > > dividedNames; //distNames[1] = vector of filenames for process 1...
@@ -1357,7 +1364,7 @@ vector<string> ClusterSplitCommand::createProcesses(vector< map<string, string>
         //Lauch worker threads
         for (int i = 0; i < processors-1; i++) {
             clusterData* dataBundle = new clusterData(showabund, classic, deleteFiles, dividedNames[i+1], cutoffNotSet, cutoff, precision, length, method, outputdir, vsearchLocation, type);
-            dataBundle->setOptiOptions(metricName, stableMetric, initialize, maxIters);
+            dataBundle->setOptiOptions(metricName, stableMetric, initialize, maxIters, optiProcessors);
             data.push_back(dataBundle);
             
             workerThreads.push_back(new std::thread(cluster, dataBundle));
@@ -1365,7 +1372,7 @@ vector<string> ClusterSplitCommand::createProcesses(vector< map<string, string>
         
         
         clusterData* dataBundle = new clusterData(showabund, classic, deleteFiles, dividedNames[0], cutoffNotSet, cutoff, precision, length, method, outputdir, vsearchLocation, type);
-        dataBundle->setOptiOptions(metricName, stableMetric, initialize, maxIters);
+        dataBundle->setOptiOptions(metricName, stableMetric, initialize, maxIters, optiProcessors);
         cluster(dataBundle);
         listFiles = dataBundle->listFileNames;
         tag = dataBundle->tag;
@@ -16,6 +16,7 @@ vector<string> CooccurrenceCommand::setParameters() {
 		CommandParameter pmetric("metric", "Multiple", "cscore-checker-combo-vratio", "cscore", "", "", "","",false,false); parameters.push_back(pmetric);
 		CommandParameter pmatrix("matrixmodel", "Multiple", "sim1-sim2-sim3-sim4-sim5-sim6-sim7-sim8-sim9", "sim2", "", "", "","",false,false); parameters.push_back(pmatrix);
         CommandParameter pruns("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(pruns);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -40,9 +41,10 @@ vector<string> CooccurrenceCommand::setParameters() {
 string CooccurrenceCommand::getHelpString(){	
 	try {
 		string helpString = "The cooccurrence command calculates four metrics and tests their significance to assess whether presence-absence patterns are different than what one would expect by chance.";
-        helpString += "The cooccurrence command parameters are shared, metric, matrixmodel, iters, label and groups.";
+        helpString += "The cooccurrence command parameters are shared, metric, matrixmodel, iters, processors, label and groups.";
         helpString += "The matrixmodel parameter options are sim1, sim2, sim3, sim4, sim5, sim6, sim7, sim8 and sim9. Default=sim2";
         helpString += "The metric parameter options are cscore, checker, combo and vratio. Default=cscore";
+        helpString += "The processors parameter allows you to specify the number of processors to use. The default is all available. Each processor builds its own chain of null matrices, so the results for a given seed depend on the number of processors.\n";
         helpString += "The label parameter is used to analyze specific labels in your input.\n";
 		helpString += "The groups parameter allows you to specify which of the groups you would like analyzed.\n";
         helpString += "The cooccurrence command should be in the following format: \n";
@@ -126,6 +128,9 @@ CooccurrenceCommand::CooccurrenceCommand(string option) : Command() {
             
             string temp = validParameter.valid(parameters, "iters");			if (temp == "not found") { temp = "1000"; }
 			util.mothurConvert(temp, runs); 
+            
+            temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
 		}
 	}
 	catch(exception& e) {
@@ -181,6 +186,162 @@ int CooccurrenceCommand::execute(){
 	}
 }
 //**********************************************************************************************************************
+struct cooccurrenceData {
+    OccupancyMatrix co_matrix; //each chain starts from its own copy of the observed matrix
+    vector<double>& probabilityMatrix;
+    vector<int>& rowtotal;
+    vector<int>& columntotal;
+    vector<double> stats;
+    string matrix, metric;
+    int runs, n;
+    MothurOut* m;
+    Utils util;
+    TrialSwap2 trial;
+    
+    cooccurrenceData(int stream, int r, OccupancyMatrix& co, vector<double>& prob, vector<int>& rt, vector<int>& ct, int num, string mat, string met) : co_matrix(co), probabilityMatrix(prob), rowtotal(rt), columntotal(ct) {
+        m = MothurOut::getInstance();
+        runs = r;
+        n = num;
+        matrix = mat;
+        metric = met;
+        util.setRandomStream(stream);
+    }
+};
+//**********************************************************************************************************************
+//populate null matrices from the probability matrix and score them, do this a lot.
+void generateNullMatrices(cooccurrenceData* params){
+    try {
+        int nrows = params->co_matrix.getNumRows();
+        int ncols = params->co_matrix.getNumCols();
+        vector<double>& probabilityMatrix = params->probabilityMatrix;
+        
+        OccupancyMatrix nullmatrix(nrows, ncols);
+        
+        double previous;
+        double current;
+        double randnum;
+        int count;
+        
+        //burn-in for sim9
+        if(params->matrix == "sim9") {
+            for(int i=0;i<10000;i++) { params->trial.swap_checkerboards (params->co_matrix, ncols, nrows, params->util); }
+        }
+        
+        for(int k=0;k<params->runs;k++){
+            //zero-fill the null matrix
+            nullmatrix.clear();
+            
+            if(params->matrix == "sim1" || params->matrix == "sim6" || params->matrix == "sim8" || params->matrix == "sim7") {
+                count = 0;
+                while(count < params->n) {
+                    if (params->m->getControl_pressed()) { return; }
+                nextnum2:
+                    previous = 0.0;
+                    randnum = params->util.getRandomDouble0to1();
+                    for(int i=0;i<nrows;i++) {
+                        for(int j=0;j<ncols;j++) {
+                            current = probabilityMatrix[ncols * i + j];
+                            if(randnum <= current && randnum > previous) {
+                                nullmatrix.set(i, j);
+                                count++;
+                                if (count > params->n) break;
+                                else
+                                    goto nextnum2;
+                            }
+                            previous = current;
+                        }
+                    }
+                }
+            }
+            
+            else if (params->matrix == "sim2") {
+                for(int i=0;i<nrows;i++) {
+                    vector<int> row = params->co_matrix.getRow(i);
+                    params->util.mothurRandomShuffle(row);
+                    params->co_matrix.setRow(i, row);
+                }
+                //do this for the scoring since those all have nullmatrix as a parameter
+                nullmatrix = params->co_matrix;
+            }
+            
+            else if(params->matrix == "sim4") {
+                for(int i=0;i<nrows;i++) {
+                    count = 0;
+                    while(count < params->rowtotal[i]) {
+                        previous = 0.0;
+                        if (params->m->getControl_pressed()) { return; }
+                        randnum = params->util.getRandomDouble0to1();
+                        for(int j=0;j<ncols;j++) {
+                            current = probabilityMatrix[ncols * i + j];
+                            if(randnum <= current && randnum > previous && nullmatrix.get(i, j) != 1) {
+                                nullmatrix.set(i, j);
+                                count++;
+                                previous = 0.0;
+                                break;
+                            }
+                            previous = current;
+                        }
+                    }
+                }
+            }
+            
+            else if(params->matrix == "sim3" || params->matrix == "sim5") {
+                //columns
+                for(int j=0;j<ncols;j++) {
+                    count = 0;
+                    previous = 0.0;
+                    while(count < params->columntotal[j]) {
+                        if (params->m->getControl_pressed()) { return; }
+                        randnum = params->util.getRandomDouble0to1();
+                        for(int i=0;i<nrows;i++) {
+                            current = probabilityMatrix[ncols * i + j];
+                            if(randnum <= current && randnum > previous && nullmatrix.get(i, j) != 1) {
+                                nullmatrix.set(i, j);
+                                count++;
+                                previous = 0.0;
+                                break;
+                            }
+                            previous = current;
+                        }
+                    }
+                }
+            }
+            
+            //swap_checkerboards takes the original matrix and swaps checkerboards
+            else if(params->matrix == "sim9") {
+                params->trial.swap_checkerboards (params->co_matrix, ncols, nrows, params->util);
+                nullmatrix = params->co_matrix;
+            }
+            else {
+                params->m->mothurOut("[ERROR]: No null model selected!\n\n"); params->m->setControl_pressed(true);
+                return;
+            }
+            
+            //run metric on null matrix and add score to the stats vector
+            if (params->metric == "cscore"){
+                params->stats.push_back(params->trial.calc_c_score(nullmatrix, params->rowtotal, ncols, nrows));
+            }
+            else if (params->metric == "checker") {
+                params->stats.push_back(params->trial.calc_checker(nullmatrix, params->rowtotal, ncols, nrows));
+            }
+            else if (params->metric == "vratio") {
+                params->stats.push_back(params->trial.calc_vratio(nrows, ncols, params->rowtotal, params->columntotal));
+            }
+            else if (params->metric == "combo") {
+                params->stats.push_back(params->trial.calc_combo(nrows, ncols, nullmatrix));
+            }
+            else {
+                params->m->mothurOut("[ERROR]: No metric selected!\n\n"); params->m->setControl_pressed(true);
+                return;
+            }
+        }
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "CooccurrenceCommand", "generateNullMatrices");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
 
 int CooccurrenceCommand::getCooccurrence(SharedRAbundVectors*& thisLookUp, ofstream& out){
     try {
@@ -191,8 +352,7 @@ int CooccurrenceCommand::getCooccurrence(SharedRAbundVectors*& thisLookUp, ofstr
             return 0;
         }
         
-        vector< vector<int> > co_matrix; co_matrix.resize(thisLookUp->getNumBins());
-        for (int i = 0; i < thisLookUp->getNumBins(); i++) { co_matrix[i].resize((thisLookUp->size()), 0); }
+        OccupancyMatrix co_matrix(thisLookUp->getNumBins(), thisLookUp->size());
         vector<int> columntotal; columntotal.resize(thisLookUp->size(), 0);
         vector<int> rowtotal; rowtotal.resize(numOTUS, 0);
         
@@ -204,7 +364,7 @@ int CooccurrenceCommand::getCooccurrence(SharedRAbundVectors*& thisLookUp, ofstr
             int abund = abunds[i];
             
                 if(abund > 0) {
-                    co_matrix[j][i] = 1;
+                    co_matrix.set(j, i);
                     rowtotal[j]++;
                     columntotal[i]++;
                 }
@@ -213,14 +373,13 @@ int CooccurrenceCommand::getCooccurrence(SharedRAbundVectors*& thisLookUp, ofstr
         
         
         //nrows is ncols of inital matrix. All the functions need this value. They assume the transposition has already taken place and nrows and ncols refer to that matrix.
-        //comatrix and initmatrix are still vectors of vectors of ints as in the original script. The abundancevector is only what was read in ie not a co-occurrence matrix!
+        //co_matrix packs the presence-absence of each OTU into words, so the metrics compare two OTUs a word at a time. The abundancevector is only what was read in ie not a co-occurrence matrix!
         int nrows = numOTUS;//rows of inital matrix
         int ncols = thisLookUp->size();//groups
         double initscore = 0.0;
        
         vector<double> stats;
         vector<double> probabilityMatrix; probabilityMatrix.resize(ncols * nrows, 0);
-        vector<vector<int> > nullmatrix(nrows, vector<int>(ncols, 0));
        
         TrialSwap2 trial;
         
@@ -323,127 +482,43 @@ int CooccurrenceCommand::getCooccurrence(SharedRAbundVectors*& thisLookUp, ofstr
         
         m->mothurOut("Initial c score: " + toString(initscore)); m->mothurOutEndLine();
         
-        double previous;
-        double current;
-        double randnum;
-        int count;
-
-        //burn-in for sim9    
-        if(matrix == "sim9") {
-            for(int i=0;i<10000;i++) trial.swap_checkerboards (co_matrix, ncols, nrows);
+        //divide the runs between the processors, each processor builds its own chain of null matrices
+        int numProcessors = processors;
+        if (numProcessors > runs) { numProcessors = runs; }
+        if (numProcessors < 1) { numProcessors = 1; }
+        
+        vector<int> lines;
+        int numRunsPerProcessor = runs / numProcessors;
+        for (int i = 0; i < numProcessors; i++) {
+            if(i == (numProcessors - 1)){	numRunsPerProcessor = runs - i * numRunsPerProcessor; 	}
+            lines.push_back(numRunsPerProcessor);
         }
-
-        //populate null matrix from probability matrix, do this a lot.
-        for(int k=0;k<runs;k++){
-            nullmatrix.clear();
-            //zero-fill the null matrix
-            nullmatrix.assign(nrows, vector<int>(ncols, 0));
-            
-            if(matrix == "sim1" || matrix == "sim6" || matrix == "sim8" || matrix == "sim7") {
-                count = 0;
-                while(count < n) {
-                    if (m->getControl_pressed()) { return 0; }
-                nextnum2:
-                    previous = 0.0;
-                    randnum = util.getRandomDouble0to1();
-                    for(int i=0;i<nrows;i++) {
-                        for(int j=0;j<ncols;j++) {
-                            current = probabilityMatrix[ncols * i + j];
-                            if(randnum <= current && randnum > previous) {
-                                nullmatrix[i][j] = 1;
-                                count++;
-                                if (count > n) break;
-                                else
-                                    goto nextnum2;
-                            }
-                            previous = current;
-                        }
-                    }
-                }
-            }
-            
-            else if (matrix == "sim2") {
-                for(int i=0;i<nrows;i++) {
-                    util.mothurRandomShuffle(co_matrix[i]);
-                }
-                //do this for the scoring since those all have nullmatrix as a parameter
-                //nullmatrix gets cleared at the begining of each run
-                nullmatrix = co_matrix;
-            }
-            
-            else if(matrix == "sim4") {
-                for(int i=0;i<nrows;i++) {
-                    count = 0;
-                    while(count < rowtotal[i]) {
-                        previous = 0.0;
-                        if (m->getControl_pressed()) { return 0; }
-                        randnum = util.getRandomDouble0to1();
-                        for(int j=0;j<ncols;j++) {
-                            current = probabilityMatrix[ncols * i + j];
-                            if(randnum <= current && randnum > previous && nullmatrix[i][j] != 1) {
-                                nullmatrix[i][j] = 1;
-                                count++;
-                                previous = 0.0;
-                                break;
-                            }
-                            previous = current;
-                        }
-                    }
-                }
-            }
-            
-            else if(matrix == "sim3" || matrix == "sim5") {
-                //columns
-                for(int j=0;j<ncols;j++) {
-                    count = 0;
-                    while(count < columntotal[j]) {
-                        if (m->getControl_pressed()) { return 0; }
-                        randnum = util.getRandomDouble0to1();
-                        for(int i=0;i<nrows;i++) {
-                            current = probabilityMatrix[ncols * i + j];
-                            if(randnum <= current && randnum > previous && nullmatrix[i][j] != 1) {
-                                nullmatrix[i][j] = 1;
-                                count++;
-                                previous = 0.0;
-                                break;
-                            }
-                            previous = current;
-                        }
-                    }
-                }
-            }
-            
-            //swap_checkerboards takes the original matrix and swaps checkerboards
-            else if(matrix == "sim9") {
-                trial.swap_checkerboards (co_matrix, ncols, nrows);
-                nullmatrix = co_matrix;
-            }
-            else {
-                m->mothurOut("[ERROR]: No null model selected!\n\n"); m->setControl_pressed(true);
-                return 1;
-            }
-            
-            //run metric on null matrix and add score to the stats vector
-            if (metric == "cscore"){
-                stats.push_back(trial.calc_c_score(nullmatrix, rowtotal, ncols, nrows));
-            }
-            else if (metric == "checker") {
-                stats.push_back(trial.calc_checker(nullmatrix, rowtotal, ncols, nrows));
-            }
-            else if (metric == "vratio") {
-                stats.push_back(trial.calc_vratio(nrows, ncols, rowtotal, columntotal));
-            }
-            else if (metric == "combo") {
-                stats.push_back(trial.calc_combo(nrows, ncols, nullmatrix));
-            }
-            else {
-                m->mothurOut("[ERROR]: No metric selected!\n\n"); m->setControl_pressed(true);
-                return 1;
-            }
-            
+        
+        //create array of worker threads
+        vector<std::thread*> workerThreads;
+        vector<cooccurrenceData*> data;
+        
+        //Lauch worker threads
+        for (int i = 0; i < numProcessors-1; i++) {
+            cooccurrenceData* dataBundle = new cooccurrenceData(i+1, lines[i+1], co_matrix, probabilityMatrix, rowtotal, columntotal, n, matrix, metric);
+            data.push_back(dataBundle);
+            workerThreads.push_back(new std::thread(generateNullMatrices, dataBundle));
         }
         
+        cooccurrenceData* dataBundle = new cooccurrenceData(0, lines[0], co_matrix, probabilityMatrix, rowtotal, columntotal, n, matrix, metric);
+        generateNullMatrices(dataBundle);
+        stats = dataBundle->stats;
+        delete dataBundle;
+        
+        for (int i = 0; i < numProcessors-1; i++) {
+            workerThreads[i]->join();
+            stats.insert(stats.end(), data[i]->stats.begin(), data[i]->stats.end());
+            
+            delete data[i];
+            delete workerThreads[i];
+        }
         
+        if (m->getControl_pressed()) { return 0; }
         
         double total = 0.0;
         for (int i=0; i<stats.size();i++) { total+=stats[i]; }
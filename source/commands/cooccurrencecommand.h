@@ -43,7 +43,7 @@ private:
     bool abort, allLines;
     set<string> labels;
     vector<string> outputNames, Groups;
-    int runs;
+    int runs, processors;
     
     int getCooccurrence(SharedRAbundVectors*&, ofstream&);
 	
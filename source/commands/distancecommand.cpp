@@ -19,6 +19,7 @@ vector<string> DistanceCommand::setParameters(){
 		CommandParameter pcalc("calc", "Multiple", "nogaps-eachgap-onegap-jtt-pmb-pam-kimura", "onegap", "", "", "","",false,false); parameters.push_back(pcalc);
 		CommandParameter pcountends("countends", "Boolean", "", "T", "", "", "","",false,false); parameters.push_back(pcountends);
         CommandParameter pfitcalc("fitcalc", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pfitcalc);
+        CommandParameter pprefilter("prefilter", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pprefilter);
 		CommandParameter pcompress("compress", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pcompress);
 		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false, true); parameters.push_back(pprocessors);
 		CommandParameter pcutoff("cutoff", "Number", "", "1.0", "", "", "","",false,false, true); parameters.push_back(pcutoff);
@@ -46,12 +47,13 @@ string DistanceCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The dist.seqs command reads a file containing sequences and creates a distance file.\n";
-		helpString += "The dist.seqs command parameters are fasta, oldfasta, column, calc, countends, output, compress, cutoff and processors.  \n";
+		helpString += "The dist.seqs command parameters are fasta, oldfasta, column, calc, countends, output, compress, cutoff, prefilter and processors.  \n";
 		helpString += "The fasta parameter is required, unless you have a valid current fasta file.\n";
 		helpString += "The oldfasta and column parameters allow you to append the distances calculated to the column file.\n";
 		helpString += "The calc parameter allows you to specify the method of calculating the distances.  Your options are: nogaps, onegap or eachgap for dna/rna sequences. If using protein sequences, your calc options are jtt, pmb, pam and kimura. The default is onegap.\n";
 		helpString += "The countends parameter allows you to specify whether to include terminal gaps in distance.  Your options are: T or F. The default is T.\n";
 		helpString += "The cutoff parameter allows you to specify maximum distance to keep. The default is 1.0.\n";
+		helpString += "The prefilter parameter allows you to skip pairs of sequences that share too few kmers to be within the cutoff. The distances are the same as without it. It is used with column output and the onegap calc or the eachgap calc with countends=T. Your options are: T or F. The default is F.\n";
 		helpString += "The output parameter allows you to specify format of your distance matrix. Options are column, lt, and square. The default is column.\n";
 		helpString += "The processors parameter allows you to specify number of processors to use.  The default is 1.\n";
 		helpString += "The compress parameter allows you to indicate that you want the resulting distance file compressed.  The default is false.\n";
@@ -127,6 +129,9 @@ DistanceCommand::DistanceCommand(string option) : Command() {
             
             temp = validParameter.valid(parameters, "fitcalc");	if(temp == "not found"){	temp = "F";	}
             fitCalc = util.isTrue(temp);
+            
+            temp = validParameter.valid(parameters, "prefilter");	if(temp == "not found"){	temp = "F";	}
+            prefilter = util.isTrue(temp);
 			
 			temp = validParameter.valid(parameters, "cutoff");		if(temp == "not found"){	temp = "1.0"; }
 			util.mothurConvert(temp, cutoff); 
@@ -150,6 +155,8 @@ DistanceCommand::DistanceCommand(string option) : Command() {
             
             prot = false; //not using protein sequences
             if ((calc == "jtt") || (calc == "pmb") || (calc == "pam") || (calc == "kimura")) { prot = true; }
+            
+            if (prefilter && ((output != "column") || !KmerPrefilter::isValid(calc, countends))) { m->mothurOut("The prefilter can only be used with column output and the onegap calc or the eachgap calc with countends=T, ignoring.\n"); prefilter = false; }
 
 		}
 	}
@@ -169,6 +176,7 @@ DistanceCommand::DistanceCommand(StorageDatabase*& storageDB, string outputFileR
         calc = "onegap";
         countends = true;
         fitCalc = false;
+        prefilter = false;
         cutoff = cut;
         processors = proc;
         compress = false;
@@ -333,234 +341,149 @@ int DistanceCommand::execute(){
 	}
 }
 /**************************************************************************************************/
-void driverColumn(distanceData* params){
+//writes the blocks of rows that are finished and have all the blocks above them written
+void writeFinishedBlocks(distanceTiles* tiles, MothurOut* m) {
     try {
-        ValidCalculators validCalculator;
-        DistCalc* distCalculator;
-
-        if (!params->prot) {
-            if (params->countends) {
-                if (validCalculator.isValidCalculator("distance", params->calc) ) {
-                    if (params->calc == "nogaps")			{	distCalculator = new ignoreGaps(params->cutoff);	}
-                    else if (params->calc == "eachgap")	{	distCalculator = new eachGapDist(params->cutoff);	}
-                    else if (params->calc == "onegap")		{	distCalculator = new oneGapDist(params->cutoff);	}
-                }
-            }else {
-                if (validCalculator.isValidCalculator("distance", params->calc) ) {
-                    if (params->calc == "nogaps")		{	distCalculator = new ignoreGaps(params->cutoff);					}
-                    else if (params->calc == "eachgap"){	distCalculator = new eachGapIgnoreTermGapDist(params->cutoff);	}
-                    else if (params->calc == "onegap")	{	distCalculator = new oneGapIgnoreTermGapDist(params->cutoff);		}
-                }
-            }
-        }else {
-            if (validCalculator.isValidCalculator("protdist", params->calc) ) {
-                if (params->calc == "jtt")        {    distCalculator = new JTT(params->cutoff);                    }
-                else if (params->calc == "pmb")        {    distCalculator = new PMB(params->cutoff);               }
-                else if (params->calc == "pam")        {    distCalculator = new PAM(params->cutoff);               }
-                else if (params->calc == "kimura")        {    distCalculator = new Kimura(params->cutoff);               }
+        lock_guard<std::mutex> guard(tiles->writeLock);
+        
+        while (true) {
+            long long block = 0;
+            {
+                lock_guard<std::mutex> tileGuard(tiles->tileLock);
+                block = tiles->nextBlockToWrite;
+                if ((block >= tiles->numBlocks) || (tiles->tilesLeft[block] != 0)) { break; }
+                tiles->nextBlockToWrite++;
             }
-        }
             
-        
-        int startTime = time(nullptr);
-       
-        params->count = 0;
-        string buffer = "";
-        
-        for(int i=params->startLine;i<params->endLine;i++){
-            
-            Sequence seqI; Protein seqIP; string nameI = "";
-            if (params->prot)   { seqIP = params->db->getProt(i);   nameI = seqIP.getName();    }
-            else                { seqI = params->db->getSeq(i);     nameI = seqI.getName();     }
-            
-            for(int j=0;j<i;j++){
-                
-                if (params->m->getControl_pressed()) { break;  }
-                
-                if ((i >= params->numNewFasta) && (j >= params->numNewFasta)) { break; }
-                
-                double dist = 1.0; string nameJ = "";
-                if (params->prot)   { Protein seqJP = params->db->getProt(j); nameJ = seqJP.getName(); dist = distCalculator->calcDist(seqIP, seqJP);   }
-                else                { Sequence seqJ = params->db->getSeq(j);  nameJ = seqJ.getName(); dist = distCalculator->calcDist(seqI, seqJ);       }
-                
-                
-                if(dist <= params->cutoff){
-                    buffer += (nameI + " " + nameJ + " " + toString(dist) + "\n");
-                    params->count++;
-                }
+            vector< vector<string> >& text = tiles->rowText[block];
+            long long numRows = min(tiles->blockSize, tiles->numSeqs - (block * tiles->blockSize));
+            for (long long row = 0; row < numRows; row++) {
+                for (int c = 0; c < text.size(); c++) { tiles->out << text[c][row]; }
             }
+            vector< vector<string> >().swap(text);
             
-            if(i % 100 == 0){ params->threadWriter->write(buffer);  buffer = ""; params->m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(nullptr) - startTime) + "\t" + toString(params->count) +"\n"); }
-            
+            tiles->count += tiles->blockCounts[block];
+            long long lastRow = block * tiles->blockSize + numRows - 1;
+            m->mothurOutJustToScreen(toString(lastRow) + "\t" + toString(time(nullptr) - tiles->startTime) + "\t" + toString(tiles->count) +"\n");
         }
-        params->threadWriter->write(buffer);
-        
-        if((params->endLine-1) % 100 != 0){ params->m->mothurOutJustToScreen(toString(params->endLine-1) + "\t" + toString(time(nullptr) - startTime) + "\t" + toString(params->count) +"\n"); }
-        
-        delete distCalculator;
     }
     catch(exception& e) {
-        params->m->errorOut(e, "DistanceCommand", "driverColumn");
+        m->errorOut(e, "DistanceCommand", "writeFinishedBlocks");
         exit(1);
     }
 }
 /**************************************************************************************************/
-void driverLt(distanceData* params){
+void driverTiles(distanceData* params){
     try {
         ValidCalculators validCalculator;
-        DistCalc* distCalculator;
-        double cutoff = 1.0;
+        DistCalc* distCalculator = nullptr;
+        BitPlaneDist* bitPlaneDist = nullptr;
+        distanceTiles* tiles = params->tiles;
+        
+        //lt and square files hold every distance, the cutoff is only used to count them
+        double cutoff = params->cutoff;
+        if (tiles->output != "column") { cutoff = 1.0; }
         
         if (!params->prot) {
-            if (params->countends) {
-                if (validCalculator.isValidCalculator("distance", params->calc) ) {
-                    if (params->calc == "nogaps")			{	distCalculator = new ignoreGaps(cutoff);	}
-                    else if (params->calc == "eachgap")	{	distCalculator = new eachGapDist(cutoff);	}
-                    else if (params->calc == "onegap")		{	distCalculator = new oneGapDist(cutoff);	}
-                }
-            }else {
-                if (validCalculator.isValidCalculator("distance", params->calc) ) {
-                    if (params->calc == "nogaps")		{	distCalculator = new ignoreGaps(cutoff);					}
-                    else if (params->calc == "eachgap"){	distCalculator = new eachGapIgnoreTermGapDist(cutoff);	}
-                    else if (params->calc == "onegap")	{	distCalculator = new oneGapIgnoreTermGapDist(cutoff);		}
-                }
-            }
+            if (validCalculator.isValidCalculator("distance", params->calc) ) { bitPlaneDist = new BitPlaneDist(params->bitPlanes, params->calc, params->countends, cutoff); }
         }else {
             if (validCalculator.isValidCalculator("protdist", params->calc) ) {
                 if (params->calc == "jtt")        {    distCalculator = new JTT(params->cutoff);                    }
                 else if (params->calc == "pmb")        {    distCalculator = new PMB(params->cutoff);               }
                 else if (params->calc == "pam")        {    distCalculator = new PAM(params->cutoff);               }
-                else if (params->calc == "kimura")        {    distCalculator = new Kimura(params->cutoff);         }
+                else if (params->calc == "kimura")        {    distCalculator = new Kimura(params->cutoff);               }
             }
         }
         
-        int startTime = time(nullptr);
-        long long numSeqs = params->db->getNumSeqs();
-        
-        //column file
-        ofstream outFile; params->util.openOutputFile(params->outputFileName, outFile);
-        outFile.setf(ios::fixed, ios::showpoint); outFile << setprecision(4);
-        
-        if(params->startLine == 0){	outFile << numSeqs << endl;	}
-        
         params->count = 0;
-        for(int i=params->startLine;i<params->endLine;i++){
+        params->skipped = 0;
+        
+        ostringstream distString; distString.setf(ios::fixed, ios::showpoint); distString << setprecision(4);
+        long long rowBlock, columnBlock;
+        while (tiles->getNextTile(rowBlock, columnBlock)) {
             
-            Sequence seqI; Protein seqIP; string nameI = "";
-            if (params->prot)   { seqIP = params->db->getProt(i);   nameI = seqIP.getName();    }
-            else                { seqI = params->db->getSeq(i);     nameI = seqI.getName();     }
+            if (params->m->getControl_pressed()) { break;  }
             
-            if (nameI.length() < 10) {  while (nameI.length() < 10) {  nameI += " ";  } }
-            outFile << nameI;
+            long long firstRow = rowBlock * tiles->blockSize;
+            long long lastRow = min(firstRow + tiles->blockSize, tiles->numSeqs);
+            long long firstColumn = columnBlock * tiles->blockSize;
+            long long lastColumn = min(firstColumn + tiles->blockSize, tiles->numSeqs);
             
-            for(int j=0;j<i;j++){
-                
-                if (params->m->getControl_pressed()) { break;  }
+            vector<string> tileText(lastRow - firstRow);
+            long long tileCount = 0;
+            
+            for(long long i=firstRow;i<lastRow;i++){
                 
-                if ((i >= params->numNewFasta) && (j >= params->numNewFasta)) { break; }
+                Protein seqIP; string nameI = "";
+                if (params->prot)   { seqIP = params->db->getProt(i);   nameI = seqIP.getName();    }
+                else                { nameI = params->bitPlanes->getName(i);                        }
                 
-                double dist = 1.0;
-                if (params->prot)   { Protein seqJP = params->db->getProt(j);  dist = distCalculator->calcDist(seqIP, seqJP);   }
-                else                { Sequence seqJ = params->db->getSeq(j);  dist = distCalculator->calcDist(seqI, seqJ);       }
+                string& text = tileText[i-firstRow];
+                distString.str("");
                 
-                if(dist <= params->cutoff){ params->count++; }
-                outFile  << '\t' << dist;
-            }
-            
-            outFile << endl;
-            
-            if(i % 100 == 0){ params->m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(nullptr) - startTime) + "\t" + toString(params->count) +"\n"); }
-            
-        }
-        
-        if((params->endLine-1) % 100 != 0){ params->m->mothurOutJustToScreen(toString(params->endLine-1) + "\t" + toString(time(nullptr) - startTime) + "\t" + toString(params->count) +"\n"); }
-        
-        outFile.close();
-        delete distCalculator;
-    }
-    catch(exception& e) {
-        params->m->errorOut(e, "DistanceCommand", "driverLt");
-        exit(1);
-    }
-}
-/**************************************************************************************************/
-void driverSquare(distanceData* params){
-    try {
-        ValidCalculators validCalculator;
-        DistCalc* distCalculator;
-        double cutoff = 1.0;
-        
-        if (!params->prot) {
-            if (params->countends) {
-                if (validCalculator.isValidCalculator("distance", params->calc) ) {
-                    if (params->calc == "nogaps")			{	distCalculator = new ignoreGaps(cutoff);	}
-                    else if (params->calc == "eachgap")	{	distCalculator = new eachGapDist(cutoff);	    }
-                    else if (params->calc == "onegap")		{	distCalculator = new oneGapDist(cutoff);	}
-                }
-            }else {
-                if (validCalculator.isValidCalculator("distance", params->calc) ) {
-                    if (params->calc == "nogaps")		{	distCalculator = new ignoreGaps(cutoff);					}
-                    else if (params->calc == "eachgap"){	distCalculator = new eachGapIgnoreTermGapDist(cutoff);	}
-                    else if (params->calc == "onegap")	{	distCalculator = new oneGapIgnoreTermGapDist(cutoff);		}
+                if ((tiles->output != "column") && (columnBlock == 0)) {
+                    if (nameI.length() < 10) {  while (nameI.length() < 10) {  nameI += " ";  } }
+                    distString << nameI;
+                    if (tiles->output == "square") { distString << '\t'; }
                 }
-            }
-        }else {
-            if (validCalculator.isValidCalculator("protdist", params->calc) ) {
-                if (params->calc == "jtt")        {    distCalculator = new JTT(params->cutoff);                    }
-                else if (params->calc == "pmb")        {    distCalculator = new PMB(params->cutoff);               }
-                else if (params->calc == "pam")        {    distCalculator = new PAM(params->cutoff);               }
-                else if (params->calc == "kimura")        {    distCalculator = new Kimura(params->cutoff);         }
-            }
-        }
-        
-        int startTime = time(nullptr);
-        
-        //column file
-        ofstream outFile;
-        params->util.openOutputFile(params->outputFileName, outFile);
-        outFile.setf(ios::fixed, ios::showpoint); outFile << setprecision(4);
-        
-        long long numSeqs = params->db->getNumSeqs();
-        if(params->startLine == 0){	outFile << numSeqs << endl;	}
-        
-        params->count = 0;
-        for(int i=params->startLine;i<params->endLine;i++){
-            
-            Sequence seqI; Protein seqIP; string nameI = "";
-            if (params->prot)   { seqIP = params->db->getProt(i);   nameI = seqIP.getName();    }
-            else                { seqI = params->db->getSeq(i);     nameI = seqI.getName();     }
-            
-            if (nameI.length() < 10) {  while (nameI.length() < 10) {  nameI += " ";  } }
-            outFile << nameI << '\t';
-            
-            for(int j=0;j<numSeqs;j++){
                 
-                if (params->m->getControl_pressed()) { break; }
+                long long endColumn = lastColumn;
+                if ((tiles->output != "square") && (endColumn > i)) { endColumn = i; }
                 
-                double dist = 1.0;
-                if (i == j) { dist = 0.0000; }
-                else {
-                    if (params->prot)   { Protein seqJP = params->db->getProt(j);  dist = distCalculator->calcDist(seqIP, seqJP);   }
-                    else                { Sequence seqJ = params->db->getSeq(j);  dist = distCalculator->calcDist(seqI, seqJ);       }
+                for(long long j=firstColumn;j<endColumn;j++){
+                    
+                    if ((tiles->output != "square") && (i >= params->numNewFasta) && (j >= params->numNewFasta)) { break; }
+                    
+                    double dist = 1.0;
+                    if (i == j) { dist = 0.0000; }
+                    else if (params->prot)  { Protein seqJP = params->db->getProt(j); dist = distCalculator->calcDist(seqIP, seqJP);   }
+                    else if ((params->prefilter != nullptr) && params->prefilter->isFar(i, j)) { params->skipped++;                 }
+                    else                    { dist = bitPlaneDist->calcDist(i, j);                                                  }
+                    
+                    if (tiles->output == "column") {
+                        if(dist <= params->cutoff){
+                            string nameJ = "";
+                            if (params->prot)   { nameJ = params->db->getProt(j).getName();     }
+                            else                { nameJ = params->bitPlanes->getName(j);        }
+                            text += (nameI + " " + nameJ + " " + toString(dist) + "\n");
+                            tileCount++;
+                        }
+                    }else {
+                        if(dist <= params->cutoff){ tileCount++; }
+                        if (tiles->output == "lt")  { distString << '\t' << dist;   }
+                        else                        { distString << dist << '\t';   }
+                    }
                 }
                 
-                if(dist <= params->cutoff){ params->count++; }
-                
-                outFile << dist << '\t'; 
+                if (tiles->output != "column") {
+                    bool lastTileInRow = (columnBlock == rowBlock);
+                    if (tiles->output == "square") { lastTileInRow = (columnBlock == tiles->numBlocks-1); }
+                    if (lastTileInRow) { distString << endl; }
+                    text = distString.str();
+                }
             }
             
-            outFile << endl; 
+            params->count += tileCount;
+            
+            bool blockDone = false;
+            {
+                lock_guard<std::mutex> guard(tiles->tileLock);
+                vector< vector<string> >& blockText = tiles->rowText[rowBlock];
+                if (blockText.size() <= columnBlock) { blockText.resize(columnBlock+1); }
+                blockText[columnBlock].swap(tileText);
+                tiles->blockCounts[rowBlock] += tileCount;
+                tiles->tilesLeft[rowBlock]--;
+                blockDone = (tiles->tilesLeft[rowBlock] == 0);
+            }
             
-            if(i % 100 == 0){ params->m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(nullptr) - startTime) + "\t" + toString(params->count) +"\n");  }
+            if (blockDone) { writeFinishedBlocks(tiles, params->m); }
         }
         
-        if((params->endLine-1) % 100 != 0){ params->m->mothurOutJustToScreen(toString(params->endLine-1) + "\t" + toString(time(nullptr) - startTime) + "\t" + toString(params->count) +"\n"); }
-        
-        outFile.close();
         delete distCalculator;
+        delete bitPlaneDist;
     }
     catch(exception& e) {
-        params->m->errorOut(e, "DistanceCommand", "driverSquare");
+        params->m->errorOut(e, "DistanceCommand", "driverTiles");
         exit(1);
     }
 }
@@ -638,6 +561,7 @@ void DistanceCommand::createProcesses(string filename) {
     try {
         long long num = db->getNumSeqs();
         long long distsBelowCutoff = 0;
+        long long numSkipped = 0;
         time_t start, end;
         time(&start);
         
@@ -645,36 +569,17 @@ void DistanceCommand::createProcesses(string filename) {
         vector<std::thread*> workerThreads;
         vector<distanceData*> data;
         
-        double numDists = 0;
-        
-        if (output == "square") { numDists = numSeqs; }
-        else { for(int i=0;i<numSeqs;i++){ for(int j=0;j<i;j++){ numDists++; if (numDists > processors) { break; } } } }
-        if (numDists < processors) { processors = numDists; }
-        
-        vector<linePair> lines;
-        for (int i = 0; i < processors; i++) {
-            linePair tempLine;
-            lines.push_back(tempLine);
-            if (output != "square") {
-                lines[i].start = int (sqrt(float(i)/float(processors)) * numSeqs);
-                lines[i].end = int (sqrt(float(i+1)/float(processors)) * numSeqs);
-            }else{
-                lines[i].start = int ((float(i)/float(processors)) * numSeqs);
-                lines[i].end = int ((float(i+1)/float(processors)) * numSeqs);
-            }
-        }
-        
-        auto synchronizedOutputFile = std::make_shared<SynchronizedOutputFile>(filename);
-        synchronizedOutputFile->setFixedShowPoint(); synchronizedOutputFile->setPrecision(4);
-        
-        StorageDatabase* oldFastaDB;
-        if (fitCalc) {
+        if (fitCalc && (output == "column")) {
+            auto synchronizedOutputFile = std::make_shared<SynchronizedOutputFile>(filename);
+            synchronizedOutputFile->setFixedShowPoint(); synchronizedOutputFile->setPrecision(4);
+            
+            StorageDatabase* oldFastaDB;
             ifstream inFASTA; util.openInputFile(oldfastafile, inFASTA);
             if (!prot) { oldFastaDB = new SequenceDB(inFASTA); }
             else                    { oldFastaDB = new ProteinDB(inFASTA); }
             inFASTA.close();
             
-            lines.clear();
+            vector<linePair> lines;
             if (processors > oldFastaDB->getNumSeqs()) { processors = oldFastaDB->getNumSeqs(); }
             int remainingSeqs = oldFastaDB->getNumSeqs();
             int startIndex = 0;
@@ -685,65 +590,90 @@ void DistanceCommand::createProcesses(string filename) {
                 startIndex = startIndex + numSeqsToFit;
                 remainingSeqs -= numSeqsToFit;
             }
-        }
-        
-        //Lauch worker threads
-        for (int i = 0; i < processors-1; i++) {
-            OutputWriter* threadWriter = nullptr;
-            distanceData* dataBundle = nullptr;
-            string extension = toString(i+1) + ".temp";
-            if (output == "column") {
-                threadWriter = new OutputWriter(synchronizedOutputFile);
-                dataBundle = new distanceData(threadWriter);
-            }else { dataBundle = new distanceData(filename+extension); }
-            dataBundle->setVariables(lines[i+1].start, lines[i+1].end, cutoff, db, oldFastaDB, calc, prot, numNewFasta, countends);
-            data.push_back(dataBundle);
-            
-            std::thread* thisThread = nullptr;
-            if (output == "column")     {
-                if (fitCalc)    { thisThread = new std::thread(driverFitCalc, dataBundle);   }
-                else            {  thisThread = new std::thread(driverColumn, dataBundle);   }
+            
+            //Lauch worker threads
+            for (int i = 0; i < processors-1; i++) {
+                OutputWriter* threadWriter = new OutputWriter(synchronizedOutputFile);
+                distanceData* dataBundle = new distanceData(threadWriter);
+                dataBundle->setVariables(lines[i+1].start, lines[i+1].end, cutoff, db, oldFastaDB, nullptr, calc, prot, numNewFasta, countends);
+                data.push_back(dataBundle);
+                
+                workerThreads.push_back(new std::thread(driverFitCalc, dataBundle));
             }
-            else if (output == "lt")    { thisThread = new std::thread(driverLt, dataBundle);            }
-            else                        { thisThread = new std::thread(driverSquare, dataBundle);        }
-            workerThreads.push_back(thisThread);
-        }
-        
-        OutputWriter* threadWriter = nullptr;
-        distanceData* dataBundle = nullptr;
-        if (output == "column") {
-            threadWriter = new OutputWriter(synchronizedOutputFile);
-            dataBundle = new distanceData(threadWriter);
-        }else { dataBundle = new distanceData(filename); }
-        dataBundle->setVariables(lines[0].start, lines[0].end, cutoff, db, oldFastaDB, calc, prot, numNewFasta, countends);
-        
-        if (output == "column")     {
-            if (fitCalc)    { driverFitCalc(dataBundle);    }
-            else            { driverColumn(dataBundle);     }
-        }
-        else if (output == "lt")    { driverLt(dataBundle);            }
-        else                        { driverSquare(dataBundle);        }
-        distsBelowCutoff = dataBundle->count;
-        
-        
-        for (int i = 0; i < processors-1; i++) {
-            workerThreads[i]->join();
             
-            distsBelowCutoff += data[i]->count;
-            if (output == "column") {  delete data[i]->threadWriter; }
-            else {
-                string extension = toString(i+1) + ".temp";
-                util.appendFiles((filename+extension), filename);
-                util.mothurRemove(filename+extension);
+            OutputWriter* threadWriter = new OutputWriter(synchronizedOutputFile);
+            distanceData* dataBundle = new distanceData(threadWriter);
+            dataBundle->setVariables(lines[0].start, lines[0].end, cutoff, db, oldFastaDB, nullptr, calc, prot, numNewFasta, countends);
+            
+            driverFitCalc(dataBundle);
+            distsBelowCutoff = dataBundle->count;
+            
+            for (int i = 0; i < processors-1; i++) {
+                workerThreads[i]->join();
+                distsBelowCutoff += data[i]->count;
+                delete data[i]->threadWriter;
+                delete data[i];
+                delete workerThreads[i];
             }
-            delete data[i];
-            delete workerThreads[i];
+            synchronizedOutputFile->close(); delete threadWriter;
+            delete dataBundle;
+            delete oldFastaDB;
+        }else {
+            //encode the sequences once for all the threads
+            AlignedBitPlanes* bitPlanes = nullptr;
+            if (!prot) { bitPlanes = new AlignedBitPlanes(db); }
+            
+            //8mers rarely match by chance in 16S sized sequences, so the shared counts are close to the kept kmers
+            KmerPrefilter* kmerPrefilter = nullptr;
+            if (prefilter && !prot) { kmerPrefilter = new KmerPrefilter(db, cutoff, 8); }
+            
+            //size the tiles so a block of rows and a block of columns take about 128K together
+            long long bytesPerSeq = 1024;
+            if (!prot) { bytesPerSeq = (2 + bitPlanes->getNumPlanes()) * bitPlanes->getNumWords() * sizeof(unsigned long long); }
+            long long blockSize = (64 * 1024) / max(bytesPerSeq, 1LL);
+            if (blockSize < 16)     { blockSize = 16;   }
+            if (blockSize > 1024)   { blockSize = 1024; }
+            
+            distanceTiles* tiles = new distanceTiles(filename, output, numSeqs, numNewFasta, blockSize, (output == "square"));
+            if (processors > tiles->tiles.size()) { processors = tiles->tiles.size(); }
+            
+            //Lauch worker threads
+            for (int i = 0; i < processors-1; i++) {
+                distanceData* dataBundle = new distanceData(tiles);
+                dataBundle->setVariables(0, numSeqs, cutoff, db, db, bitPlanes, calc, prot, numNewFasta, countends);
+                dataBundle->prefilter = kmerPrefilter;
+                data.push_back(dataBundle);
+                
+                workerThreads.push_back(new std::thread(driverTiles, dataBundle));
+            }
+            
+            distanceData* dataBundle = new distanceData(tiles);
+            dataBundle->setVariables(0, numSeqs, cutoff, db, db, bitPlanes, calc, prot, numNewFasta, countends);
+            dataBundle->prefilter = kmerPrefilter;
+            
+            driverTiles(dataBundle);
+            distsBelowCutoff = dataBundle->count;
+            numSkipped = dataBundle->skipped;
+            
+            for (int i = 0; i < processors-1; i++) {
+                workerThreads[i]->join();
+                distsBelowCutoff += data[i]->count;
+                numSkipped += data[i]->skipped;
+                delete data[i];
+                delete workerThreads[i];
+            }
+            delete dataBundle;
+            
+            tiles->out.close();
+            delete tiles;
+            delete bitPlanes;
+            delete kmerPrefilter;
         }
-        if (output == "column")     { synchronizedOutputFile->close(); delete threadWriter; }
-        delete dataBundle;
         
         time(&end);
-        m->mothurOut("\nIt took " + toString(difftime(end, start)) + " secs to find distances for " + toString(num) + " sequences. " + toString(distsBelowCutoff+numDistsBelowCutoff) + " distances below cutoff " + toString(cutoff) + ".\n\n");
+        m->mothurOut("\nIt took " + toString(difftime(end, start)) + " secs to find distances for " + toString(num) + " sequences. " + toString(distsBelowCutoff+numDistsBelowCutoff) + " distances below cutoff " + toString(cutoff) + ".\n");
+        if (prefilter) { m->mothurOut(toString(numSkipped) + " pairs were skipped by the kmer prefilter.\n"); }
+        m->mothurOut("\n");
         
 	}
 	catch(exception& e) {
@@ -20,6 +20,8 @@
 #include "eachgapignore.h"
 #include "onegapdist.h"
 #include "onegapignore.h"
+#include "bitplanedist.h"
+#include "kmerprefilter.h"
 #include "jtt.hpp"
 #include "writer.h"
 #include "proteindb.hpp"
@@ -27,12 +29,57 @@
 #include "pam.hpp"
 #include "kimura.hpp"
 
+/**************************************************************************************************/
+//dist.seqs cuts the lower triangle (or the square) into blockSize x blockSize tiles, sized so a block of rows and a
+//block of columns fit in L2 cache together. The threads take the next tile as soon as they finish one, so a thread
+//that gets cheap tiles doesn't sit idle while the others finish. The text for each row of a tile is saved until all
+//the tiles in its block of rows are done, then the block is written after the blocks above it, so the file is in the
+//same row order no matter how many processors are used.
+struct distanceTiles {
+    long long numSeqs, numNewFasta, blockSize, numBlocks, nextTile, nextBlockToWrite, count;
+    int startTime;
+    string output;
+    vector< pair<long long, long long> > tiles;     //row block, column block
+    vector<long long> tilesLeft;                    //tiles in each row block that aren't finished
+    vector<long long> blockCounts;                  //distances below the cutoff in each row block
+    vector< vector< vector<string> > > rowText;     //for each row block, the text of each column block for each row
+    ofstream out;
+    std::mutex tileLock, writeLock;
+    
+    distanceTiles(string outputFileName, string o, long long n, long long nNew, long long bSize, bool square) {
+        output = o; numSeqs = n; numNewFasta = nNew; blockSize = bSize;
+        numBlocks = (numSeqs + blockSize - 1) / blockSize;
+        nextTile = 0; nextBlockToWrite = 0; count = 0; startTime = time(nullptr);
+        
+        tilesLeft.resize(numBlocks, 0); blockCounts.resize(numBlocks, 0); rowText.resize(numBlocks);
+        for (long long r = 0; r < numBlocks; r++) {
+            long long lastColumnBlock = r;
+            if (square) { lastColumnBlock = numBlocks-1; }
+            for (long long c = 0; c <= lastColumnBlock; c++) { tiles.push_back(pair<long long, long long>(r, c)); }
+            tilesLeft[r] = lastColumnBlock+1;
+        }
+        
+        Utils util; util.openOutputFile(outputFileName, out);
+        if (output != "column") { out << numSeqs << endl; }
+    }
+    
+    bool getNextTile(long long& rowBlock, long long& columnBlock) {
+        lock_guard<std::mutex> guard(tileLock);
+        if (nextTile >= tiles.size()) { return false; }
+        rowBlock = tiles[nextTile].first; columnBlock = tiles[nextTile].second;
+        nextTile++;
+        return true;
+    }
+};
 /**************************************************************************************************/
 struct distanceData {
-    long long startLine, endLine, numNewFasta, count;
+    long long startLine, endLine, numNewFasta, count, skipped;
 	float cutoff;
     StorageDatabase* db;
     StorageDatabase* oldFastaDB;
+    AlignedBitPlanes* bitPlanes;
+    KmerPrefilter* prefilter;
+    distanceTiles* tiles;
 	MothurOut* m;
 	OutputWriter* threadWriter;
     string outputFileName, calc;
@@ -42,24 +89,31 @@ struct distanceData {
 	distanceData(){}
     distanceData(OutputWriter* ofn) {
         threadWriter = ofn;
+        tiles = nullptr;
+        prefilter = nullptr;
         m = MothurOut::getInstance();
     }
     
-    distanceData(string ofn) {
-        outputFileName = ofn;
+    distanceData(distanceTiles* t) {
+        tiles = t;
+        threadWriter = nullptr;
+        prefilter = nullptr;
         m = MothurOut::getInstance();
     }
-	void setVariables(int s, int e,  float c, StorageDatabase*& dbsp, StorageDatabase*& oldfn, string Est, bool met, long long num, bool cnt) {
+    
+	void setVariables(int s, int e,  float c, StorageDatabase*& dbsp, StorageDatabase*& oldfn, AlignedBitPlanes* bp, string Est, bool met, long long num, bool cnt) {
 		startLine = s;
 		endLine = e;
 		cutoff = c;
 		db = dbsp;
         oldFastaDB = oldfn;
+        bitPlanes = bp;
 		calc = Est;
         prot = met;
 		numNewFasta = num;
 		countends = cnt;
         count = 0;
+        skipped = 0;
 	}
 };
 /**************************************************************************************************/
@@ -91,7 +145,7 @@ private:
     long long numNewFasta, numSeqs, numDistsBelowCutoff;
 	float cutoff;
 	
-	bool abort, countends, fitCalc, prot, compress;
+	bool abort, countends, fitCalc, prot, compress, prefilter;
 	vector<string> outputNames; 
 	
 	void createProcesses(string);
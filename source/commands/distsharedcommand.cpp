@@ -423,6 +423,7 @@ int process(distSharedData* params){
             time_t start = time(nullptr);
             
             if (params->subsample) {
+                sample.setIteration(params->startIter+thisIter);
                 if (params->withReplacement)    {  sample.getSampleWithReplacement(thisItersLookup, params->subsampleSize);     }
                 else                            {  sample.getSample(thisItersLookup, params->subsampleSize);                    }
             }
@@ -486,12 +487,13 @@ int DistSharedCommand::createProcesses(SharedRAbundVectors*& thisLookup){
         
         vector<string> groupNames = thisLookup->getNamesGroups();
         
-        vector<int> lines;
+        vector<int> lines, starts;
         if (processors > (iters)) { processors = iters; }
         
         //figure out how many sequences you have to process
         int numItersPerProcessor = (iters) / processors;
         for (int i = 0; i < processors; i++) {
+            starts.push_back(i * numItersPerProcessor);
             if(i == (processors - 1)){	numItersPerProcessor = (iters) - i * numItersPerProcessor; 	}
             lines.push_back(numItersPerProcessor);
         }
@@ -505,7 +507,7 @@ int DistSharedCommand::createProcesses(SharedRAbundVectors*& thisLookup){
             
             //make copy of lookup so we don't get access violations
             SharedRAbundVectors* newLookup = new SharedRAbundVectors(*thisLookup);
-            distSharedData* dataBundle = new distSharedData(lines[i+1], false, subsample, subsampleSize, withReplacement, Estimators, newLookup);
+            distSharedData* dataBundle = new distSharedData(starts[i+1], lines[i+1], false, subsample, subsampleSize, withReplacement, Estimators, newLookup);
             
             data.push_back(dataBundle);
             
@@ -514,7 +516,7 @@ int DistSharedCommand::createProcesses(SharedRAbundVectors*& thisLookup){
         
         //make copy of lookup so we don't get access violations
         SharedRAbundVectors* newLookup = new SharedRAbundVectors(*thisLookup);
-        distSharedData* dataBundle = new distSharedData(lines[0], true, subsample, subsampleSize, withReplacement, Estimators, newLookup);
+        distSharedData* dataBundle = new distSharedData(starts[0], lines[0], true, subsample, subsampleSize, withReplacement, Estimators, newLookup);
         process(dataBundle);
         delete newLookup;
         
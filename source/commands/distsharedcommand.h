@@ -106,14 +106,15 @@ struct distSharedData {
     vector< vector< vector<seqDist> > > calcDistsTotals;  //each iter, one for each calc, then each groupCombos dists. this will be used to make .dist files
     vector< vector< vector<double> > > matrices; //for each calculator a square matrix to represent the distances, only filled by main thread
     vector<string>  Estimators;
-    long long numIters;
+    long long numIters, startIter;
 	MothurOut* m;
     int count, subsampleSize;
     bool mainThread, subsample, withReplacement;
 	
 	distSharedData(){}
-	distSharedData(long long st, bool mt, bool su, int subsize, bool wr, vector<string> est, SharedRAbundVectors* lu) {
+	distSharedData(long long si, long long st, bool mt, bool su, int subsize, bool wr, vector<string> est, SharedRAbundVectors* lu) {
         m = MothurOut::getInstance();
+        startIter = si;
 		numIters = st;
         Estimators = est;
         thisLookup = lu;
@@ -10,6 +10,7 @@
 #include "fastaqinfocommand.h"
 #include "sequence.hpp"
 #include "counttable.h"
+#include "sequencereader.hpp"
 
 //**********************************************************************************************************************
 vector<string> ParseFastaQCommand::setParameters(){	
@@ -517,22 +518,21 @@ int ParseFastaQCommand::processFile(vector<string> files, TrimOligos*& trimOligo
         if (fasta) { util.openOutputFile(ffastaFile, outfFasta);  outputNames.push_back(ffastaFile); outputTypes["fasta"].push_back(ffastaFile);	util.openOutputFile(rfastaFile, outrFasta);  outputNames.push_back(rfastaFile); outputTypes["fasta"].push_back(rfastaFile);}
         if (qual) { util.openOutputFile(fqualFile, outfQual);	outputNames.push_back(fqualFile);  outputTypes["qfile"].push_back(fqualFile);	util.openOutputFile(rqualFile, outrQual);	outputNames.push_back(rqualFile);  outputTypes["qfile"].push_back(rqualFile);	}
         
-        ifstream inf; util.openInputFile(inputfile, inf);
+        SequenceReader inf(inputfile, false);
+        SequenceReader inr(inputReverse, false);
         
-        ifstream inr; util.openInputFile(inputReverse, inr);
-        
-        ifstream inFIndex, inRIndex;
-        if (files[2] != "") { util.openInputFile(files[2], inFIndex);  }
-        if (files[3] != "") { util.openInputFile(files[3], inRIndex);  }
+        SequenceReader* inFIndex = nullptr; SequenceReader* inRIndex = nullptr;
+        if (files[2] != "") { inFIndex = new SequenceReader(files[2], false);  }
+        if (files[3] != "") { inRIndex = new SequenceReader(files[3], false);  }
         
         int count = 0;
-        while (!inf.eof() && !inr.eof()) {
+        while (inf.readFastq() && inr.readFastq()) {
             
             if (m->getControl_pressed()) { break; }
             
             bool ignoref, ignorer;
-            FastqRead thisfRead(inf, ignoref, format);
-            FastqRead thisrRead(inr, ignorer, format);
+            FastqRead thisfRead = inf.getFastqRead(ignoref, format);
+            FastqRead thisrRead = inr.getFastqRead(ignorer, format);
             
             if (!ignoref && ! ignorer) {
                 if (qual) {
@@ -569,13 +569,13 @@ int ParseFastaQCommand::processFile(vector<string> files, TrimOligos*& trimOligo
                     if (fileOption == 4) {
                         bool ignorefi, ignoreri;
                     
-                        if (files[2] != "") {
-                            FastqRead thisfiRead(inFIndex, ignorefi, format);
+                        if ((inFIndex != nullptr) && inFIndex->readFastq()) {
+                            FastqRead thisfiRead = inFIndex->getFastqRead(ignorefi, format);
                             if (!ignorefi) {  findexBarcode.setAligned(thisfiRead.getSequence().getAligned());  }
                         }
                         
-                        if (files[3] != "") {
-                            FastqRead thisriRead(inRIndex, ignoreri, format);
+                        if ((inRIndex != nullptr) && inRIndex->readFastq()) {
+                            FastqRead thisriRead = inRIndex->getFastqRead(ignoreri, format);
                             if (!ignoreri) {  rindexBarcode.setAligned(thisriRead.getSequence().getAligned());  }
                         }
                     }
@@ -656,9 +656,8 @@ int ParseFastaQCommand::processFile(vector<string> files, TrimOligos*& trimOligo
             }
         }
         
-        inf.close(); inr.close();
-        if (files[2] != "") { inFIndex.close();  }
-        if (files[3] != "") { inRIndex.close();  }
+        if (inFIndex != nullptr) { delete inFIndex;  }
+        if (inRIndex != nullptr) { delete inRIndex;  }
         
         if (fasta)	{ outfFasta.close(); outrFasta.close();	}
         if (qual)	{ outfQual.close();	outrQual.close();   }
@@ -694,16 +693,16 @@ set<string> ParseFastaQCommand::processFile(string inputfile, TrimOligos*& trimO
         if (fasta)  { util.openOutputFile(fastaFile, outFasta);  outputNames.push_back(fastaFile); outputTypes["fasta"].push_back(fastaFile);       }
         if (qual)   { util.openOutputFile(qualFile, outQual);	outputNames.push_back(qualFile);  outputTypes["qfile"].push_back(qualFile);         }
         
-        ifstream in; util.openInputFile(inputfile, in);
+        SequenceReader in(inputfile, false);
         
         int count = 0;
         set<string> names;
-        while (!in.eof()) {
+        while (in.readFastq()) {
             
             if (m->getControl_pressed()) { break; }
             
             bool ignore;
-            FastqRead thisRead(in, ignore, format);
+            FastqRead thisRead = in.getFastqRead(ignore, format);
             
             if (!ignore) {
                 if (qual) {  thisRead.getQuality().printQScores(outQual); }
@@ -781,7 +780,6 @@ set<string> ParseFastaQCommand::processFile(string inputfile, TrimOligos*& trimO
             }
         }
         
-        in.close();
         if (fasta)	{ outFasta.close();	}
         if (qual)	{ outQual.close();	}
         
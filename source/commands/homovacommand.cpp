@@ -13,6 +13,49 @@
 
 #include "designmap.h"
 
+//**********************************************************************************************************************
+//Bartlett's B of the sums of squares within the groups, with the samples in the given order. Group g is the samples
+//at positions groupStarts[g] to groupStarts[g+1].
+class HomovaBValue : public PermutationStatistic {
+public:
+    HomovaBValue(CondensedMatrix& d, vector<int>& g) : dists(d), groupStarts(g) {}
+    
+    double getValue(const vector<int>& order) { vector<double> ssWithinVector; return getValue(order, ssWithinVector); }
+    
+    double getValue(const vector<int>& order, vector<double>& ssWithinVector) {
+        double numGroups = (double)(groupStarts.size()-1);
+        ssWithinVector.assign(groupStarts.size()-1, 0);
+        
+        double totalNumSamples = 0; double ssWithinFull = 0; double secondTermSum = 0; double inverseOneMinusSum = 0;
+        
+        for (int g = 0; g < groupStarts.size()-1; g++) {
+            int numSamplesInGroup = groupStarts[g+1] - groupStarts[g];
+            totalNumSamples += numSamplesInGroup;
+            
+            for (int i = groupStarts[g]; i < groupStarts[g+1]; i++) {
+                for (int j = groupStarts[g]; j < i; j++) { ssWithinVector[g] += dists.get(order[i], order[j]); }
+            }
+            ssWithinVector[g] /= (double) numSamplesInGroup;
+            ssWithinFull += ssWithinVector[g];
+            
+            secondTermSum += (numSamplesInGroup - 1) * log(ssWithinVector[g] / (double)(numSamplesInGroup - 1));
+            inverseOneMinusSum += 1.0 / (double)(numSamplesInGroup - 1);
+            
+            ssWithinVector[g] /= (double)(numSamplesInGroup - 1); //this line is only for output purposes to scale SSw by the number of samples in the group
+        }
+        
+        double B = (totalNumSamples - numGroups) * log(ssWithinFull/(totalNumSamples-numGroups)) - secondTermSum;
+        double denomintor = 1 + 1.0/(3.0 * (numGroups - 1.0)) * (inverseOneMinusSum - 1.0 / (double) (totalNumSamples - numGroups));
+        B /= denomintor;
+        
+        return B;
+    }
+    
+private:
+    CondensedMatrix& dists;
+    vector<int>& groupStarts;
+};
+
 //**********************************************************************************************************************
 vector<string> HomovaCommand::setParameters(){	
 	try {
@@ -21,6 +64,7 @@ vector<string> HomovaCommand::setParameters(){
         CommandParameter psets("sets", "String", "", "", "", "", "","",false,false); parameters.push_back(psets);
 		CommandParameter piters("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter palpha("alpha", "Number", "", "0.05", "", "", "","",false,false); parameters.push_back(palpha);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -50,6 +94,7 @@ string HomovaCommand::getHelpString(){
 		helpString += "The design file looks like the group file.  It is a 2 column tab delimited file, where the first column is the sample name and the second column is the group the sample belongs to.\n";
         helpString += "The sets parameter allows you to specify which of the sets in your designfile you would like to analyze. The set names are separated by dashes. THe default is all sets in the designfile.\n";
 		helpString += "The iters parameter allows you to set number of randomization for the P value.  The default is 1000. \n";
+		helpString += "The processors parameter allows you to specify the number of processors to use. The default is all available.\n";
 		helpString += "The homova command should be in the following format: homova(phylip=file.dist, design=file.design).\n";
 		return helpString;
 	}
@@ -116,6 +161,9 @@ HomovaCommand::HomovaCommand(string option) : Command() {
 			temp = validParameter.valid(parameters, "alpha");
 			if (temp == "not found") { temp = "0.05"; }
 			util.mothurConvert(temp, experimentwiseAlpha); 
+			
+			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
             
             string sets = validParameter.valid(parameters, "sets");			
 			if (sets == "not found") { sets = ""; }
@@ -170,6 +218,8 @@ int HomovaCommand::execute(){
 		for(int i=0;i<distanceMatrix.size();i++){
 			for(int j=0;j<i;j++){ distanceMatrix[i][j] *= distanceMatrix[i][j];	 }
 		}
+		distances = CondensedMatrix(distanceMatrix);
+		distanceMatrix.clear();
 		
 		//link designMap to rows/columns in distance matrix
 		map<string, vector<int> > origGroupSampleMap;
@@ -195,7 +245,8 @@ int HomovaCommand::execute(){
 		HOMOVAFile << "HOMOVA\tBValue\tP-value\tSSwithin/(Ni-1)_values" << endl;
 		m->mothurOut("HOMOVA\tBValue\tP-value\tSSwithin/(Ni-1)_values\n");
 		
-		double fullHOMOVAPValue = runHOMOVA(HOMOVAFile, origGroupSampleMap, experimentwiseAlpha);
+		PermutationTest test(processors);
+		double fullHOMOVAPValue = runHOMOVA(HOMOVAFile, test, origGroupSampleMap, experimentwiseAlpha);
 
 		if(fullHOMOVAPValue <= experimentwiseAlpha && numGroups > 2){
 			
@@ -212,7 +263,7 @@ int HomovaCommand::execute(){
 					pairwiseGroupSampleMap[itA->first] = itA->second;
 					pairwiseGroupSampleMap[itB->first] = itB->second;
 					
-					runHOMOVA(HOMOVAFile, pairwiseGroupSampleMap, pairwiseAlpha);
+					runHOMOVA(HOMOVAFile, test, pairwiseGroupSampleMap, pairwiseAlpha);
 				}			
 			}
 			HOMOVAFile << endl;
@@ -238,21 +289,29 @@ int HomovaCommand::execute(){
 }
 //**********************************************************************************************************************
 
-double HomovaCommand::runHOMOVA(ofstream& HOMOVAFile, map<string, vector<int> > groupSampleMap, double alpha){
+double HomovaCommand::runHOMOVA(ofstream& HOMOVAFile, PermutationTest& test, map<string, vector<int> > groupSampleMap, double alpha){
 	try {
 		map<string, vector<int> >::iterator it;
 		int numGroups = groupSampleMap.size();
 		
+		//the distances between this comparison's samples, with each group's samples next to each other
+		vector<int> samples; vector<int> groupStarts;
+		for(it = groupSampleMap.begin();it!=groupSampleMap.end();it++){
+			groupStarts.push_back(samples.size());
+			samples.insert(samples.end(), it->second.begin(), it->second.end());
+		}
+		groupStarts.push_back(samples.size());
+		
+		CondensedMatrix dists(distances, samples);
+		HomovaBValue bValue(dists, groupStarts);
+		
+		vector<int> order(samples.size());
+		for (int i = 0; i < order.size(); i++) { order[i] = i; }
+		
 		vector<double> ssWithinOrigVector;
-		double bValueOrig = calcBValue(groupSampleMap, ssWithinOrigVector);
+		double bValueOrig = bValue.getValue(order, ssWithinOrigVector);
 		
-		double counter = 0;
-		for(int i=0;i<iters;i++){
-			vector<double> ssWithinRandVector;
-			map<string, vector<int> > randomizedGroup = getRandomizedGroups(groupSampleMap);
-			double bValueRand = calcBValue(randomizedGroup, ssWithinRandVector);
-			if(bValueRand >= bValueOrig){	counter++;	}
-		}
+		int counter = test.run(&bValue, samples.size(), iters, bValueOrig, true);
 		
 		double pValue = (double) counter / (double) iters;
 		string pString = "";
@@ -294,96 +353,3 @@ double HomovaCommand::runHOMOVA(ofstream& HOMOVAFile, map<string, vector<int> >
 }
 
 //**********************************************************************************************************************
-
-double HomovaCommand::calcSigleSSWithin(vector<int> sampleIndices) {
-	try {
-		double ssWithin = 0.0;
-		int numSamplesInGroup = sampleIndices.size();
-		
-		for(int i=0;i<numSamplesInGroup;i++){
-			int row = sampleIndices[i];
-			
-			for(int j=0;j<numSamplesInGroup;j++){
-				int col = sampleIndices[j];
-				
-				if(col < row){ ssWithin += distanceMatrix[row][col]; }
-			}
-		}
-		
-		ssWithin /= (double) numSamplesInGroup;
-		return ssWithin;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "HomovaCommand", "calcSigleSSWithin");
-		exit(1);
-	}
-}
-
-//**********************************************************************************************************************
-
-double HomovaCommand::calcBValue(map<string, vector<int> > groupSampleMap, vector<double>& ssWithinVector) {
-	try {
-		double numGroups = (double)groupSampleMap.size();
-		ssWithinVector.resize(numGroups, 0);
-		
-		double totalNumSamples = 0; double ssWithinFull = 0; double secondTermSum = 0; double inverseOneMinusSum = 0; int index = 0;
-		
-		for(map<string, vector<int> >::iterator it = groupSampleMap.begin();it!=groupSampleMap.end();it++){
-			int numSamplesInGroup = it->second.size();
-			totalNumSamples += numSamplesInGroup;
-			
-			ssWithinVector[index] = calcSigleSSWithin(it->second);
-			ssWithinFull += ssWithinVector[index];
-			
-			secondTermSum += (numSamplesInGroup - 1) * log(ssWithinVector[index] / (double)(numSamplesInGroup - 1));
-			inverseOneMinusSum += 1.0 / (double)(numSamplesInGroup - 1);
-			
-			ssWithinVector[index] /= (double)(numSamplesInGroup - 1); //this line is only for output purposes to scale SSw by the number of samples in the group
-			index++;
-		}
-		
-		double B = (totalNumSamples - numGroups) * log(ssWithinFull/(totalNumSamples-numGroups)) - secondTermSum;
-		double denomintor = 1 + 1.0/(3.0 * (numGroups - 1.0)) * (inverseOneMinusSum - 1.0 / (double) (totalNumSamples - numGroups));
-		B /= denomintor;
-		
-		return B;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "HomovaCommand", "calcBValue");
-		exit(1);
-	}
-}
-//**********************************************************************************************************************
-
-map<string, vector<int> > HomovaCommand::getRandomizedGroups(map<string, vector<int> > origMapping){
-	try{
-		vector<int> sampleIndices;
-		vector<int> samplesPerGroup;
-		
-		for(map<string, vector<int> >::iterator it=origMapping.begin();it!=origMapping.end();it++){
-			vector<int> indices = it->second;
-			samplesPerGroup.push_back(indices.size());
-			sampleIndices.insert(sampleIndices.end(), indices.begin(), indices.end());
-		}
-		
-		util.mothurRandomShuffle(sampleIndices);
-		
-		int index = 0;
-		map<string, vector<int> > randomizedGroups = origMapping;
-		for(map<string, vector<int> >::iterator it=randomizedGroups.begin();it!=randomizedGroups.end();it++){
-			for(int i=0;i<it->second.size();i++){
-				it->second[i] = sampleIndices[index++];				
-			}
-		}
-		
-		return randomizedGroups;		
-	}
-	catch (exception& e) {
-		m->errorOut(e, "AmovaCommand", "randomizeGroups");
-		exit(1);
-	}
-}
-
-//**********************************************************************************************************************
-
-
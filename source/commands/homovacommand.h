@@ -12,6 +12,7 @@
 
 
 #include "command.hpp"
+#include "permutationtest.hpp"
 
 class DesignMap;
 
@@ -34,16 +35,14 @@ public:
 	void help() { m->mothurOut(getHelpString()); }	
 	
 private:
-	double runHOMOVA(ofstream& , map<string, vector<int> >, double);
-	double calcSigleSSWithin(vector<int>);
-	double calcBValue(map<string, vector<int> >, vector<double>&);
-	map<string, vector<int> > getRandomizedGroups(map<string, vector<int> >);
+	double runHOMOVA(ofstream& , PermutationTest&, map<string, vector<int> >, double);
 
 	bool abort;
 	vector<string> outputNames, Sets;
 	string  inputDir, designFileName, phylipFileName;
 	vector< vector<double> > distanceMatrix;
-	int iters;
+	CondensedMatrix distances;
+	int iters, processors;
 	double experimentwiseAlpha;
 };
 
@@ -9,6 +9,7 @@
 #include "makecontigscommand.h"
 #include "contigsreport.hpp"
 #include "counttable.h"
+#include "sequencepipeline.hpp"
 
 //**************************************************************************************************
 
@@ -1690,18 +1691,149 @@ vector<int> trimBarCodesAndPrimers(Sequence& fSeq, Sequence& rSeq, QualityScores
 }
 //**********************************************************************************************************************
 //vector<vector<string> > fastaFileNames, vector<vector<string> > qualFileNames, , string group
-void driverContigs(contigsData* params){
-    try {
-        vector< vector<double> > qual_match_simple_bayesian;
+//what one thread needs to assemble read pairs
+struct contigsAssembler {
+    vector< vector<double> > qual_match_simple_bayesian, qual_mismatch_simple_bayesian;
+    vector<TrimOligos*> trims;
+    Alignment* alignment;
+    int numPrimers, numBarcodes;
+    bool hasQuality, hasIndex;
+
+    contigsAssembler(contigsData* params, bool hasQ, bool hasI) : hasQuality(hasQ), hasIndex(hasI) {
         qual_match_simple_bayesian.resize(47);
         for (int i = 0; i < qual_match_simple_bayesian.size(); i++) { qual_match_simple_bayesian[i].resize(47);  }
 
-        vector< vector<double> > qual_mismatch_simple_bayesian;
         qual_mismatch_simple_bayesian.resize(47);
         for (int i = 0; i < qual_mismatch_simple_bayesian.size(); i++) { qual_mismatch_simple_bayesian[i].resize(47);  }
 
         loadQmatchValues(qual_match_simple_bayesian, qual_mismatch_simple_bayesian);
 
+        numPrimers = params->pairedPrimers.size();
+        numBarcodes = params->pairedBarcodes.size();
+
+        if ((numPrimers != 0) || (numBarcodes != 0)) {
+            //standard
+            trims.push_back(new TrimOligos(params->pdiffs, params->bdiffs, 0, 0, params->pairedPrimers, params->pairedBarcodes, hasIndex));
+
+            if (params->reorient) {
+                //reoriented
+                trims.push_back(new TrimOligos(params->pdiffs, params->bdiffs, 0, 0, params->reorientedPairedPrimers, params->reorientedPairedBarcodes, hasIndex));
+                //reversed
+                trims.push_back(new TrimOligos(params->pdiffs, params->bdiffs, 0, 0, params->reversedPairedPrimers, params->reversedPairedBarcodes, hasIndex));
+            }
+        }
+
+        int longestBase = 1000;
+        if(params->align == "gotoh")			{	alignment = new GotohOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, longestBase);			}
+        else if(params->align == "needleman")	{	alignment = new NeedlemanOverlap(params->gapOpen, params->match, params->misMatch, longestBase);                        }
+        else if(params->align == "kmer")        {   alignment = new KmerAlign(params->kmerSize);                                                                            }
+    }
+    ~contigsAssembler() {
+        for (int i = 0; i < trims.size(); i++) {  delete trims[i]; }
+        delete alignment;
+    }
+};
+/**************************************************************************************************/
+//output[0] = trim fasta, output[1] = scrap fasta, output[2] = trim qual, output[3] = scrap qual, output[4] = mismatches
+void assembleContig(Sequence& fSeq, Sequence& rSeq, QualityScores*& fQual, QualityScores*& rQual, Sequence& findexBarcode, Sequence& rindexBarcode, contigsAssembler& assembler, contigsData* params, vector<string>& output) {
+    try {
+        bool ignore = false;
+        bool hasQuality = assembler.hasQuality;
+        int numBarcodes = assembler.numBarcodes;
+        int numPrimers = assembler.numPrimers;
+
+        //remove primers and barcodes if neccessary
+        vector<string> codes;
+        vector<int> oligosResults = trimBarCodesAndPrimers(fSeq, rSeq, fQual, rQual, findexBarcode, rindexBarcode, assembler.trims, codes, numBarcodes, numPrimers, hasQuality, assembler.hasIndex, params->pdiffs, params->bdiffs, params->tdiffs, params->m);
+
+        string trashCode = codes[0];
+        string commentString = codes[1];
+        int barcodeIndex = oligosResults[0];
+        int primerIndex = oligosResults[1];
+
+        //assemble reads
+        string contig = "";
+        int oend, oStart;
+        int numMismatches = 0;
+        vector<int> scores1, scores2;
+        if(hasQuality){
+            scores1 = fQual->getScores(); scores2 = rQual->getScores();
+        }
+        vector<int> contigScores = assembleFragments(assembler.qual_match_simple_bayesian, assembler.qual_mismatch_simple_bayesian, fSeq, rSeq, scores1, scores2, hasQuality, assembler.alignment, contig, trashCode, oend, oStart, numMismatches, params->insert, params->deltaq, params->trimOverlap);
+
+        //Note that usearch/vsearch cap the maximum Q value at 41 - perhaps due to ascii
+        //limits? we leave this value unbounded. if two sequences have a 40 then the
+        //assembled quality score will be 85. If two 250 nt reads are all 40 and they
+        //perfectly match each other, then the difference in the number of expected errors
+        //between using 85 and 41 all the way across will be 0.01986 - this is a "worst"
+        //case scenario
+
+        double expected_errors = 0;
+        for(int i=0;i<contigScores.size();i++){
+            expected_errors += convertQToProb(contigScores[i]);
+        }
+
+        if(expected_errors > params->maxee) { trashCode += 'e' ;}
+
+        if (params->screenSequences) { screenSequence(contig, trashCode, params); }
+
+        if(trashCode.length() == 0){
+            string thisGroup = params->group; //group from file file
+            if (params->createGroupFromOligos) { //overwrite file file group for oligos group
+                if(numBarcodes != 0){
+                    thisGroup = params->barcodeNameVector[barcodeIndex];
+                    if (numPrimers != 0) {
+                        if (params->primerNameVector[primerIndex] != "") {
+                            if(thisGroup != "") { thisGroup += "." + params->primerNameVector[primerIndex]; }
+                            else                { thisGroup = params->primerNameVector[primerIndex];        }
+                        }
+                    }
+                }
+            }
+
+            int pos = thisGroup.find("ignore");
+            if (pos == string::npos) {
+                if (thisGroup != "") {
+                    params->groupMap[fSeq.getName()] = thisGroup;
+
+                    map<string, int>::iterator it = params->groupCounts.find(thisGroup);
+                    if (it == params->groupCounts.end()) {	params->groupCounts[thisGroup] = 1; }
+                    else { params->groupCounts[it->first] ++; }
+                }
+            }else { ignore = true; }
+
+            //print good stuff
+            if(!ignore){
+                //output
+                output[0] += ">" + fSeq.getName() + '\t' + "ee=" + toString(expected_errors) + '\t' + commentString + "\n" + contig + "\n";
+                if (hasQuality && params->makeQualFile) {
+                    output[2] += ">" + fSeq.getName() + '\t' + "ee=" + toString(expected_errors) + '\t' + commentString +"\n";
+                    for (int i = 0; i < contigScores.size(); i++) { output[2] += toString(contigScores[i]) + " "; }  output[2] += "\n";
+                }
+                int numNs = 0;
+                for (int i = 0; i < contig.length(); i++) { if (contig[i] == 'N') { numNs++; }  }
+                output[4] += fSeq.getName() + '\t' + toString(contig.length()) + '\t' + toString(oend-oStart) + '\t' + toString(oStart) + '\t' + toString(oend) + '\t' + toString(numMismatches) + '\t' + toString(numNs) + '\t' + toString(expected_errors) + "\n";
+            }
+        }else{
+            params->badNames.insert(fSeq.getName());
+
+            output[1] += ">" + fSeq.getName() + " | " + trashCode + '\t' + "ee=" +  toString(expected_errors) + '\t' + commentString + "\n" + contig + "\n";
+
+            if (hasQuality && params->makeQualFile) {
+                output[3] += ">" + fSeq.getName() + " | " + trashCode + '\t' + "ee=" + toString(expected_errors) + '\t' + commentString + "\n";
+                for (int i = 0; i < contigScores.size(); i++) { output[3] += toString(contigScores[i]) + " "; }  output[3] += "\n";
+            }
+        }
+        if (params->m->getDebug()) { params->m->mothurOut("\n"); }
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "MakeContigsCommand", "assembleContig");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void driverContigs(contigsData* params){
+    try {
         params->count = 0;
         string thisfqualindexfile, thisrqualindexfile, thisffastafile, thisrfastafile;
         thisfqualindexfile = ""; thisrqualindexfile = "";
@@ -1766,25 +1898,8 @@ void driverContigs(contigsData* params){
 
         if (params->m->getDebug()) { if (hasQuality) { params->m->mothurOut("[DEBUG]: hasQuality = true\n");  } else { params->m->mothurOut("[DEBUG]: hasQuality = false\n"); } }
 
-        int numPrimers = params->pairedPrimers.size();
-        int numBarcodes = params->pairedBarcodes.size();
-        
-        vector<TrimOligos*> trims;
-        if ((numPrimers != 0) || (numBarcodes != 0)) {
-            //standard
-            trims.push_back(new TrimOligos(params->pdiffs, params->bdiffs, 0, 0, params->pairedPrimers, params->pairedBarcodes, hasIndex));
-    
-            if (params->reorient) {
-                //reoriented
-                trims.push_back(new TrimOligos(params->pdiffs, params->bdiffs, 0, 0, params->reorientedPairedPrimers, params->reorientedPairedBarcodes, hasIndex));
-                //reversed
-                trims.push_back(new TrimOligos(params->pdiffs, params->bdiffs, 0, 0, params->reversedPairedPrimers, params->reversedPairedBarcodes, hasIndex));
-            }
-        }
-        Alignment* alignment; int longestBase = 1000;
-        if(params->align == "gotoh")			{	alignment = new GotohOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, longestBase);			}
-        else if(params->align == "needleman")	{	alignment = new NeedlemanOverlap(params->gapOpen, params->match, params->misMatch, longestBase);                        }
-        else if(params->align == "kmer")        {   alignment = new KmerAlign(params->kmerSize);                                                                            }
+        contigsAssembler assembler(params, hasQuality, hasIndex);
+        vector<string> output(5, "");
 
         bool good = true;
         while (good) {
@@ -1806,96 +1921,15 @@ void driverContigs(contigsData* params){
             }
 
             if (!ignore) {
-                //remove primers and barcodes if neccessary
-                vector<string> codes;
-                vector<int> oligosResults = trimBarCodesAndPrimers(fSeq, rSeq, fQual, rQual, findexBarcode, rindexBarcode, trims, codes, numBarcodes, numPrimers, hasQuality, hasIndex, params->pdiffs, params->bdiffs, params->tdiffs, params->m);
-                
-                string trashCode = codes[0];
-                string commentString = codes[1];
-                int barcodeIndex = oligosResults[0];
-                int primerIndex = oligosResults[1];
-                
-                //assemble reads
-                string contig = "";
-                int oend, oStart;
-                int numMismatches = 0;
-                vector<int> scores1, scores2;
-                if(hasQuality){
-                    scores1 = fQual->getScores(); scores2 = rQual->getScores();
-                    delete fQual; delete rQual;
-                }
-                vector<int> contigScores = assembleFragments(qual_match_simple_bayesian, qual_mismatch_simple_bayesian, fSeq, rSeq, scores1, scores2, hasQuality, alignment, contig, trashCode, oend, oStart, numMismatches, params->insert, params->deltaq, params->trimOverlap);
-
-								//Note that usearch/vsearch cap the maximum Q value at 41 - perhaps due to ascii
-								//limits? we leave this value unbounded. if two sequences have a 40 then the
-								//assembled quality score will be 85. If two 250 nt reads are all 40 and they
- 								//perfectly match each other, then the difference in the number of expected errors
-								//between using 85 and 41 all the way across will be 0.01986 - this is a "worst"
-								//case scenario
+                assembleContig(fSeq, rSeq, fQual, rQual, findexBarcode, rindexBarcode, assembler, params, output);
 
-								double expected_errors = 0;
-								for(int i=0;i<contigScores.size();i++){
-									expected_errors += convertQToProb(contigScores[i]);
-								}
-
-								if(expected_errors > params->maxee) { trashCode += 'e' ;}
-                
-                if (params->screenSequences) { screenSequence(contig, trashCode, params); }
-
-                if(trashCode.length() == 0){
-                    string thisGroup = params->group; //group from file file
-                    if (params->createGroupFromOligos) { //overwrite file file group for oligos group
-                        if(numBarcodes != 0){
-                            thisGroup = params->barcodeNameVector[barcodeIndex];
-                            if (numPrimers != 0) {
-                                if (params->primerNameVector[primerIndex] != "") {
-                                    if(thisGroup != "") { thisGroup += "." + params->primerNameVector[primerIndex]; }
-                                    else                { thisGroup = params->primerNameVector[primerIndex];        }
-                                }
-                            }
-                        }
-                    }
-
-                    int pos = thisGroup.find("ignore");
-                    if (pos == string::npos) {
-                        if (thisGroup != "") {
-                            params->groupMap[fSeq.getName()] = thisGroup;
-
-                            map<string, int>::iterator it = params->groupCounts.find(thisGroup);
-                            if (it == params->groupCounts.end()) {	params->groupCounts[thisGroup] = 1; }
-                            else { params->groupCounts[it->first] ++; }
-                        }
-                    }else { ignore = true; }
-
-                    //print good stuff
-                    if(!ignore){
-                        //output
-                        string output = ">" + fSeq.getName() + '\t' + "ee=" + toString(expected_errors) + '\t' + commentString + "\n" + contig + "\n";
-                        params->trimFileName->write(output);
-                        if (hasQuality && params->makeQualFile) {
-                            output = ">" + fSeq.getName() + '\t' + "ee=" + toString(expected_errors) + '\t' + commentString +"\n";
-                            for (int i = 0; i < contigScores.size(); i++) { output += toString(contigScores[i]) + " "; }  output += "\n";
-                            params->trimQFileName->write(output);
-                        }
-                        int numNs = 0;
-                        for (int i = 0; i < contig.length(); i++) { if (contig[i] == 'N') { numNs++; }  }
-                        output = fSeq.getName() + '\t' + toString(contig.length()) + '\t' + toString(oend-oStart) + '\t' + toString(oStart) + '\t' + toString(oend) + '\t' + toString(numMismatches) + '\t' + toString(numNs) + '\t' + toString(expected_errors) + "\n";
-                        params->misMatchesFile->write(output);
-                    }
-                }else{
-                    params->badNames.insert(fSeq.getName());
-
-                    string output = ">" + fSeq.getName() + " | " + trashCode + '\t' + "ee=" +  toString(expected_errors) + '\t' + commentString + "\n" + contig + "\n";
-                    params->scrapFileName->write(output);
-
-                    if (hasQuality && params->makeQualFile) {
-                        output = ">" + fSeq.getName() + " | " + trashCode + '\t' + "ee=" + toString(expected_errors) + '\t' + commentString + "\n";
-                        for (int i = 0; i < contigScores.size(); i++) { output += toString(contigScores[i]) + " "; }  output += "\n";
-                        params->scrapQFileName->write(output);
-                    }
-                }
-                if (params->m->getDebug()) { params->m->mothurOut("\n"); }
+                if (output[0] != "") { params->trimFileName->write(output[0]);     output[0] = ""; }
+                if (output[1] != "") { params->scrapFileName->write(output[1]);    output[1] = ""; }
+                if (output[2] != "") { params->trimQFileName->write(output[2]);    output[2] = ""; }
+                if (output[3] != "") { params->scrapQFileName->write(output[3]);   output[3] = ""; }
+                if (output[4] != "") { params->misMatchesFile->write(output[4]);   output[4] = ""; }
             }
+            delete fQual; delete rQual;
             params->count++;
 
 #if defined NON_WINDOWS
@@ -1959,11 +1993,6 @@ void driverContigs(contigsData* params){
                 }
             }
         }
-
-        //cleanup memory
-        for (int i = 0; i < trims.size(); i++) {  delete trims[i]; }
-        delete alignment;
-        
     }
     catch(exception& e) {
         params->m->errorOut(e, "MakeContigsCommand", "driverContigs");
@@ -1971,6 +2000,95 @@ void driverContigs(contigsData* params){
     }
 }
 //**********************************************************************************************************************
+#ifdef USE_BOOST
+//read pairs a thread assembles together, see assembleContig for the outputs
+struct contigsPair {
+    Sequence fSeq, rSeq, findexBarcode, rindexBarcode;
+    QualityScores* fQual;
+    QualityScores* rQual;
+    bool ignore;
+
+    contigsPair() : findexBarcode("findex", "NONE"), rindexBarcode("rindex", "NONE"), fQual(nullptr), rQual(nullptr), ignore(false) {}
+};
+struct contigsBatch : public PipelineBatch {
+    vector<contigsPair> pairs;
+
+    contigsBatch(int numOutputs) : PipelineBatch(numOutputs) {}
+    ~contigsBatch() { for (int i = 0; i < pairs.size(); i++) { delete pairs[i].fQual; delete pairs[i].rQual; } }
+
+    int size() { return pairs.size(); }
+};
+/**************************************************************************************************/
+//decompresses a gzipped pair of fastq or fasta files, with their index or qual files, into batches of read pairs
+class contigsPairReader : public PipelineReader {
+public:
+    contigsPairReader(contigsData* p) : params(p), endOfFile(false) {
+        fqualindexfile = ""; rqualindexfile = "";
+        if (params->qualOrIndexFiles.size() != 0) {
+            fqualindexfile = params->qualOrIndexFiles[0];
+            rqualindexfile = params->qualOrIndexFiles[1];
+        }
+
+        params->util.openInputFileBinary(params->inputFiles[0], inFFasta, inFF);
+        params->util.openInputFileBinary(params->inputFiles[1], inRFasta, inRF);
+
+        if (fqualindexfile != "") {
+            if (fqualindexfile != "NONE") { params->util.openInputFileBinary(fqualindexfile, inFQualIndex, inFQ); }
+            else { fqualindexfile = ""; }
+            if (rqualindexfile != "NONE") { params->util.openInputFileBinary(rqualindexfile, inRQualIndex, inRQ); }
+            else { rqualindexfile = ""; }
+        }
+    }
+    ~contigsPairReader() {
+        inFF.reset(); inRF.reset(); inFQ.reset(); inRQ.reset();
+        inFFasta.close(); inRFasta.close(); inFQualIndex.close(); inRQualIndex.close();
+    }
+
+    //same reads as driverContigs, which stops when either file ends
+    PipelineBatch* read(int batchSize, int numOutputs) {
+        if (endOfFile) { return nullptr; }
+
+        contigsBatch* batch = new contigsBatch(numOutputs);
+        batch->pairs.reserve(batchSize);
+        while (batch->pairs.size() < batchSize) {
+            batch->pairs.push_back(contigsPair());
+            contigsPair& pair = batch->pairs.back();
+            pair.ignore = ::read(pair.fSeq, pair.rSeq, pair.fQual, pair.rQual, pair.findexBarcode, pair.rindexBarcode, params->delim, inFF, inRF, inFQ, inRQ, fqualindexfile, rqualindexfile, params->format, params->nameType, params->offByOneTrimLength, params->m);
+
+            if (inFF.eof() || inRF.eof()) { endOfFile = true; break; }
+        }
+        return batch;
+    }
+
+private:
+    contigsData* params;
+    string fqualindexfile, rqualindexfile;
+    ifstream inFFasta, inRFasta, inFQualIndex, inRQualIndex;
+    boost::iostreams::filtering_istream inFF, inRF, inFQ, inRQ;
+    bool endOfFile;
+};
+/**************************************************************************************************/
+//assembles the read pairs of a batch, one per thread. params holds the thread's bad names and groups.
+class contigsWorker : public PipelineWorker {
+public:
+    contigsWorker(contigsData* p, bool hasQuality, bool hasIndex) : params(p), assembler(p, hasQuality, hasIndex) {}
+
+    void process(PipelineBatch* batch) {
+        contigsBatch* thisBatch = (contigsBatch*)batch;
+        for (int i = 0; i < thisBatch->pairs.size(); i++) {
+            if (m->getControl_pressed()) { break; }
+
+            contigsPair& pair = thisBatch->pairs[i];
+            if (!pair.ignore) { assembleContig(pair.fSeq, pair.rSeq, pair.fQual, pair.rQual, pair.findexBarcode, pair.rindexBarcode, assembler, params, batch->output); }
+        }
+    }
+
+private:
+    contigsData* params;
+    contigsAssembler assembler;
+};
+#endif
+//**********************************************************************************************************************
 //fileInputs[0] = forward Fasta or Forward Fastq, fileInputs[1] = reverse Fasta or reverse Fastq. if qualOrIndexFiles.size() != 0, then qualOrIndexFiles[0] = forward qual or Forward index, qualOrIndexFiles[1] = reverse qual or reverse index.
 //lines[0] - ffasta, lines[1] - rfasta) - processor1
 //lines[2] - ffasta, lines[3] - rfasta) - processor2
@@ -1994,6 +2112,12 @@ unsigned long long MakeContigsCommand::createProcesses(vector<string> fileInputs
                 lines.push_back(linePair(0, 1000));
                 qLines.push_back(linePair(0, 1000));
             }
+#ifdef USE_BOOST
+            //a single pair of files, so decompress it here and give batches of read pairs to the processors
+            if ((processors > 1) && (fileInputs.size() == 2)) {
+                return createProcessesGz(fileInputs, qualOrIndexFiles, outputFasta, outputScrapFasta, outputQual, outputScrapQual, outputMisMatches, group, pairedPrimers, rpairedPrimers, revpairedPrimers, pairedBarcodes, rpairedBarcodes, revpairedBarcodes, barcodeNames, primerNames);
+            }
+#endif
             processors = fileInputs.size() / 2;
         }else        {
             //divides the files so that the processors can share the workload.
@@ -2099,6 +2223,69 @@ unsigned long long MakeContigsCommand::createProcesses(vector<string> fileInputs
     }
 }
 //**********************************************************************************************************************
+#ifdef USE_BOOST
+//one pair of gzipped files. Decompression can't be split at a file position, so this thread reads the files and
+//processors threads assemble the read pairs in batches. The outputs are written in the order of the reads.
+unsigned long long MakeContigsCommand::createProcessesGz(vector<string> fileInputs, vector<string> qualOrIndexFiles, string outputFasta, string outputScrapFasta, string outputQual, string outputScrapQual, string outputMisMatches, string group, map<int, oligosPair>& pairedPrimers, map<int, oligosPair>& rpairedPrimers, map<int, oligosPair>& revpairedPrimers, map<int, oligosPair>& pairedBarcodes, map<int, oligosPair>& rpairedBarcodes, map<int, oligosPair>& revpairedBarcodes, vector<string>& barcodeNames, vector<string>& primerNames) {
+    try {
+        bool hasQuality = false;
+        bool hasIndex = false;
+        if (delim == '@') {
+            hasQuality = true;
+            if (qualOrIndexFiles.size() != 0) {
+                if ((qualOrIndexFiles[0] != "NONE") || (qualOrIndexFiles[1] != "NONE")) { hasIndex = true; }
+            }
+        }else if ((delim == '>') && (qualOrIndexFiles.size() != 0))  { hasQuality = true; }
+
+        vector<contigsData*> data;
+        vector<PipelineWorker*> workers;
+        for (int i = 0; i < processors; i++) {
+            contigsData* dataBundle = new contigsData(nullptr, nullptr, nullptr, nullptr, nullptr, fileInputs, qualOrIndexFiles, linePair(0, 1000), linePair(0, 1000), linePair(0, 1000), linePair(0, 1000));
+            dataBundle->setVariables(gz, delim, nameType, offByOneTrimLength, pairedBarcodes, pairedPrimers, rpairedBarcodes, rpairedPrimers, revpairedBarcodes, revpairedPrimers, primerNames, barcodeNames, reorient, pdiffs, bdiffs, tdiffs, align, match, misMatch, gapOpen, gapExtend, insert, deltaq, maxee, kmerSize, format, trimOverlap, createOligosGroup, createFileGroup, group, screenSequences, maxHomoP, maxLength, maxAmbig);
+            dataBundle->makeQualFile = makeQualFile;
+            data.push_back(dataBundle);
+            workers.push_back(new contigsWorker(dataBundle, hasQuality, hasIndex));
+        }
+
+        ofstream outFasta, outScrapFasta, outQual, outScrapQual, outMisMatch;
+        util.openOutputFile(outputFasta, outFasta);
+        util.openOutputFile(outputScrapFasta, outScrapFasta);
+        if (makeQualFile) {
+            util.openOutputFile(outputQual, outQual);
+            util.openOutputFile(outputScrapQual, outScrapQual);
+        }
+        util.openOutputFile(outputMisMatches, outMisMatch);
+        vector<ostream*> outputs; outputs.push_back(&outFasta); outputs.push_back(&outScrapFasta); outputs.push_back(&outQual); outputs.push_back(&outScrapQual); outputs.push_back(&outMisMatch);
+
+        contigsPairReader reader(data[0]);
+        SequencePipeline pipeline(&reader);
+        long long num = pipeline.run(workers, outputs);
+
+        outFasta.close(); outScrapFasta.close(); outMisMatch.close();
+        if (makeQualFile) { outQual.close(); outScrapQual.close(); }
+
+        for (int i = 0; i < data.size(); i++) {
+            badNames.insert(data[i]->badNames.begin(), data[i]->badNames.end());
+            groupMap.insert(data[i]->groupMap.begin(), data[i]->groupMap.end());
+            //merge counts
+            for (map<string, int>::iterator it = data[i]->groupCounts.begin(); it != data[i]->groupCounts.end(); it++) {
+                map<string, int>::iterator itMine = groupCounts.find(it->first);
+                if (itMine != groupCounts.end()) { itMine->second += it->second; }
+                else { groupCounts[it->first] = it->second; }
+            }
+            delete workers[i];
+            delete data[i];
+        }
+
+        return num;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "MakeContigsCommand", "createProcessesGz");
+        exit(1);
+    }
+}
+#endif
+//**********************************************************************************************************************
 //process one file at a time, only get here with gz=true
 void driverContigsGroups(groupContigsData* gparams) {
     try {
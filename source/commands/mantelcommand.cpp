@@ -9,7 +9,158 @@
 
 #include "mantelcommand.h"
 #include "readphylipvector.h"
+#include "permutationtest.hpp"
 
+//**********************************************************************************************************************
+//pearson correlation of the cells of x with the cells of y, with the samples of y in the given order. The means and
+//sums of squares don't change when the samples are reordered, so only the products are summed for each order.
+class MantelPearson : public PermutationStatistic {
+public:
+    MantelPearson(CondensedMatrix& x, CondensedMatrix& y) : matrixY(y) {
+        centeredX = x.cells;
+        double averageX = 0.0, averageY = 0.0;
+        for (long long i = 0; i < centeredX.size(); i++) { averageX += centeredX[i]; averageY += y.cells[i]; }
+        averageX /= (double) centeredX.size(); averageY /= (double) centeredX.size();
+        
+        double denomTerm1 = 0.0, denomTerm2 = 0.0;
+        for (long long i = 0; i < centeredX.size(); i++) {
+            centeredX[i] -= averageX;
+            denomTerm1 += centeredX[i] * centeredX[i];
+            denomTerm2 += (y.cells[i] - averageY) * (y.cells[i] - averageY);
+        }
+        denom = sqrt(denomTerm1) * sqrt(denomTerm2);
+    }
+    
+    double getValue(const vector<int>& order) {
+        double numerator = 0.0;
+        long long index = 0;
+        for (int i = 1; i < matrixY.getNumRows(); i++) {
+            for (int j = 0; j < i; j++) { numerator += centeredX[index++] * matrixY.get(order[i], order[j]); }
+        }
+        
+        double r = numerator / denom;
+        
+        //divide by zero error
+        if (isnan(r) || isinf(r)) { r = 0.0; }
+        
+        return r;
+    }
+    
+private:
+    CondensedMatrix& matrixY;
+    vector<double> centeredX;
+    double denom;
+};
+//**********************************************************************************************************************
+//spearman correlation, the ranks of both matrices are found once
+class MantelSpearman : public PermutationStatistic {
+public:
+    MantelSpearman(CondensedMatrix& x, CondensedMatrix& y) : ranksX(x), ranksY(y) {
+        double Lx = ranksX.convertToRanks();
+        double Ly = ranksY.convertToRanks();
+        
+        double n = (double) ranksX.getNumCells();
+        SX2 = ((pow(n, 3.0) - n) / 12.0) - Lx;
+        SY2 = ((pow(n, 3.0) - n) / 12.0) - Ly;
+    }
+    
+    double getValue(const vector<int>& order) {
+        double di = 0.0;
+        long long index = 0;
+        for (int i = 1; i < ranksY.getNumRows(); i++) {
+            for (int j = 0; j < i; j++) {
+                double diff = ranksX.cells[index++] - ranksY.get(order[i], order[j]);
+                di += diff * diff;
+            }
+        }
+        
+        double r = (SX2 + SY2 - di) / (2.0 * sqrt((SX2*SY2)));
+        
+        //divide by zero error
+        if (isnan(r) || isinf(r)) { r = 0.0; }
+        
+        return r;
+    }
+    
+private:
+    CondensedMatrix ranksX, ranksY;
+    double SX2, SY2;
+};
+//**********************************************************************************************************************
+//kendall's tau-a. The cells are visited in order of x, and a binary indexed tree of the y levels already visited
+//counts how many are below and above each cell's y, so each order takes n log n instead of n^2 for n cells.
+class MantelKendall : public PermutationStatistic {
+public:
+    MantelKendall(CondensedMatrix& x, CondensedMatrix& y) {
+        //the cells in order of x
+        vector< pair<double, long long> > sorted(x.cells.size());
+        for (long long i = 0; i < x.cells.size(); i++) { sorted[i] = make_pair(x.cells[i], i); }
+        sort(sorted.begin(), sorted.end());
+        
+        vector<int> rows(x.cells.size()), cols(x.cells.size());
+        long long index = 0;
+        for (int i = 1; i < x.getNumRows(); i++) {
+            for (int j = 0; j < i; j++) { rows[index] = i; cols[index] = j; index++; }
+        }
+        
+        for (long long i = 0; i < sorted.size(); i++) {
+            cellRows.push_back(rows[sorted[i].second]); cellCols.push_back(cols[sorted[i].second]);
+            if ((i == 0) || (sorted[i].first != sorted[i-1].first)) { tieStarts.push_back(i); }
+        }
+        tieStarts.push_back(sorted.size());
+        
+        //the levels of y, 1 for the smallest value
+        vector<double> values = y.cells;
+        sort(values.begin(), values.end());
+        values.erase(unique(values.begin(), values.end()), values.end());
+        numLevels = values.size();
+        
+        levelsY.resize(y.cells.size());
+        for (long long i = 0; i < y.cells.size(); i++) { levelsY[i] = (lower_bound(values.begin(), values.end(), y.cells[i]) - values.begin()) + 1; }
+    }
+    
+    double getValue(const vector<int>& order) {
+        vector<long long> tree(numLevels+1, 0);
+        long long numCoor = 0, numDisCoor = 0, numVisited = 0;
+        
+        for (int t = 0; t < tieStarts.size()-1; t++) {
+            //cells tied in x are neither concordant nor discordant, so they are added to the tree after the group
+            for (long long c = tieStarts[t]; c < tieStarts[t+1]; c++) {
+                int level = getLevel(order, c);
+                
+                long long numBelow = 0, numAtOrBelow = 0;
+                for (int l = level-1; l > 0; l -= (l & (-l))) { numBelow += tree[l]; }
+                for (int l = level; l > 0; l -= (l & (-l))) { numAtOrBelow += tree[l]; }
+                
+                numCoor += numBelow;
+                numDisCoor += numVisited - numAtOrBelow;
+            }
+            
+            for (long long c = tieStarts[t]; c < tieStarts[t+1]; c++) {
+                for (int l = getLevel(order, c); l <= numLevels; l += (l & (-l))) { tree[l]++; }
+                numVisited++;
+            }
+        }
+        
+        double n = (double) levelsY.size();
+        double r = (numCoor - numDisCoor) / ((n * (n - 1.0)) / 2.0);
+        
+        //divide by zero error
+        if (isnan(r) || isinf(r)) { r = 0.0; }
+        
+        return r;
+    }
+    
+private:
+    vector<int> cellRows, cellCols, levelsY;
+    vector<long long> tieStarts;
+    int numLevels;
+    
+    int getLevel(const vector<int>& order, long long c) {
+        int i = order[cellRows[c]]; int j = order[cellCols[c]];
+        return (i > j) ? levelsY[CondensedMatrix::getIndex(i, j)] : levelsY[CondensedMatrix::getIndex(j, i)];
+    }
+};
 
 //**********************************************************************************************************************
 vector<string> MantelCommand::setParameters(){	
@@ -18,6 +169,7 @@ vector<string> MantelCommand::setParameters(){
 		CommandParameter pphylip2("phylip2", "InputTypes", "", "", "none", "none", "none","mantel",false,true,true); parameters.push_back(pphylip2);
 		CommandParameter piters("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter pmethod("method", "Multiple", "pearson-spearman-kendall", "pearson", "", "", "","",false,false); parameters.push_back(pmethod);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -42,9 +194,10 @@ string MantelCommand::getHelpString(){
 		string helpString = "";
 		helpString += "Sokal, R. R., & Rohlf, F. J. (1995). Biometry, 3rd edn. New York: Freeman.\n";
 		helpString += "The mantel command reads two distance matrices and calculates the mantel correlation coefficient.\n";
-		helpString += "The mantel command parameters are phylip1, phylip2, iters and method.  The phylip1 and phylip2 parameters are required.  Matrices must be the same size and contain the same names.\n";
+		helpString += "The mantel command parameters are phylip1, phylip2, iters, method and processors.  The phylip1 and phylip2 parameters are required.  Matrices must be the same size and contain the same names.\n";
 		helpString += "The method parameter allows you to select what method you would like to use. Options are pearson, spearman and kendall. Default=pearson.\n";
 		helpString += "The iters parameter allows you to set number of randomization for the P value.  The default is 1000. \n";
+		helpString += "The processors parameter allows you to specify the number of processors to use. The default is all available.\n";
 		helpString += "The mantel command should be in the following format: mantel(phylip1=veg.dist, phylip2=env.dist).\n";
 		helpString += "The mantel command outputs a .mantel file.\n";
 		return helpString;
@@ -97,6 +250,9 @@ MantelCommand::MantelCommand(string option) : Command()  {
 			string temp = validParameter.valid(parameters, "iters");			if (temp == "not found") { temp = "1000"; }
 			util.mothurConvert(temp, iters);
 			
+			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
+			
 			if ((method != "pearson") && (method != "spearman") && (method != "kendall")) { m->mothurOut(method + " is not a valid method. Valid methods are pearson, spearman, and kendall.\n"); abort = true; }
 		}
 	}
@@ -145,32 +301,20 @@ int MantelCommand::execute(){
 		//    calculating mantel and signifigance		   //
 		/***************************************************/
 		
-		//calc mantel coefficient
-		LinearAlgebra linear;
-		double mantel = 0.0;
-		if (method == "pearson")		{  mantel = linear.calcPearson(matrix1, matrix2);	}
-		else if (method == "spearman")	{  mantel = linear.calcSpearman(matrix1, matrix2);	}
-		else if (method == "kendall")	{  mantel = linear.calcKendall(matrix1, matrix2);	}
+		//calc mantel coefficient, and signifigance by reordering the samples of matrix2
+		CondensedMatrix matrixX(matrix1);
+		CondensedMatrix matrixY(matrix2);
+		int numSamples = matrixX.getNumRows();
 		
+		PermutationStatistic* statistic = nullptr;
+		if (method == "pearson")		{  statistic = new MantelPearson(matrixX, matrixY);		}
+		else if (method == "spearman")	{  statistic = new MantelSpearman(matrixX, matrixY);	}
+		else if (method == "kendall")	{  statistic = new MantelKendall(matrixX, matrixY);		}
 		
-		//calc signifigance
-		int count = 0;
-		for (int i = 0; i < iters; i++) {
-			
-			if (m->getControl_pressed()) { return 0; }
-			
-			//randomize matrix2
-			vector< vector<double> > matrix2Copy = matrix2;
-			util.mothurRandomShuffle(matrix2Copy);
-		
-			//calc random mantel
-			double randomMantel = 0.0;
-			if (method == "pearson")		{  randomMantel = linear.calcPearson(matrix1, matrix2Copy);	}
-			else if (method == "spearman")	{  randomMantel = linear.calcSpearman(matrix1, matrix2Copy);	}
-			else if (method == "kendall")	{  randomMantel = linear.calcKendall(matrix1, matrix2Copy);	}
-			
-			if (randomMantel >= mantel) { count++; }
-		}
+		PermutationTest test(processors);
+		double mantel = test.getObserved(statistic, numSamples);
+		int count = test.run(statistic, numSamples, iters, mantel, true);
+		delete statistic;
 		
 		double pValue = count / (float) iters;
 		
@@ -34,7 +34,7 @@ private:
 	
 	string phylipfile1, phylipfile2,  method;
 	bool abort;
-	int iters;
+	int iters, processors;
 	
 	vector<string> outputNames;
 };
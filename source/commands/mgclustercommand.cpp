@@ -292,7 +292,7 @@ int MGClusterCommand::runOptiCluster(){
         else if (metric == "fdr")        { metricCalc = new FDR();              }
         else if (metric == "fpfn")       { metricCalc = new FPFN();             }
         
-        OptiCluster cluster(matrix, metricCalc, 0);
+        OptiCluster cluster(matrix, metricCalc, 0, 1);
         string tag = cluster.getTag();
         
         map<string, string> variables;
@@ -17,7 +17,7 @@ vector<string> PairwiseSeqsCommand::setParameters(){
         CommandParameter poldfasta("oldfasta", "InputTypes", "", "", "none", "none", "OldFastaColumn","",false,false); parameters.push_back(poldfasta);
         CommandParameter pfitcalc("fitcalc", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pfitcalc);
 		CommandParameter pfasta("fasta", "InputTypes", "", "", "none", "none", "none","phylip-column",false,true,true); parameters.push_back(pfasta);
-		CommandParameter palign("align", "Multiple", "needleman-gotoh-noalign", "needleman", "", "", "","",false,false); parameters.push_back(palign);
+		CommandParameter palign("align", "Multiple", "needleman-gotoh-noalign-striped", "needleman", "", "", "","",false,false); parameters.push_back(palign);
 		CommandParameter pmatch("match", "Number", "", "1.0", "", "", "","",false,false); parameters.push_back(pmatch);
 		CommandParameter pmismatch("mismatch", "Number", "", "-1.0", "", "", "","",false,false); parameters.push_back(pmismatch);
 		CommandParameter pgapopen("gapopen", "Number", "", "-2.0", "", "", "","",false,false); parameters.push_back(pgapopen);
@@ -57,7 +57,7 @@ string PairwiseSeqsCommand::getHelpString(){
 		helpString += "The pairwise.seqs command reads a fasta file and creates distance matrix.\n";
 		helpString += "The pairwise.seqs command parameters are fasta, align, match, mismatch, gapopen, gapextend, calc, output, cutoff, oldfasta, column, processors.\n";
 		helpString += "The fasta parameter is required.\n";
-		helpString += "The align parameter allows you to specify the alignment method to use.  Your options are: gotoh, needleman and noalign. The default is needleman.\n";
+		helpString += "The align parameter allows you to specify the alignment method to use.  Your options are: gotoh, needleman, striped and noalign. The default is needleman. The striped option gives the same alignments as needleman using a faster SIMD implementation.\n";
 		helpString += "The match parameter allows you to specify the bonus for having the same base. The default is 1.0.\n";
 		helpString += "The mistmatch parameter allows you to specify the penalty for having different bases.  The default is -1.0.\n";
 		helpString += "The gapopen parameter allows you to specify the penalty for opening a gap in an alignment. The default is -2.0.\n";
@@ -447,6 +447,7 @@ int driverColumn(pairwiseData* params){
         Alignment* alignment;
         if(params->align == "gotoh")			{	alignment = new GotohOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, params->longestBase);			}
         else if(params->align == "needleman")	{	alignment = new NeedlemanOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
+        else if(params->align == "striped")     {	alignment = new StripedNeedleman(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
         else if(params->align == "noalign")		{	alignment = new NoAlign();													}
         else {
             params->m->mothurOut(params->align + " is not a valid alignment option. I will run the command using needleman.\n");
@@ -526,6 +527,7 @@ int driverFitCalc(pairwiseData* params){
         Alignment* alignment;
         if(params->align == "gotoh")			{	alignment = new GotohOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, params->longestBase);			}
         else if(params->align == "needleman")	{	alignment = new NeedlemanOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
+        else if(params->align == "striped")     {	alignment = new StripedNeedleman(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
         else if(params->align == "noalign")		{	alignment = new NoAlign();													}
         else {
             params->m->mothurOut(params->align + " is not a valid alignment option. I will run the command using needleman.\n");
@@ -606,6 +608,7 @@ int driverLt(pairwiseData* params){
         Alignment* alignment;
         if(params->align == "gotoh")			{	alignment = new GotohOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, params->longestBase);			}
         else if(params->align == "needleman")	{	alignment = new NeedlemanOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
+        else if(params->align == "striped")     {	alignment = new StripedNeedleman(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
         else if(params->align == "noalign")		{	alignment = new NoAlign();													}
         else {
             params->m->mothurOut(params->align + " is not a valid alignment option. I will run the command using needleman.\n");
@@ -692,6 +695,7 @@ int driverSquare(pairwiseData* params){
         Alignment* alignment;
         if(params->align == "gotoh")			{	alignment = new GotohOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, params->longestBase);			}
         else if(params->align == "needleman")	{	alignment = new NeedlemanOverlap(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
+        else if(params->align == "striped")     {	alignment = new StripedNeedleman(params->gapOpen, params->match, params->misMatch, params->longestBase);				}
         else if(params->align == "noalign")		{	alignment = new NoAlign();													}
         else {
             params->m->mothurOut(params->align + " is not a valid alignment option. I will run the command using needleman.\n");
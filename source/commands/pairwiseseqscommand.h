@@ -21,6 +21,7 @@
 
 #include "gotohoverlap.hpp"
 #include "needlemanoverlap.hpp"
+#include "stripedneedleman.hpp"
 #include "noalign.hpp"
 
 #include "ignoregaps.h"
@@ -17,6 +17,8 @@ vector<string> PCOACommand::setParameters(){
 	try {
 		CommandParameter pphylip("phylip", "InputTypes", "", "", "none", "none", "none","pcoa-loadings",false,true,true); parameters.push_back(pphylip);
 		CommandParameter pmetric("metric", "Boolean", "", "T", "", "", "","",false,false); parameters.push_back(pmetric);
+        CommandParameter paxes("axes", "Number", "", "0", "", "", "","",false,false); parameters.push_back(paxes);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -40,9 +42,11 @@ vector<string> PCOACommand::setParameters(){
 string PCOACommand::getHelpString(){	
 	try {
 		string helpString = "";
-		helpString += "The pcoa command parameters are phylip and metric"; 
+		helpString += "The pcoa command parameters are phylip, metric, axes and processors"; 
 		helpString += "The phylip parameter allows you to enter your distance file.";
 		helpString += "The metric parameter allows indicate you if would like the pearson correlation coefficient calculated. Default=True"; 
+		helpString += "The axes parameter allows you to specify the number of axes to output. Only the leading axes are calculated when there are many more samples than axes, which is much faster for large distance matrices. Default=0, meaning all axes.\n";
+		helpString += "The processors parameter allows you to specify the number of processors to use. The default is all available.\n";
 		helpString += "Example pcoa(phylip=yourDistanceFile).\n";
 		return helpString;
 	}
@@ -95,6 +99,13 @@ PCOACommand::PCOACommand(string option) : Command()  {
 			
 			string temp = validParameter.valid(parameters, "metric");	if (temp == "not found"){	temp = "T";				}
 			metric = util.isTrue(temp); 
+			
+			temp = validParameter.valid(parameters, "axes");	if (temp == "not found"){	temp = "0";				}
+			util.mothurConvert(temp, axes);
+			if (axes < 0) { m->mothurOut("[ERROR]: axes must be 0 or more.\n"); abort = true; }
+			
+			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
 		}
 
 	}
@@ -124,31 +135,42 @@ int PCOACommand::execute(){
 		
 		if (m->getControl_pressed()) { return 0; }
    	
-		double offset = 0.0000;
+		int rank = names.size();
+		if ((axes == 0) || (axes > rank)) { axes = rank; }
+		
 		vector<double> d;
-		vector<double> e;
-		vector<vector<double> > G = D;
-		//vector<vector<double> > copy_G;
+		vector<vector<double> > G;
+		double dsum = 0.0000;
 				
 		m->mothurOut("\nProcessing...\n");
 		
-		for(int count=0;count<2;count++){
-			linearCalc.recenter(offset, D, G);		if (m->getControl_pressed()) { return 0; }
-			linearCalc.tred2(G, d, e);				if (m->getControl_pressed()) { return 0; }
-			linearCalc.qtli(d, e, G);				if (m->getControl_pressed()) { return 0; }
-			offset = d[d.size()-1];
-			if(offset > 0.0) break;
-		} 
+		if ((2*axes + 20) < rank) { //only a few of many axes, find them without the full decomposition
+			getLeadingAxes(D, G, d, dsum);
+		}else {
+			double offset = 0.0000;
+			vector<double> e;
+			
+			for(int count=0;count<2;count++){
+				linearCalc.recenter(offset, D, G);		if (m->getControl_pressed()) { return 0; }
+				linearCalc.tred2(G, d, e);				if (m->getControl_pressed()) { return 0; }
+				linearCalc.qtli(d, e, G);				if (m->getControl_pressed()) { return 0; }
+				offset = d[d.size()-1];
+				if(offset > 0.0) break;
+			} 
+			
+			for(int i=0;i<rank;i++){ dsum += d[i]; }
+			d.resize(axes);
+		}
 		
 		if (m->getControl_pressed()) { return 0; }
 		
-		output(fbase, names, G, d);
+		output(fbase, names, G, d, dsum);
 		
 		if (m->getControl_pressed()) { for (int i = 0; i < outputNames.size(); i++) {	util.mothurRemove(outputNames[i]);  } return 0; }
 		
 		if (metric) {   
 			
-			for (int i = 1; i < 4; i++) {
+			for (int i = 1; i < min(4, axes+1); i++) {
 							
 				vector< vector<double> > EuclidDists = linearCalc.calculateEuclidianDistance(G, i); //G is the pcoa file
 				
@@ -186,14 +208,43 @@ void PCOACommand::get_comment(istream& f, char begin, char end){
 	}
 }	
 /*********************************************************************************************************************************/
+//The same axes as the full decomposition in execute, from the leading eigenvectors of the centered matrix.
+//When the smallest eigenvalue is negative, execute recenters with offset = that eigenvalue and decomposes again. Adding the offset
+//to the distances subtracts offset * C from the centered matrix, so the eigenvectors stay the same and their values go up by -offset.
+void PCOACommand::getLeadingAxes(vector<vector<double> >& D, vector<vector<double> >& G, vector<double>& d, double& dsum) {
+	try {
+		int rank = D.size();
+		
+		vector<double> gower; //the centered matrix in one block, so the threads multiply it a row at a time
+		linearCalc.recenter(0.0, D, gower);  if (m->getControl_pressed()) { return; }
+		
+		double trace = 0.0;
+		for (int i = 0; i < rank; i++) { trace += gower[((size_t)i)*rank+i]; }
+		
+		linearCalc.lanczos(gower, rank, axes, true, processors, d, G);  if (m->getControl_pressed()) { return; }
+		
+		vector<double> smallest; vector<vector<double> > smallestVector;
+		linearCalc.lanczos(gower, rank, 1, false, processors, smallest, smallestVector);  if (m->getControl_pressed()) { return; }
+		
+		double offset = smallest[0];
+		if (offset > 0.0) { offset = 0.0; }
+		
+		for (int i = 0; i < d.size(); i++) { d[i] -= offset; }
+		dsum = trace - offset * (rank - 1);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PCOACommand", "getLeadingAxes");
+		exit(1);
+	}
+}
+/*********************************************************************************************************************************/
 
-void PCOACommand::output(string fnameRoot, vector<string> name_list, vector<vector<double> >& G, vector<double> d) {
+void PCOACommand::output(string fnameRoot, vector<string> name_list, vector<vector<double> >& G, vector<double> d, double dsum) {
 	try {
 		int rank = name_list.size();
-		double dsum = 0.0000;
+		int numAxes = d.size();
 		for(int i=0;i<rank;i++){
-			dsum += d[i];
-			for(int j=0;j<rank;j++){
+			for(int j=0;j<numAxes;j++){
 				if(d[j] >= 0)	{	G[i][j] *= pow(d[j],0.5);	}
 				else			{	G[i][j] = 0.00000;			}
 			}
@@ -218,19 +269,19 @@ void PCOACommand::output(string fnameRoot, vector<string> name_list, vector<vect
 		outputTypes["loadings"].push_back(loadingsFile);	
 		
 		pcaLoadings << "axis\tloading\n";
-		for(int i=0;i<rank;i++){
+		for(int i=0;i<numAxes;i++){
 			pcaLoadings << i+1 << '\t' << d[i] * 100.0 / dsum << endl;
 		}
 		
 		pcaData << "group";
-		for(int i=0;i<rank;i++){
+		for(int i=0;i<numAxes;i++){
 			pcaData << '\t' << "axis" << i+1;
 		}
 		pcaData << endl;
 		
 		for(int i=0;i<rank;i++){
 			pcaData << name_list[i];
-			for(int j=0;j<rank;j++){
+			for(int j=0;j<numAxes;j++){
 				pcaData  << '\t' << G[i][j];
 			}
 			pcaData << endl;
@@ -17,6 +17,10 @@
 /*****************************************************************/
 class PCOACommand : public Command {
 	
+#ifdef UNIT_TEST
+    friend class TestPCoACommand;
+#endif
+	
 public:
 	PCOACommand(string);	
 	~PCOACommand(){}
@@ -36,12 +40,14 @@ public:
 private:
 
 	bool abort, metric;
+	int axes, processors;
 	string phylipfile, filename, fbase;
 	vector<string> outputNames;
 	LinearAlgebra linearCalc;
 	
 	void get_comment(istream&, char, char);
-	void output(string, vector<string>, vector<vector<double> >&, vector<double>);
+	void output(string, vector<string>, vector<vector<double> >&, vector<double>, double);
+	void getLeadingAxes(vector<vector<double> >&, vector<vector<double> >&, vector<double>&, double&);
 	
 };
 	
@@ -927,73 +927,45 @@ int ScreenSeqsCommand::getSummary(){
 }
 //**********************************************************************************************************************
 
-void driverScreen(sumScreenData* params){
+void ScreenWorker::process(PipelineBatch* batch){
 	try {
-		ifstream inFASTA;
-		params->util.openInputFile(params->filename, inFASTA);
-
-        inFASTA.seekg(params->start);
-
-        //print header if you are process 0
-        if (params->start == 0) { params->util.zapGremlins(inFASTA); gobble(inFASTA); }
-
-		bool done = false;
-		params->count = 0;
-        
-		while (!done) {
+		for (int i = 0; i < batch->seqs.size(); i++) {
 		
-			if (params->m->getControl_pressed()) {  break; }
+			if (m->getControl_pressed()) {  break; }
 			
-			Sequence currSeq(inFASTA); gobble(inFASTA);
-			if (currSeq.getName() != "") {
-				bool goodSeq = true;		//	innocent until proven guilty
-                string trashCode = "";
-                //have the report files found you bad
-                map<string, string>::iterator it = params->badSeqNames.find(currSeq.getName());
-                if (it != params->badSeqNames.end()) { goodSeq = 0;  trashCode = it->second; }
-                
-                if (params->summaryfile == "") { //summaryfile includes these so no need to check again
-                    if(params->startPos != -1 && params->startPos < currSeq.getStartPos())			{	goodSeq = false;	trashCode += "start|";  }
-                    if(params->endPos != -1 && params->endPos > currSeq.getEndPos())				{	goodSeq = false;	trashCode += "end|";    }
-                    if(params->maxAmbig != -1 && params->maxAmbig <	currSeq.getAmbigBases())		{	goodSeq = false;	trashCode += "ambig|";  }
-                    if(params->maxHomoP != -1 && params->maxHomoP < currSeq.getLongHomoPolymer())	{	goodSeq = false;	trashCode += "homop|";  }
-                    if(params->minLength > currSeq.getNumBases())                                   {	goodSeq = false;	trashCode += "<length|";}
-                    if(params->maxLength != -1 && params->maxLength < currSeq.getNumBases())		{	goodSeq = false;	trashCode += ">length|";}
-                    
-                    if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: " + currSeq.getName() + "\t" + toString(currSeq.getStartPos()) + "\t" + toString(currSeq.getEndPos()) + "\t" + toString(currSeq.getNumBases()) + "\n"); }
-                }
+			Sequence& currSeq = batch->seqs[i];
+            
+            bool goodSeq = true;		//	innocent until proven guilty
+            string trashCode = "";
+            //have the report files found you bad
+            map<string, string>::iterator it = badSeqNames.find(currSeq.getName());
+            if (it != badSeqNames.end()) { goodSeq = 0;  trashCode = it->second; }
+            
+            if (summaryfile == "") { //summaryfile includes these so no need to check again
+                if(startPos != -1 && startPos < currSeq.getStartPos())			{	goodSeq = false;	trashCode += "start|";  }
+                if(endPos != -1 && endPos > currSeq.getEndPos())				{	goodSeq = false;	trashCode += "end|";    }
+                if(maxAmbig != -1 && maxAmbig <	currSeq.getAmbigBases())		{	goodSeq = false;	trashCode += "ambig|";  }
+                if(maxHomoP != -1 && maxHomoP < currSeq.getLongHomoPolymer())	{	goodSeq = false;	trashCode += "homop|";  }
+                if(minLength > currSeq.getNumBases())                           {	goodSeq = false;	trashCode += "<length|";}
+                if(maxLength != -1 && maxLength < currSeq.getNumBases())		{	goodSeq = false;	trashCode += ">length|";}
                 
-                if (params->contigsreport == "") { //contigs report includes this so no need to check again
-                    if(params->maxN != -1 && params->maxN < currSeq.getNumNs())                     {	goodSeq = false;	trashCode += "n|"; }
-                }
-				
-				if(goodSeq){
-					currSeq.printSequence(params->outputWriter);
-				}else{
-					string badAccnos = currSeq.getName() + '\t' + trashCode.substr(0, trashCode.length()-1) + '\n';
-                    params->accnosWriter->write(badAccnos);
-					params->badSeqNames[currSeq.getName()] = trashCode;
-				}
-                params->count++;
-			}
-			
-			#if defined NON_WINDOWS
-				unsigned long long pos = inFASTA.tellg();
-				if ((pos == -1) || (pos >= params->end)) { break; }
-			#else
-				if (params->end == params->count) { break; }
-			#endif
-			
-			//report progress
-			if((params->count) % 1000 == 0){	params->m->mothurOutJustToScreen(toString(params->count)+"\n"); 		}
+                if (m->getDebug()) { m->mothurOut("[DEBUG]: " + currSeq.getName() + "\t" + toString(currSeq.getStartPos()) + "\t" + toString(currSeq.getEndPos()) + "\t" + toString(currSeq.getNumBases()) + "\n"); }
+            }
+            
+            if (contigsreport == "") { //contigs report includes this so no need to check again
+                if(maxN != -1 && maxN < currSeq.getNumNs())                     {	goodSeq = false;	trashCode += "n|"; }
+            }
+            
+            if(goodSeq){
+                batch->output[0] += '>' + currSeq.getName() + currSeq.getComment() + '\n' + currSeq.getAligned() + '\n';
+            }else{
+                batch->output[1] += currSeq.getName() + '\t' + trashCode.substr(0, trashCode.length()-1) + '\n';
+                badSeqNames[currSeq.getName()] = trashCode;
+            }
 		}
-		//report progress
-		if((params->count) % 1000 != 0){	params->m->mothurOutJustToScreen(toString(params->count)+"\n"); 	}
-		
-		inFASTA.close();
 	}
 	catch(exception& e) {
-		params->m->errorOut(e, "ScreenSeqsCommand", "driverScreen");
+		m->errorOut(e, "ScreenSeqsCommand", "driverScreen");
 		exit(1);
 	}
 }
@@ -1001,78 +973,33 @@ void driverScreen(sumScreenData* params){
 
 int ScreenSeqsCommand::createProcesses(string goodFileName, string badAccnos, string filename, map<string, string>& badSeqNames) {
 	try {
-        
-        vector<linePair> lines;
-        vector<double> positions;
-#if defined NON_WINDOWS
-        positions = util.divideFile(fastafile, processors);
-        for (int i = 0; i < (positions.size()-1); i++) { lines.push_back(linePair(positions[i], positions[(i+1)])); }
-#else
-        
-        long long numFastaSeqs = 0;
-        positions = util.setFilePosFasta(fastafile, numFastaSeqs);
-        if (numFastaSeqs < processors) { processors = numFastaSeqs; }
-        
-        //figure out how many sequences you have to process
-        int numSeqsPerProcessor = numFastaSeqs / processors;
+        vector<PipelineWorker*> workers;
+        vector<ScreenWorker*> screenWorkers;
         for (int i = 0; i < processors; i++) {
-            int startIndex =  i * numSeqsPerProcessor;
-            if(i == (processors - 1)){	numSeqsPerProcessor = numFastaSeqs - i * numSeqsPerProcessor; 	}
-            lines.push_back(linePair(positions[startIndex], numSeqsPerProcessor));
+            ScreenWorker* worker = new ScreenWorker(startPos, endPos, maxAmbig, maxHomoP, minLength, maxLength, maxN, badSeqNames, summaryfile, contigsreport);
+            screenWorkers.push_back(worker); workers.push_back(worker);
         }
         
-#endif
-        
-        //create array of worker threads
-        vector<std::thread*> workerThreads;
-        vector<sumScreenData*> data;
-        
-        long long num = 0;
-        
         time_t start, end;
         time(&start);
         
-        auto synchronizedOutputFile = std::make_shared<SynchronizedOutputFile>(goodFileName);
-        auto synchronizedAccnosFile = std::make_shared<SynchronizedOutputFile>(badAccnos);
+        ofstream outGood; util.openOutputFile(goodFileName, outGood);
+        ofstream outAccnos; util.openOutputFile(badAccnos, outAccnos);
+        vector<ostream*> outputs; outputs.push_back(&outGood); outputs.push_back(&outAccnos);
         
-        //Lauch worker threads
-        for (int i = 0; i < processors-1; i++) {
-            
-            OutputWriter* outputThreadWriter = new OutputWriter(synchronizedOutputFile);
-            OutputWriter* accnosThreadWriter = new OutputWriter(synchronizedAccnosFile);
-            
-            sumScreenData* dataBundle = new sumScreenData(startPos, endPos, maxAmbig, maxHomoP, minLength, maxLength, maxN, badSeqNames, filename, summaryfile, contigsreport, lines[i+1].start, lines[i+1].end,outputThreadWriter, accnosThreadWriter);
-            
-            data.push_back(dataBundle);
-            workerThreads.push_back(new std::thread(driverScreen, dataBundle));
-        }
+        SequencePipeline pipeline(filename);
+        long long num = pipeline.run(workers, outputs);
         
-        OutputWriter* outputThreadWriter = new OutputWriter(synchronizedOutputFile);
-        OutputWriter* accnosThreadWriter = new OutputWriter(synchronizedAccnosFile);
-
-        sumScreenData* dataBundle = new sumScreenData(startPos, endPos, maxAmbig, maxHomoP, minLength, maxLength, maxN, badSeqNames, filename, summaryfile, contigsreport, lines[0].start, lines[0].end,outputThreadWriter, accnosThreadWriter);
-        driverScreen(dataBundle);
-        num = dataBundle->count;
-        for (map<string, string>::iterator it = dataBundle->badSeqNames.begin(); it != dataBundle->badSeqNames.end(); it++) {	badSeqNames[it->first] = it->second;       }
-  
-        
-        for (int i = 0; i < processors-1; i++) {
-            workerThreads[i]->join();
-            num += data[i]->count;
-            
-            for (map<string, string>::iterator it = data[i]->badSeqNames.begin(); it != data[i]->badSeqNames.end(); it++) {	badSeqNames[it->first] = it->second;       }
-            
-            delete data[i]->outputWriter;
-            delete data[i]->accnosWriter;
-            delete data[i];
-            delete workerThreads[i];
+        outGood.close(); outAccnos.close();
+        
+        for (int i = 0; i < screenWorkers.size(); i++) {
+            for (map<string, string>::iterator it = screenWorkers[i]->badSeqNames.begin(); it != screenWorkers[i]->badSeqNames.end(); it++) {	badSeqNames[it->first] = it->second;       }
+            delete screenWorkers[i];
         }
         long long numRemoved = badSeqNames.size();
         
         time(&end);
         m->mothurOut("\nIt took " + toString(difftime(end, start)) + " secs to screen " + toString(num) + " sequences, removed " + toString(numRemoved) + ".\n\n");
-        delete outputThreadWriter; delete accnosThreadWriter;
-        delete dataBundle;
         return num;
         
 	}
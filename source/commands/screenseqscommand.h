@@ -12,7 +12,7 @@
 #include "mothur.h"
 #include "command.hpp"
 #include "sequence.hpp"
-#include "writer.h"
+#include "sequencepipeline.hpp"
 
 class ScreenSeqsCommand : public Command {
 	
@@ -59,43 +59,20 @@ private:
     
 };
 /**************************************************************************************************/
-//custom data structure for threads to use.
-// This is passed by void pointer so it can be any data type
-// that can be passed using a single void pointer (LPVOID).
-struct sumScreenData {
-    int startPos, endPos, maxAmbig, maxHomoP, minLength, maxLength, maxN;
-	unsigned long long start;
-	unsigned long long end;
-	int count;
-	MothurOut* m;
-	string goodFName, badAccnosFName, filename;
+//one per thread, badSeqNames starts with the sequences the reports removed
+class ScreenWorker : public PipelineWorker {
+public:
+    ScreenWorker(int s, int e, int a, int h, int minl, int maxl, int mn, map<string, string> bs, string sum, string cont) :
+        startPos(s), endPos(e), maxAmbig(a), maxHomoP(h), minLength(minl), maxLength(maxl), maxN(mn), badSeqNames(bs), summaryfile(sum), contigsreport(cont) {}
+    ~ScreenWorker() = default;
+    
+    void process(PipelineBatch*);  //output 0 is the good sequences and 1 the bad accnos
+    
     map<string, string> badSeqNames;
+    
+private:
+    int startPos, endPos, maxAmbig, maxHomoP, minLength, maxLength, maxN;
     string summaryfile, contigsreport;
-    Utils util;
-    OutputWriter* outputWriter;
-    OutputWriter* accnosWriter;
-	
-	
-	sumScreenData(){}
-    sumScreenData(int s, int e, int a, int h, int minl, int maxl, int mn, map<string, string> bs, string f, string sum, string cont, unsigned long long st, unsigned long long en, OutputWriter* oWriter, OutputWriter* aWriter) {
-		startPos = s;
-		endPos = e;
-		minLength = minl;
-        maxLength = maxl;
-		maxAmbig = a;
-		maxHomoP = h;
-        maxN = mn;
-		filename = f;
-        outputWriter = oWriter;
-        accnosWriter = aWriter;
-        m = MothurOut::getInstance();
-		start = st;
-		end = en;
-        summaryfile = sum;
-        contigsreport = cont;
-        badSeqNames = bs;
-		count = 0;
-	}
 };
 /**************************************************************************************************/
 
@@ -15,6 +15,7 @@ vector<string> ShhherCommand::setParameters(){
 		CommandParameter pflow("flow", "InputTypes", "", "", "none", "fileflow", "none","fasta-name-group-counts-qfile",false,false,true); parameters.push_back(pflow);
 		CommandParameter pfile("file", "InputTypes", "", "", "none", "fileflow", "none","fasta-name-group-counts-qfile",false,false,true); parameters.push_back(pfile);
 		CommandParameter plookup("lookup", "InputTypes", "", "", "none", "none", "none","",false,false,true); parameters.push_back(plookup);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pcutoff("cutoff", "Number", "", "0.01", "", "", "","",false,false); parameters.push_back(pcutoff);
 		CommandParameter pmaxiter("maxiter", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(pmaxiter);
         CommandParameter plarge("large", "Number", "", "-1", "", "", "","",false,false); parameters.push_back(plarge);
@@ -51,6 +52,7 @@ string ShhherCommand::getHelpString(){
         helpString += "The flow parameter is used to input your flow file.\n";
         helpString += "The file parameter is used to input the *flow.files file created by trim.flows.\n";
         helpString += "The lookup parameter is used specify the lookup file you would like to use. http://www.mothur.org/wiki/Lookup_files.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use. The default is all available.\n";
         helpString += "The order parameter options are A, B or I.  Default=A. A = TACG and B = TACGTACGTACGATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATAGATCGCATGACGATCGCATATCGTCAGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATAGATCGCATGACGATCGCATATCGTCAGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATAGATCGCATGACGATCGCATATCGTCAGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGATCTCAGTCAGCAGC and I = TACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGC.\n";
 		return helpString;
 	}
@@ -179,6 +181,9 @@ ShhherCommand::ShhherCommand(string option) : Command() {
                 
             }else						{	lookupFileName = temp;	}
 			
+			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
+			
 			temp = validParameter.valid(parameters, "cutoff");	if (temp == "not found"){	temp = "0.01";		}
 			util.mothurConvert(temp, cutoff); 
 			
@@ -373,7 +378,6 @@ int ShhherCommand::driver(vector<string> filenames, string thisCompositeFASTAFil
                 vector<string> seqNameVector;
                 vector<int> lengths;
                 vector<short> flowDataIntI;
-                vector<double> flowDataPrI;
                 map<string, int> nameMap;
                 vector<short> uniqueFlowgrams;
                 vector<int> uniqueCount;
@@ -388,7 +392,7 @@ int ShhherCommand::driver(vector<string> filenames, string thisCompositeFASTAFil
                 if (m->getControl_pressed()) { break; }
                 
                 m->mothurOut("Identifying unique flowgrams...\n");
-                int numUniques = getUniques(numSeqs, numFlowCells, uniqueFlowgrams, uniqueCount, uniqueLengths, mapSeqToUnique, mapUniqueToSeq, lengths, flowDataPrI, flowDataIntI);
+                int numUniques = getUniques(numSeqs, numFlowCells, uniqueFlowgrams, uniqueCount, uniqueLengths, mapSeqToUnique, mapUniqueToSeq, lengths, flowDataIntI);
                 
                 if (m->getControl_pressed()) { break; }
                 
@@ -397,7 +401,7 @@ int ShhherCommand::driver(vector<string> filenames, string thisCompositeFASTAFil
                 begTime = time(nullptr);
                
                 
-                flowDistParentFork(numFlowCells, distFileName, numUniques, mapUniqueToSeq, mapSeqToUnique, lengths, flowDataPrI, flowDataIntI);
+                flowDistParentFork(numFlowCells, distFileName, numUniques, mapUniqueToSeq, mapSeqToUnique, lengths, flowDataIntI);
                 
                 m->mothurOutEndLine();
                 m->mothurOut("Total time: " + toString(time(nullptr) - begTime) + '\t' + toString((clock() - begClock)/CLOCKS_PER_SEC) + '\n');
@@ -477,7 +481,7 @@ int ShhherCommand::driver(vector<string> filenames, string thisCompositeFASTAFil
                     
                     if (m->getControl_pressed()) { break; }
                     
-                    calcCentroidsDriver(numOTUs, cumNumSeqs, nSeqsPerOTU, seqIndex, change, centroids, singleTau, mapSeqToUnique, uniqueFlowgrams, flowDataIntI, lengths, numFlowCells, seqNumber);
+                    calcCentroids(numOTUs, cumNumSeqs, nSeqsPerOTU, seqIndex, change, centroids, singleTau, mapSeqToUnique, uniqueFlowgrams, flowDataIntI, lengths, numFlowCells, seqNumber);
                     
                     if (m->getControl_pressed()) { break; }
                     
@@ -521,9 +525,9 @@ int ShhherCommand::driver(vector<string> filenames, string thisCompositeFASTAFil
                 vector<int> otuCounts(numOTUs, 0);
                 for(int j=0;j<numSeqs;j++)	{	otuCounts[otuData[j]]++;	}
                 
-                calcCentroidsDriver(numOTUs, cumNumSeqs, nSeqsPerOTU, seqIndex, change, centroids, singleTau, mapSeqToUnique, uniqueFlowgrams, flowDataIntI, lengths, numFlowCells, seqNumber);
+                calcCentroids(numOTUs, cumNumSeqs, nSeqsPerOTU, seqIndex, change, centroids, singleTau, mapSeqToUnique, uniqueFlowgrams, flowDataIntI, lengths, numFlowCells, seqNumber);
                 
-                if (m->getDebug()) { m->mothurOut("[DEBUG]: done calcCentroidsDriver().\n"); }
+                if (m->getDebug()) { m->mothurOut("[DEBUG]: done calcCentroids().\n"); }
                 
                 if (m->getControl_pressed()) { break; }
                 
@@ -650,40 +654,42 @@ int ShhherCommand::getFlowData(string filename, vector<string>& thisSeqNameVecto
 }
 /**************************************************************************************************/
 
-int ShhherCommand::flowDistParentFork(int numFlowCells, string distFileName, int stopSeq, vector<int>& mapUniqueToSeq, vector<int>& mapSeqToUnique, vector<int>& lengths, vector<double>& flowDataPrI, vector<short>& flowDataIntI){
+int ShhherCommand::flowDistParentFork(int numFlowCells, string distFileName, int stopSeq, vector<int>& mapUniqueToSeq, vector<int>& mapSeqToUnique, vector<int>& lengths, vector<short>& flowDataIntI){
 	try{		
         
-		ostringstream outStream;
-		outStream.setf(ios::fixed, ios::floatfield);
-		outStream.setf(ios::dec, ios::basefield);
-		outStream.setf(ios::showpoint);
-		outStream.precision(6);
+		ofstream distFile(distFileName.c_str());
 		
 		int begTime = time(nullptr);
 		double begClock = clock();
         
-		for(int i=0;i<stopSeq;i++){
+		//each processor takes every processors'th row of a block, the rows are written in order once the block is done
+		int blockSize = 100 * processors;
+		vector<string> rows(blockSize);
+		
+		for(int start=0;start<stopSeq;start+=blockSize){
 			
 			if (m->getControl_pressed()) { break; }
 			
-			for(int j=0;j<i;j++){
-				float flowDistance = calcPairwiseDist(numFlowCells, mapUniqueToSeq[i], mapUniqueToSeq[j], mapSeqToUnique, lengths, flowDataPrI, flowDataIntI);
-                
-				if(flowDistance < 1e-6){
-					outStream << mapUniqueToSeq[i] << '\t' << mapUniqueToSeq[j] << '\t' << 0.000000 << endl;
-				}
-				else if(flowDistance <= cutoff){
-					outStream << mapUniqueToSeq[i] << '\t' << mapUniqueToSeq[j] << '\t' << flowDistance << endl;
-				}
+			int end = start + blockSize;
+			if (end > stopSeq) { end = stopSeq; }
+			
+			vector<std::thread*> workerThreads;
+			for (int i = 1; i < processors; i++) {
+				workerThreads.push_back(new std::thread(&ShhherCommand::flowDistDriver, this, numFlowCells, start+i, end, processors, &rows[i], &mapUniqueToSeq, &mapSeqToUnique, &lengths, &flowDataIntI));
 			}
-			if(i % 100 == 0){
-				m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(nullptr) - begTime));
-				m->mothurOutJustToScreen("\t" + toString((clock()-begClock)/CLOCKS_PER_SEC)+"\n");
+			flowDistDriver(numFlowCells, start, end, processors, &rows[0], &mapUniqueToSeq, &mapSeqToUnique, &lengths, &flowDataIntI);
+			
+			for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+			
+			for(int i=start;i<end;i++){
+				distFile << rows[i-start];
+				
+				if(i % 100 == 0){
+					m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(nullptr) - begTime));
+					m->mothurOutJustToScreen("\t" + toString((clock()-begClock)/CLOCKS_PER_SEC)+"\n");
+				}
 			}
 		}
-		
-		ofstream distFile(distFileName.c_str());
-		distFile << outStream.str();		
 		distFile.close();
 		
 		if (m->getControl_pressed()) {}
@@ -700,27 +706,52 @@ int ShhherCommand::flowDistParentFork(int numFlowCells, string distFileName, int
 	}
 }
 /**************************************************************************************************/
+//distances of rows start, start+step, ... below end to the uniques before them, rows[0] is the block's first row
+void ShhherCommand::flowDistDriver(int numFlowCells, int start, int end, int step, string* rows, vector<int>* mapUniqueToSeq, vector<int>* mapSeqToUnique, vector<int>* lengths, vector<short>* flowDataIntI){
+	try{
+		for(int i=start;i<end;i+=step){
+			
+			if (m->getControl_pressed()) { break; }
+			
+			ostringstream outStream;
+			outStream.setf(ios::fixed, ios::floatfield);
+			outStream.setf(ios::dec, ios::basefield);
+			outStream.setf(ios::showpoint);
+			outStream.precision(6);
+			
+			for(int j=0;j<i;j++){
+				float flowDistance = calcPairwiseDist(numFlowCells, (*mapUniqueToSeq)[i], (*mapUniqueToSeq)[j], *mapSeqToUnique, *lengths, *flowDataIntI);
+                
+				if(flowDistance < 1e-6){
+					outStream << (*mapUniqueToSeq)[i] << '\t' << (*mapUniqueToSeq)[j] << '\t' << 0.000000 << endl;
+				}
+				else if(flowDistance <= cutoff){
+					outStream << (*mapUniqueToSeq)[i] << '\t' << (*mapUniqueToSeq)[j] << '\t' << flowDistance << endl;
+				}
+			}
+			rows[i-start] = outStream.str();
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ShhherCommand", "flowDistDriver");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
 
-float ShhherCommand::calcPairwiseDist(int numFlowCells, int seqA, int seqB, vector<int>& mapSeqToUnique, vector<int>& lengths, vector<double>& flowDataPrI, vector<short>& flowDataIntI){
+float ShhherCommand::calcPairwiseDist(int numFlowCells, int seqA, int seqB, vector<int>& mapSeqToUnique, vector<int>& lengths, vector<short>& flowDataIntI){
 	try{
 		int minLength = lengths[mapSeqToUnique[seqA]];
 		if(lengths[seqB] < minLength){	minLength = lengths[mapSeqToUnique[seqB]];	}
 		
-		int ANumFlowCells = seqA * numFlowCells;
-		int BNumFlowCells = seqB * numFlowCells;
+		const short* flowA = &flowDataIntI[seqA * numFlowCells];
+		const short* flowB = &flowDataIntI[seqB * numFlowCells];
+		const double* lookUp = &jointLookUp[0];
 		
 		float dist = 0;
 		
 		for(int i=0;i<minLength;i++){
-			
-			if (m->getControl_pressed()) { break; }
-			
-			int flowAIntI = flowDataIntI[ANumFlowCells + i];
-			float flowAPrI = flowDataPrI[ANumFlowCells + i];
-			
-			int flowBIntI = flowDataIntI[BNumFlowCells + i];
-			float flowBPrI = flowDataPrI[BNumFlowCells + i];
-			dist += jointLookUp[flowAIntI * NUMBINS + flowBIntI] - flowAPrI - flowBPrI;
+			dist += lookUp[flowA[i] * NUMBINS + flowB[i]];
 		}
 		
 		dist /= (float) minLength;
@@ -734,7 +765,7 @@ float ShhherCommand::calcPairwiseDist(int numFlowCells, int seqA, int seqB, vect
 
 /**************************************************************************************************/
 
-int ShhherCommand::getUniques(int numSeqs, int numFlowCells, vector<short>& uniqueFlowgrams, vector<int>& uniqueCount, vector<int>& uniqueLengths, vector<int>& mapSeqToUnique, vector<int>& mapUniqueToSeq, vector<int>& lengths, vector<double>& flowDataPrI, vector<short>& flowDataIntI){
+int ShhherCommand::getUniques(int numSeqs, int numFlowCells, vector<short>& uniqueFlowgrams, vector<int>& uniqueCount, vector<int>& uniqueLengths, vector<int>& mapSeqToUnique, vector<int>& mapUniqueToSeq, vector<int>& lengths, vector<short>& flowDataIntI){
 	try{
 		int numUniques = 0;
 		uniqueFlowgrams.assign(numFlowCells * numSeqs, -1);
@@ -797,9 +828,6 @@ int ShhherCommand::getUniques(int numSeqs, int numFlowCells, vector<short>& uniq
 		}
 		uniqueFlowDataIntI.resize(numFlowCells * numUniques);
 		uniqueLengths.resize(numUniques);	
-		
-		flowDataPrI.resize(numSeqs * numFlowCells, 0);
-		for(int i=0;i<flowDataPrI.size();i++)	{	if (m->getControl_pressed()) { break; } flowDataPrI[i] = getProbIntensity(flowDataIntI[i]);		}
         
         return numUniques;
 	}
@@ -953,7 +981,29 @@ int ShhherCommand::getOTUData(int numSeqs, string fileName,  vector<int>& otuDat
 }
 /**************************************************************************************************/
 
-int ShhherCommand::calcCentroidsDriver(int numOTUs, 
+int ShhherCommand::calcCentroids(int numOTUs, vector<int>& cumNumSeqs, vector<int>& nSeqsPerOTU, vector<int>& seqIndex, vector<short>& change,
+                                 vector<int>& centroids, vector<double>& singleTau, vector<int>& mapSeqToUnique, vector<short>& uniqueFlowgrams,
+                                 vector<short>& flowDataIntI, vector<int>& lengths, int numFlowCells, vector<int>& seqNumber){
+	try{
+		//each otu's centroid only depends on its own sequences, so processor i takes every processors'th otu from i
+		vector<std::thread*> workerThreads;
+		for (int i = 1; i < processors; i++) {
+			workerThreads.push_back(new std::thread(&ShhherCommand::calcCentroidsDriver, this, i, processors, numOTUs, std::ref(cumNumSeqs), std::ref(nSeqsPerOTU), std::ref(seqIndex), std::ref(change), std::ref(centroids), std::ref(singleTau), std::ref(mapSeqToUnique), std::ref(uniqueFlowgrams), std::ref(flowDataIntI), std::ref(lengths), numFlowCells, std::ref(seqNumber)));
+		}
+		calcCentroidsDriver(0, processors, numOTUs, cumNumSeqs, nSeqsPerOTU, seqIndex, change, centroids, singleTau, mapSeqToUnique, uniqueFlowgrams, flowDataIntI, lengths, numFlowCells, seqNumber);
+		
+		for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+		
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ShhherCommand", "calcCentroids");
+		exit(1);	
+	}		
+}
+/**************************************************************************************************/
+
+int ShhherCommand::calcCentroidsDriver(int start, int step, int numOTUs, 
                                           vector<int>& cumNumSeqs,
                                           vector<int>& nSeqsPerOTU,
                                           vector<int>& seqIndex,
@@ -972,7 +1022,7 @@ int ShhherCommand::calcCentroidsDriver(int numOTUs,
 	
 	try{
 		
-		for(int i=0;i<numOTUs;i++){
+		for(int i=start;i<numOTUs;i+=step){
 			
 			if (m->getControl_pressed()) { break; }
 			
@@ -1074,9 +1124,32 @@ double ShhherCommand::getDistToCentroid(int cent, int flow, int length, vector<s
 double ShhherCommand::getNewWeights(int numOTUs, vector<int>& cumNumSeqs, vector<int>& nSeqsPerOTU, vector<double>& singleTau, vector<int>& seqNumber, vector<double>& weight){
 	try{
 		
+		vector<double> maxChanges(processors, 0);
+		
+		vector<std::thread*> workerThreads;
+		for (int i = 1; i < processors; i++) {
+			workerThreads.push_back(new std::thread(&ShhherCommand::getNewWeightsDriver, this, i, processors, numOTUs, std::ref(cumNumSeqs), std::ref(nSeqsPerOTU), std::ref(singleTau), std::ref(seqNumber), std::ref(weight), &maxChanges[i]));
+		}
+		getNewWeightsDriver(0, processors, numOTUs, cumNumSeqs, nSeqsPerOTU, singleTau, seqNumber, weight, &maxChanges[0]);
+		
+		for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+		
 		double maxChange = 0;
+		for (int i = 0; i < processors; i++) { if(maxChanges[i] > maxChange){	maxChange = maxChanges[i];	} }
 		
-		for(int i=0;i<numOTUs;i++){
+		return maxChange;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ShhherCommand", "getNewWeights");
+		exit(1);	
+	}		
+}
+/**************************************************************************************************/
+
+void ShhherCommand::getNewWeightsDriver(int start, int step, int numOTUs, vector<int>& cumNumSeqs, vector<int>& nSeqsPerOTU, vector<double>& singleTau, vector<int>& seqNumber, vector<double>& weight, double* maxChange){
+	try{
+		
+		for(int i=start;i<numOTUs;i+=step){
 			
 			if (m->getControl_pressed()) { break; }
 			
@@ -1090,12 +1163,11 @@ double ShhherCommand::getNewWeights(int numOTUs, vector<int>& cumNumSeqs, vector
 			}
 			
 			difference = fabs(weight[i] - difference);
-			if(difference > maxChange){	maxChange = difference;	}
+			if(difference > *maxChange){	*maxChange = difference;	}
 		}
-		return maxChange;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ShhherCommand", "getNewWeights");
+		m->errorOut(e, "ShhherCommand", "getNewWeightsDriver");
 		exit(1);	
 	}		
 }
@@ -1195,18 +1267,81 @@ void ShhherCommand::calcNewDistances(int numSeqs, int numOTUs, vector<int>& nSeq
 	
 	try{
 		
+		//each processor finds the distances and taus of a block of sequences, then the taus are added in sequence order
+		int numThreads = processors;
+		if (numThreads > numSeqs) { numThreads = numSeqs; }
+		if (numThreads < 1) { numThreads = 1; }
+		
+		vector<vector<int> > tauOTUs(numThreads);		//otu of each tau over MIN_TAU, by sequence
+		vector<vector<double> > taus(numThreads);
+		vector<vector<int> > numTaus(numThreads);		//number of taus of each sequence
+		
+		vector<std::thread*> workerThreads;
+		for (int i = 1; i < numThreads; i++) {
+			int start = (int)((i / (double) numThreads) * numSeqs);
+			int end = (int)(((i+1) / (double) numThreads) * numSeqs);
+			workerThreads.push_back(new std::thread(&ShhherCommand::calcNewDistancesDriver, this, start, end, numOTUs, std::ref(dist), std::ref(weight), std::ref(change), std::ref(centroids), std::ref(uniqueFlowgrams), std::ref(flowDataIntI), numFlowCells, std::ref(lengths), &tauOTUs[i], &taus[i], &numTaus[i]));
+		}
+		calcNewDistancesDriver(0, (int)((1 / (double) numThreads) * numSeqs), numOTUs, dist, weight, change, centroids, uniqueFlowgrams, flowDataIntI, numFlowCells, lengths, &tauOTUs[0], &taus[0], &numTaus[0]);
+		
+		for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+		
+		if (m->getControl_pressed()) { return; }
+		
 		int total = 0;
-		vector<double> newTau(numOTUs,0);
-		vector<double> norms(numSeqs, 0);
 		nSeqsPerOTU.assign(numOTUs, 0);
+		
+		int seq = 0;
+		for (int t = 0; t < numThreads; t++) {
+			int index = 0;
+			for (int k = 0; k < numTaus[t].size(); k++) {
+				for (int l = 0; l < numTaus[t][k]; l++) {
+					int j = tauOTUs[t][index];
+					
+					int oldTotal = total;
+					
+					total++;
+					
+					singleTau.resize(total, 0);
+					seqNumber.resize(total, 0);
+					seqIndex.resize(total, 0);
+					
+					singleTau[oldTotal] = taus[t][index];
+					
+					aaP[j][nSeqsPerOTU[j]] = oldTotal;
+					aaI[j][nSeqsPerOTU[j]] = seq;
+					nSeqsPerOTU[j]++;
+					
+					index++;
+				}
+				seq++;
+			}
+		}
         
-		for(int i=0;i<numSeqs;i++){
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ShhherCommand", "calcNewDistances");
+		exit(1);	
+	}		
+}
+/**************************************************************************************************/
+
+void ShhherCommand::calcNewDistancesDriver(int start, int end, int numOTUs, vector<double>& dist, vector<double>& weight, vector<short>& change,
+                                           vector<int>& centroids, vector<short>& uniqueFlowgrams, vector<short>& flowDataIntI, int numFlowCells,
+                                           vector<int>& lengths, vector<int>* tauOTUs, vector<double>* taus, vector<int>* numTaus){
+	
+	try{
+		
+		vector<double> newTau(numOTUs,0);
+        
+		for(int i=start;i<end;i++){
 			
 			if (m->getControl_pressed()) { break; }
 			
 			int indexOffset = i * numOTUs;
             
 			double offset = 1e8;
+			double norm = 0;
 			
 			for(int j=0;j<numOTUs;j++){
                 
@@ -1222,7 +1357,7 @@ void ShhherCommand::calcNewDistances(int numSeqs, int numOTUs, vector<int>& nSeq
 			for(int j=0;j<numOTUs;j++){
 				if(weight[j] > MIN_WEIGHT){
 					newTau[j] = exp(sigma * (-dist[indexOffset + j] + offset)) * weight[j];
-					norms[i] += newTau[j];
+					norm += newTau[j];
 				}
 				else{
 					newTau[j] = 0.0;
@@ -1230,33 +1365,23 @@ void ShhherCommand::calcNewDistances(int numSeqs, int numOTUs, vector<int>& nSeq
 			}
             
 			for(int j=0;j<numOTUs;j++){
-				newTau[j] /= norms[i];
+				newTau[j] /= norm;
 			}
             
+			int numKept = 0;
 			for(int j=0;j<numOTUs;j++){
 				if(newTau[j] > MIN_TAU){
-					
-					int oldTotal = total;
-					
-					total++;
-					
-					singleTau.resize(total, 0);
-					seqNumber.resize(total, 0);
-					seqIndex.resize(total, 0);
-					
-					singleTau[oldTotal] = newTau[j];
-					
-					aaP[j][nSeqsPerOTU[j]] = oldTotal;
-					aaI[j][nSeqsPerOTU[j]] = i;
-					nSeqsPerOTU[j]++;
+					tauOTUs->push_back(j);
+					taus->push_back(newTau[j]);
+					numKept++;
 				}
 			}
-            
+			numTaus->push_back(numKept);
 		}
         
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ShhherCommand", "calcNewDistances");
+		m->errorOut(e, "ShhherCommand", "calcNewDistancesDriver");
 		exit(1);	
 	}		
 }
@@ -1641,9 +1766,13 @@ void ShhherCommand::getSingleLookUp(){
 void ShhherCommand::getJointLookUp(){
 	try{
 		
-		//	the most likely joint probability (-log) that two intenities have the same polymer length
+		//	the most likely joint probability (-log) that two intenities have the same polymer length, less the
+		//	probability (-log) of each intensity - the distance calcPairwiseDist adds for a pair of flows
 		jointLookUp.resize(NUMBINS * NUMBINS, 0);
 		
+		vector<float> probIntensity(NUMBINS);
+		for(int i=0;i<NUMBINS;i++){	probIntensity[i] = getProbIntensity(i);	}
+		
 		for(int i=0;i<NUMBINS;i++){
 			
 			if (m->getControl_pressed()) { break; }
@@ -1657,7 +1786,7 @@ void ShhherCommand::getJointLookUp(){
 					
 					if(sum < minSum)	{	minSum = sum;		}
 				}	
-				jointLookUp[i * NUMBINS + j] = minSum;
+				jointLookUp[i * NUMBINS + j] = minSum - probIntensity[i] - probIntensity[j];
 			}
 		}
 	}
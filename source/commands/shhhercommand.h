@@ -53,7 +53,7 @@ private:
 	bool abort, large;
 	string  flowFileName, flowFilesFileName, lookupFileName, compositeFASTAFileName, compositeNamesFileName;
 
-	int maxIters, largeSize;
+	int maxIters, largeSize, processors;
 	float cutoff, sigma, minDelta;
 	string flowOrder;
     
@@ -65,19 +65,23 @@ private:
     vector<string> parseFlowFiles(string);
     int driver(vector<string>, string, string);
     int getFlowData(string, vector<string>&, vector<int>&, vector<short>&, map<string, int>&, int&);
-    int getUniques(int, int, vector<short>&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<double>&, vector<short>&);
-    int flowDistParentFork(int, string, int, vector<int>&, vector<int>&, vector<int>&, vector<double>&, vector<short>&);
-    float calcPairwiseDist(int, int, int, vector<int>&, vector<int>&, vector<double>&, vector<short>&);
+    int getUniques(int, int, vector<short>&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<short>&);
+    int flowDistParentFork(int, string, int, vector<int>&, vector<int>&, vector<int>&, vector<short>&);
+    void flowDistDriver(int, int, int, int, string*, vector<int>*, vector<int>*, vector<int>*, vector<short>*);
+    float calcPairwiseDist(int, int, int, vector<int>&, vector<int>&, vector<short>&);
     int createNamesFile(int, int, string, vector<string>&, vector<int>&, vector<int>&);
     int cluster(string, string, string);
     int getOTUData(int numSeqs, string,  vector<int>&, vector<int>&, vector<int>&, vector<vector<int> >&, vector<vector<int> >&, vector<int>&, vector<int>&,map<string, int>&);
-    int calcCentroidsDriver(int numOTUs, vector<int>&, vector<int>&, vector<int>&, vector<short>&, vector<int>&, vector<double>&, vector<int>&, vector<short>&, vector<short>&, vector<int>&, int, vector<int>&);
+    int calcCentroids(int numOTUs, vector<int>&, vector<int>&, vector<int>&, vector<short>&, vector<int>&, vector<double>&, vector<int>&, vector<short>&, vector<short>&, vector<int>&, int, vector<int>&);
+    int calcCentroidsDriver(int, int, int numOTUs, vector<int>&, vector<int>&, vector<int>&, vector<short>&, vector<int>&, vector<double>&, vector<int>&, vector<short>&, vector<short>&, vector<int>&, int, vector<int>&);
     double getDistToCentroid(int, int, int, vector<short>&, vector<short>&, int);
     double getNewWeights(int, vector<int>&, vector<int>&, vector<double>&, vector<int>&, vector<double>&);
+    void getNewWeightsDriver(int, int, int, vector<int>&, vector<int>&, vector<double>&, vector<int>&, vector<double>&, double*);
     
     double getLikelihood(int, int, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<double>&, vector<double>&);
     int checkCentroids(int, vector<int>&, vector<double>&);
     void calcNewDistances(int, int, vector<int>& , vector<double>&,vector<double>& , vector<short>& change, vector<int>&,vector<vector<int> >&,	vector<double>&, vector<vector<int> >&, vector<int>&, vector<int>&, vector<short>&, vector<short>&, int, vector<int>&);
+    void calcNewDistancesDriver(int, int, int, vector<double>&, vector<double>&, vector<short>&, vector<int>&, vector<short>&, vector<short>&, int, vector<int>&, vector<int>*, vector<double>*, vector<int>*);
     int fill(int, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<vector<int> >&, vector<vector<int> >&);
     void setOTUs(int, int, vector<int>&, vector<int>&, vector<int>&, vector<int>&,
                  vector<int>&, vector<double>&, vector<double>&, vector<vector<int> >&, vector<vector<int> >&);
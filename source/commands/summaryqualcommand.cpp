@@ -9,6 +9,7 @@
 
 #include "summaryqualcommand.h"
 #include "counttable.h"
+#include "sequencereader.hpp"
 
 //**********************************************************************************************************************
 vector<string> SummaryQualCommand::setParameters(){	
@@ -201,22 +202,16 @@ struct seqSumQualData {
 /**************************************************************************************/
 void driverCreateSummary(seqSumQualData* params) {
 	try {
-		ifstream in; params->util.openInputFile(params->filename, in);
+		SequenceReader reader(params->filename, params->start);
 		
-		in.seekg(params->start);
-        
-        //adjust start if null strings
-        if (params->start == 0) {  params->util.zapGremlins(in); gobble(in);  }
-		
-		bool done = false;
 		params->count = 0;
         int count = 0;
 		
-		while (!done) {
+		while (reader.readQual()) {
 			
-			if (params->m->getControl_pressed()) { in.close(); break; }
+			if (params->m->getControl_pressed()) { break; }
 			
-			QualityScores current(in); gobble(in);
+			QualityScores current = reader.getQualityScores();
 			
 			if (current.getName() != "") {
 				
@@ -254,14 +249,11 @@ void driverCreateSummary(seqSumQualData* params) {
 			}
 			
 #if defined NON_WINDOWS
-			unsigned long long pos = in.tellg();
-			if ((pos == -1) || (pos >= params->end)) { break; }
+			if (reader.getPosition() >= params->end) { break; }
 #else
-			if ((count == params->end) || (in.eof())) { break; }
+			if (count == params->end) { break; }
 #endif
 		}
-		
-		in.close();
     }
 	catch(exception& e) {
 		params->m->errorOut(e, "SummaryQualCommand", "driverCreateSummary");
@@ -472,14 +472,15 @@ struct treeSharedData {
     vector< vector< vector<seqDist> > > calcDistsTotals;  //each iter, one for each calc, then each groupCombos dists. this will be used to make .dist files
     vector< vector< vector<double> > > matrices; //for each calculator a square matrix to represent the distances, only filled by main thread
     vector<string>  Estimators;
-    long long numIters;
+    long long numIters, startIter;
     MothurOut* m;
     int count, subsampleSize;
     bool subsample, withReplacement;
     
     treeSharedData(){}
-    treeSharedData(long long st, bool su, bool wr, int subsize, vector<string> est, SharedRAbundVectors* lu) {
+    treeSharedData(long long si, long long st, bool su, bool wr, int subsize, vector<string> est, SharedRAbundVectors* lu) {
         m = MothurOut::getInstance();
+        startIter = si;
         numIters = st;
         Estimators = est;
         thisLookup = lu;
@@ -597,6 +598,7 @@ int process(treeSharedData* params) {
             vector<string> namesOfGroups = thisItersLookup->getNamesGroups();
             
             if (params->subsample) {
+                sample.setIteration(params->startIter+thisIter);
                 if (params->withReplacement)    { sample.getSampleWithReplacement(thisItersLookup, params->subsampleSize);  }
                 else                            { sample.getSample(thisItersLookup, params->subsampleSize);                 }
             }
@@ -656,12 +658,13 @@ int TreeSharedCommand::createProcesses(SharedRAbundVectors*& thisLookup, CountTa
         vector<string> groupNames = thisLookup->getNamesGroups();
         Treenames = groupNames; //may have changed if subsample eliminated groups
         
-        vector<int> lines;
+        vector<int> lines, starts;
         if (processors > (iters+1)) { processors = iters+1; }
         
         //figure out how many sequences you have to process
         int numItersPerProcessor = (iters+1) / processors;
         for (int i = 0; i < processors; i++) {
+            starts.push_back(i * numItersPerProcessor);
             if(i == (processors - 1)){	numItersPerProcessor = (iters+1) - i * numItersPerProcessor; 	}
             lines.push_back(numItersPerProcessor);
         }
@@ -675,7 +678,7 @@ int TreeSharedCommand::createProcesses(SharedRAbundVectors*& thisLookup, CountTa
             
             //make copy of lookup so we don't get access violations
             SharedRAbundVectors* newLookup = new SharedRAbundVectors(*thisLookup);
-            treeSharedData* dataBundle = new treeSharedData(lines[i+1], subsample, withReplacement, subsampleSize, Estimators, newLookup);
+            treeSharedData* dataBundle = new treeSharedData(starts[i+1], lines[i+1], subsample, withReplacement, subsampleSize, Estimators, newLookup);
             
             data.push_back(dataBundle);
             workerThreads.push_back(new std::thread(process, dataBundle));
@@ -683,7 +686,7 @@ int TreeSharedCommand::createProcesses(SharedRAbundVectors*& thisLookup, CountTa
         
         //make copy of lookup so we don't get access violations
         SharedRAbundVectors* newLookup = new SharedRAbundVectors(*thisLookup);
-        treeSharedData* dataBundle = new treeSharedData(lines[0], subsample, withReplacement, subsampleSize, Estimators, newLookup);
+        treeSharedData* dataBundle = new treeSharedData(starts[0], lines[0], subsample, withReplacement, subsampleSize, Estimators, newLookup);
         process(dataBundle);
         delete newLookup;
         
@@ -9,6 +9,7 @@
 
 #include "uniqueseqscommand.h"
 #include "sequence.hpp"
+#include "dereplicator.hpp"
 
 //**********************************************************************************************************************
 vector<string> UniqueSeqsCommand::setParameters(){
@@ -18,6 +19,7 @@ vector<string> UniqueSeqsCommand::setParameters(){
         CommandParameter pcount("count", "InputTypes", "", "", "namecount", "none", "none","count",false,false,true); parameters.push_back(pcount);
         CommandParameter pformat("format", "Multiple", "count-name", "count", "", "", "","",false,false, true); parameters.push_back(pformat);
         CommandParameter poutput("output", "Multiple", "count-name", "count", "", "", "","",false,false, true); parameters.push_back(poutput);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
         CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -43,10 +45,11 @@ string UniqueSeqsCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The unique.seqs command reads a fastafile and creates a name or count file.\n";
-		helpString += "The unique.seqs command parameters are fasta, name, count and format.  fasta is required, unless there is a valid current fasta file.\n";
+		helpString += "The unique.seqs command parameters are fasta, name, count, format and processors.  fasta is required, unless there is a valid current fasta file.\n";
         helpString += "The name parameter is used to provide an existing name file associated with the fasta file. \n";
         helpString += "The count parameter is used to provide an existing count file associated with the fasta file. \n";
         helpString += "The format parameter is used to indicate what type of file you want outputted.  Choices are name and count, default=count unless name file used then default=name.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use. The default is all available.\n";
 		helpString += "The unique.seqs command should be in the following format: \n";
 		helpString += "unique.seqs(fasta=yourFastaFile) \n";	
 		return helpString;
@@ -106,6 +109,9 @@ UniqueSeqsCommand::UniqueSeqsCommand(string option) : Command()  {
 			else if (countfile == "not found") { countfile = ""; }
 			else { current->setCountFile(countfile); }
 			
+            string temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+            processors = current->setProcessors(temp);
+			
             if ((countfile != "") && (namefile != "")) { m->mothurOut("When executing a unique.seqs command you must enter ONLY ONE of the following: count or name.\n");  abort = true; }
 			
             //allow format parameter to have two names - format or output
@@ -209,82 +215,49 @@ string UniqueSeqsCommand::processCount(string countfile) { //countfile can be bl
         
         if (m->getControl_pressed()) { return 0; }
         
-        ifstream in;  util.openInputFile(fastafile, in);
-        ofstream outFasta; util.openOutputFile(outFastaFile, outFasta);
         outputNames.push_back(outFastaFile); outputTypes["fasta"].push_back(outFastaFile);
         
-        map<string, string> sequenceStrings; //sequenceString -> list of names.  "atgc...." -> seq1,seq2,seq3.
-        map<string, string>::iterator itStrings;
-        set<string> nameInFastaFile; //for sanity checking
-        set<string>::iterator itname;
-        vector<string> nameFileOrder;
+        //only the first name of each unique is needed, unless their counts are merged
+        Dereplicator dereplicator(processors, (countfile != ""), getMemoryBudget());
+        long long count = dereplicator.dereplicate(fastafile, outFastaFile, nullptr);
         
-        int count = 0;
+        if(count % 1000 != 0)    { m->mothurOut(toString(count) + "\t" + toString(dereplicator.getNumUniques())); m->mothurOutEndLine();    }
         
-        while (!in.eof()) {
-            
+        if (m->getControl_pressed()) {  util.mothurRemove(outFastaFile); }
+        
+        vector<string> uniqueNames;
+        vector<string> names; long long numSeqs;
+        while (dereplicator.nextUnique(names, numSeqs)) {
             if (m->getControl_pressed()) { break; }
             
-            Sequence seq(in); gobble(in);
-            
-            if (seq.getName() != "") { //not end of file
-                
-                //sanity checks
-                itname = nameInFastaFile.find(seq.getName());
-                if (itname == nameInFastaFile.end()) { nameInFastaFile.insert(seq.getName());  }
-                else { m->mothurOut("[ERROR]: You already have a sequence named " + seq.getName() + " in your fasta file, sequence names must be unique, please correct.\n");  }
-                
-                itStrings = sequenceStrings.find(seq.getAligned());
-                string seqName = seq.getName();
-                int numCurrentReps = 0;
+            if (countfile != "") {
+                ct.getNumSeqs(names[0]); //checks to make sure seq is in table
                 
-                if (itStrings == sequenceStrings.end()) { //this is a new unique sequence
+                for (int i = 1; i < names.size(); i++) {
+                    if (m->getControl_pressed()) { break; }
                     
-                    seq.printSequence(outFasta); //output to unique fasta file
-                    sequenceStrings[seq.getAligned()] = seqName;    nameFileOrder.push_back(seq.getAligned());
+                    int numCurrentReps = newCt.getNumSeqs(names[i]); //checks to make sure seq is in table
                     
-                    if (countfile != "") { numCurrentReps = ct.getNumSeqs(seqName); } //checks to make sure seq is in table
-                    else { newCt.push_back(seqName); }
-                    
-                }else { //this is a dup
-                    
-                    if (countfile != "") {
-                        
-                        numCurrentReps = newCt.getNumSeqs(seq.getName()); //checks to make sure seq is in table
-                        
-                        if (numCurrentReps != 0) { //its in the table
-                            newCt.mergeCounts(itStrings->second, seq.getName()); //merges counts and saves in uniques name
-                        }
-                    }else {
-                        numCurrentReps = newCt.getNumSeqs(itStrings->second);
-                        newCt.setNumSeqs(itStrings->second, numCurrentReps+1);
+                    if (numCurrentReps != 0) { //its in the table
+                        newCt.mergeCounts(names[0], names[i]); //merges counts and saves in uniques name
                     }
                 }
-                count++;
+            }else {
+                newCt.push_back(names[0]);
+                if (numSeqs != 1) { newCt.setNumSeqs(names[0], numSeqs); }
             }
-            
-            
-            if(count % 1000 == 0)    { m->mothurOutJustToScreen(toString(count) + "\t" + toString(sequenceStrings.size()) + "\n");    }
+            uniqueNames.push_back(names[0]);
         }
         
-        if(count % 1000 != 0)    { m->mothurOut(toString(count) + "\t" + toString(sequenceStrings.size())); m->mothurOutEndLine();    }
-        
-        in.close(); outFasta.close();
-        if (m->getControl_pressed()) {  util.mothurRemove(outFastaFile); }
-        
         //print new names file
         ofstream outCount; util.openOutputFile(outCountFile, outCount); outputTypes["count"].push_back(outCountFile); outputNames.push_back(outCountFile);
         
         newCt.printCompressedHeaders(outCount);
         
-        for (int i = 0; i < nameFileOrder.size(); i++) {
+        for (int i = 0; i < uniqueNames.size(); i++) {
             if (m->getControl_pressed()) { break; }
             
-            itStrings = sequenceStrings.find(nameFileOrder[i]);
-            
-            if (itStrings != sequenceStrings.end()) {
-                newCt.printCompressedSeq(outCount, itStrings->second);
-            }else{ m->mothurOut("[ERROR]: mismatch in namefile print.\n");  m->setControl_pressed(true); }
+            newCt.printCompressedSeq(outCount, uniqueNames[i]);
         }
         outCount.close();
         
@@ -339,84 +312,33 @@ string UniqueSeqsCommand::processName(string namefile) { //namefile can be blank
         //bail if error reading namefile
         if (m->getControl_pressed()) { return ""; }
         
-        //open files
-        ifstream in;  util.openInputFile(fastafile, in);
-        ofstream outFasta; util.openOutputFile(outFastaFile, outFasta);
         outputNames.push_back(outFastaFile); outputTypes["fasta"].push_back(outFastaFile);
         
-        map<string, string> sequenceStrings; //sequenceString -> list of names.  "atgc...." -> seq1,seq2,seq3.
-        map<string, string>::iterator itStrings;
-        set<string> nameInFastaFile; //for sanity checking
-        set<string>::iterator itname;
-        vector<string> nameFileOrder;
-        
-        int count = 0;
-        while (!in.eof()) {
-            
-            if (m->getControl_pressed()) { break; }
-            
-            Sequence seq(in); gobble(in);
-            
-            if (seq.getName() != "") { //not end of file
-                
-                //sanity checks
-                itname = nameInFastaFile.find(seq.getName());
-                if (itname == nameInFastaFile.end()) { nameInFastaFile.insert(seq.getName());  }
-                else { m->mothurOut("[ERROR]: You already have a sequence named " + seq.getName() + " in your fasta file, sequence names must be unique, please correct.\n");  }
-                
-                string key = seq.getName();
-                
-                if (namefile != "") {
-                    itNames = nameMap.find(seq.getName());
-                    
-                    if (itNames == nameMap.end()) { //namefile and fastafile do not match
-                        m->mothurOut("[ERROR]: " + seq.getName() + " is in your fasta file, and not in your namefile, please correct.\n");
-                    }else { key = itNames->second;  }
-                }
-
-                itStrings = sequenceStrings.find(seq.getAligned());
-                
-                if (itStrings == sequenceStrings.end()) { //this is a new unique sequence
-                    
-                    seq.printSequence(outFasta); //output to unique fasta file
-                    
-                    //add new unique sequence to seqStrings
-                    sequenceStrings[seq.getAligned()] = key;    nameFileOrder.push_back(seq.getAligned());
-                    
-                }else { //this is a dup
-                     sequenceStrings[seq.getAligned()] += "," + key;
-                }
-                count++;
-            }
-            
-            
-            if(count % 1000 == 0)    { m->mothurOutJustToScreen(toString(count) + "\t" + toString(sequenceStrings.size()) + "\n");    }
-        }
+        Dereplicator dereplicator(processors, true, getMemoryBudget());
+        long long count = dereplicator.dereplicate(fastafile, outFastaFile, ((namefile != "") ? &nameMap : nullptr));
         
-        if(count % 1000 != 0)    { m->mothurOut(toString(count) + "\t" + toString(sequenceStrings.size())); m->mothurOutEndLine();    }
+        if(count % 1000 != 0)    { m->mothurOut(toString(count) + "\t" + toString(dereplicator.getNumUniques())); m->mothurOutEndLine();    }
         
-        in.close(); outFasta.close();
         if (m->getControl_pressed()) {  return outFastaFile;  }
         
         ofstream outNames; util.openOutputFile(outNameFile, outNames);
         outputNames.push_back(outNameFile); outputTypes["name"].push_back(outNameFile);
-         
-        for (int i = 0; i < nameFileOrder.size(); i++) {
+        
+        vector<string> names; long long numSeqs;
+        while (dereplicator.nextUnique(names, numSeqs)) {
             if (m->getControl_pressed()) { break; }
             
-            itStrings = sequenceStrings.find(nameFileOrder[i]);
+            string dups = names[0];
+            for (int i = 1; i < names.size(); i++) { dups += "," + names[i]; }
             
-            if (itStrings != sequenceStrings.end()) {
-                //get rep name
-                int pos = (itStrings->second).find_first_of(',');
-                
-                if (pos == string::npos) { // only reps itself
-                    outNames << itStrings->second << '\t' << itStrings->second << endl;
-                }else {
-                    outNames << (itStrings->second).substr(0, pos) << '\t' << itStrings->second << endl;
-                }
-                
-            }else{ m->mothurOut("[ERROR]: mismatch in namefile print.\n");  m->setControl_pressed(true); }
+            //get rep name
+            int pos = dups.find_first_of(',');
+            
+            if (pos == string::npos) { // only reps itself
+                outNames << dups << '\t' << dups << endl;
+            }else {
+                outNames << dups.substr(0, pos) << '\t' << dups << endl;
+            }
         }
         outNames.close();
         
@@ -430,6 +352,20 @@ string UniqueSeqsCommand::processName(string namefile) { //namefile can be blank
     }
 }
 /**************************************************************************************/
+//a quarter of the RAM for the uniques, the rest of the fasta file is dereplicated on disk
+double UniqueSeqsCommand::getMemoryBudget() {
+    try {
+        double budget = util.getTotalRAM() / 4.0;
+        if (budget <= 0) { budget = 1073741824.0; } //could not determine amount of RAM
+        
+        return budget;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "UniqueSeqsCommand", "getMemoryBudget");
+        exit(1);
+    }
+}
+/**************************************************************************************/
 string UniqueSeqsCommand::createNewNameFile(string countfile, map<string, int> nameMap) { //namefile can be blank, indicating no namefile provided
     try {
         map<string, string> variables;
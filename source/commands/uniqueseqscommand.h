@@ -40,12 +40,14 @@ public:
 private:
 	string fastafile, namefile,  countfile, format;
 	vector<string> outputNames;
+    int processors;
 
 	bool abort;
     
     string processName(string); //not recommended
     string processCount(string);
     string createNewNameFile(string, map<string, int>);
+    double getMemoryBudget();
 };
 
 #endif
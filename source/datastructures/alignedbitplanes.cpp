@@ -0,0 +1,75 @@
+//
+//  alignedbitplanes.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "alignedbitplanes.hpp"
+
+/**************************************************************************************************/
+AlignedBitPlanes::AlignedBitPlanes(StorageDatabase* db) {
+    try {
+        m = MothurOut::getInstance();
+
+        int numSeqs = db->getNumSeqs();
+        alignLength = 0;
+
+        //find the characters used and the longest alignment
+        vector<int> codes(256, -1);
+        int numCodes = 0;
+        names.resize(numSeqs);
+        for (int i = 0; i < numSeqs; i++) {
+            if (m->getControl_pressed()) { break; }
+
+            Sequence seq = db->getSeq(i);
+            names[i] = seq.getName();
+
+            string aligned = seq.getAligned();
+            if (aligned.length() > alignLength) { alignLength = aligned.length(); }
+
+            for (int j = 0; j < aligned.length(); j++) {
+                unsigned char base = aligned[j];
+                if ((base == '.') || (base == '-')) { continue; }
+                if (codes[base] == -1) { codes[base] = numCodes; numCodes++; }
+            }
+        }
+
+        numPlanes = 0;
+        while ((1 << numPlanes) < numCodes) { numPlanes++; }
+
+        numWords = (alignLength + 63) / 64;
+        stride = (long long)(2 + numPlanes) * numWords;
+        planes.assign(stride * numSeqs, 0);
+
+        for (int i = 0; i < numSeqs; i++) {
+            if (m->getControl_pressed()) { break; }
+
+            string aligned = db->getSeq(i).getAligned();
+
+            unsigned long long* dots = &planes[i*stride];
+            unsigned long long* dashes = dots + numWords;
+            unsigned long long* codePlanes = dots + 2*numWords;
+
+            for (int j = 0; j < numWords*64; j++) {
+                int word = j / 64;
+                unsigned long long bit = 1ULL << (j % 64);
+
+                if (j >= aligned.length())  {   dots[word] |= bit;      }
+                else if (aligned[j] == '.') {   dots[word] |= bit;      }
+                else if (aligned[j] == '-') {   dashes[word] |= bit;    }
+                else {
+                    int code = codes[(unsigned char)aligned[j]];
+                    for (int p = 0; p < numPlanes; p++) {
+                        if (code & (1 << p)) { codePlanes[p*numWords + word] |= bit; }
+                    }
+                }
+            }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "AlignedBitPlanes", "AlignedBitPlanes");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,48 @@
+//
+//  alignedbitplanes.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef alignedbitplanes_hpp
+#define alignedbitplanes_hpp
+
+#include "storagedatabase.hpp"
+
+/**************************************************************************************************/
+
+/* This class stores the aligned sequences of a database as bitplanes, 64 columns to a word. Each sequence has a plane
+ marking its '.' columns, a plane marking its '-' columns and enough code planes to tell every other character found
+ in the database apart. Characters are given codes in the order they are first seen, so two columns hold the same
+ character exactly when all their code bits match. Columns past the end of a shorter sequence are stored as '.'.
+
+ BitPlaneDist uses the planes to compute the dist.seqs distances a word at a time. */
+
+class AlignedBitPlanes {
+
+public:
+    AlignedBitPlanes(StorageDatabase*);  //encodes every sequence in the database
+    ~AlignedBitPlanes() = default;
+
+    int getNumSeqs()            { return (int)names.size();     }
+    const string& getName(int i){ return names[i];              }
+    int getAlignLength()        { return alignLength;           }
+    int getNumWords()           { return numWords;              }
+    int getNumPlanes()          { return numPlanes;             }  //number of code planes
+
+    const unsigned long long* getDots(int i)        { return &planes[i*stride];                 }
+    const unsigned long long* getDashes(int i)      { return &planes[i*stride + numWords];      }
+    const unsigned long long* getCodes(int i)       { return &planes[i*stride + 2*numWords];    }  //numPlanes blocks of numWords
+
+private:
+    MothurOut* m;
+    vector<string> names;
+    vector<unsigned long long> planes;
+    int alignLength, numWords, numPlanes;
+    long long stride;
+};
+
+/**************************************************************************************************/
+
+#endif /* alignedbitplanes_hpp */
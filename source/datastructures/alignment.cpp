@@ -115,7 +115,17 @@ void Alignment::traceBack(bool createBaseMap){			//	This traceback routine is us
 			}
 		}
 		
-       
+        finishTraceBack(createBaseMap);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Alignment", "traceBack");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//once seqAaln and seqBaln are filled, set the pairwise length, start and end positions and flip the base maps
+void Alignment::finishTraceBack(bool createBaseMap){
+	try {
         pairwiseLength = seqAaln.length();
 		seqAstart = 1;	seqAend = 0;
 		seqBstart = 1;	seqBend = 0;
@@ -155,7 +165,7 @@ void Alignment::traceBack(bool createBaseMap){			//	This traceback routine is us
 		seqBend = seqB.length() - seqBend - 1;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "Alignment", "traceBack");
+		m->errorOut(e, "Alignment", "finishTraceBack");
 		exit(1);
 	}
 }
@@ -48,6 +48,7 @@ public:
 protected:
     
 	void traceBack(bool createBaseMap);
+    void finishTraceBack(bool createBaseMap);
     void proteinTraceBack(vector<string>, vector<AminoAcid>);
 	string seqA, seqAaln;
 	string seqB, seqBaln;
@@ -91,6 +91,22 @@ AlignmentDB::AlignmentDB(string fastaFileName, string s, int kmerSize, float gap
 		}
 		
 		if (!m->getControl_pressed()) {
+			if ((method == "kmer") && (!needToGenerate)) {
+				ifstream kmerFileTest(kmerDBName.c_str());
+				search->readDB(kmerFileTest);
+				
+				//make sure the shortcut file was made from these template sequences
+				unsigned long long checksum = 0;
+				for (int i = 0; i < templateSequences.size(); i++) { checksum = KmerDB::addToChecksum(checksum, templateSequences[i].getUnaligned()); }
+				
+				unsigned long long shortcutChecksum = ((KmerDB*)search)->getTemplateChecksum();
+				if ((shortcutChecksum != 0) && (shortcutChecksum != checksum)) {
+					m->mothurOut(kmerDBName + " was not made from " + fastaFileName + ", rebuilding it.\n");
+					delete search; search = new KmerDB(fastaFileName, kmerSize);
+					needToGenerate = true;
+				}
+			}
+			
 			if (needToGenerate) {
 				//add sequences to search 
 				for (int i = 0; i < templateSequences.size(); i++) {
@@ -102,10 +118,6 @@ AlignmentDB::AlignmentDB(string fastaFileName, string s, int kmerSize, float gap
 				if (m->getControl_pressed()) {  templateSequences.clear();  }
 				
                 if ((method != "kmer") || ((method == "kmer") && (writeShortcut))) { search->generateDB(); }
-                
-			}else if ((method == "kmer") && (!needToGenerate)) {
-				ifstream kmerFileTest(kmerDBName.c_str());
-				search->readDB(kmerFileTest);
 			}
 		
 			search->setNumSeqs(numSeqs);
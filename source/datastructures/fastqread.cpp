@@ -8,18 +8,26 @@
 
 #include "fastqread.h"
 
+/*******************************************************************************/
+//goes from solexa to sanger and back. Used fq_all2std.pl as a reference.
+static vector<char> fillConvertTable() {
+    vector<char> table;
+    for (int i = -64; i < 65; i++) { table.push_back((char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499))); }
+    return table;
+}
+static vector<int> fillConvertBackTable() {
+    vector<int> table;
+    for (int i = -64; i < 65; i++) { table.push_back(((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499))); }
+    return table;
+}
+static const vector<char> convertTable = fillConvertTable();
+static const vector<int> convertBackTable = fillConvertBackTable();
 
 /*******************************************************************************/
 FastqRead::FastqRead() {
     try {
         m = MothurOut::getInstance();
         format = "illumina1.8+"; name = ""; sequence = ""; scores.clear();
-        //fill convert table - goes from solexa to sanger. Used fq_all2std.pl as a reference.
-        for (int i = -64; i < 65; i++) {
-            char temp = (char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499));
-            convertTable.push_back(temp);
-            convertBackTable.push_back(((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499)));
-        }
     }
     catch(exception& e) {
         m->errorOut(e, "FastqRead", "FastqRead");
@@ -31,13 +39,6 @@ FastqRead::FastqRead(Sequence s, QualityScores q) {
     try {
         m = MothurOut::getInstance(); format = "illumina1.8+";
         
-        //fill convert table - goes from solexa to sanger. Used fq_all2std.pl as a reference.
-        for (int i = -64; i < 65; i++) {
-            char temp = (char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499));
-            convertTable.push_back(temp);
-            convertBackTable.push_back(((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499)));
-        }
-        
         if (s.getName() != q.getName()) { m->mothurOut("[ERROR]: sequence name does not match quality score name. Found sequence named " + s.getName() + " quality scores named " + q.getName() + " Cannot construct fastq object.\n"); m->setControl_pressed(true); }
         else {
             name = s.getName();
@@ -59,13 +60,6 @@ FastqRead::FastqRead(Sequence s, QualityScores q, string f) {
     try {
         m = MothurOut::getInstance(); format = f;
         
-        //fill convert table - goes from solexa to sanger. Used fq_all2std.pl as a reference.
-        for (int i = -64; i < 65; i++) {
-            char temp = (char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499));
-            convertTable.push_back(temp);
-            convertBackTable.push_back(((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499)));
-        }
-        
         if (s.getName() != q.getName()) { m->mothurOut("[ERROR]: sequence name does not match quality score name. Found sequence named " + s.getName() + " quality scores named " + q.getName() + " Cannot construct fastq object.\n"); m->setControl_pressed(true); }
         else {
             name = s.getName();
@@ -87,12 +81,6 @@ FastqRead::FastqRead(string f) {
     try {
         m = MothurOut::getInstance();
         format = f; name = ""; sequence = ""; scores.clear();
-        //fill convert table - goes from solexa to sanger. Used fq_all2std.pl as a reference.
-        for (int i = -64; i < 65; i++) {
-            char temp = (char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499));
-            convertTable.push_back(temp);
-            convertBackTable.push_back(((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499)));
-        }
     }
     catch(exception& e) {
         m->errorOut(e, "FastqRead", "FastqRead");
@@ -105,12 +93,6 @@ FastqRead::FastqRead(string f, string n, string s, vector<int> sc) {
     try {
         m = MothurOut::getInstance();
         format = f; name = n; sequence = s; scores = sc;
-        //fill convert table - goes from solexa to sanger. Used fq_all2std.pl as a reference.
-        for (int i = -64; i < 65; i++) {
-            char temp = (char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499));
-            convertTable.push_back(temp);
-            convertBackTable.push_back(((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499)));
-        }
     }
     catch(exception& e) {
         m->errorOut(e, "FastqRead", "FastqRead");
@@ -122,17 +104,62 @@ FastqRead::FastqRead(string f, string n, string s, vector<int> sc) {
 FastqRead::FastqRead(ifstream& in, bool& ignore, string f) {
     try {
         m = MothurOut::getInstance();
+        format = f;
         
-        ignore = false;
+        string nameLine = util.getline(in); gobble(in);
+        string seqLine = util.getline(in); gobble(in);
+        string plusLine = util.getline(in); gobble(in);
+        string qualLine = util.getline(in); gobble(in);
+        
+        parse(nameLine, seqLine, plusLine, qualLine, ignore);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "FastqRead", "FastqRead");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+#ifdef USE_BOOST
+FastqRead::FastqRead(boost::iostreams::filtering_istream& in, bool& ignore, string f) {
+    try {
+        m = MothurOut::getInstance();
         format = f;
-        //fill convert table - goes from solexa to sanger. Used fq_all2std.pl as a reference.
-        for (int i = -64; i < 65; i++) {
-            char temp = (char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499));
-            convertTable.push_back(temp);
+        
+        if (in.eof()) { ignore = true; }
+        else {
+            string nameLine = util.getline(in); gobble(in);
+            string seqLine = util.getline(in); gobble(in);
+            string plusLine = util.getline(in); gobble(in);
+            string qualLine = util.getline(in); gobble(in);
+            
+            parse(nameLine, seqLine, plusLine, qualLine, ignore);
         }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "FastqRead", "FastqRead");
+        exit(1);
+    }
+}
+#endif
+//**********************************************************************************************************************
+FastqRead::FastqRead(string f, string nameLine, string seqLine, string plusLine, string qualLine, bool& ignore) {
+    try {
+        m = MothurOut::getInstance();
+        format = f;
+        
+        parse(nameLine, seqLine, plusLine, qualLine, ignore);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "FastqRead", "FastqRead");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+void FastqRead::parse(string line, string seqLine, string plusLine, string quality, bool& ignore) {
+    try {
+        ignore = false;
         
         //read sequence name
-        string line = util.getline(in); gobble(in);
         vector<string> pieces = util.splitWhiteSpace(line);
         name = "";  if (pieces.size() != 0) { name = pieces[0]; }
         if (name == "") {  m->mothurOut("[WARNING]: Blank fasta name, ignoring read.\n");  ignore=true;  }
@@ -141,19 +168,17 @@ FastqRead::FastqRead(ifstream& in, bool& ignore, string f) {
         if (pieces.size() > 1) { pieces.erase(pieces.begin()); comment = util.getStringFromVector(pieces, " "); }
         
         //read sequence
-        sequence = util.getline(in); gobble(in);
+        sequence = seqLine;
         if (sequence == "") {  m->mothurOut("[WARNING]: missing sequence for " + name + ", ignoring."); ignore=true; }
 
         //read sequence name
-        line = util.getline(in); gobble(in);
-        pieces = util.splitWhiteSpace(line);
+        pieces = util.splitWhiteSpace(plusLine);
         string name2 = "";  if (pieces.size() != 0) { name2 = pieces[0]; }
         if (name2 == "") {  m->mothurOut("[WARNING]: expected a name with + as a leading character, ignoring."); ignore=true; }
         else if (name2[0] != '+') { m->mothurOut("[WARNING]: reading " + name2 + " expected a name with + as a leading character, ignoring."); ignore=true; }
         else { name2 = name2.substr(1); if (name2 == "") { name2 = name; } }
         
         //read quality scores
-        string quality = util.getline(in); gobble(in);
         if (quality == "") {  m->mothurOut("[WARNING]: missing quality for " + name2 + ", ignoring."); ignore=true; }
         
         //sanity check sequence length and number of quality scores match
@@ -165,74 +190,13 @@ FastqRead::FastqRead(ifstream& in, bool& ignore, string f) {
         util.checkName(name);
         
         if (m->getDebug()) { m->mothurOut("[DEBUG]: " + name + " " + sequence + " " + quality + "\n"); }
-    
     }
     catch(exception& e) {
-        m->errorOut(e, "FastqRead", "FastqRead");
+        m->errorOut(e, "FastqRead", "parse");
         exit(1);
     }
 }
 //**********************************************************************************************************************
-#ifdef USE_BOOST
-FastqRead::FastqRead(boost::iostreams::filtering_istream& in, bool& ignore, string f) {
-    try {
-        m = MothurOut::getInstance();
-        
-        ignore = false;
-        format = f;
-        
-        if (in.eof()) { ignore = true; }
-        else {
-            //fill convert table - goes from solexa to sanger. Used fq_all2std.pl as a reference.
-            for (int i = -64; i < 65; i++) {
-                char temp = (char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499));
-                convertTable.push_back(temp);
-            }
-            
-            //read sequence name
-            string line = util.getline(in); gobble(in);
-            vector<string> pieces = util.splitWhiteSpace(line);
-            name = "";  if (pieces.size() != 0) { name = pieces[0];  }
-            if (name == "") {  m->mothurOut("[WARNING]: Blank fasta name, ignoring read.\n");  ignore=true;  }
-            else if (name[0] != '@') { m->mothurOut("[WARNING]: reading " + name + " expected a name with @ as a leading character, ignoring read.\n");  ignore=true; }
-            else { name = name.substr(1); }
-            if (pieces.size() > 1) { pieces.erase(pieces.begin()); comment = util.getStringFromVector(pieces, " "); }
-            
-            //read sequence
-            sequence = util.getline(in); gobble(in);
-            if (sequence == "") {  m->mothurOut("[WARNING]: missing sequence for " + name + ", ignoring."); ignore=true; }
-            
-            //read sequence name
-            line = util.getline(in); gobble(in);
-            pieces = util.splitWhiteSpace(line);
-            string name2 = "";  if (pieces.size() != 0) { name2 = pieces[0]; }
-            if (name2 == "") {  m->mothurOut("[WARNING]: expected a name with + as a leading character, ignoring."); ignore=true; }
-            else if (name2[0] != '+') { m->mothurOut("[WARNING]: reading " + name2 + " expected a name with + as a leading character, ignoring."); ignore=true; }
-            else { name2 = name2.substr(1); if (name2 == "") { name2 = name; } }
-            
-            //read quality scores
-            string quality = util.getline(in); gobble(in);
-            if (quality == "") {  m->mothurOut("[WARNING]: missing quality for " + name2 + ", ignoring."); ignore=true; }
-            
-            //sanity check sequence length and number of quality scores match
-            if (name2 != "") { if (name != name2) { m->mothurOut("[WARNING]: names do not match. read " + name + " for fasta and " + name2 + " for quality, ignoring."); ignore=true; } }
-            if (quality.length() != sequence.length()) { m->mothurOut("[WARNING]: Lengths do not match for sequence " + name + ". Read " + toString(sequence.length()) + " characters for fasta and " + toString(quality.length()) + " characters for quality scores, ignoring read."); ignore=true; }
-            
-            scoreString = quality;
-            scores = convertQual(quality);
-            util.checkName(name);
-            
-            if (m->getDebug()) { m->mothurOut("[DEBUG]: " + name + " " + sequence + " " + quality + "\n"); }
-        }
-        
-    }
-    catch(exception& e) {
-        m->errorOut(e, "FastqRead", "FastqRead");
-        exit(1);
-    }
-}
-#endif
-//**********************************************************************************************************************
 vector<int> FastqRead::convertQual(string qual) {
     try {
         vector<int> qualScores;
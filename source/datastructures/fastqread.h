@@ -41,6 +41,7 @@ public:
     #ifdef USE_BOOST
     FastqRead(boost::iostreams::filtering_istream&, bool&, string f);
     #endif
+    FastqRead(string f, string, string, string, string, bool&); //format, name line, sequence line, + line, quality line, ignore
     ~FastqRead() = default;
     
     void setFormat(string f) { format = f; }
@@ -64,9 +65,8 @@ private:
     string sequence;
     string scoreString;
     string format;
-    vector<char> convertTable;
-    vector<int> convertBackTable;
     
+    void parse(string, string, string, string, bool&);
     vector<int> convertQual(string qual);
     string convertQual(vector<int>);
     
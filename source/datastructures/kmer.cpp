@@ -67,7 +67,7 @@ vector< map<int, int> > Kmer::getKmerCounts(string sequence){	//	Calculate kmer
 	
 /**************************************************************************************************/
 
-int Kmer::getKmerNumber(string sequence, int index){
+int Kmer::getKmerNumber(const string& sequence, int index){
 	
 //	Here we convert a kmer to a number between 0 and maxKmer.  For example, AAAA would equal 0 and TTTT would equal 255.
 //	If there's an N in the kmer, it is set to 256 (if we are looking at 4mers).  The largest we can look at are 8mers,
@@ -97,6 +97,43 @@ int Kmer::getKmerNumber(string sequence, int index){
 	return kmer;	
 }
 	
+/**************************************************************************************************/
+
+void Kmer::getKmerNumbers(const string& sequence, vector<int>& kmerNumbers){
+	
+//	Rolling version of getKmerNumber.  Each base is shifted onto the previous kmer and the base that falls off the front
+//	is masked away, so each position costs one step instead of kmerSize.  lastN remembers the most recent N so any kmer
+//	that still contains it gets the N kmer number.
+	
+	int power4s[14] = { 1, 4, 16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576, 4194304, 16777216, 67108864 };
+	
+	int numKmers = (int)sequence.length() - kmerSize + 1;
+	kmerNumbers.clear();
+	if (numKmers <= 0) { return; }
+	kmerNumbers.resize(numKmers);
+	
+	int mask = power4s[kmerSize] - 1;
+	int kmer = 0;
+	int lastN = -1;
+	
+	for(int i=0;i<sequence.length();i++){
+		char base = toupper(sequence[i]);
+		int value = 0;
+		if(base == 'C')								{	value = 1;	}
+		else if(base == 'G')						{	value = 2;	}
+		else if((base == 'T') || (base == 'U'))		{	value = 3;	}
+		else if(base == 'N')						{	lastN = i;	}
+		
+		kmer = ((kmer << 2) | value) & mask;
+		
+		int start = i - kmerSize + 1;
+		if (start >= 0) {
+			if (lastN >= start)	{	kmerNumbers[start] = power4s[kmerSize];	}
+			else				{	kmerNumbers[start] = kmer;				}
+		}
+	}
+}
+
 /**************************************************************************************************/
 	
 string Kmer::getKmerBases(int kmerNumber){
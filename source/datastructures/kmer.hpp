@@ -20,7 +20,8 @@ public:
 	Kmer(int);
     ~Kmer() = default;
 	string getKmerString(string);
-	int getKmerNumber(string, int);
+	int getKmerNumber(const string&, int);
+	void getKmerNumbers(const string&, vector<int>&);	//fills the vector with the kmer number at each position, same values as getKmerNumber
 	string getKmerBases(int);
 	int getReverseKmerNumber(int);
 	vector< map<int, int> > getKmerCounts(string sequence);  //for use in chimeraCheck
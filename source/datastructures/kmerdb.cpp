@@ -27,15 +27,19 @@
 #include "searchdatabase.hpp"
 #include "kmerdb.hpp"
 
+#define KMERDB_FORMAT_VERSION 1
+static const char kmerDBMagic[8] = { 'M', 'K', 'M', 'E', 'R', 'D', 'B', '\0' };
+
 /**************************************************************************************************/
 
-KmerDB::KmerDB(string fastaFileName, int kSize) : SearchDatabase(), kmerSize(kSize) {
+KmerDB::KmerDB(string fastaFileName, int kSize) : SearchDatabase(), kmerSize(kSize), kmerOffsets(nullptr), kmerPostings(nullptr) {
 	try { 
 	
 		kmerDBName = fastaFileName.substr(0,fastaFileName.find_last_of(".")+1) + char('0'+ kmerSize) + "mer";
 		
 		int power4s[14] = { 1, 4, 16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576, 4194304, 16777216, 67108864 };
 		count = 0;
+		templateChecksum = 0;
 		
 		maxKmer = power4s[kmerSize];
 		kmerLocations.resize(maxKmer+1);
@@ -51,7 +55,8 @@ KmerDB::KmerDB(string fastaFileName, int kSize) : SearchDatabase(), kmerSize(kSi
 
 }
 /**************************************************************************************************/
-KmerDB::KmerDB() : SearchDatabase() {
+KmerDB::KmerDB() : SearchDatabase(), kmerSize(0), maxKmer(0), count(0), kmerOffsets(nullptr), kmerPostings(nullptr) {
+    templateChecksum = 0;
     CurrentFile* current; current = CurrentFile::getInstance();
     version = current->getVersion();
 }
@@ -65,55 +70,76 @@ vector<int> KmerDB::findClosestSequences(Sequence* candidateSeq, int num, vector
 	try {
 		if (num > numSeqs) { m->mothurOut("[WARNING]: you requested " + toString(num) + " closest sequences, but the template only contains " + toString(numSeqs) + ", adjusting.\n");  num = numSeqs; }
 		
+		static thread_local KmerSearchScratch scratch;
+		
 		vector<int> topMatches;
 		Kmer kmer(kmerSize);
 		float searchScore = 0;
 		Scores.clear();
 		
-		vector<int> matches(numSeqs, 0);						//	a record of the sequences with shared kmers
-		vector<bool> timesKmerFound(kmerLocations.size()+1, false);	//	a record of the kmers that we have already found
+		if (scratch.matches.size() < numSeqs)	{	scratch.matches.resize(numSeqs, 0);			}	//	a record of the sequences with shared kmers
+		if (scratch.kmerSeen.size() < maxKmer+2)	{	scratch.kmerSeen.resize(maxKmer+2, 0);		}	//	a record of the kmers that we have already found
 		
 		int numKmers = candidateSeq->getNumBases() - kmerSize + 1;	
-	
-		for(int i=0;i<numKmers;i++){
-			int kmerNumber = kmer.getKmerNumber(candidateSeq->getUnaligned(), i);		//	go through the query sequence and get a kmer number
-			if(!timesKmerFound[kmerNumber]){				//	if we haven't seen it before...
-				for(int j=0;j<kmerLocations[kmerNumber].size();j++){//increase the count for each sequence that also has
-					matches[kmerLocations[kmerNumber][j]]++;	//	that kmer
+		
+		if (kmerOffsets != nullptr) {							//	nothing to search if nothing has been added or read
+			kmer.getKmerNumbers(candidateSeq->getUnaligned(), scratch.kmerNumbers);
+			
+			for(int i=0;i<scratch.kmerNumbers.size();i++){
+				int kmerNumber = scratch.kmerNumbers[i];		//	go through the query sequence and get a kmer number
+				if(!scratch.kmerSeen[kmerNumber]){				//	if we haven't seen it before...
+					scratch.kmerSeen[kmerNumber] = 1;			//	ok, we've seen the kmer now
+					scratch.seenKmers.push_back(kmerNumber);
+					for(unsigned long long j=kmerOffsets[kmerNumber];j<kmerOffsets[kmerNumber+1];j++){//increase the count for each sequence that also has
+						int seq = kmerPostings[j];				//	that kmer
+						if (seq >= numSeqs) { continue; }
+						if (scratch.matches[seq] == 0) { scratch.touched.push_back(seq); }
+						scratch.matches[seq]++;
+					}
 				}
 			}
-			timesKmerFound[kmerNumber] = true;						//	ok, we've seen the kmer now
 		}
 		
 		if (num != 1) {
-			vector<seqMatch> seqMatches; seqMatches.resize(numSeqs);
-			for(int i=0;i<numSeqs;i++){		
-				seqMatches[i].seq = i;
-				seqMatches[i].match = matches[i];
+			//only templates that share a kmer can score above zero, so select from those and fill with zero scoring
+			//templates in index order if there aren't enough.  Ties go to the lower index.
+			vector<seqMatch>& seqMatches = scratch.candidates; seqMatches.clear();
+			for(int i=0;i<scratch.touched.size();i++){
+				seqMatches.push_back(seqMatch(scratch.touched[i], scratch.matches[scratch.touched[i]]));
 			}
 			
-			//sorts putting largest matches first
-			sort(seqMatches.begin(), seqMatches.end(), compareSeqMatches);
+			int numSelected = min(num, (int)seqMatches.size());
+			if (numSelected < seqMatches.size()) {
+				nth_element(seqMatches.begin(), seqMatches.begin()+numSelected, seqMatches.end(), compareSeqMatchesThenIndex);
+			}
+			sort(seqMatches.begin(), seqMatches.begin()+numSelected, compareSeqMatchesThenIndex);
+			seqMatches.resize(numSelected);
 			
-			searchScore = seqMatches[0].match;
-			searchScore = 100 * searchScore / (float) numKmers;		//	return the Sequence object corresponding to the db
-            Scores.push_back(searchScore);
+			for(int i=0;(i<numSeqs)&&(seqMatches.size()<num);i++){
+				if (scratch.matches[i] == 0) { seqMatches.push_back(seqMatch(i, 0)); }
+			}
+			
+			if (seqMatches.size() != 0) {
+				searchScore = seqMatches[0].match;
+				searchScore = 100 * searchScore / (float) numKmers;		//	return the Sequence object corresponding to the db
+				Scores.push_back(searchScore);
+			}
             
 			//save top matches
-			for (int i = 0; i < num; i++) {
+			for (int i = 0; i < seqMatches.size(); i++) {
 				topMatches.push_back(seqMatches[i].seq);
 				float thisScore = 100 * seqMatches[i].match / (float) numKmers;
 				Scores.push_back(thisScore);
 			}
 		}else{
 			int bestIndex = 0;
-			int bestMatch = -1;
+			int bestMatch = 0;
             
-			for(int i=0;i<numSeqs;i++){	
-				
-				if (matches[i] > bestMatch) {
-					bestIndex = i;
-					bestMatch = matches[i];
+			for(int i=0;i<scratch.touched.size();i++){
+				int seq = scratch.touched[i];
+				if ((scratch.matches[seq] > bestMatch) || ((scratch.matches[seq] == bestMatch) && (seq < bestIndex))) {
+					bestIndex = seq;
+					bestMatch = scratch.matches[seq];
 				}
 			}
             
@@ -122,6 +148,13 @@ vector<int> KmerDB::findClosestSequences(Sequence* candidateSeq, int num, vector
 			topMatches.push_back(bestIndex);
 			Scores.push_back(searchScore);
 		}
+		
+		//clear only what this query used
+		for(int i=0;i<scratch.touched.size();i++)	{	scratch.matches[scratch.touched[i]] = 0;	}
+		for(int i=0;i<scratch.seenKmers.size();i++)	{	scratch.kmerSeen[scratch.seenKmers[i]] = 0;	}
+		scratch.touched.clear();
+		scratch.seenKmers.clear();
+		
 		return topMatches;		
 	}
 	catch(exception& e) {
@@ -134,22 +167,27 @@ vector<int> KmerDB::findClosestSequences(Sequence* candidateSeq, int num, vector
 //print shortcut file
 void KmerDB::generateDB(){
 	try {
+		pack();
 		
-		ofstream kmerFile;										//	once we have the kmerLocations folder print it out
-		util.openOutputFile(kmerDBName, kmerFile);					//	to a file
+		ofstream kmerFile;
+		string tempName = MappedFile::openOutput(kmerDBName, version, kmerDBMagic, kmerFile);
 		
-		//output version
-		kmerFile << "#" << version << endl;
+		unsigned int formatVersion = KMERDB_FORMAT_VERSION;
+		unsigned int kSize = kmerSize;
+		unsigned long long numSequences = count;
+		unsigned long long numKmers = maxKmer+1;				//	includes the kmer for sequences with an N
+		unsigned long long numPostings = kmerOffsets[numKmers];
 		
-		for(int i=0;i<maxKmer;i++){								//	step through all of the possible kmer numbers
-			kmerFile << i << ' ' << kmerLocations[i].size();	//	print the kmer number and the number of sequences with
-			for(int j=0;j<kmerLocations[i].size();j++){			//	that kmer.  then print out the indices of the sequences
-				kmerFile << ' ' << kmerLocations[i][j];			//	with that kmer.
-			}
-			kmerFile << endl;
-		}
-		kmerFile.close();
+		kmerFile.write((char*)&formatVersion, sizeof(unsigned int));
+		kmerFile.write((char*)&kSize, sizeof(unsigned int));
+		kmerFile.write((char*)&numSequences, sizeof(unsigned long long));
+		kmerFile.write((char*)&numKmers, sizeof(unsigned long long));
+		kmerFile.write((char*)&numPostings, sizeof(unsigned long long));
+		kmerFile.write((char*)&templateChecksum, sizeof(unsigned long long));
+		kmerFile.write((char*)kmerOffsets, (numKmers+1) * sizeof(unsigned long long));
+		if (numPostings != 0) { kmerFile.write((char*)kmerPostings, numPostings * sizeof(unsigned int)); }
 		
+		MappedFile::closeOutput(tempName, kmerDBName, kmerFile);
 	}
 	catch(exception& e) {
 		m->errorOut(e, "KmerDB", "generateDB");
@@ -158,16 +196,72 @@ void KmerDB::generateDB(){
 	
 }
 /**************************************************************************************************/
+//convert kmerLocations into kmerOffsets and kmerPostings
+void KmerDB::pack(){
+	try {
+		if (kmerLocations.size() == 0) { return; } //already packed or read from a shortcut file
+		
+		mappedDB.close();
+		
+		packedOffsets.assign(kmerLocations.size()+1, 0);
+		unsigned long long numPostings = 0;
+		for (int i = 0; i < kmerLocations.size(); i++) {
+			packedOffsets[i] = numPostings;
+			numPostings += kmerLocations[i].size();
+		}
+		packedOffsets[kmerLocations.size()] = numPostings;
+		
+		packedPostings.resize(numPostings);
+		for (int i = 0; i < kmerLocations.size(); i++) {
+			copy(kmerLocations[i].begin(), kmerLocations[i].end(), packedPostings.begin() + packedOffsets[i]);
+		}
+		vector<vector<int> >().swap(kmerLocations);
+		
+		kmerOffsets = &packedOffsets[0];
+		kmerPostings = packedPostings.empty() ? nullptr : &packedPostings[0];
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "pack");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//FNV-1a, used to tie a shortcut file to the template sequences it was made from
+unsigned long long KmerDB::addToChecksum(unsigned long long checksum, const string& seq){
+	if (checksum == 0) { checksum = 14695981039346656037ULL; }
+	for (int i = 0; i < seq.length(); i++) {
+		checksum ^= (unsigned char)seq[i];
+		checksum *= 1099511628211ULL;
+	}
+	checksum ^= (unsigned char)'\n';
+	checksum *= 1099511628211ULL;
+	return checksum;
+}
+/**************************************************************************************************/
 void KmerDB::addSequence(Sequence seq) {
 	try {
 		Kmer kmer(kmerSize);
 		
+		if (kmerLocations.size() == 0) {					//	we were already packed, so unpack to add more
+			kmerLocations.resize(maxKmer+1);
+			if (kmerOffsets != nullptr) {
+				for (int i = 0; i <= maxKmer; i++) {
+					for (unsigned long long j = kmerOffsets[i]; j < kmerOffsets[i+1]; j++) { kmerLocations[i].push_back(kmerPostings[j]); }
+				}
+			}
+			kmerOffsets = nullptr; kmerPostings = nullptr;
+			packedOffsets.clear(); packedPostings.clear(); mappedDB.close();
+		}
+		
 		string unaligned = seq.getUnaligned();	//	...take the unaligned sequence...
 		int numKmers = unaligned.length() - kmerSize + 1;
+		templateChecksum = addToChecksum(templateChecksum, unaligned);
 			
+		vector<int> kmerNumbers; kmer.getKmerNumbers(unaligned, kmerNumbers);
+		
 		vector<int> seenBefore(maxKmer+1,0);
 		for(int j=0;j<numKmers;j++){						//	...step though the sequence and get each kmer...
-			int kmerNumber = kmer.getKmerNumber(unaligned, j);
+			int kmerNumber = kmerNumbers[j];
 			if(seenBefore[kmerNumber] == 0){
 				kmerLocations[kmerNumber].push_back(count);		//	...insert the sequence index into kmerLocations for
 			}												//	the appropriate kmer number
@@ -204,6 +298,67 @@ void KmerDB::readSeqs(ifstream& fastaFile){
 /**************************************************************************************************/
 //reads shortcut file
 void KmerDB::readDB(ifstream& kmerDBFile){
+	try {
+		vector<vector<int> >().swap(kmerLocations);
+		
+		if (readBinaryDB()) { kmerDBFile.close(); }
+		else				{ readTextDB(kmerDBFile); }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "readDB");
+		exit(1);
+	}	
+}
+/**************************************************************************************************/
+//maps the shortcut file, returns false if it is not a binary shortcut file
+bool KmerDB::readBinaryDB(){
+	try {
+		if (!mappedDB.open(kmerDBName)) { return false; }
+		
+		unsigned long long headerSize = 2*sizeof(unsigned int) + 4*sizeof(unsigned long long);
+		const char* header = mappedDB.findHeader(kmerDBMagic, headerSize);
+		if (header == nullptr) { mappedDB.close(); return false; }
+		
+		unsigned int formatVersion, kSize;
+		unsigned long long numSequences, numKmers, numPostings, checksum;
+		memcpy(&formatVersion, header, sizeof(unsigned int));		header += sizeof(unsigned int);
+		memcpy(&kSize, header, sizeof(unsigned int));				header += sizeof(unsigned int);
+		memcpy(&numSequences, header, sizeof(unsigned long long));	header += sizeof(unsigned long long);
+		memcpy(&numKmers, header, sizeof(unsigned long long));		header += sizeof(unsigned long long);
+		memcpy(&numPostings, header, sizeof(unsigned long long));	header += sizeof(unsigned long long);
+		memcpy(&checksum, header, sizeof(unsigned long long));		header += sizeof(unsigned long long);
+		
+		unsigned long long remaining = mappedDB.getData() + mappedDB.getSize() - header;
+		unsigned long long expectedSize = (numKmers+1) * sizeof(unsigned long long) + numPostings * sizeof(unsigned int);
+		
+		if ((formatVersion != KMERDB_FORMAT_VERSION) || (kSize != kmerSize) || (numKmers != (maxKmer+1)) || (remaining < expectedSize)) {
+			m->mothurOut("[ERROR]: " + kmerDBName + " is damaged or was made by a different version of mothur, please remove it and run the command again.\n"); m->setControl_pressed(true);
+			mappedDB.close();
+			return true;
+		}
+		
+		kmerOffsets = (const unsigned long long*)header;
+		kmerPostings = (const unsigned int*)(header + (numKmers+1) * sizeof(unsigned long long));
+		
+		if (kmerOffsets[numKmers] != numPostings) {
+			m->mothurOut("[ERROR]: " + kmerDBName + " is damaged, please remove it and run the command again.\n"); m->setControl_pressed(true);
+			kmerOffsets = nullptr; kmerPostings = nullptr; mappedDB.close();
+			return true;
+		}
+		
+		count = numSequences;
+		templateChecksum = checksum;
+		
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "readBinaryDB");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//reads the text shortcut files made by older versions of mothur
+void KmerDB::readTextDB(ifstream& kmerDBFile){
 	try {
 					
 		kmerDBFile.seekg(0);									//	start at the beginning of the file
@@ -213,21 +368,30 @@ void KmerDB::readDB(ifstream& kmerDBFile){
 		
 		string seqName;
 		int seqNumber;
+		
+		packedOffsets.assign(maxKmer+2, 0);
+		packedPostings.clear();
 
 		for(int i=0;i<maxKmer;i++){
 			int numValues = 0;	
 			kmerDBFile >> seqName >> numValues;
 			
+			packedOffsets[i] = packedPostings.size();
 			for(int j=0;j<numValues;j++){						//	for each kmer number get the...
 				kmerDBFile >> seqNumber;						//		1. number of sequences with the kmer number
-				kmerLocations[i].push_back(seqNumber);			//		2. sequence indices
+				packedPostings.push_back(seqNumber);			//		2. sequence indices
 			}
 		}
+		packedOffsets[maxKmer] = packedPostings.size();		//	older files don't save the kmer for sequences with an N
+		packedOffsets[maxKmer+1] = packedPostings.size();
 		kmerDBFile.close();
 		
+		kmerOffsets = &packedOffsets[0];
+		kmerPostings = packedPostings.empty() ? nullptr : &packedPostings[0];
+		templateChecksum = 0;								//	unknown
 	}
 	catch(exception& e) {
-		m->errorOut(e, "KmerDB", "readDB");
+		m->errorOut(e, "KmerDB", "readTextDB");
 		exit(1);
 	}	
 }
@@ -237,7 +401,9 @@ int KmerDB::getCount(int kmer) {
 	try {
 		if (kmer < 0) { return 0; }  //if user gives negative number
 		else if (kmer > maxKmer) {	return 0;	}  //or a kmer that is bigger than maxkmer
-		else {	return kmerLocations[kmer].size();	}  // kmer is in vector range
+		pack();
+		if (kmerOffsets == nullptr) { return 0; }
+		return (int)(kmerOffsets[kmer+1] - kmerOffsets[kmer]);  // kmer is in vector range
 	}
 	catch(exception& e) {
 		m->errorOut(e, "KmerDB", "getCount");
@@ -266,7 +432,10 @@ vector<int> KmerDB::getSequencesWithKmer(int kmer) {
 	
 		if (kmer < 0) { }  //if user gives negative number
 		else if (kmer > maxKmer) {	}  //or a kmer that is bigger than maxkmer
-		else {	seqs = kmerLocations[kmer];	}
+		else {
+			pack();
+			if (kmerOffsets != nullptr) { seqs.assign(kmerPostings + kmerOffsets[kmer], kmerPostings + kmerOffsets[kmer+1]); }
+		}
 		
 		return seqs;
 	}
@@ -16,11 +16,44 @@
  *	Construction of an object of this type will first look for an appropriately named database file and if it is found
  *	then will read in the database file (readKmerDB), otherwise it will generate one and store the data in memory
  *	(generateKmerDB)
+ *
+ *	Once all the sequences are added, kmerLocations is packed into a compressed row layout: kmerOffsets[k] to
+ *	kmerOffsets[k+1] are the positions in kmerPostings of the indices of the sequences that contain kmer k.  The shortcut
+ *	file stores this layout directly so it can be memory mapped instead of parsed:
+ *
+ *		#version\n					so the release version checks done before readDB still work
+ *		zero padding					to the next 8 byte boundary
+ *		char[8]	magic					"MKMERDB" followed by a null
+ *		uint32	format version
+ *		uint32	kmer size
+ *		uint64	number of sequences
+ *		uint64	number of kmers (4^kmerSize)
+ *		uint64	number of postings
+ *		uint64	template checksum		FNV-1a of the unaligned template sequences in the order they were added
+ *		uint64	offsets[numKmers+1]
+ *		uint32	postings[numPostings]
+ *
+ *	Numbers are written in the byte order of the machine that made the file.  A file from a machine with a different
+ *	byte order fails the format version check.  Text shortcut files from older versions of mothur can still be read.
 
  */
 
 #include "mothur.h"
 #include "searchdatabase.hpp"
+#include "mappedfile.hpp"
+
+/**************************************************************************************************/
+//buffers reused by findClosestSequences.  Each thread has its own copy, and only the entries a query touched are
+//cleared afterwards, so a search costs the number of shared kmers rather than numSeqs + 4^kmerSize.
+struct KmerSearchScratch {
+	vector<int> kmerNumbers;		//kmer number at each position of the query
+	vector<int> matches;			//shared kmer counts by template index, zero unless listed in touched
+	vector<int> touched;			//templates sharing at least one kmer with the query
+	vector<char> kmerSeen;			//kmers already counted for this query, set entries are listed in seenKmers
+	vector<int> seenKmers;
+	vector<seqMatch> candidates;
+};
+/**************************************************************************************************/
 
 class KmerDB : public SearchDatabase {
 	
@@ -38,6 +71,10 @@ public:
 	vector<int> getSequencesWithKmer(int);  //returns vector of sequences that contain kmer passed in
 	int getReversed(int);  //returns reverse compliment kmerNumber 
 	int getMaxKmer() { return maxKmer; }
+	void setNumSeqs(int i) { numSeqs = i; pack(); }
+	unsigned long long getTemplateChecksum() { return templateChecksum; } //checksum of the sequences added or read from the shortcut file, 0 if unknown
+	
+	static unsigned long long addToChecksum(unsigned long long, const string&);
 	
 private:
 	
@@ -45,7 +82,18 @@ private:
 	int kmerSize;
 	int maxKmer, count;
 	string kmerDBName;
-	vector<vector<int> > kmerLocations;
+	unsigned long long templateChecksum;
+	vector<vector<int> > kmerLocations;  //used while adding sequences, emptied by pack()
+	
+	vector<unsigned long long> packedOffsets;
+	vector<unsigned int> packedPostings;
+	const unsigned long long* kmerOffsets; //points into packedOffsets or the mapped shortcut file
+	const unsigned int* kmerPostings;
+	MappedFile mappedDB;
+	
+	void pack();
+	void readTextDB(ifstream&);
+	bool readBinaryDB();
 };
 
 #endif
@@ -0,0 +1,133 @@
+//
+//  mappedfile.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "mappedfile.hpp"
+#include "utils.hpp"
+
+#if defined NON_WINDOWS
+    #include <sys/mman.h>
+    #include <fcntl.h>
+#endif
+
+/**************************************************************************************************/
+MappedFile::MappedFile() : data(nullptr), size(0), mapped(false) { m = MothurOut::getInstance(); }
+/**************************************************************************************************/
+MappedFile::~MappedFile() { close(); }
+/**************************************************************************************************/
+bool MappedFile::open(string fileName) {
+    try {
+        close();
+        
+#if defined NON_WINDOWS
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd == -1) { return false; }
+        
+        struct stat fileInfo;
+        if ((fstat(fd, &fileInfo) == -1) || (fileInfo.st_size == 0)) { ::close(fd); return false; }
+        
+        void* address = mmap(nullptr, fileInfo.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); //the mapping keeps its own reference to the file
+        
+        if (address == MAP_FAILED) { return false; }
+        
+        data = (const char*)address;
+        size = fileInfo.st_size;
+        mapped = true;
+#else
+        ifstream in(fileName.c_str(), ios::binary);
+        if (!in) { return false; }
+        
+        in.seekg(0, ios::end);
+        size = in.tellg();
+        in.seekg(0, ios::beg);
+        if (size == 0) { return false; }
+        
+        buffer.resize((size + sizeof(unsigned long long) - 1) / sizeof(unsigned long long));
+        in.read((char*)&buffer[0], size);
+        if ((unsigned long long)in.gcount() != size) { buffer.clear(); size = 0; return false; }
+        
+        data = (const char*)&buffer[0];
+        mapped = false;
+#endif
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "MappedFile", "open");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void MappedFile::close() {
+    try {
+#if defined NON_WINDOWS
+        if (mapped && (data != nullptr)) { munmap((void*)data, size); }
+#endif
+        buffer.clear();
+        data = nullptr;
+        size = 0;
+        mapped = false;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "MappedFile", "close");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+const char* MappedFile::findHeader(const char* magic, unsigned long long headerSize) {
+    try {
+        if (data == nullptr) { return nullptr; }
+        
+        //skip the version line and padding
+        unsigned long long start = 0;
+        while ((start < size) && (data[start] != '\n')) { start++; }
+        start = ((start + 1 + 7) / 8) * 8;
+        
+        if ((start + 8 + headerSize > size) || (memcmp(data + start, magic, 8) != 0)) { return nullptr; }
+        
+        return data + start + 8;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "MappedFile", "findHeader");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+string MappedFile::openOutput(string fileName, string version, const char* magic, ofstream& out) {
+    try {
+        Utils util;
+        string tempName = fileName + ".temp";
+#if defined NON_WINDOWS
+        tempName = fileName + "." + toString(getpid()) + ".temp";
+#endif
+        util.openOutputFileBinary(tempName, out);
+        
+        string versionLine = "#" + version + "\n";
+        out.write(versionLine.c_str(), versionLine.length());
+        char padding[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+        out.write(padding, (8 - (versionLine.length() % 8)) % 8);
+        out.write(magic, 8);
+        
+        return tempName;
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "MappedFile", "openOutput");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void MappedFile::closeOutput(string tempName, string fileName, ofstream& out) {
+    try {
+        Utils util;
+        out.close();
+        util.renameFile(tempName, fileName);
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "MappedFile", "closeOutput");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,56 @@
+//
+//  mappedfile.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef mappedfile_hpp
+#define mappedfile_hpp
+
+#include "mothurout.h"
+
+/**************************************************************************************************/
+
+/* This class maps a binary shortcut file into memory read only. On unix the file is mmap'd, so every thread and every
+ mothur process using the same file shares one copy of it through the page cache. On windows the file is read into
+ a buffer instead. The data is 8 byte aligned in both cases.
+ 
+ A shortcut file starts with a "#version" line, so the release version checks still work, padded with zeros to 8 bytes
+ so the arrays that follow are aligned, then an 8 byte magic naming the kind of file. openOutput and closeOutput write
+ that header and findHeader skips it. */
+
+class MappedFile {
+    
+public:
+    MappedFile();
+    ~MappedFile();
+    
+    bool open(string);  //returns false if the file can't be opened or is empty
+    void close();
+    
+    bool isOpen()                   { return (data != nullptr);     }
+    const char* getData()           { return data;                  }
+    unsigned long long getSize()    { return size;                  }
+    
+    //returns a pointer just past the magic, or nullptr if the file doesn't start with magic and headerSize more bytes
+    const char* findHeader(const char*, unsigned long long);
+    
+    //writes to a temp file that closeOutput renames, so other mothur processes never map a partly written file
+    static string openOutput(string, string, const char*, ofstream&); //fileName, version, magic - returns the temp file name
+    static void closeOutput(string, string, ofstream&); //temp file name, fileName
+    
+private:
+    MothurOut* m;
+    const char* data;
+    unsigned long long size;
+    bool mapped;
+    vector<unsigned long long> buffer; //windows copy, unsigned long long so the data is 8 byte aligned
+    
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
+
+/**************************************************************************************************/
+
+#endif /* mappedfile_hpp */
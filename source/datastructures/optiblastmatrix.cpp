@@ -407,8 +407,8 @@ int OptiBlastMatrix::readBlast(){
                                 
                                 int newB = singletonIndexSwap[indexB];
                                 int newA = singletonIndexSwap[indexA];
-                                closeness[newA].insert(newB);
-                                closeness[newB].insert(newA);
+                                closeness[newA].push_back(newB);
+                                closeness[newB].push_back(newA);
                             }
                             //not going to need this again
                             dists[itB->second].erase(itDist);
@@ -479,8 +479,8 @@ int OptiBlastMatrix::readBlast(){
                     
                     int newB = singletonIndexSwap[indexB];
                     int newA = singletonIndexSwap[indexA];
-                    closeness[newA].insert(newB);
-                    closeness[newB].insert(newA);
+                    closeness[newA].push_back(newB);
+                    closeness[newB].push_back(newA);
                 }
                 //not going to need this again
                 dists[itB->second].erase(itDist);
@@ -492,6 +492,7 @@ int OptiBlastMatrix::readBlast(){
         thisRowsBlastScores.clear();
         dists.clear();
         nameAssignment.clear();
+        packCloseness();
         
         m->mothurOut(" done.\n");
         
@@ -12,10 +12,10 @@
 long long OptiData::print(ostream& out) {
     try {
         long long count = 0;
-        for (long long i = 0; i < closeness.size(); i++) {
+        for (long long i = 0; i < getNumSeqs(); i++) {
             out << i << '\t' << getName(i) << '\t';
-            for(set<long long>::iterator it = closeness[i].begin(); it != closeness[i].end(); it++){
-                out << *it << '\t';
+            for(long long j = closeStart[i]; j < closeStart[i+1]; j++){
+                out << closeIndexes[j] << '\t';
                 count++;
             }
             out << endl;
@@ -32,8 +32,8 @@ long long OptiData::print(ostream& out) {
 long long OptiData::getNumClose(long long index) {
     try {
         if (index < 0) { return 0; }
-        else if (index > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); return 0; }
-        else { return closeness[index].size(); }
+        else if (index >= getNumSeqs()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); return 0; }
+        else { return closeStart[index+1] - closeStart[index]; }
     }
     catch(exception& e) {
         m->errorOut(e, "OptiData", "getNumClose");
@@ -44,11 +44,9 @@ long long OptiData::getNumClose(long long index) {
 bool OptiData::isClose(long long i, long long toFind){
     try {
         if (i < 0) { return false; }
-        else if (i > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); return false; }
+        else if (i >= getNumSeqs()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); return false; }
         
-        bool found = false;
-        if (closeness[i].count(toFind) != 0) { found = true; }
-        return found;
+        return binary_search(closeIndexes.begin()+closeStart[i], closeIndexes.begin()+closeStart[i+1], toFind);
     }
     catch(exception& e) {
         m->errorOut(e, "OptiData", "isClose");
@@ -59,9 +57,10 @@ bool OptiData::isClose(long long i, long long toFind){
 set<long long> OptiData::getCloseSeqs(long long i){
     try {
         if (i < 0) { set<long long> temp; return temp; }
-        else if (i > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); set<long long> temp; return temp; }
+        else if (i >= getNumSeqs()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); set<long long> temp; return temp; }
         
-        return closeness[i];
+        set<long long> close(closeIndexes.begin()+closeStart[i], closeIndexes.begin()+closeStart[i+1]);
+        return close;
     }
     catch(exception& e) {
         m->errorOut(e, "OptiData", "getNumClose");
@@ -76,7 +75,7 @@ map<string, long long> OptiData::getNameIndexMap() {
         map<string, long long> nameIndexes;
         for (int i = 0; i < nameMap.size(); i++) {
             vector<string> thisBinsSeqs; util.splitAtComma(nameMap[i], thisBinsSeqs);
-            if (i < closeness.size()) { nameIndexes[thisBinsSeqs[0]] = i;  }
+            if (i < getNumSeqs()) { nameIndexes[thisBinsSeqs[0]] = i;  }
         }
         return nameIndexes;
     }
@@ -109,7 +108,7 @@ set<long long> OptiData::getIndexes(set<string> seqs) {
 string OptiData::getName(long long index) {
     try {
         if (index < 0) { return ""; }
-        else if (index > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); return ""; }
+        else if (index > getNumSeqs()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); return ""; }
         
         return nameMap[index];
     }
@@ -136,9 +135,7 @@ set<string> OptiData::getNames(set<long long> indexes) {
 /***********************************************************************/
 long long OptiData::getNumDists(){
     try {
-        long long foundDists = 0;
-        for (int i = 0; i < closeness.size(); i++) { foundDists += closeness[i].size(); }
-        return foundDists;
+        return closeIndexes.size();
     }
     catch(exception& e) {
         m->errorOut(e, "OptiData", "getNumDists");
@@ -167,3 +164,40 @@ ListVector* OptiData::getListSingle() {
 /***********************************************************************/
 
 
+void OptiData::packCloseness() {
+    try {
+        long long numSeqs = closeness.size();
+        
+        closeStart.assign(numSeqs+1, 0);
+        for (long long i = 0; i < numSeqs; i++) {
+            sort(closeness[i].begin(), closeness[i].end());
+            closeness[i].erase(unique(closeness[i].begin(), closeness[i].end()), closeness[i].end());
+            closeStart[i+1] = closeStart[i] + closeness[i].size();
+        }
+        
+        closeIndexes.clear(); closeIndexes.reserve(closeStart[numSeqs]);
+        for (long long i = 0; i < numSeqs; i++) {
+            closeIndexes.insert(closeIndexes.end(), closeness[i].begin(), closeness[i].end());
+            vector<unsigned int>().swap(closeness[i]); //free as we go
+        }
+        vector< vector<unsigned int> >().swap(closeness);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiData", "packCloseness");
+        exit(1);
+    }
+}
+/***********************************************************************/
+void OptiData::packCloseness(vector< set<long long> >& close) {
+    try {
+        closeness.clear(); closeness.resize(close.size());
+        for (long long i = 0; i < close.size(); i++) { closeness[i].assign(close[i].begin(), close[i].end()); }
+        
+        packCloseness();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiData", "packCloseness");
+        exit(1);
+    }
+}
+/***********************************************************************/
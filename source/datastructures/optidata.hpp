@@ -15,6 +15,19 @@
 #include "counttable.h"
 
 
+/***********************************************************************/
+//the sequences close to one sequence, read in place from the matrix. Sorted, so it can be walked with a range for.
+struct OptiCloseSeqs {
+    const unsigned int* first;
+    const unsigned int* last;
+    
+    OptiCloseSeqs(const unsigned int* f, const unsigned int* l) : first(f), last(l) {}
+    const unsigned int* begin() const { return first; }
+    const unsigned int* end() const { return last; }
+    long long size() const { return (last - first); }
+};
+/***********************************************************************/
+
 /*
  #ifdef UNIT_TEST
      friend class TestOptiMatrix;
@@ -25,17 +38,18 @@
 class OptiData {
 public:
     
-    OptiData(double c)  { m = MothurOut::getInstance(); cutoff = c; }
+    OptiData(double c)  { m = MothurOut::getInstance(); cutoff = c; closeStart.push_back(0); }
     virtual ~OptiData(){}
     
     set<long long> getCloseSeqs(long long i);
+    OptiCloseSeqs getCloseSeqsInPlace(long long i) { return OptiCloseSeqs(closeIndexes.data()+closeStart[i], closeIndexes.data()+closeStart[i+1]); } //no copy, i must be valid
     bool isClose(long long, long long);
     long long getNumClose(long long);
     map<string, long long> getNameIndexMap();
     string getName(long long); //name from nameMap index
     set<string> getNames(set<long long>); //name from nameMap index
     
-    long long getNumSeqs() { return closeness.size(); }
+    long long getNumSeqs() { return closeStart.size()-1; }
     long long getNumSingletons() { return singletons.size(); }
     virtual long long getNumDists(); //number of distances under cutoff
     ListVector* getListSingle();
@@ -69,12 +83,16 @@ public:
     
 protected:
     Utils util; MothurOut* m;
-    vector< set<long long> > closeness;  //closeness[0] contains indexes of seqs "close" to seq 0.
+    vector< vector<unsigned int> > closeness;  //filled while reading, closeness[0] contains indexes of seqs "close" to seq 0. Emptied by packCloseness.
+    vector<long long> closeStart;   //the seqs close to seq i are closeIndexes[closeStart[i]] to closeIndexes[closeStart[i+1]-1]
+    vector<unsigned int> closeIndexes; //sorted for each seq
     vector<string> singletons; //name of seqs with NO distances in matrix, if name file is given then it contains 2nd column of namefile
     vector<string> nameMap;  //name of seqs with distances in matrix, if name file is given then it contains 2nd column of namefile
     double cutoff;
     
     set<long long> getIndexes(set<string> seqs);
+    void packCloseness(); //sorts each seq's close seqs, removes duplicates and moves them into closeStart and closeIndexes
+    void packCloseness(vector< set<long long> >&);
 };
 
 
@@ -11,7 +11,7 @@
 
 /***********************************************************************/
 OptiMatrix::OptiMatrix(vector< set<long long> > close, vector<string> name, vector<string> single, double c) : OptiData(c) {
-    closeness = close;
+    packCloseness(close);
     nameMap = name;
     singletons = single;
 }
@@ -146,8 +146,8 @@ int OptiMatrix::readPhylip(){
                     if(distance <= cutoff){
                         long long newB = singletonIndexSwap[j];
                         long long newA = singletonIndexSwap[i];
-                        closeness[newA].insert(newB);
-                        closeness[newB].insert(newA);
+                        closeness[newA].push_back(newB);
+                        closeness[newB].push_back(newA);
                     }
                     index++; 
                 }
@@ -173,14 +173,15 @@ int OptiMatrix::readPhylip(){
                     if(distance <= cutoff && j < i){
                         long long newB = singletonIndexSwap[j];
                         long long newA = singletonIndexSwap[i];
-                        closeness[newA].insert(newB);
-                        closeness[newB].insert(newA);
+                        closeness[newA].push_back(newB);
+                        closeness[newB].push_back(newA);
                     }
                     index++; 
                 }
             }
         }
         in.close();
+        packCloseness();
         
         return 0;
     }
@@ -292,8 +293,8 @@ int OptiMatrix::readColumn(){
                 
                 long long newB = singletonIndexSwap[indexB];
                 long long newA = singletonIndexSwap[indexA];
-                closeness[newA].insert(newB);
-                closeness[newB].insert(newA);
+                closeness[newA].push_back(newB);
+                closeness[newB].push_back(newA);
                 
                 if (namefile != "") {
                     firstName = names[firstName];  //redundant names
@@ -306,6 +307,7 @@ int OptiMatrix::readColumn(){
         }
         in.close();
         nameAssignment.clear();
+        packCloseness();
         
         return 1;
         
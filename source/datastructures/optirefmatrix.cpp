@@ -252,7 +252,7 @@ vector<long long> OptiRefMatrix::getTranslatedBins(vector<vector<string> > & bin
         set<string> unique;
         for (long long i = 0; i < nameMap.size(); i++) { //vector of string representing the sequences in the matrix from the name file.
             vector<string> thisSeqsReps; util.splitAtComma(nameMap[i], thisSeqsReps); //split redundant names
-            if (i < closeness.size()) {  nameIndexes[thisSeqsReps[0]] = i;  } //this is a sequence with distances in the matrix
+            if (i < getNumSeqs()) {  nameIndexes[thisSeqsReps[0]] = i;  } //this is a sequence with distances in the matrix
             if (thisSeqsReps.size() == 1) { //you are unique
                 unique.insert(thisSeqsReps[0]);
             }
@@ -289,11 +289,11 @@ vector<long long> OptiRefMatrix::getTranslatedBins(vector<vector<string> > & bin
 bool OptiRefMatrix::isCloseFit(long long i, long long toFind, bool& isFit){
     try {
         if (i < 0) { return false; }
-        else if (i > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); return false; }
+        else if (i >= getNumSeqs()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true); return false; }
         
         bool found = false;
         if (!isRef[toFind]) { //are you a fit seq
-            if (closeness[i].count(toFind) != 0) {  //are you close
+            if (binary_search(closeIndexes.begin()+closeStart[i], closeIndexes.begin()+closeStart[i+1], toFind)) {  //are you close
                 found = true;
             }
             isFit = true;
@@ -372,11 +372,11 @@ long long OptiRefMatrix::getNumFitClose(long long index) {
         long long numClose = 0;
         
         if (index < 0) { }
-        else if (index > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  }
+        else if (index >= getNumSeqs()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  }
         else {
             //reference seqs all have indexes less than refEnd
-            for (set<long long>::iterator it = closeness[index].begin(); it != closeness[index].end(); it++) {
-                if (!isRef[*it]) {  numClose++; } //you are a fit seq
+            for (long long j = closeStart[index]; j < closeStart[index+1]; j++) {
+                if (!isRef[closeIndexes[j]]) {  numClose++; } //you are a fit seq
             }
         }
         
@@ -393,11 +393,11 @@ long long OptiRefMatrix::getNumRefClose(long long index) {
         long long numClose = 0;
         
         if (index < 0) { }
-        else if (index > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  }
+        else if (index >= getNumSeqs()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  }
         else {
             //reference seqs all have indexes less than refEnd
-            for (set<long long>::iterator it = closeness[index].begin(); it != closeness[index].end(); it++) {
-                if (isRef[*it]) {  numClose++; } //you are a ref seq
+            for (long long j = closeStart[index]; j < closeStart[index+1]; j++) {
+                if (isRef[closeIndexes[j]]) {  numClose++; } //you are a ref seq
             }
         }
         
@@ -414,11 +414,11 @@ set<long long> OptiRefMatrix::getCloseFitSeqs(long long index){
         set<long long> closeSeqs;
         
         if (index < 0) { }
-        else if (index > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  } //
+        else if (index >= getNumSeqs()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  } //
         else {
             //reference seqs all have indexes less than refEnd
-            for (set<long long>::iterator it = closeness[index].begin(); it != closeness[index].end(); it++) {
-                if (!isRef[*it]) {  closeSeqs.insert(*it); } //you are a fit seq
+            for (long long j = closeStart[index]; j < closeStart[index+1]; j++) {
+                if (!isRef[closeIndexes[j]]) {  closeSeqs.insert(closeIndexes[j]); } //you are a fit seq
             }
         }
         
@@ -435,11 +435,11 @@ set<long long> OptiRefMatrix::getCloseRefSeqs(long long index){
         set<long long> closeSeqs;
         
         if (index < 0) { }
-        else if (index > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  }
+        else if (index >= getNumSeqs()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->setControl_pressed(true);  }
         else {
             //reference seqs all have indexes less than refEnd
-            for (set<long long>::iterator it = closeness[index].begin(); it != closeness[index].end(); it++) {
-                if (isRef[*it]) { closeSeqs.insert(*it); } //you are a ref seq
+            for (long long j = closeStart[index]; j < closeStart[index+1]; j++) {
+                if (isRef[closeIndexes[j]]) { closeSeqs.insert(closeIndexes[j]); } //you are a ref seq
             }
         }
         
@@ -614,6 +614,7 @@ int OptiRefMatrix::readFiles(string distFile, string distFormat, string dupsFile
             }
         }
         singleton.clear();
+        packCloseness();
         
         //find number of fitDists, refDists and between dists
         calcCounts();
@@ -743,6 +744,7 @@ int OptiRefMatrix::readFiles(string refdistfile, string refnamefile, string refc
         if (!hasName && refHasName) { hasName = true; } //if either the ref or fit has a name file then set hasName
         if (betweendistformat == "column")        {  readColumn(betweendistfile, hasName, names, nameAssignment, singletonIndexSwap);     }
         else if (betweendistformat == "phylip")   {  readPhylip(betweendistfile, hasName, names, nameAssignment, singletonIndexSwap);     }
+        packCloseness();
         
         //find number of fitDists, refDists and between dists
         calcCounts();
@@ -927,8 +929,8 @@ int OptiRefMatrix::readPhylip(string distFile, bool hasName, map<string, string>
                         }
                         long long newB = singletonIndexSwap[j];
                         long long newA = singletonIndexSwap[i];
-                        closeness[newA].insert(newB);
-                        closeness[newB].insert(newA);
+                        closeness[newA].push_back(newB);
+                        closeness[newB].push_back(newA);
                     }
                 }
             }
@@ -954,8 +956,8 @@ int OptiRefMatrix::readPhylip(string distFile, bool hasName, map<string, string>
                         }
                         long long newB = singletonIndexSwap[j];
                         long long newA = singletonIndexSwap[i];
-                        closeness[newA].insert(newB);
-                        closeness[newB].insert(newA);
+                        closeness[newA].push_back(newB);
+                        closeness[newB].push_back(newA);
                     }
                 }
             }
@@ -1006,8 +1008,8 @@ int OptiRefMatrix::readColumn(string distFile, bool hasName, map<string, string>
                 
                 long long newB = singletonIndexSwap[indexB];
                 long long newA = singletonIndexSwap[indexA];
-                closeness[newA].insert(newB);
-                closeness[newB].insert(newA);
+                closeness[newA].push_back(newB);
+                closeness[newB].push_back(newA);
                 
                 if (hasName) {
                     map<string, string>::iterator itName1 = names.find(firstName);
@@ -1043,15 +1045,15 @@ void OptiRefMatrix::calcCounts(){
         numFitSeqs = 0;
         numRefSingletons = 0;
         
-        for (long long i = 0; i < closeness.size(); i++) {
+        for (long long i = 0; i < getNumSeqs(); i++) {
             if (m->getControl_pressed()) { break; }
             
             bool thisSeqIsRef = isRef[i];
             long long thisSeqsNumRefDists = 0;
             long long thisSeqsNumFitDists = 0;
             
-            for (set<long long>::iterator it = closeness[i].begin(); it != closeness[i].end(); it++) {
-                long long newB = *it;
+            for (long long j = closeStart[i]; j < closeStart[i+1]; j++) {
+                long long newB = closeIndexes[j];
                 
                 if ((thisSeqIsRef) && (isRef[newB])) {  thisSeqsNumRefDists++; } //both refs
                 else if ((thisSeqIsRef) && (!isRef[newB])) { numBetweenDists++; } // ref to fit dist
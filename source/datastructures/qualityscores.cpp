@@ -44,7 +44,7 @@ QualityScores::QualityScores(ifstream& qFile){
 		m = MothurOut::getInstance();
 
 		int score;
-        seqName = getSequenceName(qFile); gobble(qFile); getCommentString(qFile);
+        seqName = getSequenceName(qFile); getCommentString(qFile);
 
         if (m->getDebug()) { m->mothurOut("[DEBUG]: name = '" + seqName + "'\n.");  }
 
@@ -94,7 +94,7 @@ QualityScores::QualityScores(boost::iostreams::filtering_istream& qFile){
         m = MothurOut::getInstance();
 
         int score;
-        seqName = getSequenceName(qFile); gobble(qFile); getCommentString(qFile);
+        seqName = getSequenceName(qFile); getCommentString(qFile);
 
         if (m->getDebug()) { m->mothurOut("[DEBUG]: name = '" + seqName + "'\n.");  }
 
@@ -143,7 +143,7 @@ QualityScores::QualityScores(boost::iostreams::filtering_istream& qFile){
 int QualityScores::read(ifstream& qFile){
     try {
         int score;
-        seqName = getSequenceName(qFile); gobble(qFile); getCommentString(qFile);
+        seqName = getSequenceName(qFile); getCommentString(qFile);
 
         if (m->getDebug()) { m->mothurOut("[DEBUG]: name = '" + seqName + "'\n.");  }
 
@@ -35,6 +35,11 @@ inline bool compareSeqMatches (seqMatch member, seqMatch member2){ //sorts large
 	}
 }
 /**************************************************************************************************/
+inline bool compareSeqMatchesThenIndex (const seqMatch& member, const seqMatch& member2){ //sorts largest to smallest, ties by index
+	if (member.match != member2.match) { return (member.match > member2.match); }
+	return (member.seq < member2.seq);
+}
+/**************************************************************************************************/
 inline bool compareSeqMatchesReverse (seqMatch member, seqMatch member2){ //sorts largest to smallest
 	if(member.match < member2.match){
 		return true;   }   
@@ -22,7 +22,7 @@ Sequence::Sequence(string newName, string sequence) {
 		initialize();	
 		name = newName;
         
-        util.checkName(name);
+        checkName(name);
 		
 		//setUnaligned removes any gap characters for us
 		setUnaligned(sequence);
@@ -272,6 +272,13 @@ Protein Sequence::getProtein(int sf, bool trim) {
     }
 }
 //********************************************************************************************************************
+//same as Utils::checkName, so a sequence doesn't need its own Utils
+void Sequence::checkName(string& seqName) {
+    if (m->getChangedSeqNames()) {
+        for (auto& n : seqName) { if (n == ':') { n = '_'; } }
+    }
+}
+//********************************************************************************************************************
 string Sequence::getSequenceName(ifstream& fastaFile) {
 	try {
 		string name = "";
@@ -282,7 +289,7 @@ string Sequence::getSequenceName(ifstream& fastaFile) {
             
 			name = name.substr(1); 
             
-            util.checkName(name);
+            checkName(name);
             
         }else{ if (!fastaFile.eof()) { m->mothurOut("Error in reading your fastafile, at position " + toString(fastaFile.tellg()) + ". Blank name.\n");  m->setControl_pressed(true);  } }
         
@@ -305,7 +312,7 @@ string Sequence::getSequenceName(boost::iostreams::filtering_istream& fastaFile)
             
             name = name.substr(1);
             
-            util.checkName(name);
+            checkName(name);
             
         }else{ if (!fastaFile.eof()) { m->mothurOut("Error in reading your fastafile, at position " + toString(fastaFile.tellg()) + ". Blank name.\n");  m->setControl_pressed(true);  }  }
         
@@ -328,7 +335,7 @@ string Sequence::getSequenceName(istringstream& fastaFile) {
             
 			name = name.substr(1); 
             
-            util.checkName(name);
+            checkName(name);
             
         }else{ if (!fastaFile.eof()) { m->mothurOut("Error in reading your fastafile, at position " + toString(fastaFile.tellg()) + ". Blank name.\n");  m->setControl_pressed(true);  }  }
         
@@ -348,7 +355,7 @@ string Sequence::getSequenceString(ifstream& fastaFile, int& numAmbig) {
         while(fastaFile.peek() != '>' && fastaFile.peek() != EOF){
             if (m->getControl_pressed()) { break; }
             
-            string line = util.getline(fastaFile);
+            string line = getlineTrimmed(fastaFile);
             
             //iterate through string
             for_each(line.begin(), line.end(), [&numAmbig](char & c) {
@@ -461,7 +468,7 @@ string Sequence::getSequenceString(istringstream& fastaFile, int& numAmbig) {
         while(fastaFile.peek() != '>' && fastaFile.peek() != EOF){
             if (m->getControl_pressed()) { break; }
             
-            string line = util.getline(fastaFile);
+            string line = getlineTrimmed(fastaFile);
             
             //iterate through string
             for_each(line.begin(), line.end(), [&numAmbig](char & c) {
@@ -96,6 +96,7 @@ protected:
     string getSequenceName(boost::iostreams::filtering_istream&);
     #endif
     string getSequenceName(istringstream&);
+    void checkName(string&);
     
     
 	string name;
@@ -108,7 +109,6 @@ protected:
 	int longHomoPolymer;
 	int ambigBases;
 	int startPos, endPos;
-    Utils util;
 };
 
 /**************************************************************************************************/
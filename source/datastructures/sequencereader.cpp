@@ -0,0 +1,380 @@
+//
+//  sequencereader.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "sequencereader.hpp"
+
+/**************************************************************************************************/
+//cleaned base and ambiguous flag for every character, same as Sequence::getSequenceString
+struct BaseTable {
+    unsigned char base[256];
+    unsigned char ambig[256];
+
+    BaseTable() {
+        for (int i = 0; i < 256; i++) {
+            char c = (char)i;
+            if (i < 128) { c = toupper(c); }
+            if (c == 'U') { c = 'T'; }
+
+            ambig[i] = 0;
+            if (c != '.' && c != '-' && c != 'A' && c != 'T' && c != 'G' && c != 'C' && c != 'N') { c = 'N'; ambig[i] = 1; }
+            base[i] = (unsigned char)c;
+        }
+    }
+};
+static const BaseTable baseTable;
+
+static const size_t readSize = 4194304;
+
+inline bool isSpaceChar(int c) { return ((c == ' ') || (c == '\t') || (c == '\n') || (c == '\v') || (c == '\f') || (c == '\r')); }
+/**************************************************************************************************/
+SequenceReader::SequenceReader(string filename, bool gz) {
+    try {
+        m = MothurOut::getInstance();
+        pos = 0; filled = 0; recordStart = 0; bufferOffset = 0; endOfFile = false; in = &file;
+        buffer.resize(readSize);
+        startRecord();
+
+        if (gz) {
+#ifdef USE_BOOST
+            if (!util.openInputFileBinary(filename, file, gzFile)) { endOfFile = true; }
+            in = &gzFile;
+#else
+            m->mothurOut("[ERROR]: mothur was not compiled with boost, so it cannot read the gzipped file " + filename + ".\n"); m->setControl_pressed(true);
+            endOfFile = true;
+#endif
+        }else {
+            if (!util.openInputFile(filename, file)) { endOfFile = true; }
+            else { bufferOffset = file.tellg(); }
+        }
+
+        skipNulls();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "SequenceReader");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+SequenceReader::SequenceReader(string filename, unsigned long long start) {
+    try {
+        m = MothurOut::getInstance();
+        pos = 0; filled = 0; recordStart = 0; bufferOffset = start; endOfFile = false; in = &file;
+        buffer.resize(readSize);
+        startRecord();
+
+        if (!util.openInputFile(filename, file)) { endOfFile = true; }
+        else { file.seekg(start); }
+
+        if (start == 0) { skipNulls(); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "SequenceReader");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+SequenceReader::~SequenceReader() {
+#ifdef USE_BOOST
+    gzFile.reset();
+#endif
+    file.close();
+}
+/**************************************************************************************************/
+//reads the next block of the file, keeping the part of the current record already read. Marks in the record are
+//saved from recordStart, so moving the record to the front of the buffer only moves pos and recordStart.
+bool SequenceReader::more() {
+    try {
+        if (endOfFile) { return false; }
+
+        if (recordStart > 0) {
+            memmove(buffer.data(), buffer.data() + recordStart, filled - recordStart);
+            bufferOffset += recordStart;
+            filled -= recordStart;
+            pos -= recordStart;
+            recordStart = 0;
+        }
+        if (filled == buffer.size()) { buffer.resize(buffer.size() * 2); } //record bigger than the buffer
+
+        in->read(buffer.data() + filled, buffer.size() - filled);
+        size_t numRead = in->gcount();
+        filled += numRead;
+
+        if (numRead == 0) { endOfFile = true; return false; }
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "more");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SequenceReader::startRecord() {
+    recordStart = pos;
+    nameStart = 0; nameEnd = 0; commentStart = 0; commentEnd = 0; basesStart = 0; basesEnd = 0;
+    qualStart = 0; qualEnd = 0; plusStart = 0; plusEnd = 0;
+    numAmbig = 0;
+}
+/**************************************************************************************************/
+//same as gobble
+void SequenceReader::skipSpace() {
+    while (true) {
+        int c = peekChar();
+        if ((c == EOF) || !isSpaceChar(c)) { break; }
+        pos++;
+    }
+}
+/**************************************************************************************************/
+//same as Utils::zapGremlins
+void SequenceReader::skipNulls() {
+    while (peekChar() == '\0') { pos++; }
+}
+/**************************************************************************************************/
+//same as in >> token, with the marks saved from recordStart
+void SequenceReader::readToken(size_t& start, size_t& end) {
+    skipSpace();
+    start = pos - recordStart;
+    while (true) {
+        int c = peekChar();
+        if ((c == EOF) || isSpaceChar(c)) { break; }
+        pos++;
+    }
+    end = pos - recordStart;
+}
+/**************************************************************************************************/
+//returns the position of the next '\n', or filled at the end of the file
+size_t SequenceReader::findLineEnd() {
+    size_t searched = 0;
+    while (true) {
+        const char* lineEnd = (const char*)memchr(buffer.data() + pos + searched, '\n', filled - pos - searched);
+        if (lineEnd != nullptr) { return lineEnd - buffer.data(); }
+
+        searched = filled - pos;
+        if (!more()) { return filled; }
+    }
+}
+/**************************************************************************************************/
+//same as getlineTrimmed
+void SequenceReader::readLine(size_t& start, size_t& end) {
+    size_t lineEnd = findLineEnd();
+    start = pos - recordStart;
+    end = lineEnd - recordStart;
+
+    pos = lineEnd;
+    if (pos < filled) { pos++; }
+    skipSpace();
+
+    while ((end > start) && isSpaceChar((unsigned char)buffer[recordStart + end - 1])) { end--; }
+}
+/**************************************************************************************************/
+//same as Sequence::getCommentString, reads to the '\r' or '\n' and the white space after it
+void SequenceReader::readToLineEnd(size_t& start, size_t& end) {
+    start = pos - recordStart;
+    while (true) {
+        int c = peekChar();
+        if (c == EOF) { break; }
+        if ((c == '\r') || (c == '\n') || (c == 255)) {
+            end = pos - recordStart;
+            pos++;
+            skipSpace();
+            return;
+        }
+        pos++;
+    }
+    end = pos - recordStart;
+}
+/**************************************************************************************************/
+//reads the name token of a fasta or qual record, without its '>'. A record that doesn't start with '>' is reported and
+//stops the read, instead of losing the first character of whatever is there.
+bool SequenceReader::readName(string fileType) {
+    try {
+        readToken(nameStart, nameEnd);
+
+        if (buffer[recordStart + nameStart] != '>') {
+            string found = view(nameStart, min(nameEnd, nameStart + 50)).toString();
+            m->mothurOut("[ERROR]: Error in reading your " + fileType + " file, at position " + toString(bufferOffset + recordStart + nameStart) + ". Expected a name starting with '>' and found '" + found + "'.\n");
+            m->setControl_pressed(true);
+            nameStart = nameEnd;
+            return false;
+        }
+        nameStart++;
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "readName");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool SequenceReader::readFasta() {
+    try {
+        skipSpace();
+        startRecord();
+        if (peekChar() == EOF) { return false; }
+
+        if (!readName("fasta")) { return false; }
+
+        //skip commented out sequences
+        while ((nameEnd > nameStart) && (buffer[recordStart + nameStart] == '#')) {
+            while (true) {
+                int c = peekChar();
+                if (c == EOF) { break; }
+                pos++;
+                if ((c == '\r') || (c == '\n')) { break; }
+            }
+            size_t start, end; readToLineEnd(start, end);
+
+            if (peekChar() == EOF) { nameStart = nameEnd; break; }
+            if (!readName("fasta")) { return false; }
+        }
+
+        readToLineEnd(commentStart, commentEnd);
+
+        //clean each line of bases and move it to the end of the bases before it
+        basesStart = pos - recordStart;
+        size_t out = basesStart;
+        while (true) {
+            int c = peekChar();
+            if ((c == EOF) || (c == '>')) { break; }
+            if (m->getControl_pressed()) { break; }
+
+            size_t start, end; readLine(start, end);
+
+            unsigned char* record = (unsigned char*)buffer.data() + recordStart;
+            for (size_t i = start; i < end; i++) {
+                unsigned char base = record[i];
+                record[out++] = baseTable.base[base];
+                numAmbig += baseTable.ambig[base];
+            }
+        }
+        basesEnd = out;
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "readFasta");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//name, sequence, + and quality lines, each read like getlineTrimmed. getName returns the whole '@' line.
+bool SequenceReader::readFastq() {
+    try {
+        skipSpace();
+        startRecord();
+        if (peekChar() == EOF) { return false; }
+
+        readLine(nameStart, nameEnd);
+        readLine(basesStart, basesEnd);
+        readLine(plusStart, plusEnd);
+        readLine(qualStart, qualEnd);
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "readFastq");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//the score lines are joined with a space between them, moving each line to the end of the line before it
+bool SequenceReader::readQual() {
+    try {
+        skipSpace();
+        startRecord();
+        if (peekChar() == EOF) { return false; }
+
+        if (!readName("qual")) { return false; }
+        readToLineEnd(commentStart, commentEnd);
+
+        //a record without score lines has no scores, instead of taking the next name line as its scores
+        int c = peekChar();
+        if ((c == EOF) || (c == '>')) { qualStart = qualEnd = pos - recordStart; return true; }
+
+        readLine(qualStart, qualEnd);
+        while (true) {
+            int c = peekChar();
+            if ((c == EOF) || (c == '>')) { break; }
+            if (m->getControl_pressed()) { break; }
+
+            size_t start, end; readLine(start, end);
+
+            char* record = buffer.data() + recordStart;
+            record[qualEnd++] = ' ';
+            memmove(record + qualEnd, record + start, end - start);
+            qualEnd += end - start;
+        }
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "readQual");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+Sequence SequenceReader::getSequence() {
+    try {
+        Sequence seq(getName().toString(), getBases().toString());
+        seq.setComment(getComment().toString());
+
+        if ((numAmbig / (float) seq.getNumBases()) > 0.25) { m->mothurOut("[WARNING]: We found more than 25% of the bases in sequence " + seq.getName() + " to be ambiguous. Mothur is not setup to process protein sequences.\n");  }
+
+        return seq;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "getSequence");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+FastqRead SequenceReader::getFastqRead(bool& ignore, string format) {
+    try {
+        return FastqRead(format, getName().toString(), getBases().toString(), view(plusStart, plusEnd).toString(), getQuality().toString(), ignore);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "getFastqRead");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//same as QualityScores(ifstream&), scores over 40 are set to 40
+QualityScores SequenceReader::getQualityScores() {
+    try {
+        string name = getName().toString();
+        vector<int> scores;
+
+        RecordView quality = getQuality();
+        size_t i = 0;
+        while (i < quality.length) {
+            if (m->getControl_pressed()) { break; }
+
+            size_t start = i;
+            while ((i < quality.length) && !isSpaceChar((unsigned char)quality.start[i])) { i++; }
+
+            int score = 0; bool digits = true;
+            for (size_t j = start; j < i; j++) {
+                char c = quality.start[j];
+                if ((c < '0') || (c > '9')) { digits = false; break; }
+                if (score <= 40) { score = score * 10 + (c - '0'); }
+            }
+            if (!digits) { m->mothurOut("[ERROR]: In sequence " + name + "'s quality scores, expected a number and got " + string(quality.start + start, i - start) + ", setting score to 0.\n");  score = 0; }
+            if (score > 40) { score = 40; }
+            scores.push_back(score);
+
+            while ((i < quality.length) && isSpaceChar((unsigned char)quality.start[i])) { i++; }
+        }
+
+        return QualityScores(name, scores);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "getQualityScores");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,90 @@
+#ifndef sequencereader_hpp
+#define sequencereader_hpp
+//
+//  sequencereader.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "mothurout.h"
+#include "utils.hpp"
+#include "sequence.hpp"
+#include "qualityscores.h"
+#include "fastqread.h"
+
+/**************************************************************************************************/
+//characters in the reader's buffer, valid until the next record is read
+struct RecordView {
+    const char* start;
+    size_t length;
+
+    RecordView() : start(nullptr), length(0) {}
+    RecordView(const char* s, size_t l) : start(s), length(l) {}
+    string toString() const { return string(start, length); }
+};
+/**************************************************************************************************/
+
+/* Reads fasta, fastq and qual records from a plain or gzipped file in large blocks. Gzipped files are read through
+ boost's gzip_decompressor, so both kinds of input share every line of the parser. The name, comment, bases and
+ quality of the current record are views into the block. Lines and records are split the same way as
+ Sequence(ifstream&), FastqRead(ifstream&, bool&, string) and QualityScores(ifstream&). Fasta bases are cleaned in
+ place with a lookup table, as Sequence does: upper case, U to T, and anything else but .-ATGCN is an N counted as
+ ambiguous. */
+
+class SequenceReader {
+
+public:
+    SequenceReader(string, bool);   //filename, gz
+    SequenceReader(string, unsigned long long);   //filename, start - plain file read from a position given by divideFile
+    ~SequenceReader();
+
+    bool readFasta();   //false at the end of the file, or after reporting a record that doesn't start with '>'
+    bool readFastq();
+    bool readQual();
+
+    RecordView getName()        { return view(nameStart, nameEnd);          }   //fasta or qual name without the '>', the whole '@' line of a fastq read
+    RecordView getComment()     { return view(commentStart, commentEnd);    }   //rest of the fasta or qual name line
+    RecordView getBases()       { return view(basesStart, basesEnd);        }
+    RecordView getQuality()     { return view(qualStart, qualEnd);          }   //fastq quality line or qual scores
+    int getNumAmbig()           { return numAmbig;                          }
+    unsigned long long getPosition() { return bufferOffset + pos;           }   //where ifstream::tellg would be after the record and the white space after it
+
+    Sequence getSequence();
+    FastqRead getFastqRead(bool&, string);  //ignore, format
+    QualityScores getQualityScores();
+
+private:
+    MothurOut* m;
+    Utils util;
+    ifstream file;
+#ifdef USE_BOOST
+    boost::iostreams::filtering_istream gzFile;
+#endif
+    istream* in;
+
+    vector<char> buffer;
+    size_t pos, filled, recordStart;
+    unsigned long long bufferOffset;    //file position of buffer[0]
+    bool endOfFile;
+
+    size_t nameStart, nameEnd, commentStart, commentEnd, basesStart, basesEnd, qualStart, qualEnd, plusStart, plusEnd;
+    int numAmbig;
+
+    RecordView view(size_t s, size_t e) { return RecordView(buffer.data() + recordStart + s, e - s); }  //marks are saved from recordStart
+
+    bool more();
+    int peekChar()      { if ((pos < filled) || more()) { return (unsigned char)buffer[pos]; } return EOF; }
+    void skipSpace();
+    void skipNulls();
+    void readToken(size_t&, size_t&);
+    bool readName(string);
+    void readLine(size_t&, size_t&);
+    void readToLineEnd(size_t&, size_t&);
+    size_t findLineEnd();
+    void startRecord();
+};
+
+/**************************************************************************************************/
+
+#endif
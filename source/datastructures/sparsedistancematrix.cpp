@@ -23,6 +23,7 @@ int SparseDistanceMatrix::getNNodes(){
 void SparseDistanceMatrix::clear(){
     for (int i = 0; i < seqVec.size(); i++) {  seqVec[i].clear();  }
     seqVec.clear();
+    rowMin.clear(); rowMins.clear(); dirtyRows.clear(); isDirty.clear();
 }
 
 /***********************************************************************/
@@ -44,6 +45,7 @@ int SparseDistanceMatrix::updateCellCompliment(ull row, ull col){
         }
        
         seqVec[vrow][vcol].dist = seqVec[row][col].dist;
+        setDirty(row, vrow);
         
         return 0;
     }
@@ -64,7 +66,7 @@ int SparseDistanceMatrix::rmCell(ull row, ull col){
         //find the columns entry for this cell as well
         for (int i = 0; i < seqVec[vrow].size(); i++) {  if (seqVec[vrow][i].index == row) { vcol = i;  break; }  }
         
-        
+        setDirty(row, vrow);
         seqVec[vrow].erase(seqVec[vrow].begin()+vcol);
         seqVec[row].erase(seqVec[row].begin()+col);
         
@@ -86,6 +88,7 @@ void SparseDistanceMatrix::addCell(ull row, PDistCell cell){
         seqVec[row].push_back(cell);
         PDistCell temp(row, cell.dist);
         seqVec[cell.index].push_back(temp);
+        setDirty(row, cell.index);
 	}
 	catch(exception& e) {
 		m->errorOut(e, "SparseDistanceMatrix", "addCell");
@@ -98,15 +101,29 @@ int SparseDistanceMatrix::addCellSorted(ull row, PDistCell cell){
 		numNodes+=2;
 		if(cell.dist < smallDist){ smallDist = cell.dist; }
         
-        seqVec[row].push_back(cell);
         PDistCell temp(row, cell.dist);
-        seqVec[cell.index].push_back(temp);
+        setDirty(row, cell.index);
+        
+        if (!sorted) {
+            seqVec[row].push_back(cell);
+            seqVec[cell.index].push_back(temp);
+            
+            sortSeqVec(row);
+            sortSeqVec(cell.index);
+            
+            int location = -1; //find location of new cell when sorted
+            for (int i = 0; i < seqVec[row].size(); i++) {  if (seqVec[row][i].index == cell.index) { location = i; break; } }
+            
+            return location;
+        }
         
-        sortSeqVec(row);
-        sortSeqVec(cell.index);
+        //rows are already sorted, so insert the cells in place instead of sorting the rows again
+        vector<PDistCell>::iterator it = lower_bound(seqVec[cell.index].begin(), seqVec[cell.index].end(), temp, compareIndexes);
+        seqVec[cell.index].insert(it, temp);
         
-        int location = -1; //find location of new cell when sorted
-        for (int i = 0; i < seqVec[row].size(); i++) {  if (seqVec[row][i].index == cell.index) { location = i; break; } }
+        it = lower_bound(seqVec[row].begin(), seqVec[row].end(), cell, compareIndexes);
+        int location = it - seqVec[row].begin();
+        seqVec[row].insert(it, cell);
         
         return location;
 	}
@@ -122,12 +139,28 @@ ull SparseDistanceMatrix::getSmallestCell(ull& row){
 	try {
         if (!sorted) { sortSeqVec(); sorted = true; }
         
+        updateRowMins();
+        
         //print();
         
         vector<PDistCellMin> mins;
         smallDist = MOTHURMAX;
+        
+        //only rows with a distance that can equal the smallest can add to mins. Searching them in order
+        //finds the same cells the search of every row would
+        vector<ull> rowsToSearch;
+        if (rowMins.size() != 0) {
+            float smallest = rowMins.begin()->first;
+            float largest = smallest + fabs(smallest) * 0.002; //past the largest distance isEqual to smallest
+            for (set< pair<float, ull> >::iterator it = rowMins.begin(); it != rowMins.end(); it++) {
+                if (it->first > largest) { break; }
+                rowsToSearch.push_back(it->second);
+            }
+            sort(rowsToSearch.begin(), rowsToSearch.end());
+        }
        
-        for (int i = 0; i < seqVec.size(); i++) {
+        for (int k = 0; k < rowsToSearch.size(); k++) {
+            ull i = rowsToSearch[k];
             for (int j = 0; j < seqVec[i].size(); j++) {
                 
                 if (m->getControl_pressed()) { return smallDist; }
@@ -168,6 +201,36 @@ ull SparseDistanceMatrix::getSmallestCell(ull& row){
 	}
 }
 /***********************************************************************/
+//the distance between row and col changed, it is kept in the smaller row's rowMin
+void SparseDistanceMatrix::setDirty(ull row, ull col){
+    ull lower = row; if (col < lower) { lower = col; }
+    if (!isDirty[lower]) { isDirty[lower] = true; dirtyRows.push_back(lower); }
+}
+/***********************************************************************/
+void SparseDistanceMatrix::updateRowMins(){
+	try {
+        for (int k = 0; k < dirtyRows.size(); k++) {
+            ull i = dirtyRows[k];
+            isDirty[i] = false;
+            
+            if (rowMin[i] != MOTHURMAX) { rowMins.erase(make_pair(rowMin[i], i)); }
+            
+            rowMin[i] = MOTHURMAX;
+            for (int j = 0; j < seqVec[i].size(); j++) {
+                if (i < seqVec[i][j].index) { if (seqVec[i][j].dist < rowMin[i]) { rowMin[i] = seqVec[i][j].dist; } }
+                else if (sorted) { break; } //higher indexes are first once sorted
+            }
+            
+            if (rowMin[i] != MOTHURMAX) { rowMins.insert(make_pair(rowMin[i], i)); }
+        }
+        dirtyRows.clear();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SparseDistanceMatrix", "updateRowMins");
+		exit(1);
+	}
+}
+/***********************************************************************/
 
 void SparseDistanceMatrix::print(){
     try {
@@ -29,7 +29,7 @@ public:
 	
 	int rmCell(ull, ull);
     int updateCellCompliment(ull, ull);
-    void resize(ull n) { seqVec.resize(n);  }
+    void resize(ull n) { seqVec.resize(n); rowMin.resize(n, MOTHURMAX); isDirty.resize(n, false); }
     void clear();
 	void addCell(ull, PDistCell);
     int addCellSorted(ull, PDistCell);
@@ -45,6 +45,14 @@ private:
     int sortSeqVec(int);
 	float smallDist, aboveCutoff;
     
+    //smallest distance to a higher index in each row, so getSmallestCell only searches the rows that can hold it
+    vector<float> rowMin; //MOTHURMAX if the row has no higher index
+    set< pair<float, ull> > rowMins; //rowMin, row for each row with a higher index
+    vector<ull> dirtyRows; //rows changed since rowMins was last updated
+    vector<bool> isDirty;
+    void setDirty(ull, ull);
+    void updateRowMins();
+    
 	MothurOut* m;
     Utils util;
 
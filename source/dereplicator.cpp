@@ -0,0 +1,619 @@
+//
+//  dereplicator.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "dereplicator.hpp"
+#include "sequencereader.hpp"
+
+/**************************************************************************************************/
+inline unsigned long long rotl64(unsigned long long x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline unsigned long long fmix64(unsigned long long k) {
+    k ^= k >> 33; k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33; k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+/**************************************************************************************************/
+//MurmurHash3_x64_128 with a seed of 0
+Fingerprint::Fingerprint(const string& s) {
+    const unsigned char* data = (const unsigned char*)s.data();
+    size_t length = s.length();
+    const unsigned long long c1 = 0x87c37b91114253d5ULL;
+    const unsigned long long c2 = 0x4cf5ad432745937fULL;
+    unsigned long long h1 = 0, h2 = 0;
+
+    size_t numBlocks = length / 16;
+    for (size_t i = 0; i < numBlocks; i++) {
+        unsigned long long k1, k2;
+        memcpy(&k1, data + (i * 16), 8);
+        memcpy(&k2, data + (i * 16) + 8, 8);
+
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = rotl64(h1, 27); h1 += h2; h1 = (h1 * 5) + 0x52dce729;
+
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = rotl64(h2, 31); h2 += h1; h2 = (h2 * 5) + 0x38495ab5;
+    }
+
+    const unsigned char* tail = data + (numBlocks * 16);
+    int tailLength = length & 15;
+    unsigned long long k1 = 0, k2 = 0;
+    for (int i = tailLength-1; i >= 8; i--) { k2 ^= ((unsigned long long)tail[i]) << ((i - 8) * 8); }
+    if (tailLength > 8) { k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2; }
+    for (int i = min(tailLength, 8)-1; i >= 0; i--) { k1 ^= ((unsigned long long)tail[i]) << (i * 8); }
+    if (tailLength > 0) { k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1; }
+
+    h1 ^= length; h2 ^= length;
+    h1 += h2; h2 += h1;
+    h1 = fmix64(h1); h2 = fmix64(h2);
+    h1 += h2; h2 += h1;
+
+    hi = h1; lo = h2;
+}
+/**************************************************************************************************/
+//hi picks the shard and partition, so only lo changes
+Fingerprint Fingerprint::next() const {
+    Fingerprint f;
+    f.hi = hi; f.lo = fmix64(lo + 0x9e3779b97f4a7c15ULL);
+    return f;
+}
+/**************************************************************************************************/
+void FingerprintTable::clear() {
+    keys.assign(1024, Fingerprint());
+    values.assign(1024, -1);
+    numKeys = 0;
+    mask = 1023;
+}
+/**************************************************************************************************/
+long long FingerprintTable::insert(const Fingerprint& key, long long value) {
+    if ((numKeys + 1) * 2 > keys.size()) { //keep the table at most half full
+        vector<Fingerprint> oldKeys(keys.size() * 2);  oldKeys.swap(keys);
+        vector<long long> oldValues(values.size() * 2, -1);   oldValues.swap(values);
+        mask = keys.size() - 1;
+
+        for (size_t i = 0; i < oldKeys.size(); i++) {
+            if (oldValues[i] == -1) { continue; }
+            size_t slot = oldKeys[i].lo & mask;
+            while (values[slot] != -1) { slot = (slot + 1) & mask; }
+            keys[slot] = oldKeys[i]; values[slot] = oldValues[i];
+        }
+    }
+
+    size_t slot = key.lo & mask;
+    while (values[slot] != -1) {
+        if (keys[slot] == key) { return values[slot]; }
+        slot = (slot + 1) & mask;
+    }
+    keys[slot] = key; values[slot] = value;
+    numKeys++;
+
+    return -1;
+}
+/**************************************************************************************************/
+//indexes and counts are written as long longs, and a label or the bases as a long long length and the characters
+inline void writeLong(ofstream& out, long long value) { out.write((char*)&value, sizeof(long long)); }
+
+inline void writeString(ofstream& out, const string& s) { writeLong(out, s.length()); out.write(s.data(), s.length()); }
+
+inline bool readLong(ifstream& in, long long& value) { in.read((char*)&value, sizeof(long long)); return (bool)in; }
+
+inline void readString(ifstream& in, string& s) {
+    long long length; readLong(in, length);
+    s.resize(length);
+    if (length != 0) { in.read(&s[0], length); }
+}
+/**************************************************************************************************/
+//the bases of the sequence printed at offset in a fasta file
+inline string readFastaBases(ifstream& in, long long offset) {
+    string name, bases;
+    in.clear(); in.seekg(offset);
+    getline(in, name); getline(in, bases);
+    return bases;
+}
+/**************************************************************************************************/
+Dereplicator::Dereplicator(int p, bool k, double b) : processors(p), keepLabels(k), budget(b) {
+    try {
+        m = MothurOut::getInstance();
+        if (processors < 1) { processors = 1; }
+        spilled = false;
+        numSeqs = 0; numUniques = 0; nextOrder = 0;
+        orderedFile = "";
+        batchSize = 10000;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "Dereplicator");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+Dereplicator::~Dereplicator() {
+    if (ordered.is_open()) { ordered.close(); }
+    if (orderedFile != "") { util.mothurRemove(orderedFile); }
+}
+/**************************************************************************************************/
+//the name file line of the sequence, or its name
+string Dereplicator::getLabel(const string& name, map<string, string>* nameMap, bool reportMissing) {
+    try {
+        if (nameMap == nullptr) { return name; }
+
+        map<string, string>::iterator itNames = nameMap->find(name);
+        if (itNames == nameMap->end()) { //namefile and fastafile do not match
+            if (reportMissing) { m->mothurOut("[ERROR]: " + name + " is in your fasta file, and not in your namefile, please correct.\n"); }
+            return name;
+        }
+        return itNames->second;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "getLabel");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+long long Dereplicator::addLabel(const string& label) {
+    long long start = labelChars.size();
+    labelChars.insert(labelChars.end(), label.begin(), label.end());
+    labelChars.push_back('\0');
+    return start;
+}
+/**************************************************************************************************/
+long long Dereplicator::getBytes() {
+    long long bytes = labelChars.capacity() + (labelStarts.capacity() * sizeof(long long)) + (next.capacity() * sizeof(long long));
+    bytes += order.capacity() * sizeof(pair<int, long long>);
+    for (int i = 0; i < processors; i++) {
+        bytes += seqTables[i].bytes() + nameTables[i].bytes() + (entries[i].capacity() * sizeof(UniqueEntry));
+    }
+    return bytes;
+}
+/**************************************************************************************************/
+void Dereplicator::clearMemory() {
+    vector<FingerprintTable>().swap(seqTables); vector<FingerprintTable>().swap(nameTables);
+    vector< vector<UniqueEntry> >().swap(entries);
+    vector< pair<int, long long> >().swap(order);
+    vector<char>().swap(labelChars);
+    vector<long long>().swap(labelStarts);
+    vector<long long>().swap(next);
+}
+/**************************************************************************************************/
+long long Dereplicator::dereplicate(string fastafile, string outFastaFile, map<string, string>* nameMap) {
+    try {
+        numSeqs = 0; numUniques = 0; nextOrder = 0; spilled = false;
+
+        int numPartitions = 0; long long numRead = 0;
+        if (readInMemory(fastafile, outFastaFile, nameMap, numPartitions, numRead)) { return numSeqs; }
+        if (m->getControl_pressed()) { return numSeqs; }
+
+        //out of memory, start again with the sequences on disk
+        m->mothurOut("\nThe unique sequences need more than " + toString((long long)(budget / 1048576)) + " MB, dereplicating them in " + toString(numPartitions) + " partitions.\n");
+        spilled = true;
+        readPartitioned(fastafile, outFastaFile, nameMap, numPartitions, numRead);
+
+        return numSeqs;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "dereplicate");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//a batch of sequences shared by the threads, each thread finds the fingerprints of one slice of the batch and then
+//adds the sequences of its shard to its table
+struct dereplicateBatch {
+    Dereplicator* dereplicator;
+    vector<Sequence>* seqs;
+    vector<Fingerprint>* seqPrints;
+    vector<Fingerprint>* namePrints;
+    vector<char>* isNew;
+    vector<char>* isDupName;
+    vector<long long>* uniqueOf;
+    FingerprintTable* seqTable;
+    FingerprintTable* nameTable;
+    vector<UniqueEntry>* entries;
+    vector<long long>* labelStarts;
+    vector<long long>* next;
+    ifstream uniques;       //the output fasta file, to compare bases with the uniques of earlier batches
+    long long firstIndex;   //index of the batch's first sequence in the file
+    int shard, numShards;
+    bool keepLabels;
+};
+/**************************************************************************************************/
+void fingerprintBatch(dereplicateBatch* batch) {
+    int size = batch->seqs->size();
+    for (int i = batch->shard; i < size; i += batch->numShards) {
+        (*batch->seqPrints)[i] = batch->dereplicator->getFingerprint((*batch->seqs)[i].getAligned());
+        (*batch->namePrints)[i] = Fingerprint((*batch->seqs)[i].getName());
+    }
+}
+/**************************************************************************************************/
+//the sequences of a shard are added in file order, so the first one of each unique is the one that adds it
+void insertBatch(dereplicateBatch* batch) {
+    int size = batch->seqs->size();
+    for (int i = 0; i < size; i++) {
+        const Fingerprint& namePrint = (*batch->namePrints)[i];
+        if ((namePrint.hi % batch->numShards) == batch->shard) {
+            (*batch->isDupName)[i] = (batch->nameTable->insert(namePrint, 0) != -1);
+        }
+
+        Fingerprint seqPrint = (*batch->seqPrints)[i];
+        if ((seqPrint.hi % batch->numShards) != batch->shard) { continue; }
+
+        long long index = batch->firstIndex + i;
+        const string& bases = (*batch->seqs)[i].getAligned();
+        long long unique = -1;
+        while ((unique = batch->seqTable->insert(seqPrint, batch->entries->size())) != -1) {
+            UniqueEntry& entry = (*batch->entries)[unique];
+            if (entry.first >= batch->firstIndex) { //added by this batch, not written yet
+                if ((*batch->seqs)[entry.first - batch->firstIndex].getAligned() == bases) { break; }
+            }else if (readFastaBases(batch->uniques, entry.offset) == bases) { break; }
+            seqPrint = seqPrint.next();
+        }
+        if (unique == -1) {
+            long long label = -1;
+            if (batch->keepLabels) { label = (*batch->labelStarts)[index]; }
+            (*batch->isNew)[i] = true;
+            (*batch->uniqueOf)[i] = batch->entries->size();
+            batch->entries->push_back(UniqueEntry(index, label));
+        }else {
+            UniqueEntry& entry = (*batch->entries)[unique];
+            entry.count++;
+            if (batch->keepLabels) { (*batch->next)[entry.last] = index; entry.last = index; }
+        }
+    }
+}
+/**************************************************************************************************/
+//false if the uniques outgrew the budget, numPartitions is set to the number needed for the whole file
+bool Dereplicator::readInMemory(string fastafile, string outFastaFile, map<string, string>* nameMap, int& numPartitions, long long& numRead) {
+    try {
+        seqTables.resize(processors); nameTables.resize(processors); entries.resize(processors);
+
+        SequenceReader reader(fastafile, false);
+        ofstream outFasta; util.openOutputFile(outFastaFile, outFasta);
+
+        unsigned long long fileSize = 0;
+        ifstream in; util.openInputFile(fastafile, in); in.seekg(0, ios::end); fileSize = in.tellg(); in.close();
+
+        vector<Sequence> seqs; vector<Fingerprint> seqPrints, namePrints;
+        vector<char> isNew, isDupName; vector<long long> uniqueOf;
+
+        vector<dereplicateBatch*> batches;
+        for (int i = 0; i < processors; i++) {
+            dereplicateBatch* batch = new dereplicateBatch();
+            batch->dereplicator = this; batch->seqs = &seqs; batch->seqPrints = &seqPrints; batch->namePrints = &namePrints;
+            batch->isNew = &isNew; batch->isDupName = &isDupName; batch->uniqueOf = &uniqueOf;
+            batch->seqTable = &seqTables[i]; batch->nameTable = &nameTables[i]; batch->entries = &entries[i];
+            batch->labelStarts = &labelStarts; batch->next = &next;
+            util.openInputFile(outFastaFile, batch->uniques, "noerror");
+            batch->shard = i; batch->numShards = processors; batch->keepLabels = keepLabels;
+            batches.push_back(batch);
+        }
+
+        bool fits = true;
+        bool endOfFile = false;
+        while (!endOfFile) {
+            if (m->getControl_pressed()) { break; }
+
+            seqs.clear();
+            while (seqs.size() < batchSize) {
+                if (!reader.readFasta()) { endOfFile = true; break; }
+                Sequence seq = reader.getSequence();
+                if (seq.getName() != "") { seqs.push_back(seq); } //not end of file
+            }
+            if (seqs.size() == 0) { break; }
+
+            int size = seqs.size();
+            seqPrints.assign(size, Fingerprint()); namePrints.assign(size, Fingerprint());
+            isNew.assign(size, false); isDupName.assign(size, false); uniqueOf.assign(size, -1);
+
+            vector<string> batchLabels(size);
+            for (int i = 0; i < size; i++) {
+                batchLabels[i] = getLabel(seqs[i].getName(), nameMap, false);
+                if (keepLabels) { labelStarts.push_back(addLabel(batchLabels[i])); next.push_back(-1); }
+            }
+
+            for (int i = 0; i < processors; i++) { batches[i]->firstIndex = numSeqs; }
+
+            //the threads read back the uniques of earlier batches through their own streams
+            outFasta.flush();
+
+            if (processors == 1) { fingerprintBatch(batches[0]); insertBatch(batches[0]); }
+            else {
+                vector<std::thread*> workerThreads;
+                for (int i = 0; i < processors; i++) { workerThreads.push_back(new std::thread(fingerprintBatch, batches[i])); }
+                for (int i = 0; i < processors; i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+                workerThreads.clear();
+
+                for (int i = 0; i < processors; i++) { workerThreads.push_back(new std::thread(insertBatch, batches[i])); }
+                for (int i = 0; i < processors; i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+            }
+
+            //report in file order, as reading one sequence at a time would
+            for (int i = 0; i < size; i++) {
+                if (isDupName[i]) { m->mothurOut("[ERROR]: You already have a sequence named " + seqs[i].getName() + " in your fasta file, sequence names must be unique, please correct.\n");  }
+                if (nameMap != nullptr) { getLabel(seqs[i].getName(), nameMap, true); }
+
+                if (isNew[i]) {
+                    int shard = seqPrints[i].hi % processors;
+                    if (!keepLabels) { entries[shard][uniqueOf[i]].label = addLabel(batchLabels[i]); }
+                    entries[shard][uniqueOf[i]].offset = outFasta.tellp();
+                    order.push_back(make_pair(shard, uniqueOf[i]));
+                    seqs[i].printSequence(outFasta); //output to unique fasta file
+                }
+                numSeqs++;
+
+                if(numSeqs % 1000 == 0)    { m->mothurOutJustToScreen(toString(numSeqs) + "\t" + toString(order.size()) + "\n");    }
+            }
+
+            long long bytes = getBytes();
+            if (bytes > budget) {
+                numRead = numSeqs;
+                double fractionRead = 1.0;
+                if (fileSize != 0) { fractionRead = reader.getPosition() / (double) fileSize; }
+                if (fractionRead <= 0) { fractionRead = 1.0; }
+
+                //room for each processor to hold a partition, with the labels of every sequence
+                double partitionBudget = budget / (double) processors;
+                numPartitions = ceil((2.0 * bytes / fractionRead) / partitionBudget);
+                if (numPartitions < processors) { numPartitions = processors; }
+                if (numPartitions > 128) { numPartitions = 128; }
+
+                fits = false;
+                break;
+            }
+        }
+        outFasta.close();
+
+        for (int i = 0; i < processors; i++) { batches[i]->uniques.close(); delete batches[i]; }
+
+        if (!fits) { clearMemory(); return false; }
+
+        numUniques = order.size();
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "readInMemory");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//the partitions each thread dereplicates, and the duplicate names it finds
+struct partitionData {
+    Dereplicator* dereplicator;
+    vector<string> seqFiles, nameFiles, resultFiles;
+    vector< pair<long long, string> > dupNames;
+};
+/**************************************************************************************************/
+void dereplicatePartitions(partitionData* params) {
+    for (int i = 0; i < params->seqFiles.size(); i++) {
+        params->dereplicator->dereplicatePartition(params->seqFiles[i], params->nameFiles[i], params->resultFiles[i], params->dupNames);
+    }
+}
+/**************************************************************************************************/
+void Dereplicator::readPartitioned(string fastafile, string outFastaFile, map<string, string>* nameMap, int numPartitions, long long numReported) {
+    try {
+        string prefix = outFastaFile + ".derep";
+
+        //write each sequence's fingerprint, bases and label to its partition, and each name to its partition
+        vector<string> seqFiles, nameFiles, resultFiles;
+        vector<ofstream*> seqOut, nameOut;
+        for (int i = 0; i < numPartitions; i++) {
+            seqFiles.push_back(prefix + toString(i) + ".seqs.temp");
+            nameFiles.push_back(prefix + toString(i) + ".names.temp");
+            resultFiles.push_back(prefix + toString(i) + ".uniques.temp");
+
+            ofstream* out = new ofstream(); util.openOutputFileBinary(seqFiles[i], *out); seqOut.push_back(out);
+            out = new ofstream(); util.openOutputFileBinary(nameFiles[i], *out); nameOut.push_back(out);
+        }
+
+        numSeqs = 0;
+        SequenceReader reader(fastafile, false);
+        while (reader.readFasta()) {
+            if (m->getControl_pressed()) { break; }
+
+            Sequence seq = reader.getSequence();
+            if (seq.getName() == "") { continue; } //not end of file
+
+            Fingerprint seqPrint = getFingerprint(seq.getAligned());
+            ofstream& out = *seqOut[(seqPrint.hi >> 32) % numPartitions];
+            writeLong(out, numSeqs);
+            out.write((char*)&seqPrint, sizeof(Fingerprint));
+            writeString(out, seq.getAligned());
+            writeString(out, getLabel(seq.getName(), nameMap, (numSeqs >= numReported)));
+
+            Fingerprint namePrint(seq.getName());
+            ofstream& outName = *nameOut[(namePrint.hi >> 32) % numPartitions];
+            writeLong(outName, numSeqs);
+            outName.write((char*)&namePrint, sizeof(Fingerprint));
+            writeString(outName, seq.getName());
+
+            numSeqs++;
+            if((numSeqs > numReported) && (numSeqs % 1000 == 0))    { m->mothurOutJustToScreen(toString(numSeqs) + "\n");    }
+        }
+        for (int i = 0; i < numPartitions; i++) { seqOut[i]->close(); delete seqOut[i]; nameOut[i]->close(); delete nameOut[i]; }
+
+        //dereplicate the partitions
+        vector<partitionData*> data;
+        for (int i = 0; i < processors; i++) { partitionData* params = new partitionData(); params->dereplicator = this; data.push_back(params); }
+        for (int i = 0; i < numPartitions; i++) {
+            data[i % processors]->seqFiles.push_back(seqFiles[i]);
+            data[i % processors]->nameFiles.push_back(nameFiles[i]);
+            data[i % processors]->resultFiles.push_back(resultFiles[i]);
+        }
+
+        if (!m->getControl_pressed()) {
+            vector<std::thread*> workerThreads;
+            for (int i = 1; i < processors; i++) { workerThreads.push_back(new std::thread(dereplicatePartitions, data[i])); }
+            dereplicatePartitions(data[0]);
+            for (int i = 0; i < workerThreads.size(); i++) { workerThreads[i]->join(); delete workerThreads[i]; }
+        }
+
+        vector< pair<long long, string> > dupNames;
+        for (int i = 0; i < processors; i++) { dupNames.insert(dupNames.end(), data[i]->dupNames.begin(), data[i]->dupNames.end()); delete data[i]; }
+        sort(dupNames.begin(), dupNames.end());
+        for (int i = 0; i < dupNames.size(); i++) {
+            if (dupNames[i].first < numReported) { continue; } //reported before running out of memory
+            m->mothurOut("[ERROR]: You already have a sequence named " + dupNames[i].second + " in your fasta file, sequence names must be unique, please correct.\n");
+        }
+        for (int i = 0; i < numPartitions; i++) { util.mothurRemove(seqFiles[i]); util.mothurRemove(nameFiles[i]); }
+
+        //merge the uniques of the partitions by the first sequence of each, and write that sequence
+        orderedFile = prefix + ".temp";
+        ofstream outOrdered; util.openOutputFileBinary(orderedFile, outOrdered);
+        ofstream outFasta; util.openOutputFile(outFastaFile, outFasta);
+
+        vector<ifstream*> results;
+        priority_queue< pair<long long, int>, vector< pair<long long, int> >, greater< pair<long long, int> > > firsts; //first sequence, partition
+        for (int i = 0; i < numPartitions; i++) {
+            ifstream* in = new ifstream(); results.push_back(in);
+            if (m->getControl_pressed()) { continue; }
+            util.openInputFileBinary(resultFiles[i], *in);
+            long long first;
+            if (readLong(*in, first)) { firsts.push(make_pair(first, i)); }
+        }
+
+        SequenceReader fasta(fastafile, false);
+        long long index = -1;
+        numUniques = 0;
+        while (!firsts.empty()) {
+            if (m->getControl_pressed()) { break; }
+
+            long long first = firsts.top().first; int partition = firsts.top().second; firsts.pop();
+
+            Sequence seq;
+            while ((index < first) && fasta.readFasta()) {
+                seq = fasta.getSequence();
+                if (seq.getName() != "") { index++; }
+            }
+            seq.printSequence(outFasta); //output to unique fasta file
+
+            long long count, numLabels; string label;
+            readLong(*results[partition], count); readLong(*results[partition], numLabels);
+            writeLong(outOrdered, count); writeLong(outOrdered, numLabels);
+            for (long long i = 0; i < numLabels; i++) { readString(*results[partition], label); writeString(outOrdered, label); }
+            numUniques++;
+
+            long long nextFirst;
+            if (readLong(*results[partition], nextFirst)) { firsts.push(make_pair(nextFirst, partition)); }
+        }
+        outFasta.close(); outOrdered.close();
+
+        for (int i = 0; i < numPartitions; i++) { results[i]->close(); delete results[i]; util.mothurRemove(resultFiles[i]); }
+
+        util.openInputFileBinary(orderedFile, ordered);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "readPartitioned");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//writes the partition's uniques in the order they first appear: first sequence, count, number of labels and labels
+void Dereplicator::dereplicatePartition(string seqFile, string nameFile, string resultFile, vector< pair<long long, string> >& dupNames) {
+    try {
+        FingerprintTable table;
+        vector<UniqueEntry> uniques;
+        vector<long long> indexes;  //index in the file of each unique's first sequence
+        vector<char> chars;         //labels, each followed by '\0'
+        vector<long long> starts;   //where each sequence's label starts, if all labels are kept
+        vector<long long> links;    //next sequence of the partition with the same bases
+
+        ifstream in; util.openInputFileBinary(seqFile, in);
+        ifstream firsts; util.openInputFileBinary(seqFile, firsts);  //to compare bases with the uniques' first sequences
+        long long index, numRecords = 0;
+        string bases, firstBases, label;
+        while (readLong(in, index)) {
+            if (m->getControl_pressed()) { break; }
+
+            Fingerprint seqPrint;
+            in.read((char*)&seqPrint, sizeof(Fingerprint));
+            long long offset = in.tellg();
+            readString(in, bases);
+            readString(in, label);
+
+            long long unique = -1;
+            while ((unique = table.insert(seqPrint, uniques.size())) != -1) {
+                firsts.clear(); firsts.seekg(uniques[unique].offset);
+                readString(firsts, firstBases);
+                if (firstBases == bases) { break; }
+                seqPrint = seqPrint.next();
+            }
+            if ((unique == -1) || keepLabels) {
+                long long start = chars.size();
+                chars.insert(chars.end(), label.begin(), label.end()); chars.push_back('\0');
+                if (keepLabels) { starts.push_back(start); links.push_back(-1); }
+                if (unique == -1) { uniques.push_back(UniqueEntry(numRecords, start)); uniques.back().offset = offset; indexes.push_back(index); }
+            }
+            if (unique != -1) {
+                UniqueEntry& entry = uniques[unique];
+                entry.count++;
+                if (keepLabels) { links[entry.last] = numRecords; entry.last = numRecords; }
+            }
+            numRecords++;
+        }
+        in.close(); firsts.close();
+
+        ofstream out; util.openOutputFileBinary(resultFile, out);
+        for (int i = 0; i < uniques.size(); i++) {
+            writeLong(out, indexes[i]); writeLong(out, uniques[i].count);
+            if (keepLabels) {
+                long long numLabels = 0;
+                for (long long r = uniques[i].first; r != -1; r = links[r]) { numLabels++; }
+                writeLong(out, numLabels);
+                for (long long r = uniques[i].first; r != -1; r = links[r]) { writeString(out, string(&chars[starts[r]])); }
+            }else { writeLong(out, 1); writeString(out, string(&chars[uniques[i].label])); }
+        }
+        out.close();
+
+        //names seen more than once
+        table.clear();
+        util.openInputFileBinary(nameFile, in);
+        while (readLong(in, index)) {
+            if (m->getControl_pressed()) { break; }
+
+            Fingerprint namePrint;
+            in.read((char*)&namePrint, sizeof(Fingerprint));
+            readString(in, label);
+
+            if (table.insert(namePrint, 0) != -1) { dupNames.push_back(make_pair(index, label)); }
+        }
+        in.close();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "dereplicatePartition");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+bool Dereplicator::nextUnique(vector<string>& uniqueLabels, long long& count) {
+    try {
+        uniqueLabels.clear(); count = 0;
+
+        if (spilled) {
+            long long numLabels;
+            if (!readLong(ordered, count)) { return false; }
+            readLong(ordered, numLabels);
+            uniqueLabels.resize(numLabels);
+            for (long long i = 0; i < numLabels; i++) { readString(ordered, uniqueLabels[i]); }
+            return true;
+        }
+
+        if (nextOrder >= order.size()) { return false; }
+
+        UniqueEntry& entry = entries[order[nextOrder].first][order[nextOrder].second];
+        nextOrder++;
+
+        count = entry.count;
+        if (keepLabels) {
+            for (long long r = entry.first; r != -1; r = next[r]) { uniqueLabels.push_back(string(&labelChars[labelStarts[r]])); }
+        }else { uniqueLabels.push_back(string(&labelChars[entry.label])); }
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Dereplicator", "nextUnique");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
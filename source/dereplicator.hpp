@@ -0,0 +1,124 @@
+#ifndef dereplicator_hpp
+#define dereplicator_hpp
+//
+//  dereplicator.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "mothurout.h"
+#include "utils.hpp"
+#include "sequence.hpp"
+#include <queue>
+
+/**************************************************************************************************/
+//128 bit MurmurHash3 of a sequence or name
+struct Fingerprint {
+    unsigned long long hi, lo;
+
+    Fingerprint() : hi(0), lo(0) {}
+    Fingerprint(const string&);
+    Fingerprint next() const;   //the key to try when different bases already have this fingerprint
+    bool operator==(const Fingerprint& f) const { return ((hi == f.hi) && (lo == f.lo)); }
+};
+/**************************************************************************************************/
+//open addressing hash table from fingerprints to indexes, 24 bytes a slot
+class FingerprintTable {
+public:
+    FingerprintTable() { clear(); }
+
+    long long insert(const Fingerprint&, long long);    //returns the value already stored for the fingerprint, or -1 after storing the value
+    long long size()    { return numKeys;                                                       }
+    long long bytes()   { return (keys.capacity() * sizeof(Fingerprint)) + (values.capacity() * sizeof(long long)); }
+    void clear();
+
+private:
+    vector<Fingerprint> keys;
+    vector<long long> values;     //-1 is empty
+    long long numKeys;
+    unsigned long long mask;
+};
+/**************************************************************************************************/
+//a unique sequence, first and last are the first and last sequences in the file with it
+struct UniqueEntry {
+    long long first, last, count;
+    long long label;    //where the first sequence's label starts
+    long long offset;   //where the first sequence's bases are in the output fasta file, or in its partition file
+
+    UniqueEntry(long long f, long long l) : first(f), last(f), count(1), label(l), offset(-1) {}
+};
+/**************************************************************************************************/
+
+/* Finds the unique sequences in a fasta file for unique.seqs without keeping the sequences in memory.
+
+ Each sequence is stored as a 128 bit fingerprint of its bases, in a hash table. Each table is one shard, and each
+ processor inserts the sequences of its own shard. When a fingerprint is already in the table, the bases are compared
+ with the unique's first sequence, read back from where it was written. Different bases with the same fingerprint try
+ the next key of the fingerprint, so they never merge. Each sequence has a label, its name or its line of the name file. The labels are
+ kept in one block of characters, and the labels of a unique are a list through the sequences' indexes. When only the
+ number of sequences is needed, only the first label of each unique is kept.
+
+ If the tables and labels grow past the memory budget, the fasta file is read again and each sequence is written to a
+ partition file chosen by its fingerprint, so all copies of a sequence are in the same partition. The partitions are
+ dereplicated one at a time on each processor, and their uniques are merged back into the order they first appear in
+ the fasta file. The output is the same in both modes. */
+
+class Dereplicator {
+
+public:
+    Dereplicator(int, bool, double);    //processors, keep all labels, memory budget in bytes
+    virtual ~Dereplicator();
+
+    //writes the first copy of each unique sequence to the output fasta file, returns the number of sequences. The labels
+    //are the second column of the name file, or the sequence names if there is no name file.
+    long long dereplicate(string, string, map<string, string>*);  //fasta file, output fasta file, name file lines
+
+    long long getNumUniques() { return numUniques; }
+
+    //the labels of the next unique in the order they first appear in the fasta file, and the number of sequences it
+    //represents. Only the first label is filled in if all labels weren't kept. false after the last unique.
+    bool nextUnique(vector<string>&, long long&);
+
+    //finds the uniques of a partition file and the names seen more than once in a name partition file, run by each thread
+    void dereplicatePartition(string, string, string, vector< pair<long long, string> >&);  //sequences, names, uniques, index and name of each duplicate name
+
+    //the fingerprint of a sequence's bases, used by the threads
+    virtual Fingerprint getFingerprint(const string& bases) { return Fingerprint(bases); }
+
+protected:
+    int batchSize;  //sequences read and inserted by the threads at a time
+
+private:
+    MothurOut* m;
+    Utils util;
+    int processors;
+    bool keepLabels, spilled;
+    double budget;
+    long long numSeqs, numUniques;
+
+    //in memory
+    vector<FingerprintTable> seqTables, nameTables;  //one per processor
+    vector< vector<UniqueEntry> > entries;          //entries[shard]
+    vector< pair<int, long long> > order;           //shard and entry of the uniques, in the order they first appear
+    vector<char> labelChars;                        //labels, each followed by '\0'
+    vector<long long> labelStarts;                  //where each sequence's label starts, if all labels are kept
+    vector<long long> next;                         //next sequence with the same bases, -1 for the last one
+    long long nextOrder;
+
+    //on disk
+    string orderedFile;
+    ifstream ordered;
+
+    string getLabel(const string&, map<string, string>*, bool); //name, name file lines, report a name missing from the name file
+    long long addLabel(const string&);
+    long long getBytes();
+    void clearMemory();
+
+    bool readInMemory(string, string, map<string, string>*, int&, long long&);
+    void readPartitioned(string, string, map<string, string>*, int, long long);
+};
+
+/**************************************************************************************************/
+
+#endif
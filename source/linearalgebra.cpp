@@ -9,6 +9,7 @@
 
 #include "linearalgebra.h"
 #include "wilcox.h"
+#include <condition_variable>
 
 #define PI 3.1415926535897932384626433832795
 
@@ -235,7 +236,7 @@ double LinearAlgebra::betacf(const double a, const double b, const double x) {
 }
 /*********************************************************************************************************************************/
 //[3][4] * [4][5] - columns in first must match rows in second, returns matrix[3][5]
-vector<vector<double> > LinearAlgebra::matrix_mult(vector<vector<double> > first, vector<vector<double> > second){
+vector<vector<double> > LinearAlgebra::matrix_mult(const vector<vector<double> >& first, const vector<vector<double> >& second){
 	try {
 		vector<vector<double> > product;
 		
@@ -245,17 +246,19 @@ vector<vector<double> > LinearAlgebra::matrix_mult(vector<vector<double> > first
 		
 		product.resize(first_rows);
 		for(int i=0;i<first_rows;i++){
-			product[i].resize(second_cols);
+			product[i].resize(second_cols, 0.0);
 		}
 		
+		//walk the rows of second, so the sums are added in the same order as a dot product of row i and column j
 		for(int i=0;i<first_rows;i++){
-			for(int j=0;j<second_cols;j++){
-				
-				if (m->getControl_pressed()) { return product; }
-					
-				product[i][j] = 0.0;
-				for(int k=0;k<first_cols;k++){
-					product[i][j] += first[i][k] * second[k][j];
+			
+			if (m->getControl_pressed()) { return product; }
+			
+			for(int k=0;k<first_cols;k++){
+				double f = first[i][k];
+				const vector<double>& secondRow = second[k];
+				for(int j=0;j<second_cols;j++){
+					product[i][j] += f * secondRow[j];
 				}
 			}
 		}
@@ -270,11 +273,12 @@ vector<vector<double> > LinearAlgebra::matrix_mult(vector<vector<double> > first
 }
 /*********************************************************************************************************************************/
 
-vector<vector<double> > LinearAlgebra::transpose(vector<vector<double> >matrix){
+vector<vector<double> > LinearAlgebra::transpose(const vector<vector<double> >& matrix){
 	try {
 		vector<vector<double> > trans; trans.resize(matrix[0].size());
         for (int i = 0; i < trans.size(); i++) {
-            for (int j = 0; j < matrix.size(); j++) { trans[i].push_back(matrix[j][i]); }
+            trans[i].resize(matrix.size());
+            for (int j = 0; j < matrix.size(); j++) { trans[i][j] = matrix[j][i]; }
         }
  				
 		return trans;
@@ -286,31 +290,53 @@ vector<vector<double> > LinearAlgebra::transpose(vector<vector<double> >matrix){
 	
 }
 /*********************************************************************************************************************************/
-
-void LinearAlgebra::recenter(double offset, vector<vector<double> > D, vector<vector<double> >& G){
+//G = C * A * C, where A[i][j] = -0.5 * D[i][j]^2 + offset off the diagonal and C = I - 1/rank is the centering matrix.
+//Multiplying by C on both sides subtracts the row and column means and adds the grand mean, so it is done without the products.
+void LinearAlgebra::recenter(double offset, const vector<vector<double> >& D, vector<vector<double> >& G){
 	try {
 		int rank = D.size();
 		
-		vector<vector<double> > A(rank);
-		vector<vector<double> > C(rank);
+		vector<double> means = getGowerMeans(offset, D);
+		double grandMean = means[rank];
+		
+		G.resize(rank);
 		for(int i=0;i<rank;i++){
-			A[i].resize(rank);
-			C[i].resize(rank);
+			
+			if (m->getControl_pressed()) { return; }
+			
+			G[i].resize(rank);
+			for(int j=0;j<rank;j++){
+				double a = (i == j) ? 0.0000 : (-0.5 * D[i][j] * D[i][j] + offset);
+				G[i][j] = a - means[i] - means[j] + grandMean;
+			}
 		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "LinearAlgebra", "recenter");
+		exit(1);
+	}
+	
+}
+/*********************************************************************************************************************************/
+//same as above with G in one row-major block of rank * rank
+void LinearAlgebra::recenter(double offset, const vector<vector<double> >& D, vector<double>& G){
+	try {
+		int rank = D.size();
 		
-		double scale = -1.0000 / (double) rank;
+		vector<double> means = getGowerMeans(offset, D);
+		double grandMean = means[rank];
 		
+		G.assign(((size_t)rank)*rank, 0.0);
 		for(int i=0;i<rank;i++){
-			A[i][i] = 0.0000;
-			C[i][i] = 1.0000 + scale;
-			for(int j=i+1;j<rank;j++){
-				A[i][j] = A[j][i] = -0.5 * D[i][j] * D[i][j] + offset;
-				C[i][j] = C[j][i] = scale;
+			
+			if (m->getControl_pressed()) { return; }
+			
+			double* row = &G[((size_t)i)*rank];
+			for(int j=0;j<rank;j++){
+				double a = (i == j) ? 0.0000 : (-0.5 * D[i][j] * D[i][j] + offset);
+				row[j] = a - means[i] - means[j] + grandMean;
 			}
 		}
-		
-		A = matrix_mult(C,A);
-		G = matrix_mult(A,C);
 	}
 	catch(exception& e) {
 		m->errorOut(e, "LinearAlgebra", "recenter");
@@ -319,6 +345,30 @@ void LinearAlgebra::recenter(double offset, vector<vector<double> > D, vector<ve
 	
 }
 /*********************************************************************************************************************************/
+//returns the row means of A = -0.5 * D^2 + offset (A is symmetric, so they are also the column means), followed by the grand mean
+vector<double> LinearAlgebra::getGowerMeans(double offset, const vector<vector<double> >& D){
+	try {
+		int rank = D.size();
+		
+		vector<double> means(rank+1, 0.0);
+		for(int i=0;i<rank;i++){
+			double sum = 0.0;
+			for(int j=0;j<rank;j++){
+				if (i != j) { sum += -0.5 * D[i][j] * D[i][j] + offset; }
+			}
+			means[i] = sum / (double) rank;
+			means[rank] += means[i];
+		}
+		means[rank] /= (double) rank;
+		
+		return means;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "LinearAlgebra", "getGowerMeans");
+		exit(1);
+	}
+}
+/*********************************************************************************************************************************/
 
 //  This function is taken from Numerical Recipes in C++ by Press et al., 2nd edition, pg. 479
 
@@ -501,6 +551,442 @@ int LinearAlgebra::qtli(vector<double>& d, vector<double>& e, vector<vector<doub
 	}
 }
 /*********************************************************************************************************************************/
+//  This function is adapted from Numerical Recipes in C++ by Press et al., 2nd edition, pg. 468
+//  Cyclic Jacobi rotations of a small symmetric matrix, the eigenvalues are sorted largest first with the eigenvectors as the columns of v.
+//  Unlike qtli, which stops at a relative off diagonal of 0.001, it rotates until the off diagonal is below the precision of the diagonal,
+//  so lanczos can tell a converged Ritz pair from one that is not.
+
+int LinearAlgebra::jacobi(const vector<vector<double> >& matrix, vector<double>& d, vector<vector<double> >& v) {
+	try {
+		int n = matrix.size();
+		vector<vector<double> > a = matrix;
+		
+		v.assign(n, vector<double>(n, 0.0));
+		d.resize(n);
+		vector<double> b(n), z(n, 0.0);
+		for (int ip = 0; ip < n; ip++) {
+			v[ip][ip] = 1.0;
+			b[ip] = d[ip] = a[ip][ip];
+		}
+		
+		for (int i = 1; i <= 50; i++) {
+			double sm = 0.0;
+			for (int ip = 0; ip < n-1; ip++) {
+				for (int iq = ip+1; iq < n; iq++) { sm += fabs(a[ip][iq]); }
+			}
+			if (sm == 0.0) { break; }
+			
+			double tresh = (i < 4) ? (0.2 * sm / (n*n)) : 0.0;
+			for (int ip = 0; ip < n-1; ip++) {
+				for (int iq = ip+1; iq < n; iq++) {
+					double g = 100.0 * fabs(a[ip][iq]);
+					if ((i > 4) && ((fabs(d[ip]) + g) == fabs(d[ip])) && ((fabs(d[iq]) + g) == fabs(d[iq]))) {
+						a[ip][iq] = 0.0;
+					}else if (fabs(a[ip][iq]) > tresh) {
+						double h = d[iq] - d[ip];
+						double t;
+						if ((fabs(h) + g) == fabs(h)) { t = a[ip][iq] / h; }
+						else {
+							double theta = 0.5 * h / a[ip][iq];
+							t = 1.0 / (fabs(theta) + sqrt(1.0 + theta*theta));
+							if (theta < 0.0) { t = -t; }
+						}
+						double c = 1.0 / sqrt(1 + t*t);
+						double s = t * c;
+						double tau = s / (1.0 + c);
+						h = t * a[ip][iq];
+						z[ip] -= h; z[iq] += h;
+						d[ip] -= h; d[iq] += h;
+						a[ip][iq] = 0.0;
+						for (int j = 0; j < ip; j++)        { rotate(a, s, tau, j, ip, j, iq);  }
+						for (int j = ip+1; j < iq; j++)     { rotate(a, s, tau, ip, j, j, iq);  }
+						for (int j = iq+1; j < n; j++)      { rotate(a, s, tau, ip, j, iq, j);  }
+						for (int j = 0; j < n; j++)         { rotate(v, s, tau, j, ip, j, iq);  }
+					}
+				}
+			}
+			for (int ip = 0; ip < n; ip++) {
+				b[ip] += z[ip];
+				d[ip] = b[ip];
+				z[ip] = 0.0;
+			}
+		}
+		
+		//sort largest first
+		for (int i = 0; i < n-1; i++) {
+			int k = i; double p = d[i];
+			for (int j = i+1; j < n; j++) { if (d[j] > p) { p = d[k=j]; } }
+			if (k != i) {
+				d[k] = d[i]; d[i] = p;
+				for (int j = 0; j < n; j++) { swap(v[j][i], v[j][k]); }
+			}
+		}
+		
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "LinearAlgebra", "jacobi");
+		exit(1);
+	}
+}
+/*********************************************************************************************************************************/
+void LinearAlgebra::rotate(vector<vector<double> >& a, double s, double tau, int i, int j, int k, int l) {
+	double g = a[i][j];
+	double h = a[k][l];
+	a[i][j] = g - s * (h + g * tau);
+	a[k][l] = h + s * (g - h * tau);
+}
+/*********************************************************************************************************************************/
+//lanczos splits the rows into blocks of this many and adds up sums over the rows a block at a time in order,
+//so the results do not depend on the number of processors
+#define LANCZOS_BLOCK_SIZE 64
+
+enum { lanczosMultiply, lanczosDots, lanczosSubtract, lanczosCombine };
+
+struct lanczosData;
+
+/* The worker threads of lanczos. They are started once per solve and wait for each task, like the OptiCluster workers.
+ Each thread owns a range of row blocks and does its part of every matrix-vector product, Gram-Schmidt pass and restart,
+ so only the small projected matrix is handled by one thread. */
+class LanczosWorkers {
+    
+public:
+    LanczosWorkers(const vector<double>&, int, int); //matrix, size, processors
+    ~LanczosWorkers();
+    
+    void multiply(const vector<double>&, vector<double>&); //y = A * x
+    void dots(const vector<vector<double> >&, int, const vector<double>&, vector<double>&); //h[i] = V[i] . x for the first numVectors of V
+    void subtract(const vector<vector<double> >&, int, const vector<double>&, vector<double>&); //x -= the sum of h[i] * V[i]
+    void combine(const vector<vector<double> >&, int, const vector<vector<double> >&, const vector<int>&, vector<vector<double> >&); //out[c] = the sum of S[l][columns[c]] * V[l]
+    void worker(int);
+    
+private:
+    MothurOut* m;
+    const double* matrix;
+    int size, numBlocks, numThreads;
+    vector<int> firstBlock; //thread i owns blocks firstBlock[i] to firstBlock[i+1]-1
+    vector<std::thread*> workerThreads;
+    vector<lanczosData*> data;
+    
+    std::mutex taskMutex; //guards the task handed to the worker threads
+    std::condition_variable taskReady, taskDone;
+    int taskType, taskGeneration, numThreadsDone;
+    bool finished;
+    
+    //arguments of the current task
+    const vector<vector<double> >* basis;
+    const vector<vector<double> >* coefficients;
+    const vector<int>* columns;
+    const vector<double>* x;
+    const vector<double>* h;
+    vector<double>* y;
+    vector<vector<double> >* out;
+    int numVectors;
+    vector<double> blockSums; //blockSums[block*numVectors+i] = the part of h[i] from the rows in block
+    
+    void run(int);
+    void doTask(int);
+    
+    LanczosWorkers(const LanczosWorkers&);
+    LanczosWorkers& operator=(const LanczosWorkers&);
+};
+/*********************************************************************************************************************************/
+struct lanczosData {
+    LanczosWorkers* workers;
+    int thread;
+    
+    lanczosData(LanczosWorkers* w, int t) : workers(w), thread(t) {}
+};
+/*********************************************************************************************************************************/
+void lanczosWorker(lanczosData* params) {
+    params->workers->worker(params->thread);
+}
+/*********************************************************************************************************************************/
+LanczosWorkers::LanczosWorkers(const vector<double>& A, int n, int processors) : matrix(&A[0]), size(n), taskType(0), taskGeneration(0), numThreadsDone(0), finished(false) {
+    try {
+        m = MothurOut::getInstance();
+        
+        numBlocks = (size + LANCZOS_BLOCK_SIZE - 1) / LANCZOS_BLOCK_SIZE;
+        numThreads = processors;
+        if (numThreads > numBlocks) { numThreads = numBlocks; }
+        if (numThreads < 1) { numThreads = 1; }
+        
+        //divide the blocks between the threads
+        int numBlocksPerThread = numBlocks / numThreads;
+        int remainder = numBlocks % numThreads;
+        firstBlock.push_back(0);
+        for (int i = 0; i < numThreads; i++) { firstBlock.push_back(firstBlock.back() + numBlocksPerThread + ((i < remainder) ? 1 : 0)); }
+        
+        //Lauch worker threads
+        for (int i = 1; i < numThreads; i++) {
+            lanczosData* dataBundle = new lanczosData(this, i);
+            data.push_back(dataBundle);
+            workerThreads.push_back(new std::thread(lanczosWorker, dataBundle));
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "LanczosWorkers", "LanczosWorkers");
+        exit(1);
+    }
+}
+/*********************************************************************************************************************************/
+LanczosWorkers::~LanczosWorkers() {
+    {   //release the workers
+        std::lock_guard<std::mutex> lock(taskMutex);
+        finished = true;
+    }
+    taskReady.notify_all();
+    
+    for (int i = 0; i < workerThreads.size(); i++) {
+        workerThreads[i]->join();
+        delete data[i];
+        delete workerThreads[i];
+    }
+}
+/*********************************************************************************************************************************/
+//run by worker thread, does its part of each task until the solve is finished
+void LanczosWorkers::worker(int thread) {
+    try {
+        int lastGeneration = 0;
+        
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(taskMutex);
+                while ((taskGeneration == lastGeneration) && !finished) { taskReady.wait(lock); }
+                if (finished) { return; }
+                
+                lastGeneration = taskGeneration;
+            }
+            
+            doTask(thread);
+            
+            {
+                std::lock_guard<std::mutex> lock(taskMutex);
+                numThreadsDone++;
+            }
+            taskDone.notify_one();
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "LanczosWorkers", "worker");
+        exit(1);
+    }
+}
+/*********************************************************************************************************************************/
+//hands the task to the workers, does the first thread's part and waits for the rest
+void LanczosWorkers::run(int type) {
+    try {
+        if (numThreads == 1) { taskType = type; doTask(0); return; }
+        
+        {
+            std::lock_guard<std::mutex> lock(taskMutex);
+            taskType = type; numThreadsDone = 0; taskGeneration++;
+        }
+        taskReady.notify_all();
+        
+        doTask(0);
+        
+        {
+            std::unique_lock<std::mutex> lock(taskMutex);
+            while (numThreadsDone < (numThreads-1)) { taskDone.wait(lock); }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "LanczosWorkers", "run");
+        exit(1);
+    }
+}
+/*********************************************************************************************************************************/
+//does the current task for the rows of the blocks thread owns
+void LanczosWorkers::doTask(int thread) {
+    try {
+        int rowStart = firstBlock[thread] * LANCZOS_BLOCK_SIZE;
+        int rowEnd = min(size, firstBlock[thread+1] * LANCZOS_BLOCK_SIZE);
+        
+        if (taskType == lanczosMultiply) {
+            const double* xx = &(*x)[0];
+            for (int r = rowStart; r < rowEnd; r++) {
+                const double* row = matrix + (((size_t)r) * size);
+                double sum = 0.0;
+                for (int c = 0; c < size; c++) { sum += row[c] * xx[c]; }
+                (*y)[r] = sum;
+            }
+        }else if (taskType == lanczosDots) {
+            for (int b = firstBlock[thread]; b < firstBlock[thread+1]; b++) {
+                int blockEnd = min(size, (b+1) * LANCZOS_BLOCK_SIZE);
+                for (int i = 0; i < numVectors; i++) {
+                    const vector<double>& v = (*basis)[i];
+                    double sum = 0.0;
+                    for (int r = b * LANCZOS_BLOCK_SIZE; r < blockEnd; r++) { sum += v[r] * (*x)[r]; }
+                    blockSums[((size_t)b)*numVectors+i] = sum;
+                }
+            }
+        }else if (taskType == lanczosSubtract) {
+            for (int i = 0; i < numVectors; i++) {
+                const vector<double>& v = (*basis)[i]; double hi = (*h)[i];
+                for (int r = rowStart; r < rowEnd; r++) { (*y)[r] -= hi * v[r]; }
+            }
+        }else if (taskType == lanczosCombine) {
+            for (int c = 0; c < columns->size(); c++) {
+                vector<double>& o = (*out)[c];
+                for (int r = rowStart; r < rowEnd; r++) { o[r] = 0.0; }
+                for (int l = 0; l < numVectors; l++) {
+                    const vector<double>& v = (*basis)[l]; double s = (*coefficients)[l][(*columns)[c]];
+                    for (int r = rowStart; r < rowEnd; r++) { o[r] += s * v[r]; }
+                }
+            }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "LanczosWorkers", "doTask");
+        exit(1);
+    }
+}
+/*********************************************************************************************************************************/
+void LanczosWorkers::multiply(const vector<double>& xx, vector<double>& yy) {
+    x = &xx; y = &yy;
+    run(lanczosMultiply);
+}
+/*********************************************************************************************************************************/
+void LanczosWorkers::dots(const vector<vector<double> >& V, int num, const vector<double>& xx, vector<double>& hh) {
+    basis = &V; numVectors = num; x = &xx;
+    blockSums.resize(((size_t)numBlocks)*numVectors);
+    run(lanczosDots);
+    
+    for (int i = 0; i < numVectors; i++) {
+        hh[i] = 0.0;
+        for (int b = 0; b < numBlocks; b++) { hh[i] += blockSums[((size_t)b)*numVectors+i]; }
+    }
+}
+/*********************************************************************************************************************************/
+void LanczosWorkers::subtract(const vector<vector<double> >& V, int num, const vector<double>& hh, vector<double>& xx) {
+    basis = &V; numVectors = num; h = &hh; y = &xx;
+    run(lanczosSubtract);
+}
+/*********************************************************************************************************************************/
+void LanczosWorkers::combine(const vector<vector<double> >& V, int num, const vector<vector<double> >& S, const vector<int>& cols, vector<vector<double> >& o) {
+    basis = &V; numVectors = num; coefficients = &S; columns = &cols; out = &o;
+    run(lanczosCombine);
+}
+/*********************************************************************************************************************************/
+/* Thick restart Lanczos (Wu & Simon, 2000), which finds the same Ritz vectors as implicitly restarted Lanczos.
+ A is a symmetric n x n matrix in one row-major block. Only the products A * x touch A, so finding k eigenpairs costs a few hundred
+ matrix-vector products instead of the O(n^3) of tred2 and qtli. The basis is fully reorthogonalized, it is small next to A.
+ The processors share every step over the rows, see LanczosWorkers.
+ Returns the k largest (or smallest) eigenvalues in order from the end of the spectrum, with the eigenvectors as the columns of vectors[n][k]. */
+int LinearAlgebra::lanczos(const vector<double>& A, int n, int k, bool largest, int processors, vector<double>& values, vector<vector<double> >& vectors){
+	try {
+        if (k > n) { k = n; }
+        int numBasis = min(n, max(2*k + 20, 30)); //size of the basis before a restart
+        int maxRestarts = 500;
+        
+        vector< vector<double> > V(numBasis+1, vector<double>(n, 0.0)); //basis vectors
+        vector< vector<double> > T(numBasis, vector<double>(numBasis, 0.0)); //projection of A on the basis, V' * A * V
+        vector<double> w(n, 0.0);
+        vector<double> h(numBasis, 0.0);
+        vector< vector<double> > S; vector<double> d; //eigenvectors and values of T
+        vector<int> wanted(numBasis, 0);
+        vector<double> dot(numBasis+1, 0.0);
+        
+        LanczosWorkers workers(A, n, processors);
+        
+        //random start vector
+        double norm = 0.0;
+        for (int r = 0; r < n; r++) { V[0][r] = util.getRandomDouble0to1() - 0.5; norm += V[0][r] * V[0][r]; }
+        norm = sqrt(norm);
+        for (int r = 0; r < n; r++) { V[0][r] /= norm; }
+        
+        int start = 0; double beta = 0.0;
+        bool converged = false;
+        for (int restart = 0; restart < maxRestarts; restart++) {
+            
+            //extend the basis to numBasis vectors
+            for (int j = start; j < numBasis; j++) {
+                if (m->getControl_pressed()) { return 0; }
+                
+                workers.multiply(V[j], w);
+                
+                //orthogonalize against the basis twice, the dot products are column j of T.
+                //classical Gram-Schmidt done twice is as accurate as modified Gram-Schmidt and takes the dot products with the whole basis at once
+                for (int i = 0; i <= j; i++) { h[i] = 0.0; }
+                for (int pass = 0; pass < 2; pass++) {
+                    workers.dots(V, j+1, w, dot);
+                    workers.subtract(V, j+1, dot, w);
+                    for (int i = 0; i <= j; i++) { h[i] += dot[i]; }
+                }
+                for (int i = 0; i <= j; i++) { T[i][j] = T[j][i] = h[i]; }
+                
+                beta = 0.0;
+                for (int r = 0; r < n; r++) { beta += w[r] * w[r]; }
+                beta = sqrt(beta);
+                
+                double scale = 0.0;
+                for (int i = 0; i <= j; i++) { scale = max(scale, fabs(T[i][i])); }
+                if (beta > 1e-14 * scale) {
+                    for (int r = 0; r < n; r++) { V[j+1][r] = w[r] / beta; }
+                }else {
+                    //the basis spans an invariant subspace, continue with a random vector orthogonal to it
+                    beta = 0.0;
+                    if (j+1 == numBasis) { fill(V[j+1].begin(), V[j+1].end(), 0.0); continue; }
+                    for (int r = 0; r < n; r++) { V[j+1][r] = util.getRandomDouble0to1() - 0.5; }
+                    for (int pass = 0; pass < 2; pass++) {
+                        workers.dots(V, j+1, V[j+1], dot);
+                        workers.subtract(V, j+1, dot, V[j+1]);
+                    }
+                    norm = 0.0;
+                    for (int r = 0; r < n; r++) { norm += V[j+1][r] * V[j+1][r]; }
+                    norm = sqrt(norm);
+                    for (int r = 0; r < n; r++) { V[j+1][r] /= norm; }
+                }
+            }
+            
+            //Ritz values and vectors of the basis, largest first
+            jacobi(T, d, S);    if (m->getControl_pressed()) { return 0; }
+            
+            for (int i = 0; i < numBasis; i++) { wanted[i] = largest ? i : (numBasis-1-i); }
+            
+            //the residual of Ritz pair i is beta * the last entry of its eigenvector
+            double tolerance = 1e-8 * max(fabs(d[0]), fabs(d[numBasis-1]));
+            converged = true;
+            for (int i = 0; i < k; i++) {
+                if (fabs(beta * S[numBasis-1][wanted[i]]) > tolerance) { converged = false; break; }
+            }
+            if (converged || (restart == maxRestarts-1)) { break; }
+            
+            //restart with the best Ritz vectors and the residual
+            int numKept = min(k + (numBasis - k) / 2, numBasis - 1);
+            vector<int> keptColumns(wanted.begin(), wanted.begin()+numKept);
+            vector< vector<double> > kept(numKept, vector<double>(n, 0.0));
+            workers.combine(V, numBasis, S, keptColumns, kept);
+            V[numKept] = V[numBasis];
+            for (int i = 0; i < numKept; i++) { V[i].swap(kept[i]); }
+            
+            for (int i = 0; i < numBasis; i++) { fill(T[i].begin(), T[i].end(), 0.0); }
+            for (int i = 0; i < numKept; i++) { T[i][i] = d[wanted[i]]; }
+            start = numKept;
+        }
+        
+        if (!converged) { m->mothurOut("[WARNING]: the eigenvalues did not converge after " + toString(maxRestarts) + " restarts, the results are approximate.\n"); }
+        
+        vector<int> wantedColumns(wanted.begin(), wanted.begin()+k);
+        vector< vector<double> > ritz(k, vector<double>(n, 0.0));
+        workers.combine(V, numBasis, S, wantedColumns, ritz);
+        
+        values.resize(k);
+        vectors.assign(n, vector<double>(k, 0.0));
+        for (int i = 0; i < k; i++) {
+            values[i] = d[wanted[i]];
+            for (int r = 0; r < n; r++) { vectors[r][i] = ritz[i][r]; }
+        }
+        
+        return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "LinearAlgebra", "lanczos");
+		exit(1);
+	}
+}
+/*********************************************************************************************************************************/
 //groups by dimension
 vector< vector<double> > LinearAlgebra::calculateEuclidianDistance(vector< vector<double> >& axes, int dimensions){
 	try {
@@ -20,12 +20,15 @@ public:
 	LinearAlgebra() { m = MothurOut::getInstance(); }
 	~LinearAlgebra() = default;
 	
-	vector<vector<double> > matrix_mult(vector<vector<double> >, vector<vector<double> >);
-    vector<vector<double> >transpose(vector<vector<double> >);
-	void recenter(double, vector<vector<double> >, vector<vector<double> >&);
+	vector<vector<double> > matrix_mult(const vector<vector<double> >&, const vector<vector<double> >&);
+    vector<vector<double> >transpose(const vector<vector<double> >&);
+	void recenter(double, const vector<vector<double> >&, vector<vector<double> >&);
+	void recenter(double, const vector<vector<double> >&, vector<double>&); //G in one row-major block
 	//eigenvectors
     int tred2(vector<vector<double> >&, vector<double>&, vector<double>&);
 	int qtli(vector<double>&, vector<double>&, vector<vector<double> >&);
+    //the k largest (or smallest) eigenvalues and eigenvectors of a symmetric matrix in one row-major block, see lanczos in linearalgebra.cpp
+    int lanczos(const vector<double>&, int, int, bool, int, vector<double>&, vector<vector<double> >&); //matrix, size, k, largest, processors, values, vectors[size][k]
     
 	vector< vector<double> > calculateEuclidianDistance(vector<vector<double> >&, int); //pass in axes and number of dimensions
 	vector< vector<double> > calculateEuclidianDistance(vector<vector<double> >&); //pass in axes
@@ -56,6 +59,9 @@ private:
     Utils util;
 	
 	double pythag(double, double);
+    vector<double> getGowerMeans(double, const vector<vector<double> >&);
+    int jacobi(const vector<vector<double> >&, vector<double>&, vector<vector<double> >&);
+    void rotate(vector<vector<double> >&, double, double, int, int, int, int);
     double betacf(const double, const double, const double);
     double betai(const double, const double, const double);
     double gammln(const double);
@@ -195,6 +195,15 @@ static inline void gobble(In& f) {
     if(!f.eof()) { f.putback(d); }
 }
 
+//read a line, remove the line ending and skip the white space after it
+template <typename In>
+static inline string getlineTrimmed(In& f) {
+    string line = "";
+    getline(f, line); gobble(f);
+    rtrim(line);
+    return line;
+}
+
 /**************************************************************************************************/
 
 template <typename Out>
@@ -0,0 +1,225 @@
+//
+//  oligoindex.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "oligoindex.hpp"
+#include "needlemanoverlap.hpp"
+
+static const string maskBases = "ATGCN";
+
+/**************************************************************************************************/
+//false if TrimOligos::countDiffs counts oligo base o across from read base s as a difference
+inline bool sameBase(char o, char s) {
+    if (o == s) { return true; }
+    if (o == 'A' || o == 'T' || o == 'G' || o == 'C' || o == '-' || o == '.')	{	return false;   }
+    else if((o == 'N' || o == 'I') && (s == 'N'))	{	return false;	}
+    else if(o == 'R' && (s != 'A' && s != 'G'))	{	return false;	}
+    else if(o == 'Y' && (s != 'C' && s != 'T'))	{	return false;	}
+    else if(o == 'M' && (s != 'C' && s != 'A'))	{	return false;	}
+    else if(o == 'K' && (s != 'T' && s != 'G'))	{	return false;	}
+    else if(o == 'W' && (s != 'T' && s != 'A'))	{	return false;	}
+    else if(o == 'S' && (s != 'C' && s != 'G'))	{	return false;	}
+    else if(o == 'B' && (s != 'C' && s != 'T' && s != 'G'))	{	return false;	}
+    else if(o == 'D' && (s != 'A' && s != 'T' && s != 'G'))	{	return false;	}
+    else if(o == 'H' && (s != 'A' && s != 'T' && s != 'C'))	{	return false;	}
+    else if(o == 'V' && (s != 'A' && s != 'C' && s != 'G'))	{	return false;	}
+    return true;
+}
+/**************************************************************************************************/
+//positions of the oligo that match s and not a gap
+unsigned long long baseMask(const string& oligo, char s) {
+    unsigned long long mask = 0;
+    for (int i = 0; i < oligo.length(); i++) {
+        if (sameBase(oligo[i], s) && !sameBase(oligo[i], '-')) { mask |= (1ULL << i); }
+    }
+    return mask;
+}
+/**************************************************************************************************/
+void OligoIndex::build(vector<string> o, int d, bool nm) {
+    try {
+        oligos = o; diffs = d; noneMatches = nm;
+        maxLength = 0; hasNone = false;
+
+        set<int> lengths;
+        masks.resize(oligos.size());
+        numWildcards.resize(oligos.size(), 0);
+        for (int i = 0; i < oligos.size(); i++) {
+            string oligo = oligos[i];
+            if (oligo.length() > maxLength) { maxLength = oligo.length(); }
+            if (oligo == "NONE") { hasNone = true; }
+
+            bool acgt = (oligo.length() != 0);
+            for (int j = 0; j < oligo.length(); j++) {
+                if ((oligo[j] != 'A') && (oligo[j] != 'T') && (oligo[j] != 'G') && (oligo[j] != 'C')) { acgt = false; }
+                if (sameBase(oligo[j], '-')) { numWildcards[i]++; }
+            }
+            if (acgt)   { exact[oligo].push_back(i); lengths.insert(oligo.length()); }
+            else        { inexact.push_back(i); }
+
+            if (oligo.length() <= 64) {
+                for (int j = 0; j < maskBases.length(); j++) { masks[i].push_back(baseMask(oligo, maskBases[j])); }
+            }
+        }
+        exactLengths.assign(lengths.begin(), lengths.end());
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OligoIndex", "build");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+vector<int> OligoIndex::getCandidates(const string& seq, bool all) {
+    try {
+        vector<int> candidates;
+        if (all) {
+            for (int i = 0; i < oligos.size(); i++) { candidates.push_back(i); }
+            return candidates;
+        }
+
+        candidates = inexact;
+        for (int i = 0; i < exactLengths.size(); i++) {
+            if (exactLengths[i] > seq.length()) { break; }
+
+            unordered_map<string, vector<int> >::iterator it = exact.find(seq.substr(0, exactLengths[i]));
+            if (it != exact.end()) { candidates.insert(candidates.end(), it->second.begin(), it->second.end()); }
+        }
+        sort(candidates.begin(), candidates.end());
+
+        return candidates;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OligoIndex", "getCandidates");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//fewest differences the alignment of oligo i to the start of seq can have
+int OligoIndex::lowerBound(int i, const string& seq) {
+    try {
+        if (masks[i].size() == 0) { return 0; }
+        if (noneMatches && (oligos[i] == "NONE")) { return 0; }
+
+        int length = oligos[i].length();
+        int fragLength = oligos[i].length() + diffs;
+        if (fragLength > seq.length()) { fragLength = seq.length(); }
+
+        //V has a 0 for each oligo position in the longest common subsequence so far
+        unsigned long long V = ~0ULL;
+        for (int j = 0; j < fragLength; j++) {
+            unsigned long long M;
+            switch (seq[j]) {
+                case 'A': M = masks[i][0]; break;
+                case 'T': M = masks[i][1]; break;
+                case 'G': M = masks[i][2]; break;
+                case 'C': M = masks[i][3]; break;
+                case 'N': M = masks[i][4]; break;
+                default: M = baseMask(oligos[i], seq[j]); break;
+            }
+            unsigned long long U = V & M;
+            V = (V + U) | (V - U);
+        }
+
+        unsigned long long positions = (length == 64) ? ~0ULL : ((1ULL << length) - 1);
+        int common = __builtin_popcountll(~V & positions);
+
+        return length - numWildcards[i] - common;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OligoIndex", "lowerBound");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//same as the alignments in TrimOligos, pos is the number of read bases the oligo covers
+int OligoIndex::alignOligo(int i, const string& seq, int& pos) {
+    try {
+        if (alignment == nullptr) { alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxLength+diffs+1)); }
+
+        //use needleman to align first oligo.length()+numdiffs of sequence to the oligo
+        alignment->alignPrimer(oligos[i], seq.substr(0,oligos[i].length()+diffs));
+        string oligo = alignment->getSeqAAln();
+        string temp = alignment->getSeqBAln();
+
+        int alnLength = oligo.length();
+        for(int j=oligo.length()-1;j>=0;j--){ if(oligo[j] != '-'){	alnLength = j+1;	break;	} }
+
+        int numDiff = 0;
+        pos = 0;
+        for (int j = 0; j < alnLength; j++) {
+            if (!sameBase(oligo[j], temp[j]))   { numDiff++;    }
+            if (temp[j] != '-')                 { pos++;        }
+        }
+        if (alnLength == 0) { numDiff = diffs + 1000; }
+
+        if (m->getDebug()) { m->mothurOut("[DEBUG]: aligned fragment=" + temp.substr(0,alnLength) + ", oligo=" + oligo.substr(0,alnLength) + ", numDiffs=" + toString(numDiff) + ".\n");  }
+
+        return numDiff;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OligoIndex", "alignOligo");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+int OligoIndex::align(const string& seq, bool lengthFirst, bool& tooShort, vector<int>& minOligos, vector<int>& minPos) {
+    try {
+        int minDiff = MOTHURMAX;
+        minOligos.clear(); minPos.clear();
+        tooShort = false;
+
+        if (oligos.size() == 0) { return minDiff; }
+
+        if (noneMatches && hasNone) { //"NONE" adds a match without clearing the ones before it, so go in order
+            for (int i = 0; i < oligos.size(); i++) {
+                if (lengthFirst && (seq.length() < maxLength)) { tooShort = true; break; }
+
+                if (oligos[i] == "NONE") { minOligos.push_back(i); minPos.push_back(0); minDiff = 0; continue; }
+
+                if (seq.length() < maxLength) { tooShort = true; break; }
+
+                if (lowerBound(i, seq) > minDiff) { continue; }
+
+                int pos;
+                int numDiff = alignOligo(i, seq, pos);
+                if (numDiff < minDiff) {
+                    minDiff = numDiff;
+                    minOligos.clear(); minPos.clear();
+                    minOligos.push_back(i); minPos.push_back(pos);
+                }else if (numDiff == minDiff) { minOligos.push_back(i); minPos.push_back(pos); }
+            }
+            return minDiff;
+        }
+
+        if (seq.length() < maxLength) { tooShort = true; return minDiff; }
+
+        vector< pair<int, int> > order; //bound, oligo
+        for (int i = 0; i < oligos.size(); i++) { order.push_back(make_pair(lowerBound(i, seq), i)); }
+        sort(order.begin(), order.end());
+
+        vector< pair<int, int> > best; //oligo, pos
+        for (int i = 0; i < order.size(); i++) {
+            if (order[i].first > minDiff) { break; }
+
+            int pos;
+            int numDiff = alignOligo(order[i].second, seq, pos);
+            if (numDiff < minDiff) {
+                minDiff = numDiff;
+                best.clear();
+                best.push_back(make_pair(order[i].second, pos));
+            }else if (numDiff == minDiff) { best.push_back(make_pair(order[i].second, pos)); }
+        }
+        sort(best.begin(), best.end());
+
+        for (int i = 0; i < best.size(); i++) { minOligos.push_back(best[i].first); minPos.push_back(best[i].second); }
+
+        return minDiff;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OligoIndex", "align");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
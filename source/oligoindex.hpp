@@ -0,0 +1,65 @@
+#ifndef oligoindex_hpp
+#define oligoindex_hpp
+//
+//  oligoindex.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "mothurout.h"
+#include "alignment.hpp"
+
+/**************************************************************************************************/
+
+/* Finds barcodes and primers at the start of a read for TrimOligos without comparing the read to every oligo.
+
+ Oligos made of A, T, G and C only match a read that starts with them, so they are looked up in a hash of the read's
+ prefixes. Oligos with ambiguous bases, and "NONE", are still compared base by base.
+
+ When no oligo matches, TrimOligos aligns the start of the read to each oligo and keeps the ones with the fewest
+ differences. Every base of the oligo that isn't a difference is paired with a base of the read, in order, so the
+ differences are at least the oligo length minus the longest common subsequence of the oligo and the read, counted
+ with TrimOligos::countDiffs's rules. N and I are left out, because they also match the gaps of the alignment. The
+ subsequence is found with a bit parallel algorithm for oligos up to 64 bases. The oligos are aligned in order of that
+ bound until the bound is more than the fewest differences found, so the result is the same as aligning all of them. */
+
+class OligoIndex {
+
+public:
+    OligoIndex() : alignment(nullptr), diffs(0), maxLength(0), noneMatches(false), hasNone(false) { m = MothurOut::getInstance(); }
+    ~OligoIndex() { if (alignment != nullptr) { delete alignment; } }
+    OligoIndex(const OligoIndex&) = delete;
+    OligoIndex& operator=(const OligoIndex&) = delete;
+
+    void build(vector<string>, int, bool);  //oligos in the order TrimOligos searches them, diffs, true if "NONE" matches any read
+
+    //oligos that can match the start of the read, in order. all returns every oligo.
+    vector<int> getCandidates(const string&, bool);
+
+    //same as aligning the start of the read to each oligo in order, returns the fewest differences. Fills the oligos
+    //with that many differences, in order, and the number of read bases each one covers. The length check comes before
+    //the "NONE" check if the bool is true. tooShort is set if the read is shorter than the longest oligo.
+    int align(const string&, bool, bool&, vector<int>&, vector<int>&);
+
+private:
+    MothurOut* m;
+    Alignment* alignment;
+    int diffs, maxLength;
+    bool noneMatches, hasNone;
+
+    vector<string> oligos;
+    unordered_map<string, vector<int> > exact;  //oligos made of A, T, G and C
+    vector<int> exactLengths;
+    vector<int> inexact;                //oligos with other bases
+
+    vector< vector<unsigned long long> > masks;  //masks[oligo][base] - positions that match base, base is A, T, G, C or N
+    vector<int> numWildcards;           //positions that also match a gap
+
+    int lowerBound(int, const string&);
+    int alignOligo(int, const string&, int&);
+};
+
+/**************************************************************************************************/
+
+#endif
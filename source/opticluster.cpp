@@ -8,8 +8,9 @@
 
 #include "opticluster.h"
 
-OptiCluster::OptiCluster(OptiData* mt, ClusterMetric* met, long long ns) : Cluster() {
-    matrix = mt; metric = met; truePositives = 0; trueNegatives = 0; falseNegatives = 0; falsePositives = 0; numSingletons = ns;
+OptiCluster::OptiCluster(OptiData* mt, ClusterMetric* met, long long ns, int p) : Cluster() {
+    matrix = mt; metric = met; truePositives = 0; trueNegatives = 0; falseNegatives = 0; falsePositives = 0; numSingletons = ns; processors = p; optiBatchSize = 1024;
+    if (processors < 1) { processors = 1; }
 }
 /***********************************************************************/
 //randomly assign sequences to OTUs
@@ -21,55 +22,47 @@ int OptiCluster::initialize(double& value, bool randomize, string initialize) {
         falseNegatives = 0;
         trueNegatives = 0;
         
-        bins.resize(numSeqs); //place seqs in own bin
-        
-        vector<long long> temp;
-        bins.push_back(temp);
-        seqBin[numSeqs] = -1;
+        bins.resize(numSeqs+1); //place seqs in own bin, plus an empty bin
+        binSize.resize(numSeqs+1, 0);
+        seqBin.resize(numSeqs, -1);
+        seqPosition.resize(numSeqs, 0);
+        closeInBin.resize(numSeqs+1, -1);
+        if (processors > 1) {
+            threadCloseInBin.resize(processors-1, closeInBin);
+            threadBinsToTry.resize(processors-1);
+            touchedInBatch.resize(numSeqs+1, -1);
+            proposedBins.resize(optiBatchSize, 0);
+            proposedCounts.resize(optiBatchSize*4, 0);
+        }
         insertLocation = numSeqs;
         Utils util;
         
         if (initialize == "singleton") {
             
             //put everyone in own bin
-            for (int i = 0; i < numSeqs; i++) { bins[i].push_back(i); }
-            
-            //maps randomized sequences to bins
-            for (int i = 0; i < numSeqs; i++) {
-                seqBin[i] = bins[i][0];
-                randomizeSeqs.push_back(i);
-            }
+            for (int i = 0; i < numSeqs; i++) { addToBin(i, i); randomizeSeqs.push_back(i); }
             
             if (randomize) { util.mothurRandomShuffle(randomizeSeqs); }
             
             //for each sequence (singletons removed on read)
-            for (map<long long, long long>::iterator it = seqBin.begin(); it != seqBin.end(); it++) {
-                if (it->second == -1) { }
-                else {
-                    long long numCloseSeqs = (matrix->getNumClose(it->first)); //does not include self
-                    falseNegatives += numCloseSeqs;
-                }
+            for (long long i = 0; i < numSeqs; i++) {
+                long long numCloseSeqs = (matrix->getNumClose(i)); //does not include self
+                falseNegatives += numCloseSeqs;
             }
             falseNegatives /= 2; //square matrix
             trueNegatives = numSeqs * (numSeqs-1)/2 - (falsePositives + falseNegatives + truePositives); //since everyone is a singleton no one clusters together. True negative = num far apart
         }else {
             
             //put everyone in first bin
-            for (int i = 0; i < numSeqs; i++) {
-                bins[0].push_back(i);
-                seqBin[i] = 0;
-                randomizeSeqs.push_back(i);
-            }
+            for (int i = 0; i < numSeqs; i++) { addToBin(i, 0); randomizeSeqs.push_back(i); }
+            for (long long i = 1; i < numSeqs; i++) { emptyBins.insert(i); }
             
             if (randomize) { util.mothurRandomShuffle(randomizeSeqs); }
             
             //for each sequence (singletons removed on read)
-            for (map<long long, long long>::iterator it = seqBin.begin(); it != seqBin.end(); it++) {
-                if (it->second == -1) { }
-                else {
-                    long long numCloseSeqs = (matrix->getNumClose(it->first)); //does not include self
-                    truePositives += numCloseSeqs;
-                }
+            for (long long i = 0; i < numSeqs; i++) {
+                long long numCloseSeqs = (matrix->getNumClose(i)); //does not include self
+                truePositives += numCloseSeqs;
             }
             truePositives /= 2; //square matrix
             falsePositives = numSeqs * (numSeqs-1)/2 - (trueNegatives + falseNegatives + truePositives);
@@ -91,85 +84,284 @@ int OptiCluster::initialize(double& value, bool randomize, string initialize) {
 bool OptiCluster::update(double& listMetric) {
     try {
         
-        //for each sequence (singletons removed on read)
-        for (int i = 0; i < randomizeSeqs.size(); i++) {
+        if (processors > 1) { updateInBatches(); }
+        else {
+            //for each sequence (singletons removed on read)
+            for (int i = 0; i < randomizeSeqs.size(); i++) {
+                
+                if (m->getControl_pressed()) { break; }
+                
+                long long seqNumber = randomizeSeqs[i];
+                
+                double bestTp, bestTn, bestFp, bestFn;
+                long long bestBin = findBestBin(seqNumber, closeInBin, binsToTry, bestTp, bestTn, bestFp, bestFn);
+                
+                moveSeq(seqNumber, bestBin, bestTp, bestTn, bestFp, bestFn);
+            }
+        }
+        
+        listMetric = metric->getValue(truePositives, trueNegatives, falsePositives, falseNegatives);
+        
+        if (m->getDebug()) { ListVector* list = getList(); list->print(cout); delete list; }
+        
+        return 0;
+        
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "update");
+        exit(1);
+    }
+}
+/***********************************************************************/
+struct optiMoveData {
+    OptiCluster* cluster;
+    int thread;
+    
+    optiMoveData(){}
+    optiMoveData(OptiCluster* c, int t) {
+        cluster = c;
+        thread = t;
+    }
+};
+/***********************************************************************/
+void findOptiMoves(optiMoveData* params) {
+    params->cluster->moveWorker(params->thread);
+}
+/***********************************************************************/
+/* Splits randomizeSeqs into batches of optiBatchSize sequences. The threads find the best bin for each sequence in the
+ * batch against the counts and bins at the start of the batch, then the moves are made in randomizeSeqs order. A move
+ * only depends on the sizes of its old and new bins and which of its close seqs are in them, so its change to the
+ * counts is still exact as long as no earlier move in the batch touched either bin. Moves that touched bins, or that
+ * no longer improve the metric, are found again from the current bins and counts, the same as the serial update.
+ * The batches don't depend on the number of threads, so any processors > 1 gives the same OTUs for a seed.
+ * The worker threads are started once per update and wait for each batch in moveWorker. */
+void OptiCluster::updateInBatches() {
+    try {
+        
+        //Lauch worker threads
+        batchGeneration = 0; numThreadsDone = 0; updateDone = false;
+        vector<std::thread*> workerThreads;
+        vector<optiMoveData*> data;
+        for (int i = 1; i < processors; i++) {
+            optiMoveData* dataBundle = new optiMoveData(this, i);
+            data.push_back(dataBundle);
+            workerThreads.push_back(new std::thread(findOptiMoves, dataBundle));
+        }
+        
+        for (long long batchStart = 0; batchStart < randomizeSeqs.size(); batchStart += optiBatchSize) {
             
             if (m->getControl_pressed()) { break; }
             
-            map<long long, long long>::iterator it = seqBin.find(randomizeSeqs[i]);
+            long long batchEnd = batchStart + optiBatchSize;
+            if (batchEnd > randomizeSeqs.size()) { batchEnd = randomizeSeqs.size(); }
+            
+            //find the best moves for the batch
+            long long numSeqsPerThread = (batchEnd - batchStart) / processors;
+            long long remainder = (batchEnd - batchStart) % processors;
+            vector<linePair> lines;
+            long long startIndex = batchStart;
+            for (int i = 0; i < processors; i++) {
+                long long numSeqsToFit = numSeqsPerThread;
+                if (i < remainder) { numSeqsToFit++; }
+                lines.push_back(linePair(startIndex, (startIndex+numSeqsToFit))); //startIndex, endIndex
+                startIndex += numSeqsToFit;
+            }
             
-            long long seqNumber = it->first;
-            long long binNumber = it->second;
+            {   //hand the batch to the workers
+                std::lock_guard<std::mutex> lock(batchMutex);
+                batchLines = lines; currentBatchStart = batchStart; numThreadsDone = 0; batchGeneration++;
+            }
+            batchReady.notify_all();
             
-            if (binNumber == -1) { }
-            else {
-                
-                double tn, tp, fp, fn;
-                double bestMetric = -1;
-                double bestBin, bestTp, bestTn, bestFn, bestFp;
-                tn = trueNegatives; tp = truePositives; fp = falsePositives; fn = falseNegatives;
-                
-                //close / far count in current bin
-                vector<double> results = getCloseFarCounts(seqNumber, binNumber);
-                double cCount = results[0];  double fCount = results[1];
+            findBestMoves(lines[0].start, lines[0].end, batchStart, 0);
+            
+            {   //wait for the workers to finish the batch
+                std::unique_lock<std::mutex> lock(batchMutex);
+                while (numThreadsDone < (processors-1)) { batchFound.wait(lock); }
+            }
+            
+            //the proposals are incomplete if a thread stopped early
+            if (m->getControl_pressed()) { break; }
+            
+            //make the moves in order
+            double startTp = truePositives; double startTn = trueNegatives; double startFp = falsePositives; double startFn = falseNegatives;
+            for (long long i = batchStart; i < batchEnd; i++) {
                 
-                //metric in current bin
-                bestMetric = metric->getValue(tp, tn, fp, fn); bestBin = binNumber; bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn;
+                long long seqNumber = randomizeSeqs[i];
+                long long binNumber = seqBin[seqNumber];
+                long long bestBin = proposedBins[i-batchStart];
                 
-                //if not already singleton, then calc value if singleton was created
-                if (!((bins[binNumber].size()) == 1)) {
-                    //make a singleton
-                    //move out of old bin
-                    fn+=cCount; tn+=fCount; fp-=fCount; tp-=cCount;
-                    double singleMetric = metric->getValue(tp, tn, fp, fn);
-                    if (singleMetric > bestMetric) {
-                        bestBin = -1; bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn;
-                        bestMetric = singleMetric;
-                    }
-                }
+                if (bestBin == binNumber) { continue; } //staying put
                 
-                set<long long> binsToTry;
-                set<long long> closeSeqs = matrix->getCloseSeqs(seqNumber);
-                for (set<long long>::iterator itClose = closeSeqs.begin(); itClose != closeSeqs.end(); itClose++) {  binsToTry.insert(seqBin[*itClose]); }
+                double* counts = &proposedCounts[(i-batchStart)*4];
+                double bestTp = truePositives + (counts[0] - startTp);
+                double bestTn = trueNegatives + (counts[1] - startTn);
+                double bestFp = falsePositives + (counts[2] - startFp);
+                double bestFn = falseNegatives + (counts[3] - startFn);
                 
-                //merge into each "close" otu
-                for (set<long long>::iterator it = binsToTry.begin(); it != binsToTry.end(); it++) {
-                    tn = trueNegatives; tp = truePositives; fp = falsePositives; fn = falseNegatives;
-                    fn+=cCount; tn+=fCount; fp-=fCount; tp-=cCount; //move out of old bin
-                    results = getCloseFarCounts(seqNumber, *it);
-                    fn-=results[0]; tn-=results[1];  tp+=results[0]; fp+=results[1]; //move into new bin
-                    double newMetric = metric->getValue(tp, tn, fp, fn); //score when sequence is moved
-                    //new best
-                    if (newMetric > bestMetric) { bestMetric = newMetric; bestBin = (*it); bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn; }
+                bool findAgain = (touchedInBatch[binNumber] == batchStart);
+                if ((bestBin != -1) && (touchedInBatch[bestBin] == batchStart)) { findAgain = true; }
+                if (!findAgain) {
+                    double currentMetric = metric->getValue(truePositives, trueNegatives, falsePositives, falseNegatives);
+                    if (!(metric->getValue(bestTp, bestTn, bestFp, bestFn) > currentMetric)) { findAgain = true; }
                 }
                 
-                bool usedInsert = false;
-                if (bestBin == -1) {  bestBin = insertLocation;  usedInsert = true;  }
+                if (findAgain) { bestBin = findBestBin(seqNumber, closeInBin, binsToTry, bestTp, bestTn, bestFp, bestFn); }
                 
-                if (bestBin != binNumber) {
-                    truePositives = bestTp; trueNegatives = bestTn; falsePositives = bestFp; falseNegatives = bestFn;
-                    
-                    //move seq from i to j
-                    bins[bestBin].push_back(seqNumber); //add seq to bestbin
-                    bins[binNumber].erase(remove(bins[binNumber].begin(), bins[binNumber].end(), seqNumber), bins[binNumber].end()); //remove from old bin i
-                }
+                moveSeq(seqNumber, bestBin, bestTp, bestTn, bestFp, bestFn);
                 
-                if (usedInsert) { insertLocation = findInsert(); }
+                if (seqBin[seqNumber] != binNumber) { touchedInBatch[binNumber] = batchStart; touchedInBatch[seqBin[seqNumber]] = batchStart; }
+            }
+        }
+        
+        {   //release the workers
+            std::lock_guard<std::mutex> lock(batchMutex);
+            updateDone = true;
+        }
+        batchReady.notify_all();
+        
+        for (int i = 0; i < workerThreads.size(); i++) {
+            workerThreads[i]->join();
+            delete data[i];
+            delete workerThreads[i];
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "updateInBatches");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//run by worker thread, finds the best moves for its part of each batch until updateInBatches is done
+void OptiCluster::moveWorker(int thread) {
+    try {
+        int lastGeneration = 0;
+        
+        while (true) {
+            long long start, end, batchStart;
+            {
+                std::unique_lock<std::mutex> lock(batchMutex);
+                while ((batchGeneration == lastGeneration) && !updateDone) { batchReady.wait(lock); }
+                if (updateDone) { return; }
                 
-                //update seqBins
-                seqBin[seqNumber] = bestBin; //set new OTU location
+                lastGeneration = batchGeneration;
+                start = batchLines[thread].start; end = batchLines[thread].end; batchStart = currentBatchStart;
+            }
+            
+            findBestMoves(start, end, batchStart, thread);
+            
+            {
+                std::lock_guard<std::mutex> lock(batchMutex);
+                numThreadsDone++;
             }
+            batchFound.notify_one();
         }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "moveWorker");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//finds the best bins for randomizeSeqs[start] to randomizeSeqs[end-1] without changing the bins, run by the worker threads
+void OptiCluster::findBestMoves(long long start, long long end, long long batchStart, int thread) {
+    try {
+        vector<long long>& closeCounts = (thread == 0) ? closeInBin : threadCloseInBin[thread-1];
+        vector<long long>& tryBins = (thread == 0) ? binsToTry : threadBinsToTry[thread-1];
         
-        listMetric = metric->getValue(truePositives, trueNegatives, falsePositives, falseNegatives);
+        for (long long i = start; i < end; i++) {
+            
+            if (m->getControl_pressed()) { break; }
+            
+            double* counts = &proposedCounts[(i-batchStart)*4];
+            proposedBins[i-batchStart] = findBestBin(randomizeSeqs[i], closeCounts, tryBins, counts[0], counts[1], counts[2], counts[3]);
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "findBestMoves");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//returns the bin seqNumber should be in and the counts after moving it there, -1 if it should be a new singleton. closeCounts must be -1 for every bin.
+long long OptiCluster::findBestBin(long long seqNumber, vector<long long>& closeCounts, vector<long long>& tryBins, double& bestTp, double& bestTn, double& bestFp, double& bestFn) {
+    try {
+        long long binNumber = seqBin[seqNumber];
         
-        if (m->getDebug()) { ListVector* list = getList(); list->print(cout); delete list; }
+        //count the close seqs in each bin with a close seq, one pass over the seqs close to this one
+        tryBins.clear();
+        for (unsigned int closeSeq : matrix->getCloseSeqsInPlace(seqNumber)) {
+            long long closeBin = seqBin[closeSeq];
+            if (closeCounts[closeBin] == -1) { closeCounts[closeBin] = 0; tryBins.push_back(closeBin); }
+            if (closeSeq != seqNumber) { closeCounts[closeBin]++; } //ignore self
+        }
+        sort(tryBins.begin(), tryBins.end());
         
-        return 0;
+        double tn, tp, fp, fn;
+        double bestMetric = -1;
+        double bestBin;
+        tn = trueNegatives; tp = truePositives; fp = falsePositives; fn = falseNegatives;
+        
+        //close / far count in current bin
+        double cCount = 0; if (closeCounts[binNumber] != -1) { cCount = closeCounts[binNumber]; }
+        double fCount = binSize[binNumber] - 1 - cCount;
+        
+        //metric in current bin
+        bestMetric = metric->getValue(tp, tn, fp, fn); bestBin = binNumber; bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn;
+        
+        //if not already singleton, then calc value if singleton was created
+        if (!(binSize[binNumber] == 1)) {
+            //make a singleton
+            //move out of old bin
+            fn+=cCount; tn+=fCount; fp-=fCount; tp-=cCount;
+            double singleMetric = metric->getValue(tp, tn, fp, fn);
+            if (singleMetric > bestMetric) {
+                bestBin = -1; bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn;
+                bestMetric = singleMetric;
+            }
+        }
+        
+        //merge into each "close" otu
+        for (vector<long long>::iterator it = tryBins.begin(); it != tryBins.end(); it++) {
+            tn = trueNegatives; tp = truePositives; fp = falsePositives; fn = falseNegatives;
+            fn+=cCount; tn+=fCount; fp-=fCount; tp-=cCount; //move out of old bin
+            double close = closeCounts[*it];
+            double far = binSize[*it] - close; if ((*it) == binNumber) { far--; } //ignore self
+            fn-=close; tn-=far;  tp+=close; fp+=far; //move into new bin
+            double newMetric = metric->getValue(tp, tn, fp, fn); //score when sequence is moved
+            //new best
+            if (newMetric > bestMetric) { bestMetric = newMetric; bestBin = (*it); bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn; }
+        }
+        for (vector<long long>::iterator it = tryBins.begin(); it != tryBins.end(); it++) { closeCounts[*it] = -1; }
         
+        return (long long)bestBin;
     }
     catch(exception& e) {
-        m->errorOut(e, "OptiCluster", "update");
+        m->errorOut(e, "OptiCluster", "findBestBin");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//moves seqNumber to bestBin, or the insert location if bestBin is -1, and sets the counts
+void OptiCluster::moveSeq(long long seqNumber, long long bestBin, double bestTp, double bestTn, double bestFp, double bestFn) {
+    try {
+        long long binNumber = seqBin[seqNumber];
+        
+        bool usedInsert = false;
+        if (bestBin == -1) {  bestBin = insertLocation;  usedInsert = true;  }
+        
+        if (bestBin != binNumber) {
+            truePositives = bestTp; trueNegatives = bestTn; falsePositives = bestFp; falseNegatives = bestFn;
+            
+            //move seq from i to j
+            removeFromBin(seqNumber, binNumber); //remove from old bin i
+            addToBin(seqNumber, bestBin); //add seq to bestbin
+        }
+        
+        if (usedInsert) { insertLocation = findInsert(); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "moveSeq");
         exit(1);
     }
 }
@@ -180,11 +372,11 @@ vector<double> OptiCluster::getCloseFarCounts(long long seq, long long newBin) {
         
         if (newBin == -1) { }  //making a singleton bin. Close but we are forcing apart.
         else { //merging a bin
-            for (int i = 0; i < bins[newBin].size(); i++) {
-                if (seq == bins[newBin][i]) {} //ignore self
-                else if (!matrix->isClose(seq, bins[newBin][i])) { results[1]++; }  //this sequence is "far away" from sequence i - above the cutoff
-                else { results[0]++;  }  //this sequence is "close" to sequence i - distance between them is less than cutoff
+            for (unsigned int closeSeq : matrix->getCloseSeqsInPlace(seq)) {
+                if ((closeSeq != seq) && (seqBin[closeSeq] == newBin)) { results[0]++; } //this sequence is "close" to sequence i - distance between them is less than cutoff
             }
+            results[1] = binSize[newBin] - results[0]; //the rest are "far away" from sequence i - above the cutoff
+            if (seqBin[seq] == newBin) { results[1]--; } //ignore self
         }
         
         return results;
@@ -194,6 +386,41 @@ vector<double> OptiCluster::getCloseFarCounts(long long seq, long long newBin) {
         exit(1);
     }
 }
+/***********************************************************************/
+void OptiCluster::addToBin(long long seq, long long bin) {
+    try {
+        seqBin[seq] = bin;
+        seqPosition[seq] = bins[bin].size();
+        bins[bin].push_back(seq);
+        binSize[bin]++;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "addToBin");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//marks the seq's spot in the bin instead of shifting the seqs after it, so a move doesn't depend on the size of the bin.
+//Once the marked spots outnumber the seqs the bin is compacted, keeping the seqs in order.
+void OptiCluster::removeFromBin(long long seq, long long bin) {
+    try {
+        bins[bin][seqPosition[seq]] = -1;
+        binSize[bin]--;
+        
+        if (binSize[bin] == 0) { bins[bin].clear(); emptyBins.insert(bin); }
+        else if ((bins[bin].size() - binSize[bin]) > binSize[bin]) {
+            long long count = 0;
+            for (long long i = 0; i < bins[bin].size(); i++) {
+                if (bins[bin][i] != -1) { bins[bin][count] = bins[bin][i]; seqPosition[bins[bin][i]] = count; count++; }
+            }
+            bins[bin].resize(count);
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "removeFromBin");
+        exit(1);
+    }
+}
 
 /***********************************************************************/
 vector<double> OptiCluster::getStats( double& tp,  double& tn,  double& fp,  double& fn) {
@@ -240,11 +467,13 @@ ListVector* OptiCluster::getList() {
         }
         
         for (int i = 0; i < bins.size(); i++) {
-            if (bins[i].size() != 0) {
-                string otu = matrix->getName(bins[i][0]);
+            if (binSize[i] != 0) {
+                string otu = "";
                 
-                for (int j = 1; j < bins[i].size(); j++) {
-                    otu += "," + matrix->getName(bins[i][j]);
+                for (int j = 0; j < bins[i].size(); j++) {
+                    if (bins[i][j] == -1) { continue; } //moved out
+                    if (otu != "") { otu += ","; }
+                    otu += matrix->getName(bins[i][j]);
                 }
                 list->push_back(otu);
             }
@@ -262,8 +491,8 @@ long long OptiCluster::getNumBins() {
     try {
         long long singletn = matrix->getNumSingletons();
         
-        for (int i = 0; i < bins.size(); i++) {
-            if (bins[i].size() != 0) {
+        for (int i = 0; i < binSize.size(); i++) {
+            if (binSize[i] != 0) {
                 singletn++;
             }
         }
@@ -280,15 +509,13 @@ long long OptiCluster::getNumBins() {
 long long OptiCluster::findInsert() {
     try {
         
-        //initially there are bins for each sequence (excluding singletons removed on read)
-        for (long long i = 0; i < bins.size(); i++) {
-            
-            if (m->getControl_pressed()) { break; }
-            
-            if (bins[i].size() == 0) { return i;  } //this bin is empty
-        }
+        //lowest numbered empty bin
+        if (emptyBins.size() == 0) { return -1; }
+        
+        long long bin = *emptyBins.begin();
+        emptyBins.erase(emptyBins.begin());
         
-        return -1;
+        return bin;
     }
     catch(exception& e) {
         m->errorOut(e, "OptiCluster", "findInsert");
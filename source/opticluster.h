@@ -26,6 +26,7 @@
 #include "tn.hpp"
 #include "fn.hpp"
 #include "accuracy.hpp"
+#include <condition_variable>
 
 /***********************************************************************/
 
@@ -42,7 +43,7 @@ class OptiCluster : public Cluster {
 
 public:
     
-    OptiCluster(OptiData* mt, ClusterMetric* met, long long ns);
+    OptiCluster(OptiData* mt, ClusterMetric* met, long long ns, int p); //matrix, metric, numSingletons, processors
     ~OptiCluster() = default;
     
     bool updateDistance(PDistCell& colCell, PDistCell& rowCell) { return false; } 
@@ -53,19 +54,43 @@ public:
     bool update(double&); //returns whether list changed and MCC
     vector<double> getStats( double&,  double&,  double&,  double&);
     ListVector* getList();
+    void findBestMoves(long long, long long, long long, int); //start, end, batchStart, thread - used by update's worker threads
+    void moveWorker(int); //thread - waits for each batch of updateInBatches
     
 protected:
     OptiData* matrix;
     ClusterMetric* metric;
     vector<int> randomizeSeqs;
-    vector< vector<long long> > bins; //bin[0] -> seqs in bin[0]
+    vector< vector<long long> > bins; //bin[0] -> seqs in bin[0] in the order they were added, -1 where a seq was moved out
+    vector<long long> binSize; //number of seqs in each bin
     map<long long, string> binLabels; //for fitting - maps binNumber to existing reference label
-    map<long long, long long> seqBin; //sequence# -> bin#
+    vector<long long> seqBin; //sequence# -> bin#
+    vector<long long> seqPosition; //sequence# -> index in bins[seqBin[sequence#]]
+    set<long long> emptyBins; //empty bins other than insertLocation
+    vector<long long> binsToTry; //bins of the seqs close to the seq being moved, kept to reuse its memory
+    vector<long long> closeInBin; //number of seqs close to the seq being moved in each bin of binsToTry, -1 for other bins
+    vector< vector<long long> > threadCloseInBin, threadBinsToTry; //closeInBin and binsToTry for each worker thread
+    vector<long long> touchedInBatch; //bin# -> start of the last batch that moved a seq into or out of the bin
+    vector<long long> proposedBins; //best bin found for each seq in the batch
+    vector<double> proposedCounts; //tp, tn, fp, fn after each seq in the batch is moved to its best bin
     
-    long long numSeqs, insertLocation, numSingletons;
+    std::mutex batchMutex; //guards the batch handed to the worker threads
+    std::condition_variable batchReady, batchFound;
+    vector<linePair> batchLines; //seqs of each thread in the current batch
+    long long currentBatchStart;
+    int batchGeneration, numThreadsDone;
+    bool updateDone;
+    
+    int processors;
+    long long numSeqs, insertLocation, numSingletons, optiBatchSize;
     double truePositives, trueNegatives, falsePositives, falseNegatives;
     
     long long findInsert();
+    void updateInBatches();
+    long long findBestBin(long long, vector<long long>&, vector<long long>&, double&, double&, double&, double&);
+    void moveSeq(long long, long long, double, double, double, double);
+    void addToBin(long long seq, long long bin);
+    void removeFromBin(long long seq, long long bin);
     vector<double> getCloseFarCounts(long long seq, long long newBin);
     vector<double> getFitStats( long long&, long long&, long long&, long long&);
 };
@@ -531,7 +531,7 @@ ListVector* OptiFitCluster::clusterUnfitted(OptiData* unfittedMatrix, string lab
     try {
         ListVector* list = nullptr;
         
-        OptiCluster cluster(unfittedMatrix, metric, 0);
+        OptiCluster cluster(unfittedMatrix, metric, 0, 1);
         
         int iters = 0;
         double listVectorMetric = 0; //worst state
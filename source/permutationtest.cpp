@@ -0,0 +1,161 @@
+//
+//  permutationtest.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "permutationtest.hpp"
+
+/**************************************************************************************************/
+CondensedMatrix::CondensedMatrix(vector< vector<double> >& matrix) {
+    numRows = matrix.size();
+    cells.reserve((((long long)numRows) * (numRows-1)) / 2);
+
+    for (int i = 1; i < numRows; i++) {
+        for (int j = 0; j < i; j++) { cells.push_back(matrix[i][j]); }
+    }
+}
+/**************************************************************************************************/
+CondensedMatrix::CondensedMatrix(const CondensedMatrix& matrix, const vector<int>& samples) {
+    numRows = samples.size();
+    cells.reserve((((long long)numRows) * (numRows-1)) / 2);
+
+    for (int i = 1; i < numRows; i++) {
+        for (int j = 0; j < i; j++) { cells.push_back(matrix.get(samples[i], samples[j])); }
+    }
+}
+/**************************************************************************************************/
+double CondensedMatrix::convertToRanks() {
+    MothurOut* m = MothurOut::getInstance();
+    try {
+        //sort cells by distance, ties stay in matrix order
+        vector< pair<double, long long> > sorted(cells.size());
+        for (long long i = 0; i < cells.size(); i++) { sorted[i] = make_pair(cells[i], i); }
+        sort(sorted.begin(), sorted.end());
+
+        double ties = 0.0;
+        long long start = 0;
+        while (start < sorted.size()) {
+            long long end = start + 1;
+            while ((end < sorted.size()) && (sorted[end].first == sorted[start].first)) { end++; }
+
+            //ranks start at 1, so the tied cells share the average of start+1 to end
+            double rank = (start + 1 + end) / 2.0;
+            for (long long i = start; i < end; i++) { cells[sorted[i].second] = rank; }
+
+            double t = end - start;
+            ties += ((t * t * t) - t) / 12.0;
+
+            start = end;
+        }
+
+        return ties;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CondensedMatrix", "convertToRanks");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+struct permutationData {
+    PermutationStatistic* statistic;
+    MothurOut* m;
+    Utils util;
+    long long firstStream;
+    int start, num, numSamples, count;
+    double observed;
+    bool larger;
+
+    permutationData(PermutationStatistic* s, long long fs, int st, int n, int ns, double o, bool l) : statistic(s), firstStream(fs), start(st), num(n), numSamples(ns), observed(o), larger(l) {
+        m = MothurOut::getInstance();
+        count = 0;
+    }
+};
+/**************************************************************************************************/
+void permuteSamples(permutationData* params) {
+    try {
+        vector<int> order(params->numSamples);
+
+        for (int i = params->start; i < params->start+params->num; i++) {
+            if (params->m->getControl_pressed()) { break; }
+
+            params->util.setRandomStream(params->firstStream + i);
+            for (int j = 0; j < order.size(); j++) { order[j] = j; }
+            params->util.mothurRandomShuffle(order);
+
+            double value = params->statistic->getValue(order);
+
+            if (params->larger)     { if (value >= params->observed) { params->count++; } }
+            else                    { if (value <= params->observed) { params->count++; } }
+        }
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "PermutationTest", "permuteSamples");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+double PermutationTest::getObserved(PermutationStatistic* statistic, int numSamples) {
+    try {
+        vector<int> order(numSamples);
+        for (int i = 0; i < numSamples; i++) { order[i] = i; }
+
+        return statistic->getValue(order);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "PermutationTest", "getObserved");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+int PermutationTest::run(PermutationStatistic* statistic, int numSamples, int iters, double observed, bool larger) {
+    try {
+        long long firstStream = nextStream;
+        nextStream += iters;
+
+        int numProcessors = processors;
+        if (numProcessors > iters) { numProcessors = iters; }
+        if (numProcessors < 1) { numProcessors = 1; }
+
+        //divide the iters between the processors
+        vector<int> lines, starts;
+        int numItersPerProcessor = iters / numProcessors;
+        for (int i = 0; i < numProcessors; i++) {
+            starts.push_back(i * numItersPerProcessor);
+            if(i == (numProcessors - 1)){	numItersPerProcessor = iters - i * numItersPerProcessor; 	}
+            lines.push_back(numItersPerProcessor);
+        }
+
+        //create array of worker threads
+        vector<std::thread*> workerThreads;
+        vector<permutationData*> data;
+
+        //Lauch worker threads
+        for (int i = 0; i < numProcessors-1; i++) {
+            permutationData* dataBundle = new permutationData(statistic, firstStream, starts[i+1], lines[i+1], numSamples, observed, larger);
+            data.push_back(dataBundle);
+            workerThreads.push_back(new std::thread(permuteSamples, dataBundle));
+        }
+
+        permutationData* dataBundle = new permutationData(statistic, firstStream, starts[0], lines[0], numSamples, observed, larger);
+        permuteSamples(dataBundle);
+        int count = dataBundle->count;
+        delete dataBundle;
+
+        for (int i = 0; i < numProcessors-1; i++) {
+            workerThreads[i]->join();
+            count += data[i]->count;
+
+            delete data[i];
+            delete workerThreads[i];
+        }
+
+        return count;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "PermutationTest", "run");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
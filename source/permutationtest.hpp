@@ -0,0 +1,70 @@
+#ifndef permutationtest_hpp
+#define permutationtest_hpp
+//
+//  permutationtest.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "mothurout.h"
+#include "utils.hpp"
+
+/**************************************************************************************************/
+//the lower triangle of a square distance matrix in one block, cell (i, j) with j < i is at i*(i-1)/2 + j
+class CondensedMatrix {
+public:
+    CondensedMatrix() : numRows(0) {}
+    CondensedMatrix(vector< vector<double> >&);                 //copies the lower triangle of a square matrix
+    CondensedMatrix(const CondensedMatrix&, const vector<int>&); //the rows and columns of the samples, in that order
+
+    int getNumRows() const              { return numRows;       }
+    long long getNumCells() const       { return cells.size();  }
+    double get(int i, int j) const      { return (i > j) ? cells[getIndex(i, j)] : cells[getIndex(j, i)]; }
+    static long long getIndex(int i, int j) { return ((((long long)i) * (i-1)) / 2) + j; } //i > j
+
+    //replaces each cell with its rank among the cells, tied cells get the average of their ranks.
+    //returns the sum of (t^3 - t) / 12 over the groups of t tied cells.
+    double convertToRanks();
+
+    vector<double> cells;
+
+private:
+    int numRows;
+};
+/**************************************************************************************************/
+
+//a statistic of a permutation test, calculated with the samples in an order
+class PermutationStatistic {
+public:
+    virtual ~PermutationStatistic() {}
+
+    //called from several threads at once, so it must only read the members
+    virtual double getValue(const vector<int>&) = 0;
+};
+/**************************************************************************************************/
+
+/* Runs the randomizations of a permutation test on several processors. Each randomization is a random order of the
+ samples, so the statistic reads the original matrix through the order instead of a shuffled copy. Each randomization
+ is drawn from its own random number stream, so the p-values depend on the seed but not on the number of processors,
+ and each test run by the same PermutationTest uses new streams. */
+
+class PermutationTest {
+
+public:
+    PermutationTest(int p) : processors(p), nextStream(0) { m = MothurOut::getInstance(); }
+
+    double getObserved(PermutationStatistic*, int); //statistic, number of samples. The value with the samples in order.
+
+    //returns the number of the iters random orders with a value at least as large (or small) as the observed value
+    int run(PermutationStatistic*, int, int, double, bool); //statistic, number of samples, iters, observed, larger
+
+private:
+    MothurOut* m;
+    int processors;
+    long long nextStream;
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,159 @@
+//
+//  sequencepipeline.cpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#include "sequencepipeline.hpp"
+#include "sequencereader.hpp"
+
+/***********************************************************************/
+SequencePipeline::SequencePipeline(string f) : filename(f), reader(nullptr) {
+    try {
+        m = MothurOut::getInstance();
+        batchSize = 256;
+        finished = false;
+
+        gz = util.isGZ(filename)[1];
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequencePipeline", "SequencePipeline");
+        exit(1);
+    }
+}
+/***********************************************************************/
+SequencePipeline::SequencePipeline(PipelineReader* r) : filename(""), reader(r) {
+    try {
+        m = MothurOut::getInstance();
+        batchSize = 256;
+        finished = false;
+        gz = false;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequencePipeline", "SequencePipeline");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//the batches of a fasta file
+class FastaPipelineReader : public PipelineReader {
+public:
+    FastaPipelineReader(string filename, bool gz) : reader(filename, gz) {}
+
+    PipelineBatch* read(int batchSize, int numOutputs) {
+        PipelineBatch* batch = new PipelineBatch(numOutputs);
+        while ((batch->seqs.size() < batchSize) && reader.readFasta()) {
+            if (reader.getName().length != 0) { batch->seqs.push_back(reader.getSequence()); } //commented out sequence at the end of the file
+        }
+
+        if (batch->seqs.size() == 0) { delete batch; return nullptr; }
+        return batch;
+    }
+
+private:
+    SequenceReader reader;
+};
+/***********************************************************************/
+void SequencePipeline::workerLoop(PipelineWorker* worker) {
+    try {
+        while (true) {
+            PipelineBatch* batch = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                while (work.empty() && !finished) { workReady.wait(lock); }
+                if (work.empty()) { return; }
+                batch = work.front(); work.pop_front();
+            }
+
+            worker->process(batch);
+
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                batch->done = true;
+            }
+            batchDone.notify_all();
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequencePipeline", "workerLoop");
+        exit(1);
+    }
+}
+/***********************************************************************/
+long long SequencePipeline::run(vector<PipelineWorker*>& workers, vector<ostream*>& outputs) {
+    try {
+        FastaPipelineReader* fastaReader = nullptr;
+        PipelineReader* input = reader;
+        if (input == nullptr) { fastaReader = new FastaPipelineReader(filename, gz); input = fastaReader; }
+
+        int numThreads = workers.size();
+        finished = false;
+
+        vector<std::thread*> workerThreads;
+        if (numThreads > 1) {
+            for (int i = 0; i < numThreads; i++) { workerThreads.push_back(new std::thread(&SequencePipeline::workerLoop, this, workers[i])); }
+        }
+
+        deque<PipelineBatch*> inFlight; //batches read and not written yet, in the order they were read
+        int maxInFlight = 4 * numThreads;
+        bool endOfFile = false;
+        long long numSeqs = 0;
+
+        while (true) {
+            //read ahead
+            while (!endOfFile && (inFlight.size() < maxInFlight)) {
+                if (m->getControl_pressed()) { endOfFile = true; break; }
+
+                PipelineBatch* batch = input->read(batchSize, outputs.size());
+                if (batch == nullptr) { endOfFile = true; break; }
+
+                inFlight.push_back(batch);
+                if (numThreads > 1) {
+                    {
+                        std::lock_guard<std::mutex> lock(queueMutex);
+                        work.push_back(batch);
+                    }
+                    workReady.notify_one();
+                }else { workers[0]->process(batch); batch->done = true; }
+            }
+
+            if (inFlight.size() == 0) { break; }
+
+            //write the oldest batch once it is done
+            PipelineBatch* batch = inFlight.front(); inFlight.pop_front();
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                while (!batch->done) { batchDone.wait(lock); }
+            }
+            for (int i = 0; i < outputs.size(); i++) { *outputs[i] << batch->output[i]; }
+
+            //report progress
+            long long before = numSeqs;
+            numSeqs += batch->size();
+            if ((numSeqs / 1000) != (before / 1000)) { m->mothurOutJustToScreen(toString((numSeqs / 1000) * 1000) + "\n"); }
+
+            delete batch;
+        }
+        if ((numSeqs % 1000) != 0) { m->mothurOutJustToScreen(toString(numSeqs) + "\n"); }
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            finished = true;
+        }
+        workReady.notify_all();
+
+        for (int i = 0; i < workerThreads.size(); i++) {
+            workerThreads[i]->join();
+            delete workerThreads[i];
+        }
+        delete fastaReader;
+
+        return numSeqs;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequencePipeline", "run");
+        exit(1);
+    }
+}
+/***********************************************************************/
@@ -0,0 +1,84 @@
+//
+//  sequencepipeline.hpp
+//  Mothur
+//
+//  Copyright © 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef sequencepipeline_hpp
+#define sequencepipeline_hpp
+
+#include "mothurout.h"
+#include "utils.hpp"
+#include "sequence.hpp"
+#include <condition_variable>
+#include <deque>
+
+/***********************************************************************/
+//sequences read together and the text each output file gets for them
+struct PipelineBatch {
+    vector<Sequence> seqs;
+    vector<string> output;
+    bool done;
+
+    PipelineBatch(int numOutputs) : done(false) { output.resize(numOutputs, ""); }
+    virtual ~PipelineBatch() = default;
+
+    virtual int size() { return seqs.size(); }  //number of reads in the batch, for the progress report
+};
+/***********************************************************************/
+//one per thread, so anything a worker changes is only used by its thread
+class PipelineWorker {
+public:
+    PipelineWorker() { m = MothurOut::getInstance(); }
+    virtual ~PipelineWorker() = default;
+
+    virtual void process(PipelineBatch*) = 0;   //adds the output for each sequence in the batch
+
+protected:
+    MothurOut* m;
+};
+/***********************************************************************/
+//reads the input of a pipeline that isn't a single fasta file, only used by the calling thread
+class PipelineReader {
+public:
+    virtual ~PipelineReader() = default;
+
+    virtual PipelineBatch* read(int, int) = 0;   //batch size, number of outputs - returns nullptr at the end of the input
+};
+/***********************************************************************/
+
+/* Reads a plain or gzipped fasta file in batches of sequences, hands each batch to the next free worker thread and
+ writes the output of the batches in the order they were read. Other inputs, like make.contigs' read pairs, come in
+ through a PipelineReader. Only 4 batches per worker are read ahead, so memory stays bounded and a slow batch only
+ holds up the writing, not the other workers. Each output file is written by the calling thread alone, and the files
+ match for any number of workers. */
+
+class SequencePipeline {
+
+public:
+    SequencePipeline(string);   //fasta file
+    SequencePipeline(PipelineReader*);
+    ~SequencePipeline() = default;
+
+    long long run(vector<PipelineWorker*>&, vector<ostream*>&);  //one worker per thread, output files - returns number of sequences
+
+private:
+    MothurOut* m;
+    Utils util;
+    string filename;
+    PipelineReader* reader;
+    bool gz;
+    int batchSize;
+
+    std::mutex queueMutex;
+    std::condition_variable workReady, batchDone;
+    deque<PipelineBatch*> work;
+    bool finished;
+
+    void workerLoop(PipelineWorker*);
+};
+
+/***********************************************************************/
+
+#endif
@@ -0,0 +1,347 @@
+/*
+ *  stripedneedleman.cpp
+ *
+ *
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ *	This class is an Alignment child class that implements the same Needleman-Wunsch alignment as NeedlemanOverlap,
+ *	but fills the dynamic programming matrix with the striped SIMD method described in:
+ *
+ *		Farrar M. 2007.  Striped Smith-Waterman speeds database searches six times over other SIMD implementations.
+ *			Bioinformatics.  23:156-61.
+ *
+ *	seqA is laid out down the vector lanes so that lane l holds positions l*segLength through (l+1)*segLength-1.  Each
+ *	row of seqB is filled in one pass using the diagonal and up scores, and then the "lazy F" loop carries the left
+ *	scores across lane boundaries until nothing changes.
+ *
+ */
+
+#include "stripedneedleman.hpp"
+
+/**************************************************************************************************/
+//	small set of integer vector operations so the fill can be written once for every instruction set
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+#define SIMD_LANES 8
+typedef __m256i simdInt;
+
+static inline simdInt simdSet(int a)							{	return _mm256_set1_epi32(a);	}
+static inline simdInt simdLoad(const int* p)					{	return _mm256_loadu_si256((const __m256i*)p);	}
+static inline void simdStore(int* p, simdInt a)					{	_mm256_storeu_si256((__m256i*)p, a);	}
+static inline simdInt simdAdd(simdInt a, simdInt b)				{	return _mm256_add_epi32(a, b);	}
+static inline simdInt simdMax(simdInt a, simdInt b)				{	return _mm256_max_epi32(a, b);	}
+static inline int simdMaskEqual(simdInt a, simdInt b)			{	return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));	}
+static inline int simdMaskGreater(simdInt a, simdInt b)			{	return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b)));	}
+static inline simdInt simdShiftIn(simdInt a, int first)	{	//	move every lane up one and put first in lane 0
+	simdInt shifted = _mm256_permutevar8x32_epi32(a, _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6));
+	return _mm256_blend_epi32(shifted, _mm256_set1_epi32(first), 1);
+}
+
+#elif defined(__SSE2__)
+
+#include <emmintrin.h>
+#if defined(__SSE4_1__)
+	#include <smmintrin.h>
+#endif
+
+#define SIMD_LANES 4
+typedef __m128i simdInt;
+
+static inline simdInt simdSet(int a)							{	return _mm_set1_epi32(a);	}
+static inline simdInt simdLoad(const int* p)					{	return _mm_loadu_si128((const __m128i*)p);	}
+static inline void simdStore(int* p, simdInt a)					{	_mm_storeu_si128((__m128i*)p, a);	}
+static inline simdInt simdAdd(simdInt a, simdInt b)				{	return _mm_add_epi32(a, b);	}
+static inline simdInt simdMax(simdInt a, simdInt b)	{
+#if defined(__SSE4_1__)
+	return _mm_max_epi32(a, b);
+#else
+	simdInt greater = _mm_cmpgt_epi32(a, b);
+	return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+#endif
+}
+static inline int simdMaskEqual(simdInt a, simdInt b)			{	return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)));	}
+static inline int simdMaskGreater(simdInt a, simdInt b)			{	return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(a, b)));	}
+static inline simdInt simdShiftIn(simdInt a, int first)			{	return _mm_or_si128(_mm_slli_si128(a, 4), _mm_cvtsi32_si128(first));	}
+
+#else
+
+#define SIMD_LANES 4
+struct simdInt { int lane[SIMD_LANES]; };
+
+static inline simdInt simdSet(int a)				{	simdInt r; for (int l = 0; l < SIMD_LANES; l++) { r.lane[l] = a; } return r;	}
+static inline simdInt simdLoad(const int* p)		{	simdInt r; for (int l = 0; l < SIMD_LANES; l++) { r.lane[l] = p[l]; } return r;	}
+static inline void simdStore(int* p, simdInt a)		{	for (int l = 0; l < SIMD_LANES; l++) { p[l] = a.lane[l]; }	}
+static inline simdInt simdAdd(simdInt a, simdInt b)	{	for (int l = 0; l < SIMD_LANES; l++) { a.lane[l] += b.lane[l]; } return a;	}
+static inline simdInt simdMax(simdInt a, simdInt b)	{	for (int l = 0; l < SIMD_LANES; l++) { if (b.lane[l] > a.lane[l]) { a.lane[l] = b.lane[l]; } } return a;	}
+static inline int simdMaskEqual(simdInt a, simdInt b)	{
+	int mask = 0; for (int l = 0; l < SIMD_LANES; l++) { if (a.lane[l] == b.lane[l]) { mask |= (1 << l); } } return mask;
+}
+static inline int simdMaskGreater(simdInt a, simdInt b)	{
+	int mask = 0; for (int l = 0; l < SIMD_LANES; l++) { if (a.lane[l] > b.lane[l]) { mask |= (1 << l); } } return mask;
+}
+static inline simdInt simdShiftIn(simdInt a, int first)	{
+	for (int l = SIMD_LANES-1; l > 0; l--) { a.lane[l] = a.lane[l-1]; } a.lane[0] = first; return a;
+}
+
+#endif
+
+//	low enough that adding gaps across a full row can't wrap around, high enough to never win a max
+#define STRIPED_NEG_INF -536870912
+
+/**************************************************************************************************/
+
+StripedNeedleman::StripedNeedleman(float gO, float f, float mm, int r) :
+gap(gO), match(f), mismatch(mm), Alignment(), backup(nullptr), segLength(0) {
+	try {
+		nRows = r; nCols = r;
+
+		//	the integer fill only reproduces the float scores of NeedlemanOverlap if the parameters are whole numbers
+		integerScores = true;
+		float params[3] = { gap, match, mismatch };
+		for (int i = 0; i < 3; i++) {
+			if ((params[i] != floor(params[i])) || (fabs(params[i]) > 1000)) { integerScores = false; }
+		}
+		iGap = (int)gap; iMatch = (int)match; iMismatch = (int)mismatch;
+
+		profileIndex.resize(256, -1);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "StripedNeedleman", "StripedNeedleman");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+StripedNeedleman::~StripedNeedleman(){	if (backup != nullptr) { delete backup; }	}
+
+/**************************************************************************************************/
+//	we don't keep a full matrix so the only thing to remember is the size the backup aligner needs
+void StripedNeedleman::resize(int A){
+	nRows = A; nCols = A;
+	if (backup != nullptr) { backup->resize(A); }
+}
+/**************************************************************************************************/
+
+void StripedNeedleman::align(string A, string B, bool createBaseMap){
+	try {
+		seqA = ' ' + A;	lA = seqA.length();		//	algorithm requires a dummy space at the beginning of each string
+		seqB = ' ' + B;	lB = seqB.length();		//	algorithm requires a dummy space at the beginning of each string
+
+		//	float scores are exact up to 2^24, past that or with fractional parameters let NeedlemanOverlap do the work
+		int maxParam = max(abs(iGap), max(abs(iMatch), abs(iMismatch)));
+		if (!integerScores || ((double)maxParam * (double)(lA + lB) >= 16777216.0)) {
+			if (backup == nullptr) { backup = new NeedlemanOverlap(gap, match, mismatch, nRows); }
+			backup->align(A, B, createBaseMap);
+
+			seqAaln = backup->getSeqAAln();				seqBaln = backup->getSeqBAln();
+			ABaseMap = backup->getSeqAAlnBaseMap();		BBaseMap = backup->getSeqBAlnBaseMap();
+			seqAstart = backup->getCandidateStartPos();	seqAend = backup->getCandidateEndPos();
+			seqBstart = backup->getTemplateStartPos();	seqBend = backup->getTemplateEndPos();
+			pairwiseLength = backup->getPairwiseLength();
+			return;
+		}
+
+		if (lA > nRows) { m->mothurOut("One of your candidate sequences is longer than you longest template sequence. Your longest template sequence is " + toString(nRows) + ". Your candidate is " + toString(lA) + ".\n");   }
+
+		fill();
+		stripedTraceBack(createBaseMap);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "StripedNeedleman", "align");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//	striped match/mismatch scores of seqA against the character c
+void StripedNeedleman::buildProfile(unsigned char c){
+	try {
+		int n = lA - 1;
+		int offset = profile.size();
+		profile.resize(offset + segLength * SIMD_LANES);
+
+		for (int t = 0; t < segLength; t++) {
+			for (int l = 0; l < SIMD_LANES; l++) {
+				int k = l * segLength + t;				//	padding past the end of seqA never feeds a real cell
+				if ((k < n) && ((unsigned char)seqA[k+1] == c))	{	profile[offset + t * SIMD_LANES + l] = iMatch;		}
+				else											{	profile[offset + t * SIMD_LANES + l] = iMismatch;	}
+			}
+		}
+		profileIndex[c] = offset;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "StripedNeedleman", "buildProfile");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+void StripedNeedleman::fill(){
+	try {
+		int n = lA - 1;
+
+		profile.clear();
+		for (int i = 0; i < profileIndex.size(); i++) { profileIndex[i] = -1; }
+
+		lastColumn.assign(lB, 0);		//	first row and column are zero so end gaps at the 5' end are free
+		lastRow.assign(lA, 0);
+
+		if (n == 0) { segLength = 0; return; }
+
+		segLength = (n + SIMD_LANES - 1) / SIMD_LANES;
+		int size = segLength * SIMD_LANES;
+
+		scores.assign(2 * size, 0);
+		int* prev = &scores[0];
+		int* curr = &scores[size];
+
+		if (trace.size() < (lB - 1) * segLength) { trace.resize((lB - 1) * segLength); }
+
+		int lastT = (n - 1) % segLength;
+		int lastLane = (n - 1) / segLength;
+
+		simdInt vGap = simdSet(iGap);
+
+		for (int i = 1; i < lB; i++) {
+			unsigned char c = seqB[i];
+			if (profileIndex[c] == -1) { buildProfile(c); }
+			const int* prof = &profile[profileIndex[c]];
+			unsigned short* rowTrace = &trace[(i - 1) * segLength];
+
+			simdInt vDiag = simdShiftIn(simdLoad(prev + (segLength - 1) * SIMD_LANES), 0);	//	alignment[i-1][0] is 0
+			simdInt vLeft = simdShiftIn(simdSet(STRIPED_NEG_INF), iGap);						//	alignment[i][0] + gap
+
+			for (int t = 0; t < segLength; t++) {
+				simdInt vPrev = simdLoad(prev + t * SIMD_LANES);
+
+				simdInt vD = simdAdd(vDiag, simdLoad(prof + t * SIMD_LANES));
+				simdInt vU = simdAdd(vPrev, vGap);
+				simdInt vH = simdMax(simdMax(vD, vU), vLeft);
+				simdStore(curr + t * SIMD_LANES, vH);
+
+				//	same priority as NeedlemanOverlap: diagonal, then up, then left
+				rowTrace[t] = (unsigned short)(simdMaskEqual(vD, vH) | (simdMaskEqual(vU, vH) << SIMD_LANES));
+
+				vLeft = simdAdd(vH, vGap);
+				vDiag = vPrev;
+			}
+
+			//	carry the left scores into the next lane until they stop improving anything.  a cell that improves here
+			//	came from the left, so clear its diagonal and up flags
+			vLeft = simdShiftIn(vLeft, STRIPED_NEG_INF);
+			int t = 0;
+			while (true) {
+				simdInt vH = simdLoad(curr + t * SIMD_LANES);
+				int improved = simdMaskGreater(vLeft, vH);
+				if (improved == 0) { break; }
+
+				simdStore(curr + t * SIMD_LANES, simdMax(vH, vLeft));
+				rowTrace[t] &= (unsigned short)~(improved | (improved << SIMD_LANES));
+
+				vLeft = simdAdd(vLeft, vGap);
+				if (++t == segLength) { t = 0; vLeft = simdShiftIn(vLeft, STRIPED_NEG_INF); }
+			}
+
+			lastColumn[i] = curr[lastT * SIMD_LANES + lastLane];
+			swap(prev, curr);
+		}
+
+		if (lB > 1) {
+			for (int k = 0; k < n; k++) { lastRow[k+1] = prev[(k % segLength) * SIMD_LANES + (k / segLength)]; }
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "StripedNeedleman", "fill");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//	decodes the packed traceback, applying the first row / column pointers and the Overlap end correction
+char StripedNeedleman::getPrevCell(int row, int column, int rowIndex, int colIndex, char overlap){
+
+	if ((row == 0) && (column == 0))	{	return 'x';	}
+	if (row == 0)						{	return 'l';	}
+	if (column == 0)					{	return 'u';	}
+
+	if ((overlap == 'u') && (column == lA - 1) && (row > rowIndex))		{	return 'u';	}
+	if ((overlap == 'l') && (row == lB - 1) && (column > colIndex))		{	return 'l';	}
+
+	int k = column - 1;
+	int bits = trace[(row - 1) * segLength + (k % segLength)];
+	int lane = k / segLength;
+
+	if ((bits >> lane) & 1)						{	return 'd';	}
+	if ((bits >> (SIMD_LANES + lane)) & 1)		{	return 'u';	}
+	return 'l';
+}
+/**************************************************************************************************/
+
+void StripedNeedleman::stripedTraceBack(bool createBaseMap){
+	try {
+		int row = lB - 1;
+		int column = lA - 1;
+
+		//	same search as Overlap::setOverlap for the highest score in the right most column and bottom row
+		int rowIndex = row;	int maxScore = -100;
+		for (int i = 0; i < lB; i++) {	if (lastColumn[i] >= maxScore) { rowIndex = i; maxScore = lastColumn[i]; }	}
+
+		int colIndex = column;	maxScore = -100;
+		for (int i = 0; i < lA; i++) {	if (lastRow[i] >= maxScore) { colIndex = i; maxScore = lastRow[i]; }	}
+
+		char overlap = 'x';
+		if ((colIndex == column) && (rowIndex == row))				{	}
+		else if (lastRow[colIndex] < lastColumn[rowIndex])			{	overlap = 'u';	}
+		else														{	overlap = 'l';	}
+
+		BBaseMap.clear();
+		ABaseMap.clear();
+		seqAaln = "";
+		seqBaln = "";
+
+		char prevCell = getPrevCell(row, column, rowIndex, colIndex, overlap);
+
+		if (prevCell == 'x') {	seqAaln = seqBaln = "NOALIGNMENT";	}
+		else {
+			seqAaln.reserve(lA + lB);	seqBaln.reserve(lA + lB);
+
+			int count = 0;
+			while (prevCell != 'x') {					//	built back to front and reversed at the end
+				if (prevCell == 'u') {
+					seqAaln += '-';
+					seqBaln += seqB[row];
+					if (createBaseMap) { BBaseMap[row] = count; }
+					--row;
+				}
+				else if (prevCell == 'l') {
+					seqBaln += '-';
+					seqAaln += seqA[column];
+					if (createBaseMap) { ABaseMap[column] = count; }
+					--column;
+				}
+				else {
+					seqAaln += seqA[column];
+					seqBaln += seqB[row];
+					if (createBaseMap) {
+						BBaseMap[row] = count;
+						ABaseMap[column] = count;
+					}
+					--row; --column;
+				}
+				if ((row >= 0) && (column >= 0)) { prevCell = getPrevCell(row, column, rowIndex, colIndex, overlap); }
+				else { break; }
+				count++;
+			}
+
+			reverse(seqAaln.begin(), seqAaln.end());
+			reverse(seqBaln.begin(), seqBaln.end());
+		}
+
+		finishTraceBack(createBaseMap);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "StripedNeedleman", "stripedTraceBack");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
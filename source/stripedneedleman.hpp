@@ -0,0 +1,61 @@
+#ifndef STRIPEDNEEDLEMAN_H
+#define STRIPEDNEEDLEMAN_H
+
+/*
+ *  stripedneedleman.hpp
+ *
+ *
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ *	This class is an Alignment child class that implements the same Needleman-Wunsch alignment as NeedlemanOverlap,
+ *	but fills the dynamic programming matrix with the striped SIMD method described in:
+ *
+ *		Farrar M. 2007.  Striped Smith-Waterman speeds database searches six times over other SIMD implementations.
+ *			Bioinformatics.  23:156-61.
+ *
+ *	Scores are kept as integers in AVX2, SSE2 or plain scalar lanes depending on what the compiler targets, only two
+ *	rows of scores are held at a time, and the traceback is stored as 2 bits per cell (diagonal and up flags).  The
+ *	tie breaking and the Overlap end correction match NeedlemanOverlap, so the aligned strings and start/end positions
+ *	are identical.  If the scoring parameters are not whole numbers we hand the pair to NeedlemanOverlap instead.
+ *
+ */
+
+#include "mothur.h"
+#include "alignment.hpp"
+#include "needlemanoverlap.hpp"
+
+/**************************************************************************************************/
+
+class StripedNeedleman : public Alignment {
+
+public:
+	StripedNeedleman(float, float, float, int);
+	~StripedNeedleman();
+	void align(string, string, bool createBaseMap=false);
+	void resize(int);
+
+private:
+	float gap;
+	float match;
+	float mismatch;
+	bool integerScores;
+	int iGap, iMatch, iMismatch;
+
+	int segLength;                      //number of vectors needed to hold seqA in the striped layout
+	vector<int> scores;                 //two rows of striped scores, current and previous
+	vector<int> profile;                //striped match/mismatch scores of seqA for each character found in seqB
+	vector<int> profileIndex;           //character -> offset into profile, -1 if not built for this pair
+	vector<unsigned short> trace;       //per row and vector, low lanes are the diagonal flags, high lanes the up flags
+	vector<int> lastColumn;             //scores of the right most column, needed by the overlap correction
+	vector<int> lastRow;                //scores of the bottom row, needed by the overlap correction
+	NeedlemanOverlap* backup;
+
+	void fill();
+	void buildProfile(unsigned char);
+	char getPrevCell(int, int, int, int, char);
+	void stripedTraceBack(bool);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -30,21 +30,14 @@ Tree* SubSample::getSample(Tree* T, CountTable* ct, CountTable* newCt, int size,
                 if (thisSize >= size) {	
                     
                     vector<string> names = ct->getNamesOfSeqs(Groups[i]);
-                    vector<int> random;
-                    for (int j = 0; j < names.size(); j++) {
-                        int num = ct->getGroupCount(names[j], Groups[i]);
-                        for (int k = 0; k < num; k++) { random.push_back(j); }
-                    }
-                    util.mothurRandomShuffle(random);
+                    vector<int> abunds;
+                    for (int j = 0; j < names.size(); j++) { abunds.push_back(ct->getGroupCount(names[j], Groups[i])); }
                     
-                    vector<int> sampleRandoms; sampleRandoms.resize(names.size(), 0);
-                    for (int j = 0; j < size; j++) { sampleRandoms[random[j]]++; }
+                    vector<int> sampleRandoms = drawCounts(abunds, size);
                     for (int j = 0; j < sampleRandoms.size(); j++) {
                         newCt->setAbund(names[j], Groups[i], sampleRandoms[j]);
+                        doNotIncludeTotals[names[j]] += (abunds[j] - sampleRandoms[j]);
                     }
-                    sampleRandoms.clear(); sampleRandoms.resize(names.size(), 0);
-                    for (int j = size; j < thisSize; j++) { sampleRandoms[random[j]]++; }
-                    for (int j = 0; j < sampleRandoms.size(); j++) {  doNotIncludeTotals[names[j]] += sampleRandoms[j]; }
                 }else {  m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->setControl_pressed(true); }
             }
 
@@ -232,6 +225,85 @@ set<long long> SubSample::getWeightedSample(map<long long, long long> & nameMap,
     }
 }
 //**********************************************************************************************************************
+//draws num reads without replacement, one bin at a time from a fenwick tree of the abundances, so each draw takes log(numBins)
+//steps instead of shuffling one entry per read. if num is more than half the reads, draws the reads left out instead.
+vector<int> SubSample::drawCounts(const vector<int>& abunds, long long num) {
+    try {
+        int numBins = abunds.size();
+        vector<int> counts(numBins, 0);
+        
+        long long total = 0;
+        for (int i = 0; i < numBins; i++) { total += abunds[i]; }
+        if (num >= total) { return abunds; }
+        
+        bool leaveOut = (num > (total / 2));
+        long long numDraws = num;
+        if (leaveOut) { numDraws = total - num; }
+        
+        //tree[i] is the sum of the abundances of bins i-lowbit(i) to i-1
+        vector<long long> tree(numBins+1, 0);
+        for (int i = 1; i <= numBins; i++) {
+            tree[i] += abunds[i-1];
+            int parent = i + (i & -i);
+            if (parent <= numBins) { tree[parent] += tree[i]; }
+        }
+        int topBit = 1; while ((topBit * 2) <= numBins) { topBit *= 2; }
+        
+        long long remaining = total;
+        for (long long j = 0; j < numDraws; j++) {
+            if (m->getControl_pressed()) { return counts; }
+            
+            //find the bin holding read number random
+            long long random = util.getRandomIndex(remaining-1);
+            int pos = 0;
+            for (int bit = topBit; bit > 0; bit /= 2) {
+                int next = pos + bit;
+                if ((next <= numBins) && (tree[next] <= random)) { pos = next; random -= tree[next]; }
+            }
+            
+            counts[pos]++;
+            for (int i = pos+1; i <= numBins; i += (i & -i)) { tree[i]--; }
+            remaining--;
+        }
+        
+        if (leaveOut) { for (int i = 0; i < numBins; i++) { counts[i] = abunds[i] - counts[i]; } }
+        
+        return counts;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SubSample", "drawCounts");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+//draws num reads with replacement, finding each read's bin in the running total of the abundances
+vector<int> SubSample::drawCountsWithReplacement(const vector<int>& abunds, long long num) {
+    try {
+        int numBins = abunds.size();
+        vector<int> counts(numBins, 0);
+        
+        vector<long long> runningTotal(numBins, 0);
+        long long total = 0;
+        for (int i = 0; i < numBins; i++) { total += abunds[i]; runningTotal[i] = total; }
+        if (total == 0) { return counts; }
+        
+        for (long long j = 0; j < num; j++) {
+            if (m->getControl_pressed()) { return counts; }
+            
+            //"grab random from bag"
+            long long randomRead = util.getRandomIndex(total-1);
+            int bin = upper_bound(runningTotal.begin(), runningTotal.end(), randomRead) - runningTotal.begin();
+            counts[bin]++;
+        }
+        
+        return counts;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SubSample", "drawCountsWithReplacement");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
 vector<string> SubSample::getSample(vector<SharedRAbundVector*>& rabunds, int size, vector<string> currentLabels) {
     try {
         
@@ -245,22 +317,17 @@ vector<string> SubSample::getSample(vector<SharedRAbundVector*>& rabunds, int si
             
             if (thisSize != size) {
                 
-                vector<int> order;
-                for (int j = 0; j < rabunds[i]->size(); j++) {
-                    int abund = rabunds[i]->get(j);
-                    for(int k=0;k<abund;k++){ order.push_back(j);  }
-                }
+                vector<int> abunds;
+                for (int j = 0; j < rabunds[i]->size(); j++) { abunds.push_back(rabunds[i]->get(j)); }
                 
-                util.mothurRandomShuffle(order);
+                vector<int> counts = drawCounts(abunds, size); //only allows you to select a read once
+                if (m->getControl_pressed()) {  delete newLookup; return currentLabels; }
                 
                 SharedRAbundVector* temp = new SharedRAbundVector(numBins);
                 temp->setLabel(rabunds[i]->getLabel());
                 temp->setGroup(rabunds[i]->getGroup());
                 
-                for (int j = 0; j < size; j++) { //only allows you to select a read once
-                    if (m->getControl_pressed()) {  return currentLabels; }
-                    temp->increment(order[j]);
-                }
+                for (int j = 0; j < counts.size(); j++) { if (counts[j] != 0) { temp->set(j, counts[j]); } }
                 newLookup->push_back(temp);
             }else { SharedRAbundVector* temp = new SharedRAbundVector(*rabunds[i]); newLookup->push_back(temp); }
         }
@@ -293,23 +360,17 @@ vector<string> SubSample::getSampleWithReplacement(vector<SharedRAbundVector*>&
         int numBins = rabunds[0]->getNumBins();
         for (int i = 0; i < rabunds.size(); i++) {
 
-            vector<int> order;
-            for (int j = 0; j < rabunds[i]->size(); j++) {
-                int abund = rabunds[i]->get(j);
-                for(int k=0;k<abund;k++){ order.push_back(j);  }
-            }
+            vector<int> abunds;
+            for (int j = 0; j < rabunds[i]->size(); j++) { abunds.push_back(rabunds[i]->get(j)); }
+            
+            vector<int> counts = drawCountsWithReplacement(abunds, size); //allows you to select a read multiple times
+            if (m->getControl_pressed()) {  delete newLookup; return currentLabels; }
             
             SharedRAbundVector* temp = new SharedRAbundVector(numBins);
             temp->setLabel(rabunds[i]->getLabel());
             temp->setGroup(rabunds[i]->getGroup());
             
-            long long orderSize = order.size()-1;
-            for (int j = 0; j < size; j++) { //allows you to select a read multiple times
-                if (m->getControl_pressed()) {  return currentLabels; }
-                //"grab random from bag"
-                long long randomRead = util.getRandomIndex(orderSize);
-                temp->increment(order[randomRead]);
-            }
+            for (int j = 0; j < counts.size(); j++) { if (counts[j] != 0) { temp->set(j, counts[j]); } }
             newLookup->push_back(temp);
 
         }
@@ -384,21 +445,17 @@ int SubSample::getSample(SAbundVector*& sabund, int size) {
         int numBins = sabund->getNumBins();
         int thisSize = sabund->getNumSeqs();
 
-        OrderVector order = sabund->getOrderVector();
-        
 		if (thisSize > size) {
-			util.mothurRandomShuffle(order);
+            RAbundVector wholeRabund = sabund->getRAbundVector();
+            vector<int> abunds;
+            for (int j = 0; j < wholeRabund.getNumBins(); j++) { abunds.push_back(wholeRabund.get(j)); }
+            
+            vector<int> counts = drawCounts(abunds, size);
+            if (m->getControl_pressed()) { return 0; }
 			
             RAbundVector rabund(numBins);
 			rabund.setLabel(sabund->getLabel());
-
-			for (int j = 0; j < size; j++) {
-                
-				if (m->getControl_pressed()) { return 0; }
-				
-                int abund = rabund.get(order.get(j));
-				rabund.set(order.get(j), (abund+1));
-			}
+            for (int j = 0; j < counts.size(); j++) { rabund.set(j, counts[j]); }
 
             delete sabund;
             sabund = new SAbundVector();
@@ -421,23 +478,17 @@ int SubSample::getSampleWithReplacement(SAbundVector*& sabund, int size) {
         int numBins = sabund->getNumBins();
         int thisSize = sabund->getNumSeqs();
         
-        OrderVector order = sabund->getOrderVector();
-        
         if (thisSize > size) {
+            RAbundVector wholeRabund = sabund->getRAbundVector();
+            vector<int> abunds;
+            for (int j = 0; j < wholeRabund.getNumBins(); j++) { abunds.push_back(wholeRabund.get(j)); }
+            
+            vector<int> counts = drawCountsWithReplacement(abunds, size);
+            if (m->getControl_pressed()) { return 0; }
+            
             RAbundVector rabund(numBins);
             rabund.setLabel(sabund->getLabel());
-            
-            long long orderSize = order.size()-1;
-            for (int j = 0; j < size; j++) {
-                
-                if (m->getControl_pressed()) { return 0; }
-                
-                //"grab random from bag"
-                long long randomRead = util.getRandomIndex(orderSize);
-                
-                int abund = rabund.get(order.get(randomRead));
-                rabund.set(order.get(randomRead), (abund+1));
-            }
+            for (int j = 0; j < counts.size(); j++) { rabund.set(j, counts[j]); }
             
             delete sabund;
             sabund = new SAbundVector();
@@ -457,24 +508,18 @@ int SubSample::getSampleWithReplacement(SAbundVector*& sabund, int size) {
 int SubSample::getSample(RAbundVector*& rabund, int size) {
     try {
         
-        int numBins = rabund->getNumBins();
         int thisSize = rabund->getNumSeqs();
         
-        OrderVector order = rabund->getOrderVector(nullptr);
-        
         if (thisSize > size) {
-            util.mothurRandomShuffle(order);
+            vector<int> abunds;
+            for (int j = 0; j < rabund->size(); j++) { abunds.push_back(rabund->get(j)); }
             
-            RAbundVector sampledRabund(numBins);
-            sampledRabund.setLabel(rabund->getLabel());
+            vector<int> counts = drawCounts(abunds, size);
+            if (m->getControl_pressed()) { return 0; }
             
-            for (int j = 0; j < size; j++) {
-                
-                if (m->getControl_pressed()) { return 0; }
-                
-                int abund = sampledRabund.get(order.get(j));
-                sampledRabund.set(order.get(j), (abund+1));
-            }
+            RAbundVector sampledRabund(counts.size());
+            sampledRabund.setLabel(rabund->getLabel());
+            for (int j = 0; j < counts.size(); j++) { sampledRabund.set(j, counts[j]); }
             
             delete rabund;
             rabund = new RAbundVector(sampledRabund);
@@ -493,26 +538,18 @@ int SubSample::getSample(RAbundVector*& rabund, int size) {
 int SubSample::getSampleWithReplacement(RAbundVector*& rabund, int size) {
     try {
         
-        int numBins = rabund->getNumBins();
         int thisSize = rabund->getNumSeqs();
         
-        OrderVector order = rabund->getOrderVector(nullptr);
-        
         if (thisSize > size) {
-            RAbundVector sampledRabund(numBins);
-            sampledRabund.setLabel(rabund->getLabel());
+            vector<int> abunds;
+            for (int j = 0; j < rabund->size(); j++) { abunds.push_back(rabund->get(j)); }
             
-            long long orderSize = order.size()-1;
-            for (int j = 0; j < size; j++) {
-                
-                if (m->getControl_pressed()) { return 0; }
-                
-                //"grab random from bag"
-                long long randomRead = util.getRandomIndex(orderSize);
-                
-                int abund = sampledRabund.get(order.get(randomRead));
-                sampledRabund.set(order.get(randomRead), (abund+1));
-            }
+            vector<int> counts = drawCountsWithReplacement(abunds, size);
+            if (m->getControl_pressed()) { return 0; }
+            
+            RAbundVector sampledRabund(counts.size());
+            sampledRabund.setLabel(rabund->getLabel());
+            for (int j = 0; j < counts.size(); j++) { sampledRabund.set(j, counts[j]); }
             
             delete rabund;
             rabund = new RAbundVector(sampledRabund);
@@ -539,31 +576,32 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups,
             sampledCt.addGroup(Groups[i]);
             
             vector<string> names = ct.getNamesOfSeqs(Groups[i]);
-            vector<int> allNames;
+            vector<int> abunds; long long numReads = 0;
             for (int j = 0; j < names.size(); j++) {
                 
                 if (m->getControl_pressed()) { return sampledCt; }
                 
                 int num = ct. getGroupCount(names[j], Groups[i]);
-                for (int k = 0; k < num; k++) { allNames.push_back(j); }
+                abunds.push_back(num); numReads += num;
             }
             
-            util.mothurRandomShuffle(allNames);
-            
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->setControl_pressed(true); }
+            if (numReads < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->setControl_pressed(true); }
             else{
-                for (int j = 0; j < size; j++) {
+                vector<int> counts = drawCounts(abunds, size);
+                
+                for (int j = 0; j < counts.size(); j++) {
                     
                     if (m->getControl_pressed()) { return sampledCt; }
+                    if (counts[j] == 0) { continue; }
                     
-                    map<string, vector<int> >::iterator it = tempCount.find(names[allNames[j]]);
+                    map<string, vector<int> >::iterator it = tempCount.find(names[j]);
                     
                     if (it == tempCount.end()) { //we have not seen this sequence at all yet
                         vector<int> tempGroups; tempGroups.resize(Groups.size(), 0);
-                        tempGroups[i]++;
-                        tempCount[names[allNames[j]]] = tempGroups;
+                        tempGroups[i] += counts[j];
+                        tempCount[names[j]] = tempGroups;
                     }else{
-                        tempCount[names[allNames[j]]][i]++;
+                        tempCount[names[j]][i] += counts[j];
                     }
                 }
             }
@@ -595,34 +633,32 @@ CountTable SubSample::getSampleWithReplacement(CountTable& ct, int size, vector<
             sampledCt.addGroup(Groups[i]);
             
             vector<string> names = ct.getNamesOfSeqs(Groups[i]);
-            vector<int> allNames;
+            vector<int> abunds; long long numReads = 0;
             for (int j = 0; j < names.size(); j++) {
                 
                 if (m->getControl_pressed()) { return sampledCt; }
                 
                 int num = ct.getGroupCount(names[j], Groups[i]);
-                for (int k = 0; k < num; k++) { allNames.push_back(j); }
+                abunds.push_back(num); numReads += num;
             }
             
-            long long allNamesSize = allNames.size()-1;
-            
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->setControl_pressed(true); }
+            if (numReads < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->setControl_pressed(true); }
             else{
-                for (int j = 0; j < size; j++) {
+                vector<int> counts = drawCountsWithReplacement(abunds, size);
+                
+                for (int j = 0; j < counts.size(); j++) {
                     
                     if (m->getControl_pressed()) { return sampledCt; }
+                    if (counts[j] == 0) { continue; }
                     
-                    //"grab random from bag"
-                    long long randomRead = util.getRandomIndex(allNamesSize);
-                    
-                    map<string, vector<int> >::iterator it = tempCount.find(names[allNames[randomRead]]);
+                    map<string, vector<int> >::iterator it = tempCount.find(names[j]);
                     
                     if (it == tempCount.end()) { //we have not seen this sequence at all yet
                         vector<int> tempGroups; tempGroups.resize(Groups.size(), 0);
-                        tempGroups[i]++;
-                        tempCount[names[allNames[randomRead]]] = tempGroups;
+                        tempGroups[i] += counts[j];
+                        tempCount[names[j]] = tempGroups;
                     }else{
-                        tempCount[names[allNames[randomRead]]][i]++;
+                        tempCount[names[j]][i] += counts[j];
                     }
                 }
             }
@@ -752,34 +788,28 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups)
             for (int i = 0; i < Groups.size(); i++) { sampledCt.addGroup(Groups[i]);  }
                 
             vector<string> names = ct.getNamesOfSeqs(Groups); //names of sequences in groups
-            vector<intPair> allNames;
+            vector<int> abunds; long long numReads = 0; //abunds[j*Groups.size()+i] is the num reads in group i from seq j
             for (int j = 0; j < names.size(); j++) {
-                    
+                
                 if (m->getControl_pressed()) { return sampledCt; }
                 
                 for (int i = 0; i < Groups.size(); i++) {
                     int num = ct.getGroupCount(names[j], Groups[i]); //num reads in this group from this seq
-                    intPair thisSeq(j,i);
-                    for (int k = 0; k < num; k++) { allNames.push_back(thisSeq); }
+                    abunds.push_back(num); numReads += num;
                 }
             }
-                
-            util.mothurRandomShuffle(allNames);
-                
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); }
+            
+            if (numReads < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); }
             else{
-                for (int j = 0; j < size; j++) {
-                        
+                vector<int> counts = drawCounts(abunds, size);
+                
+                for (int j = 0; j < names.size(); j++) {
+                    
                     if (m->getControl_pressed()) { return sampledCt; }
-                        
-                    map<string, vector<int> >::iterator it = tempCount.find(names[allNames[j].abund]);
-                        
-                    if (it == tempCount.end()) { //we have not seen this sequence at all yet
-                        vector<int> tempGroups; tempGroups.resize(Groups.size(), 0);
-                        tempGroups[allNames[j].group]++;
-                        tempCount[names[allNames[j].abund]] = tempGroups;
-                    }else{
-                        tempCount[names[allNames[j].abund]][allNames[j].group]++;
+                    
+                    vector<int> tempGroups(counts.begin()+(j*Groups.size()), counts.begin()+((j+1)*Groups.size()));
+                    for (int i = 0; i < tempGroups.size(); i++) {
+                        if (tempGroups[i] != 0) { tempCount[names[j]] = tempGroups; break; }
                     }
                 }
             }
@@ -793,32 +823,21 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups)
 
         }else { //no groups
             vector<string> names = ct.getNamesOfSeqs();
-            map<int, int> nameMap;
-            vector<int> allNames;
+            vector<int> abunds; long long numReads = 0;
             
             for (int i = 0; i < names.size(); i++) {
                 int num = ct.getNumSeqs(names[i]);
-                for (int j = 0; j < num; j++) { allNames.push_back(i); }
+                abunds.push_back(num); numReads += num;
             }
             
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); return sampledCt; }
+            if (numReads < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); return sampledCt; }
             else {
-                util.mothurRandomShuffle(allNames);
-                
-                for (int j = 0; j < size; j++) {
-                    if (m->getControl_pressed()) { return sampledCt; }
-                    
-                    map<int, int>::iterator it = nameMap.find(allNames[j]);
-                    
-                    //we have not seen this sequence at all yet
-                    if (it == nameMap.end()) { nameMap[allNames[j]] = 1;  }
-                    else{  nameMap[allNames[j]]++;  }
-                }
+                vector<int> counts = drawCounts(abunds, size);
+                if (m->getControl_pressed()) { return sampledCt; }
                 
                 //build count table
-                for (map<int, int>::iterator it = nameMap.begin(); it != nameMap.end();) {
-                    sampledCt.push_back(names[it->first], it->second);
-                    nameMap.erase(it++);
+                for (int i = 0; i < counts.size(); i++) {
+                    if (counts[i] != 0) { sampledCt.push_back(names[i], counts[i]); }
                 }
             }
         }
@@ -842,36 +861,28 @@ CountTable SubSample::getSampleWithReplacement(CountTable& ct, int size, vector<
             for (int i = 0; i < Groups.size(); i++) { sampledCt.addGroup(Groups[i]);  }
             
             vector<string> names = ct.getNamesOfSeqs(Groups); //names of sequences in groups
-            vector<intPair> allNames;
+            vector<int> abunds; long long numReads = 0; //abunds[j*Groups.size()+i] is the num reads in group i from seq j
             for (int j = 0; j < names.size(); j++) {
                 
                 if (m->getControl_pressed()) { return sampledCt; }
                 
                 for (int i = 0; i < Groups.size(); i++) {
                     int num = ct.getGroupCount(names[j], Groups[i]); //num reads in this group from this seq
-                    intPair thisSeq(j,i);
-                    for (int k = 0; k < num; k++) { allNames.push_back(thisSeq); }
+                    abunds.push_back(num); numReads += num;
                 }
             }
             
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); }
+            if (numReads < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); }
             else{
-                long long allNamesSize = allNames.size()-1;
+                vector<int> counts = drawCountsWithReplacement(abunds, size);
                 
-                for (int j = 0; j < size; j++) {
+                for (int j = 0; j < names.size(); j++) {
                     
                     if (m->getControl_pressed()) { return sampledCt; }
                     
-                    long long randomRead = util.getRandomIndex(allNamesSize);
-                    
-                    map<string, vector<int> >::iterator it = tempCount.find(names[allNames[randomRead].abund]);
-                    
-                    if (it == tempCount.end()) { //we have not seen this sequence at all yet
-                        vector<int> tempGroups; tempGroups.resize(Groups.size(), 0);
-                        tempGroups[allNames[randomRead].group]++;
-                        tempCount[names[allNames[randomRead].abund]] = tempGroups;
-                    }else{
-                        tempCount[names[allNames[randomRead].abund]][allNames[randomRead].group]++;
+                    vector<int> tempGroups(counts.begin()+(j*Groups.size()), counts.begin()+((j+1)*Groups.size()));
+                    for (int i = 0; i < tempGroups.size(); i++) {
+                        if (tempGroups[i] != 0) { tempCount[names[j]] = tempGroups; break; }
                     }
                 }
             }
@@ -885,34 +896,21 @@ CountTable SubSample::getSampleWithReplacement(CountTable& ct, int size, vector<
             
         }else { //no groups
             vector<string> names = ct.getNamesOfSeqs();
-            map<int, int> nameMap;
-            vector<int> allNames;
+            vector<int> abunds; long long numReads = 0;
             
             for (int i = 0; i < names.size(); i++) {
                 int num = ct.getNumSeqs(names[i]);
-                for (int j = 0; j < num; j++) { allNames.push_back(i); }
+                abunds.push_back(num); numReads += num;
             }
             
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); return sampledCt; }
+            if (numReads < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->setControl_pressed(true); return sampledCt; }
             else {
-                long long allNamesSize = allNames.size()-1;
-                
-                for (int j = 0; j < size; j++) {
-                    if (m->getControl_pressed()) { return sampledCt; }
-                    
-                    long long randomRead = util.getRandomIndex(allNamesSize);
-                    
-                    map<int, int>::iterator it = nameMap.find(allNames[randomRead]);
-                    
-                    //we have not seen this sequence at all yet
-                    if (it == nameMap.end()) { nameMap[allNames[randomRead]] = 1;  }
-                    else{  nameMap[allNames[randomRead]]++;  }
-                }
+                vector<int> counts = drawCountsWithReplacement(abunds, size);
+                if (m->getControl_pressed()) { return sampledCt; }
                 
                 //build count table
-                for (map<int, int>::iterator it = nameMap.begin(); it != nameMap.end();) {
-                    sampledCt.push_back(names[it->first], it->second);
-                    nameMap.erase(it++);
+                for (int i = 0; i < counts.size(); i++) {
+                    if (counts[i] != 0) { sampledCt.push_back(names[i], counts[i]); }
                 }
             }
         }
@@ -21,6 +21,10 @@
 //subsampling overwrites the sharedRabunds.  If you need to reuse the original use the getSamplePreserve function.
 
 class SubSample {
+    
+#ifdef UNIT_TEST
+    friend class TestSubSample;
+#endif
 	
     public:
     
@@ -51,10 +55,14 @@ class SubSample {
     
         set<long long> getWeightedSample(map<long long, long long>&, long long); //map of sequence names -> weight (could be abundance or some other measure), num to sample
     
+        void setIteration(long long iter) { util.setRandomStream(iter); } //reseeds the random numbers, so an iteration draws the same sample no matter which processor runs it
+    
     private:
     
         MothurOut* m;
         Utils util;
+        vector<int> drawCounts(const vector<int>&, long long); //abundance of each bin, num to sample. returns the number of reads sampled from each bin, without expanding the reads
+        vector<int> drawCountsWithReplacement(const vector<int>&, long long); //abundance of each bin, num to sample. a read may be sampled more than once
         map<string, string> deconvolute(map<string, string> wholeSet, vector<string>& subsampleWanted); //returns new nameMap containing only subsampled names, and removes redundants from subsampled wanted because it makes the new nameMap.
         GroupMap getSample(GroupMap&, int, vector<string> groupsWanted);
         CountTable getSample(CountTable&, int, vector<string>); //subsample a countTable bygroup(same number sampled from each group), returns subsampled countTable
@@ -9,6 +9,7 @@
 #include "summary.hpp"
 #include "contigsreport.hpp"
 #include "alignreport.hpp"
+#include "sequencereader.hpp"
 
 //**********************************************************************************************************************
 void Summary::processNameCount(string n) { //name or count file to include in counts
@@ -230,24 +231,20 @@ void driverSummarize(seqSumData* params) { //(string fastafile, string output, l
         ofstream out;
         if (params->summaryFile != "") { params->util.openOutputFile(params->summaryFile, out); }
 
-        ifstream in; params->util.openInputFile(params->filename, in);
-        in.seekg(params->start);
+        SequenceReader reader(params->filename, (unsigned long long)params->start);
 
         //print header if you are process 0
         if (params->start == 0) {
-            params->util.zapGremlins(in); gobble(in);
-            //print header if you are process 0
             if (params->summaryFile != "") { out << "seqname\tstart\tend\tnbases\tambigs\tpolymer\tnumSeqs" << endl; }
         }
 
-        bool done = false;
         params->count = 0;
 
-        while (!done) {
+        while (reader.readFasta()) {
 
             if (params->m->getControl_pressed()) {  break; }
 
-            Sequence seq(in); gobble(in);
+            Sequence seq = reader.getSequence();
 
             if (seq.getName() != "") {
 
@@ -308,15 +305,13 @@ void driverSummarize(seqSumData* params) { //(string fastafile, string output, l
             }
 
 #if defined NON_WINDOWS
-            unsigned long long pos = in.tellg();
-            if ((pos == -1) || (pos >= params->end)) { break; }
+            if (reader.getPosition() >= params->end) { break; }
 #else
             if (params->count == params->end) { break; }
 #endif
         }
 
         if (params->summaryFile != "") { out.close(); }
-        in.close();
 
     }
     catch(exception& e) {
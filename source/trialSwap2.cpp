@@ -4,7 +4,7 @@
 //The sum_of_squares, havel_hakimi and calc_c_score algorithms have been adapted from I. Miklos and J. Podani. 2004. Randomization of presence-absence matrices: comments and new algorithms. Ecology 85:86-92.
 
 
-double TrialSwap2::calc_c_score (vector<vector<int> > &co_matrix, vector<int> rowtotal, int ncols, int nrows)
+double TrialSwap2::calc_c_score (OccupancyMatrix &co_matrix, vector<int>& rowtotal, int ncols, int nrows)
 {
     try {
         double cscore = 0.0;
@@ -12,26 +12,18 @@ double TrialSwap2::calc_c_score (vector<vector<int> > &co_matrix, vector<int> ro
         double D;
         double normcscore = 0.0;
         int nonzeros = 0;
-        //int ncols = co_matrix[0].size(); int nrows = rowtotal.size();
-        vector<vector<double> > s; s.resize(nrows);
-        for (int i = 0; i < nrows; i++) { s[i].resize(nrows,0.0); }//only fill half the matrix
-        
         
         for(int i=0;i<nrows-1;i++)
         {
+            if (m->getControl_pressed()) { return 0; }
             
             for(int j=i+1;j<nrows;j++)
             {
-                if (m->getControl_pressed()) { return 0; }
-                for(int k=0;k<ncols;k++)
-                {
-                    if((co_matrix[i][k]==1)&&(co_matrix[j][k]==1)) //if both are 1s ie co-occurrence
-                        s[i][j]++; //s counts co-occurrences
-                }
+                //rowtotal[i] = A, rowtotal[j] = B, ncols = P, s = J
+                double s = co_matrix.getNumShared(i, j); //s counts co-occurrences
                 
-                //rowtotal[i] = A, rowtotal[j] = B, ncols = P, s[i][j] = J
-                cscore += (rowtotal[i]-s[i][j])*(rowtotal[j]-s[i][j]);///(nrows*(nrows-1)/2);
-                D = (rowtotal[i]-s[i][j])*(rowtotal[j]-s[i][j]);
+                cscore += (rowtotal[i]-s)*(rowtotal[j]-s);///(nrows*(nrows-1)/2);
+                D = (rowtotal[i]-s)*(rowtotal[j]-s);
                 
                 if(ncols < (rowtotal[i] + rowtotal[j]))
                 {
@@ -61,31 +53,19 @@ double TrialSwap2::calc_c_score (vector<vector<int> > &co_matrix, vector<int> ro
     }
 }
 /**************************************************************************************************/
-int TrialSwap2::calc_checker (vector<vector<int> > &co_matrix, vector<int> rowtotal, int ncols, int nrows)
+int TrialSwap2::calc_checker (OccupancyMatrix &co_matrix, vector<int>& rowtotal, int ncols, int nrows)
 {
     try {
         int cunits=0;
-        //int s[nrows][ncols];
-        //int ncols = co_matrix[0].size(); int nrows = rowtotal.size();
-        vector<vector<int> > s; s.resize(nrows);
-        for (int i = 0; i < nrows; i++) { s[i].resize(nrows,0); }//only fill half the matrix
         
         for(int i=0;i<nrows-1;i++)
         {
+            if (m->getControl_pressed()) { return 0; }
+            
             for(int j=i+1;j<nrows;j++)
             {
-                if (m->getControl_pressed()) { return 0; }
-                //s[i][j]=0;
-                for(int k=0;k<ncols;k++)
-                {
-                    
-                    //iterates through the row and counts co-occurrences. The total number of co-occurrences for each row pair is kept in matrix s at location s[i][j].
-                    if((co_matrix[i][k]==1)&&(co_matrix[j][k]==1)) //if both are 1s ie co-occurrence
-                        s[i][j]++; //s counts co-occurrences
-                    
-                }
-               
-                if (s[i][j] == 0) {  cunits+=1; }
+                //the number of co-occurrences of the row pair
+                if (co_matrix.getNumShared(i, j) == 0) {  cunits+=1; }
             }
         }
         
@@ -97,7 +77,7 @@ int TrialSwap2::calc_checker (vector<vector<int> > &co_matrix, vector<int> rowto
     }
 }
 /**************************************************************************************************/
-double TrialSwap2::calc_vratio (int nrows, int ncols, vector<int> rowtotal, vector<int> columntotal)
+double TrialSwap2::calc_vratio (int nrows, int ncols, vector<int>& rowtotal, vector<int>& columntotal)
 {
     try {
         //int nrows = rowtotal.size();
@@ -138,47 +118,25 @@ double TrialSwap2::calc_vratio (int nrows, int ncols, vector<int> rowtotal, vect
     
 }
 /**************************************************************************************************/
-int TrialSwap2::calc_combo (int nrows, int ncols, vector<vector<int> > &nullmatrix)
+int TrialSwap2::calc_combo (int nrows, int ncols, OccupancyMatrix &nullmatrix)
 {
     try {
-        //need to transpose so we can compare rows (row-major order)
-        //int tmpnrows = nrows;
-        vector<vector<int> > tmpmatrix;
-        
-        vector<int> tmprow;
-        if(!tmpmatrix.empty())
-            tmpmatrix.clear();
-        for (int i=0;i<ncols;i++)
+        //need to transpose so we can compare columns (the species combinations) a word at a time
+        OccupancyMatrix tmpmatrix(ncols, nrows);
+        for (int i=0;i<nrows;i++)
         {
-            for (int j=0;j<nrows;j++)
+            if (m->getControl_pressed()) { return 0; }
+            for (int j=0;j<ncols;j++)
             {
-                tmprow.push_back(nullmatrix[j][i]);
+                if (nullmatrix.get(i, j) == 1) { tmpmatrix.set(j, i); }
             }
-            
-            tmpmatrix.push_back(tmprow);
-            tmprow.clear();
         }
         
-        int unique = 0;
-        int match = 0;
-        for(int j=0;j<ncols;j++)
-        {
-            match = 0;
-            for(int i=j+1;i<=ncols;i++)
-            {
-                //comparing matrix rows
-                if( (tmpmatrix[j] == tmpmatrix[i]))
-                {
-                    match++;
-                    break;
-                }
-            }
-            
-            //on the last iteration of a previously matched row it will add itself because it doesn't match any following rows, so that combination is counted
-            if (match == 0)
-                unique++;
-        }
-        return unique;
+        //count the distinct combinations, using the packed words of each column
+        set< vector<unsigned long long> > combos;
+        for(int j=0;j<ncols;j++) { combos.insert(tmpmatrix.getRowWords(j)); }
+        
+        return combos.size();
     }
     catch(exception& e) {
         m->errorOut(e, "TrialSwap2", "calc_combo");
@@ -186,10 +144,10 @@ int TrialSwap2::calc_combo (int nrows, int ncols, vector<vector<int> > &nullmatr
     }
 }
 /**************************************************************************************************/
-int TrialSwap2::swap_checkerboards (vector<vector<int> > &co_matrix, int ncols, int nrows)
+//util is the random stream of the null model chain, so each batch of swaps continues it
+int TrialSwap2::swap_checkerboards (OccupancyMatrix &co_matrix, int ncols, int nrows, Utils &util)
 {
     try {
-        Utils util;
         //do 100 runs to make sure enough swaps are happening. This does NOT mean that there will be 1000 swaps, but that is the theoretical max.
         for(int a=0;a<1000;a++){
             int i, j, k, l;
@@ -198,13 +156,15 @@ int TrialSwap2::swap_checkerboards (vector<vector<int> > &co_matrix, int ncols,
             k = util.getRandomIndex(ncols-1);
             while((l = util.getRandomIndex(ncols-1)) == k ) {;if (m->getControl_pressed()) { return 0; }}
 
-            if((co_matrix[i][k]*co_matrix[j][l]==1 && co_matrix[i][l]+co_matrix[j][k]==0)||(co_matrix[i][k]+co_matrix[j][l]==0 && co_matrix[i][l]*co_matrix[j][k]==1)) //checking for checkerboard value and swap
+            int ik = co_matrix.get(i, k); int jl = co_matrix.get(j, l);
+            int il = co_matrix.get(i, l); int jk = co_matrix.get(j, k);
+            
+            if((ik*jl==1 && il+jk==0)||(ik+jl==0 && il*jk==1)) //checking for checkerboard value and swap
             {
-                co_matrix[i][k]=1-co_matrix[i][k];
-                co_matrix[i][l]=1-co_matrix[i][l];
-                co_matrix[j][k]=1-co_matrix[j][k];
-                co_matrix[j][l]=1-co_matrix[j][l];
-
+                co_matrix.flip(i, k);
+                co_matrix.flip(i, l);
+                co_matrix.flip(j, k);
+                co_matrix.flip(j, l);
             }
         }
         
@@ -314,7 +274,7 @@ double TrialSwap2::get_zscore (double sd, double nullMean, double initscore)
     }
 }
 /**************************************************************************************************/
-int TrialSwap2::print_matrix(vector<vector<int> > &matrix, int nrows, int ncols)
+int TrialSwap2::print_matrix(OccupancyMatrix &matrix, int nrows, int ncols)
 {
     try {
         m->mothurOut("matrix:\n"); 
@@ -324,7 +284,7 @@ int TrialSwap2::print_matrix(vector<vector<int> > &matrix, int nrows, int ncols)
             if (m->getControl_pressed()) { return 0; }
             for (int j = 0; j < ncols; j++)
             {
-                m->mothurOut(toString(matrix[i][j]));
+                m->mothurOut(toString(matrix.get(i, j)));
             }
             m->mothurOutEndLine();
         }
@@ -341,3 +301,16 @@ int TrialSwap2::print_matrix(vector<vector<int> > &matrix, int nrows, int ncols)
 
 
 
+vector<int> OccupancyMatrix::getRow(int i)
+{
+    vector<int> row(ncols, 0);
+    for (int j = 0; j < ncols; j++) { row[j] = get(i, j); }
+    return row;
+}
+/**************************************************************************************************/
+void OccupancyMatrix::setRow(int i, vector<int>& row)
+{
+    fill(bits.begin()+(((size_t)i)*numWords), bits.begin()+(((size_t)i+1)*numWords), 0);
+    for (int j = 0; j < ncols; j++) { if (row[j] == 1) { set(i, j); } }
+}
+/**************************************************************************************************/
@@ -13,6 +13,39 @@
 #include "mothurout.h"
 #include "utils.hpp"
 
+/**************************************************************************************************/
+//a presence-absence matrix with each row packed into 64 bit words, so two rows are compared a word at a time
+class OccupancyMatrix {
+    
+public:
+    OccupancyMatrix() : nrows(0), ncols(0), numWords(0) {}
+    OccupancyMatrix(int r, int c) : nrows(r), ncols(c), numWords((c+63)/64) { bits.assign(((size_t)nrows)*numWords, 0); }
+    
+    int getNumRows()                { return nrows; }
+    int getNumCols()                { return ncols; }
+    
+    int get(int i, int j)           { return (bits[(((size_t)i)*numWords)+(j >> 6)] >> (j & 63)) & 1ULL;  }
+    void set(int i, int j)          { bits[(((size_t)i)*numWords)+(j >> 6)] |= (1ULL << (j & 63));    }
+    void flip(int i, int j)         { bits[(((size_t)i)*numWords)+(j >> 6)] ^= (1ULL << (j & 63));    }
+    void clear()                    { fill(bits.begin(), bits.end(), 0);                            }
+    
+    int getNumShared(int i, int j) { //number of columns with a 1 in both rows
+        const unsigned long long* rowI = &bits[((size_t)i)*numWords]; const unsigned long long* rowJ = &bits[((size_t)j)*numWords];
+        int shared = 0;
+        for (int w = 0; w < numWords; w++) { shared += __builtin_popcountll(rowI[w] & rowJ[w]); }
+        return shared;
+    }
+    
+    vector<unsigned long long> getRowWords(int i) { return vector<unsigned long long>(bits.begin()+(((size_t)i)*numWords), bits.begin()+(((size_t)i+1)*numWords)); } //the packed row, unused bits are 0
+    vector<int> getRow(int);
+    void setRow(int, vector<int>&);
+    
+private:
+    int nrows, ncols, numWords;
+    vector<unsigned long long> bits;
+};
+/**************************************************************************************************/
+
 
 class TrialSwap2 {
     
@@ -22,11 +55,11 @@ public:
     
     double calc_pvalue_lessthan (vector<double>, double);
     double calc_pvalue_greaterthan (vector<double>, double);
-    int swap_checkerboards (vector<vector<int> > &, int, int);
-    int calc_combo (int, int, vector<vector<int> > &);
-    double calc_vratio (int, int, vector<int>, vector<int>);
-    int calc_checker (vector<vector<int> > &, vector<int>, int, int);
-    double calc_c_score (vector<vector<int> > &, vector<int>, int, int);
+    int swap_checkerboards (OccupancyMatrix &, int, int, Utils &);
+    int calc_combo (int, int, OccupancyMatrix &);
+    double calc_vratio (int, int, vector<int>&, vector<int>&);
+    int calc_checker (OccupancyMatrix &, vector<int>&, int, int);
+    double calc_c_score (OccupancyMatrix &, vector<int>&, int, int);
     double get_zscore (double, double, double);
     double getSD (int, vector<double>, double);
     
@@ -36,7 +69,7 @@ private:
     Utils util;
     
     double t_test (double, int, double, vector<double>);
-    int print_matrix(vector<vector<int> > &, int, int);
+    int print_matrix(OccupancyMatrix &, int, int);
     
     
         
@@ -91,6 +91,14 @@ int TrimOligos::preProcess(int p, int b, int l, int s, int rd, map<string, int>
             }
         }
         
+        vector<string> oligos;
+        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){ oligos.push_back(it->first); barcodeGroups.push_back(it->second); }
+        barcodeIndex.build(oligos, bdiffs, false);
+        
+        oligos.clear();
+        for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){ oligos.push_back(it->first); primerGroups.push_back(it->second); }
+        primerIndex.build(oligos, pdiffs, false);
+        
         return 0;
     }
     catch(exception& e) {
@@ -164,6 +172,21 @@ int TrimOligos::preProcess(int p, int b, int l, int s, map<int, oligosPair> pr,
         
         ipbarcodes = br;
         ipprimers = pr;
+        
+        buildPairedIndex(ifbarcodes, bdiffs, fBarcodeIndex, fBarcodeGroups, false);
+        buildPairedIndex(irbarcodes, bdiffs, rBarcodeIndex, rBarcodeGroups, false);
+        buildPairedIndex(irbarcodes, bdiffs, rcBarcodeIndex, rBarcodeGroups, true);
+        buildPairedIndex(ifprimers, pdiffs, fPrimerIndex, fPrimerGroups, false);
+        buildPairedIndex(irprimers, pdiffs, rPrimerIndex, rPrimerGroups, false);
+        buildPairedIndex(irprimers, pdiffs, rcPrimerIndex, rPrimerGroups, true);
+        
+        vector<string> oligos;
+        for(map<int,oligosPair>::iterator it=ipbarcodes.begin();it!=ipbarcodes.end();it++){ oligos.push_back(it->second.forward); }
+        pairBarcodeIndex.build(oligos, bdiffs, true);
+        
+        oligos.clear();
+        for(map<int,oligosPair>::iterator it=ipprimers.begin();it!=ipprimers.end();it++){ oligos.push_back(it->second.forward); }
+        pairPrimerIndex.build(oligos, pdiffs, true);
 
         return 0;
     }
@@ -172,6 +195,25 @@ int TrimOligos::preProcess(int p, int b, int l, int s, map<int, oligosPair> pr,
         exit(1);
     }
 }
+/********************************************************************/
+//index of the unique forward or reverse oligos, the reverse complements are searched for at the end of single reads
+void TrimOligos::buildPairedIndex(map<string, vector<int> >& oligoGroups, int diffs, OligoIndex& index, vector< vector<int> >& groups, bool reverse){
+    try {
+        vector<string> oligos;
+        groups.clear();
+        for(map<string, vector<int> >::iterator it=oligoGroups.begin();it!=oligoGroups.end();it++){
+            string oligo = it->first;
+            if (reverse && (oligo != "NONE")) { oligo = reverseOligo(oligo); }
+            oligos.push_back(oligo);
+            groups.push_back(it->second);
+        }
+        index.build(oligos, diffs, true);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "TrimOligos", "buildPairedIndex");
+        exit(1);
+    }
+}
 //********************************************************************/
 vector<int> TrimOligos::findForward(Sequence& seq, int& primerStart, int& primerEnd){
     try {
@@ -412,7 +454,13 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, QualityScores& qual, int& gr
         if (barcodes.size() == 0) { return success;  }
         
         //can you find the barcode
-        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
+        vector<int> candidates = barcodeIndex.getCandidates(rawSequence, (rawSequence.length() < maxFBarcodeLength));
+        int index = 0, next = 0;
+        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++, index++){
+            if (next == candidates.size()) { break; }
+            if (candidates[next] != index) { continue; }
+            next++;
+            
             string oligo = it->first;
             if(rawSequence.length() < oligo.length()){	//let's just assume that the barcodes are the same length
                 success[0] = rawSequence.length();
@@ -437,7 +485,6 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, QualityScores& qual, int& gr
         if ((bdiffs == 0) || (success[0] == 0)) { return success; }
         
         else { //try aligning and see if you can find it
-            Alignment* alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxFBarcodeLength+bdiffs+1));
             
             //can you find the barcode
             int minDiff = MOTHURMAX;
@@ -445,47 +492,17 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, QualityScores& qual, int& gr
             int minGroup = -1;
             int minPos = 0;
             
-            for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
-                string oligo = it->first;
-                // int length = oligo.length();
-                
-                if(rawSequence.length() < maxFBarcodeLength){	//let's just assume that the barcodes are the same length
-                    success[0] = rawSequence.length();
-                    success[1] = bdiffs + 1000;
-                    break;
-                }
-                
-                //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                alignment->alignPrimer(oligo, rawSequence.substr(0,oligo.length()+bdiffs));
-                oligo = alignment->getSeqAAln();
-                string temp = alignment->getSeqBAln();
-                
-                int alnLength = oligo.length();
-                
-                for(int i=oligo.length()-1;i>=0;i--){
-                    if(oligo[i] != '-'){	alnLength = i+1;	break;	}
-                }
-                oligo = oligo.substr(0,alnLength);
-                temp = temp.substr(0,alnLength);
-                int numDiff = countDiffs(oligo, temp);
-                
-                if (m->getDebug()) { m->mothurOut("[DEBUG]: " + seq.getName() + " aligned fragment =" + temp + ", barcode =" + oligo + ", numDiffs = " + toString(numDiff) + "\n"); }
-                
-                if(numDiff < minDiff){
-                    minDiff = numDiff;
-                    minCount = 1;
-                    minGroup = it->second;
-                    minPos = 0;
-                    for(int i=0;i<alnLength;i++){
-                        if(temp[i] != '-'){
-                            minPos++;
-                        }
-                    }
-                }
-                else if(numDiff == minDiff){
-                    minCount++;
-                }
-                
+            bool tooShort = false;
+            vector<int> minOligos, minOligoPos;
+            minDiff = barcodeIndex.align(rawSequence, true, tooShort, minOligos, minOligoPos);
+            if (tooShort) {	//let's just assume that the barcodes are the same length
+                success[0] = rawSequence.length();
+                success[1] = bdiffs + 1000;
+            }
+            if (minOligos.size() != 0) {
+                minCount = minOligos.size();
+                minGroup = barcodeGroups[minOligos[0]];
+                minPos = minOligoPos[0];
             }
             
             if(minDiff > bdiffs)	{	success[0] = minDiff;  success[1] = MOTHURMAX;	}	//no good matches
@@ -500,8 +517,6 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, QualityScores& qual, int& gr
                 success[0] = minDiff; success[1] = 0;
             }
             
-            delete alignment;
-            
         }
         
         return success;
@@ -527,7 +542,13 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
         if ((ifbarcodes.size() == 0) || (irbarcodes.size() == 0)) { return success;  }
         
         //can you find the forward barcode
-        for(map<int,oligosPair>::iterator it=ipbarcodes.begin();it!=ipbarcodes.end();it++){
+        vector<int> candidates = pairBarcodeIndex.getCandidates(rawFSequence, ((rawFSequence.length() < maxFBarcodeLength) || (rawRSequence.length() < maxRBarcodeLength)));
+        int index = 0, next = 0;
+        for(map<int,oligosPair>::iterator it=ipbarcodes.begin();it!=ipbarcodes.end();it++, index++){
+            if (next == candidates.size()) { break; }
+            if (candidates[next] != index) { continue; }
+            next++;
+            
             string foligo = it->second.forward;
             string roligo = it->second.reverse;
             
@@ -568,7 +589,6 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
         //if you found the barcode or if you don't want to allow for diffs
         if ((bdiffs == 0) || (success[0] == 0)) { return success; }
         else { //try aligning and see if you can find it
-            Alignment* alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxFBarcodeLength+bdiffs+1));
             
             //can you find the barcode
             int minDiff = MOTHURMAX;
@@ -590,63 +610,14 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             
-            for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){
-                string oligo = it->first;
-                
-                if(rawFSequence.length() < maxFBarcodeLength){	//let's just assume that the barcodes are the same length
-                    success[0] = rawFSequence.length();
-                    success[1] = bdiffs + 1000;	//if the sequence is shorter than the barcode then bail out
-                    break;
-                }
-                
-                if (oligo != "NONE") {
-                    
-                    //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                    alignment->alignPrimer(oligo, rawFSequence.substr(0,oligo.length()+bdiffs));
-                    oligo = alignment->getSeqAAln();
-                    string temp = alignment->getSeqBAln();
-                    
-                    int alnLength = oligo.length();
-                    
-                    for(int i=oligo.length()-1;i>=0;i--){ if(oligo[i] != '-'){	alnLength = i+1;	break;	} }
-                    oligo = oligo.substr(0,alnLength);
-                    temp = temp.substr(0,alnLength);
-                    int numDiff = countDiffs(oligo, temp);
-                    
-                    if (m->getDebug()) { m->mothurOut("[DEBUG]: forward " + forwardSeq.getName() + " aligned fragment=" + temp + ", barcode=" + oligo + ", numDiffs=" + toString(numDiff) + ".\n");  }
-                    
-                    if (alnLength == 0) { numDiff = bdiffs + 1000; }
-                    
-                    
-                    if(numDiff < minDiff){
-                        minDiff = numDiff;
-                        minCount = 1;
-                        minFGroup.clear();
-                        minFGroup.push_back(it->second);
-                        int tempminFPos = 0;
-                        minFPos.clear();
-                        for(int i=0;i<alnLength;i++){
-                            if(temp[i] != '-'){
-                                tempminFPos++;
-                            }
-                        }
-                        minFPos.push_back(tempminFPos);
-                    }else if(numDiff == minDiff){
-                        minFGroup.push_back(it->second);
-                        int tempminFPos = 0;
-                        for(int i=0;i<alnLength;i++){
-                            if(temp[i] != '-'){
-                                tempminFPos++;
-                            }
-                        }
-                        minFPos.push_back(tempminFPos);
-                    }
-                }else { //is a match
-                    minFGroup.push_back(it->second);
-                    minFPos.push_back(0);
-                    minDiff = 0;
-                }
+            bool tooShort = false;
+            vector<int> minOligos;
+            minDiff = fBarcodeIndex.align(rawFSequence, true, tooShort, minOligos, minFPos);
+            if (tooShort) {	//let's just assume that the barcodes are the same length
+                success[0] = rawFSequence.length();
+                success[1] = bdiffs + 1000;	//if the sequence is shorter than the barcode then bail out
             }
+            for (int i = 0; i < minOligos.size(); i++) { minFGroup.push_back(fBarcodeGroups[minOligos[i]]); }
             
             
             if(minDiff > bdiffs)	{	success[0] = minDiff;  success[1] = MOTHURMAX;	}	//no good matches
@@ -654,8 +625,6 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
                 success[0] = minDiff;
                 
                 //check for reverse match
-                delete alignment;
-                alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxRBarcodeLength+bdiffs+1));
                 
                 //can you find the barcode
                 minDiff = MOTHURMAX;
@@ -663,62 +632,12 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
-                for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){
-                    string oligo = it->first;
-                    
-                    if(rawRSequence.length() < maxRBarcodeLength){	//let's just assume that the barcodes are the same length
-                        success[2] = rawRSequence.length();
-                        success[3] = bdiffs + 1000;	//if the sequence is shorter than the barcode then bail out
-                        break;
-                    }
-                    
-                    if (oligo != "NONE") {
-                        //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                        alignment->alignPrimer(oligo, rawRSequence.substr(0,oligo.length()+bdiffs));
-                        oligo = alignment->getSeqAAln();
-                        string temp = alignment->getSeqBAln();
-                        
-                        int alnLength = oligo.length();
-                        for(int i=oligo.length()-1;i>=0;i--){ if(oligo[i] != '-'){	alnLength = i+1;	break;	} }
-                        oligo = oligo.substr(0,alnLength);
-                        temp = temp.substr(0,alnLength);
-                        int numDiff = countDiffs(oligo, temp);
-                        
-                        if (m->getDebug()) { m->mothurOut("[DEBUG]: reverse " + forwardSeq.getName() + " aligned fragment=" + temp + ", barcode=" + oligo + ", numDiffs=" + toString(numDiff) + ".\n");  }
-                        
-                        if (alnLength == 0) { numDiff = bdiffs + 1000; }
-                        
-                        
-                        if(numDiff < minDiff){
-                            minDiff = numDiff;
-                            minCount = 1;
-                            minRGroup.clear();
-                            minRGroup.push_back(it->second);
-                            int tempminRPos = 0;
-                            minRPos.clear();
-                            for(int i=0;i<alnLength;i++){
-                                if(temp[i] != '-'){
-                                    tempminRPos++;
-                                }
-                            }
-                            minRPos.push_back(tempminRPos);
-                        }else if(numDiff == minDiff){
-                            int tempminRPos = 0;
-                            for(int i=0;i<alnLength;i++){
-                                if(temp[i] != '-'){
-                                    tempminRPos++;
-                                }
-                            }
-                            minRPos.push_back(tempminRPos);
-                            minRGroup.push_back(it->second);
-                        }
-                    }else { //is a match
-                        minRPos.push_back(0);
-                        minRGroup.push_back(it->second);
-                        minDiff = 0;
-                    }
-                    
+                minDiff = rBarcodeIndex.align(rawRSequence, true, tooShort, minOligos, minRPos);
+                if (tooShort) {	//let's just assume that the barcodes are the same length
+                    success[2] = rawRSequence.length();
+                    success[3] = bdiffs + 1000;	//if the sequence is shorter than the barcode then bail out
                 }
+                for (int i = 0; i < minOligos.size(); i++) { minRGroup.push_back(rBarcodeGroups[minOligos[i]]); }
                 
                 if(minDiff > bdiffs)	{	success[2] = minDiff;  success[3] = MOTHURMAX;	}	//no good matches
                 else {
@@ -750,7 +669,6 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
                 }
             }
             
-            delete alignment; 
         }
         
         return success;
@@ -778,7 +696,13 @@ vector<int> TrimOligos::stripIndexBarcode(Sequence& forwardSeq, Sequence& revers
         
         if ((ifbarcodes.size() == 0) || (irbarcodes.size() == 0)) { return success; }
         
-        for(map<int,oligosPair>::iterator it=ipbarcodes.begin();it!=ipbarcodes.end();it++){
+        vector<int> candidates = pairBarcodeIndex.getCandidates(rawFSequence, ((rawFSequence.length() < maxFBarcodeLength) || (rawRSequence.length() < maxRBarcodeLength)));
+        int index = 0, next = 0;
+        for(map<int,oligosPair>::iterator it=ipbarcodes.begin();it!=ipbarcodes.end();it++, index++){
+            if (next == candidates.size()) { break; }
+            if (candidates[next] != index) { continue; }
+            next++;
+            
             string foligo = it->second.forward;
             string roligo = it->second.reverse;
             
@@ -818,7 +742,6 @@ vector<int> TrimOligos::stripIndexBarcode(Sequence& forwardSeq, Sequence& revers
         //if you found the barcode or if you don't want to allow for diffs
         if ((bdiffs == 0) || (success[0] == 0)) { return success; }
         else { //try aligning and see if you can find it
-            Alignment* alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxFBarcodeLength+bdiffs+1));
             
             //can you find the barcode
             int minDiff = MOTHURMAX;
@@ -839,67 +762,14 @@ vector<int> TrimOligos::stripIndexBarcode(Sequence& forwardSeq, Sequence& revers
              reverse = Westcott, Schloss, Brown, Moore
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
-            for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){
-                string oligo = it->first;
-                //cout << "trying forward oligos " << oligo << endl;
-                if (oligo != "NONE") {
-                    
-                    if(rawFSequence.length() < maxFBarcodeLength){    //let's just assume that the barcodes are the same length
-                        success[0] = rawFSequence.length();
-                        success[1] = bdiffs + 1000;    //if the sequence is shorter than the barcode then bail out
-                        break;
-                    }
-                    
-                    //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                    alignment->alignPrimer(oligo, rawFSequence.substr(0,oligo.length()+bdiffs));
-                    oligo = alignment->getSeqAAln();
-                    string temp = alignment->getSeqBAln();
-                    
-                    int alnLength = oligo.length();
-                    
-                    for(int i=oligo.length()-1;i>=0;i--){ if(oligo[i] != '-'){    alnLength = i+1;    break;    } }
-                    oligo = oligo.substr(0,alnLength);
-                    temp = temp.substr(0,alnLength);
-                    int numDiff = countDiffs(oligo, temp);
-                    
-                    if (alnLength == 0) { numDiff = bdiffs + 1000; }
-                    //if (m->getDebug()) { m->mothurOut("[DEBUG]: forward " + forwardSeq.getName() + " aligned fragment=" + temp + ", barcode=" + oligo + ", numDiffs=" + toString(numDiff) + ".\n");  }
-                    
-                    if (m->getDebug()) {
-                        if (numDiff < minDiff) {
-                            m->mothurOut("[DEBUG]: forward " + forwardSeq.getName() + " aligned fragment=" + temp + "\nbarcode=" + oligo + "\nnumDiffs=" + toString(numDiff) + ".\n");
-                        }
-                    }
-                    
-                    if(numDiff < minDiff){
-                        minDiff = numDiff;
-                        minCount = 1;
-                        minFGroup.clear();
-                        minFGroup.push_back(it->second);
-                        int tempminFPos = 0;
-                        minFPos.clear();
-                        for(int i=0;i<alnLength;i++){
-                            if(temp[i] != '-'){
-                                tempminFPos++;
-                            }
-                        }
-                        minFPos.push_back(tempminFPos);
-                    }else if(numDiff == minDiff){
-                        minFGroup.push_back(it->second);
-                        int tempminFPos = 0;
-                        for(int i=0;i<alnLength;i++){
-                            if(temp[i] != '-'){
-                                tempminFPos++;
-                            }
-                        }
-                        minFPos.push_back(tempminFPos);
-                    }
-                }else { //is a match
-                    minFGroup.push_back(it->second);
-                    minFPos.push_back(0);
-                    minDiff = 0;
-                }
+            bool tooShort = false;
+            vector<int> minOligos;
+            minDiff = fBarcodeIndex.align(rawFSequence, false, tooShort, minOligos, minFPos);
+            if (tooShort) {	//let's just assume that the barcodes are the same length
+                success[0] = rawFSequence.length();
+                success[1] = bdiffs + 1000;    //if the sequence is shorter than the barcode then bail out
             }
+            for (int i = 0; i < minOligos.size(); i++) { minFGroup.push_back(fBarcodeGroups[minOligos[i]]); }
             
             
             if(minDiff > bdiffs)    {    success[0] = minDiff;  success[1] = MOTHURMAX;    }    //no good matches
@@ -907,8 +777,6 @@ vector<int> TrimOligos::stripIndexBarcode(Sequence& forwardSeq, Sequence& revers
                 success[0] = minDiff; //set forward barcode diffs
                 
                 //check for reverse match
-                delete alignment;
-                alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxRBarcodeLength+bdiffs+1));
                 
                 //can you find the barcode
                 minDiff = MOTHURMAX;
@@ -916,66 +784,12 @@ vector<int> TrimOligos::stripIndexBarcode(Sequence& forwardSeq, Sequence& revers
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
-                for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){
-                    string oligo = it->first;
-                    //cout << "trying reverse oligos " << oligo << endl;
-                    if (oligo != "NONE") {
-                        
-                        if(rawRSequence.length() < maxRBarcodeLength){    //let's just assume that the barcodes are the same length
-                            success[2] = rawRSequence.length();
-                            success[3] = bdiffs + 1000;    //if the sequence is shorter than the barcode then bail out
-                            break;
-                        }
-                        
-                        //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                        alignment->alignPrimer(oligo, rawRSequence.substr(0,oligo.length()+bdiffs));
-                        oligo = alignment->getSeqAAln();
-                        string temp = alignment->getSeqBAln();
-                        //cout << oligo <<endl;
-                        //cout << temp << endl;
-                        int alnLength = oligo.length();
-                        for(int i=oligo.length()-1;i>=0;i--){ if(oligo[i] != '-'){    alnLength = i+1;    break;    } }
-                        oligo = oligo.substr(0,alnLength);
-                        temp = temp.substr(0,alnLength);
-                        int numDiff = countDiffs(oligo, temp);
-                        if (alnLength == 0) { numDiff = bdiffs + 1000; }
-                        
-                        if (m->getDebug()) {
-                            if (numDiff < minDiff) {
-                                m->mothurOut("[DEBUG]: reverse " + reverseSeq.getName() + " aligned fragment=" + temp + "\nbarcode=" + oligo + "\nnumDiffs=" + toString(numDiff) + ".\n");
-                            }
-                        }
-                        
-                        if(numDiff < minDiff){
-                            minDiff = numDiff;
-                            minCount = 1;
-                            minRGroup.clear();
-                            minRGroup.push_back(it->second);
-                            int tempminRPos = 0;
-                            minRPos.clear();
-                            for(int i=0;i<alnLength;i++){
-                                if(temp[i] != '-'){
-                                    tempminRPos++;
-                                }
-                            }
-                            minRPos.push_back(tempminRPos);
-                        }else if(numDiff == minDiff){
-                            int tempminRPos = 0;
-                            for(int i=0;i<alnLength;i++){
-                                if(temp[i] != '-'){
-                                    tempminRPos++;
-                                }
-                            }
-                            minRPos.push_back(tempminRPos);
-                            minRGroup.push_back(it->second);
-                        }
-                    }else { //is a match
-                        minRPos.push_back(0);
-                        minRGroup.push_back(it->second);
-                        minDiff = 0;
-                    }
-                    
+                minDiff = rBarcodeIndex.align(rawRSequence, false, tooShort, minOligos, minRPos);
+                if (tooShort) {	//let's just assume that the barcodes are the same length
+                    success[2] = rawRSequence.length();
+                    success[3] = bdiffs + 1000;    //if the sequence is shorter than the barcode then bail out
                 }
+                for (int i = 0; i < minOligos.size(); i++) { minRGroup.push_back(rBarcodeGroups[minOligos[i]]); }
                 
                 if(minDiff > bdiffs)    {    success[2] = minDiff;  success[3] = MOTHURMAX;    }    //no good matches
                 else {
@@ -1005,7 +819,6 @@ vector<int> TrimOligos::stripIndexBarcode(Sequence& forwardSeq, Sequence& revers
                 }
             }
             
-            delete alignment;
         }
         //exit(1);
         return success;
@@ -1033,7 +846,13 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
         
         if ((ifbarcodes.size() == 0) || (irbarcodes.size() == 0)) { return success; }
         
-        for(map<int,oligosPair>::iterator it=ipbarcodes.begin();it!=ipbarcodes.end();it++){
+        vector<int> candidates = pairBarcodeIndex.getCandidates(rawFSequence, ((rawFSequence.length() < maxFBarcodeLength) || (rawRSequence.length() < maxRBarcodeLength)));
+        int index = 0, next = 0;
+        for(map<int,oligosPair>::iterator it=ipbarcodes.begin();it!=ipbarcodes.end();it++, index++){
+            if (next == candidates.size()) { break; }
+            if (candidates[next] != index) { continue; }
+            next++;
+            
             string foligo = it->second.forward;
             string roligo = it->second.reverse;
             
@@ -1087,7 +906,6 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
         //if you found the barcode or if you don't want to allow for diffs
         if ((bdiffs == 0) || (success[0] == 0)) { return success; }
         else { //try aligning and see if you can find it
-            Alignment* alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxFBarcodeLength+bdiffs+1));
             
             //can you find the barcode
             int minDiff = MOTHURMAX;
@@ -1108,67 +926,14 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
              reverse = Westcott, Schloss, Brown, Moore
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
-            for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){
-                string oligo = it->first;
-                
-                if (oligo != "NONE") {
-                    
-                    if(rawFSequence.length() < maxFBarcodeLength){	//let's just assume that the barcodes are the same length
-                        success[0] = rawFSequence.length();
-                        success[1] = bdiffs + 1000;	//if the sequence is shorter than the barcode then bail out
-                        break;
-                    }
-                    
-                    //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                    alignment->alignPrimer(oligo, rawFSequence.substr(0,oligo.length()+bdiffs));
-                    oligo = alignment->getSeqAAln();
-                    string temp = alignment->getSeqBAln();
-                    
-                    int alnLength = oligo.length();
-                    
-                    for(int i=oligo.length()-1;i>=0;i--){ if(oligo[i] != '-'){	alnLength = i+1;	break;	} }
-                    oligo = oligo.substr(0,alnLength);
-                    temp = temp.substr(0,alnLength);
-                    int numDiff = countDiffs(oligo, temp);
-                    
-                    if (alnLength == 0) { numDiff = bdiffs + 1000; }
-                    //if (m->getDebug()) { m->mothurOut("[DEBUG]: forward " + forwardSeq.getName() + " aligned fragment=" + temp + ", barcode=" + oligo + ", numDiffs=" + toString(numDiff) + ".\n");  }
-                    
-                    if (m->getDebug()) {
-                        if (numDiff < minDiff) {
-                            m->mothurOut("[DEBUG]: forward " + forwardSeq.getName() + " aligned fragment=" + temp + "\nbarcode=" + oligo + "\nnumDiffs=" + toString(numDiff) + ".\n");
-                        }
-                    }
-                    
-                    if(numDiff < minDiff){
-                        minDiff = numDiff;
-                        minCount = 1;
-                        minFGroup.clear();
-                        minFGroup.push_back(it->second);
-                        int tempminFPos = 0;
-                        minFPos.clear();
-                        for(int i=0;i<alnLength;i++){
-                            if(temp[i] != '-'){
-                                tempminFPos++;
-                            }
-                        }
-                        minFPos.push_back(tempminFPos);
-                    }else if(numDiff == minDiff){
-                        minFGroup.push_back(it->second);
-                        int tempminFPos = 0;
-                        for(int i=0;i<alnLength;i++){
-                            if(temp[i] != '-'){
-                                tempminFPos++;
-                            }
-                        }
-                        minFPos.push_back(tempminFPos);
-                    }
-                }else { //is a match
-                    minFGroup.push_back(it->second);
-                    minFPos.push_back(0);
-                    minDiff = 0;
-                }
+            bool tooShort = false;
+            vector<int> minOligos;
+            minDiff = fBarcodeIndex.align(rawFSequence, false, tooShort, minOligos, minFPos);
+            if (tooShort) {	//let's just assume that the barcodes are the same length
+                success[0] = rawFSequence.length();
+                success[1] = bdiffs + 1000;	//if the sequence is shorter than the barcode then bail out
             }
+            for (int i = 0; i < minOligos.size(); i++) { minFGroup.push_back(fBarcodeGroups[minOligos[i]]); }
             
             
             if(minDiff > bdiffs)	{	success[0] = minDiff;  success[1] = MOTHURMAX;	}	//no good matches
@@ -1176,8 +941,6 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
                 success[0] = minDiff; //set forward barcode diffs
                 
                 //check for reverse match
-                delete alignment;
-                alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxRBarcodeLength+bdiffs+1));
                 
                 //can you find the barcode
                 minDiff = MOTHURMAX;
@@ -1185,66 +948,12 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
-                for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){
-                    string oligo = it->first;
-                    
-                    if (oligo != "NONE") {
-                        
-                        if(rawRSequence.length() < maxRBarcodeLength){	//let's just assume that the barcodes are the same length
-                            success[2] = rawRSequence.length();
-                            success[3] = bdiffs + 1000;	//if the sequence is shorter than the barcode then bail out
-                            break;
-                        }
-                        
-                        //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                        alignment->alignPrimer(oligo, rawRSequence.substr(0,oligo.length()+bdiffs));
-                        oligo = alignment->getSeqAAln();
-                        string temp = alignment->getSeqBAln();
-                        //cout << oligo <<endl;
-                        //cout << temp << endl;
-                        int alnLength = oligo.length();
-                        for(int i=oligo.length()-1;i>=0;i--){ if(oligo[i] != '-'){	alnLength = i+1;	break;	} }
-                        oligo = oligo.substr(0,alnLength);
-                        temp = temp.substr(0,alnLength);
-                        int numDiff = countDiffs(oligo, temp);
-                        if (alnLength == 0) { numDiff = bdiffs + 1000; }
-                    
-                        if (m->getDebug()) {
-                            if (numDiff < minDiff) {
-                                m->mothurOut("[DEBUG]: reverse " + reverseSeq.getName() + " aligned fragment=" + temp + "\nbarcode=" + oligo + "\nnumDiffs=" + toString(numDiff) + ".\n");
-                            }
-                        }
-                        
-                        if(numDiff < minDiff){
-                            minDiff = numDiff;
-                            minCount = 1;
-                            minRGroup.clear();
-                            minRGroup.push_back(it->second);
-                            int tempminRPos = 0;
-                            minRPos.clear();
-                            for(int i=0;i<alnLength;i++){
-                                if(temp[i] != '-'){
-                                    tempminRPos++;
-                                }
-                            }
-                            minRPos.push_back(tempminRPos);
-                        }else if(numDiff == minDiff){
-                            int tempminRPos = 0;
-                            for(int i=0;i<alnLength;i++){
-                                if(temp[i] != '-'){
-                                    tempminRPos++;
-                                }
-                            }
-                            minRPos.push_back(tempminRPos);
-                            minRGroup.push_back(it->second);
-                        }
-                    }else { //is a match
-                        minRPos.push_back(0);
-                        minRGroup.push_back(it->second);
-                        minDiff = 0;
-                    }
-                    
+                minDiff = rBarcodeIndex.align(rawRSequence, false, tooShort, minOligos, minRPos);
+                if (tooShort) {	//let's just assume that the barcodes are the same length
+                    success[2] = rawRSequence.length();
+                    success[3] = bdiffs + 1000;	//if the sequence is shorter than the barcode then bail out
                 }
+                for (int i = 0; i < minOligos.size(); i++) { minRGroup.push_back(rBarcodeGroups[minOligos[i]]); }
                 
                 if(minDiff > bdiffs)	{	success[2] = minDiff;  success[3] = MOTHURMAX;	}	//no good matches
                 else {
@@ -1280,7 +989,6 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
                 }
             }
             
-            if (alignment != nullptr) { delete alignment; }
         }
         //exit(1);
         return success;
@@ -1309,7 +1017,13 @@ vector<int> TrimOligos::stripPairedBarcode(Sequence& seq, QualityScores& qual, i
         if ((ifbarcodes.size() == 0) || (irbarcodes.size() == 0)) { return success; }
         
         //can you find the forward barcode
-        for(map<int,oligosPair>::iterator it=ipbarcodes.begin();it!=ipbarcodes.end();it++){
+        vector<int> candidates = pairBarcodeIndex.getCandidates(rawSeq, (rawSeq.length() < (maxFBarcodeLength + maxRBarcodeLength)));
+        int index = 0, next = 0;
+        for(map<int,oligosPair>::iterator it=ipbarcodes.begin();it!=ipbarcodes.end();it++, index++){
+            if (next == candidates.size()) { break; }
+            if (candidates[next] != index) { continue; }
+            next++;
+            
             string foligo = it->second.forward;
             string roligo = it->second.reverse;
             
@@ -1364,7 +1078,6 @@ vector<int> TrimOligos::stripPairedBarcode(Sequence& seq, QualityScores& qual, i
         //if you found the barcode or if you don't want to allow for diffs
         if ((bdiffs == 0) || (success[0] == 0)) { return success; }
         else { //try aligning and see if you can find it
-            Alignment* alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxFBarcodeLength+bdiffs+1));
             
             //can you find the barcode
             int minDiff = MOTHURMAX;
@@ -1386,60 +1099,14 @@ vector<int> TrimOligos::stripPairedBarcode(Sequence& seq, QualityScores& qual, i
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             
-            for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){
-                string oligo = it->first;
-
-                if (oligo != "NONE") {
-                    if(rawSeq.length() < maxFBarcodeLength){	//let's just assume that the barcodes are the same length
-                        success[0] = rawSeq.length();
-                        success[1] = bdiffs + 1000;	//if the sequence is shorter than the barcode then bail out
-                        break;
-                    }
-                    
-                    //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                    alignment->alignPrimer(oligo, rawSeq.substr(0,oligo.length()+bdiffs));
-                    oligo = alignment->getSeqAAln();
-                    string temp = alignment->getSeqBAln();
-                    
-                    int alnLength = oligo.length();
-                    
-                    for(int i=oligo.length()-1;i>=0;i--){ if(oligo[i] != '-'){	alnLength = i+1;	break;	} }
-                    oligo = oligo.substr(0,alnLength);
-                    temp = temp.substr(0,alnLength);
-                    int numDiff = countDiffs(oligo, temp);
-                    
-                    if (alnLength == 0) { numDiff = bdiffs + 1000; }
-                    
-                    
-                    if(numDiff < minDiff){
-                        minDiff = numDiff;
-                        minCount = 1;
-                        minFGroup.clear();
-                        minFGroup.push_back(it->second);
-                        int tempminFPos = 0;
-                        minFPos.clear();
-                        for(int i=0;i<alnLength;i++){
-                            if(temp[i] != '-'){
-                                tempminFPos++;
-                            }
-                        }
-                        minFPos.push_back(tempminFPos);
-                    }else if(numDiff == minDiff){
-                        minFGroup.push_back(it->second);
-                        int tempminFPos = 0;
-                        for(int i=0;i<alnLength;i++){
-                            if(temp[i] != '-'){
-                                tempminFPos++;
-                            }
-                        }
-                        minFPos.push_back(tempminFPos);
-                    }
-                }else { //is a match
-                    minFGroup.push_back(it->second);
-                    minFPos.push_back(0);
-                    minDiff = 0;
-                }
+            bool tooShort = false;
+            vector<int> minOligos;
+            minDiff = fBarcodeIndex.align(rawSeq, false, tooShort, minOligos, minFPos);
+            if (tooShort) {	//let's just assume that the barcodes are the same length
+                success[0] = rawSeq.length();
+                success[1] = bdiffs + 1000;	//if the sequence is shorter than the barcode then bail out
             }
+            for (int i = 0; i < minOligos.size(); i++) { minFGroup.push_back(fBarcodeGroups[minOligos[i]]); }
             
             fMinDiff = minDiff;
             
@@ -1448,8 +1115,6 @@ vector<int> TrimOligos::stripPairedBarcode(Sequence& seq, QualityScores& qual, i
                 success[0] = minDiff; //set forward barcode diffs
                 
                 //check for reverse match
-                 delete alignment;
-                alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxRBarcodeLength+bdiffs+1));
                 
                 //can you find the barcode
                 minDiff = MOTHURMAX;
@@ -1459,60 +1124,12 @@ vector<int> TrimOligos::stripPairedBarcode(Sequence& seq, QualityScores& qual, i
                 
                 string rawRSequence = reverseOligo(seq.getUnaligned());
                 
-                for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){
-                    string oligo = it->first;
-                    if (oligo != "NONE") { oligo = reverseOligo(oligo); }
-                    
-                    if (oligo != "NONE") {
-                        
-                        if(rawRSequence.length() < maxRBarcodeLength){	//let's just assume that the barcodes are the same length
-                            success[2] = rawRSequence.length();
-                            success[3] = bdiffs + 1000;
-                            break;
-                        }
-                        
-                        //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                        alignment->alignPrimer(oligo, rawRSequence.substr(0,oligo.length()+bdiffs));
-                        oligo = alignment->getSeqAAln();
-                        string temp = alignment->getSeqBAln();
-                        
-                        int alnLength = oligo.length();
-                        for(int i=oligo.length()-1;i>=0;i--){ if(oligo[i] != '-'){	alnLength = i+1;	break;	} }
-                        oligo = oligo.substr(0,alnLength);
-                        temp = temp.substr(0,alnLength);
-                        int numDiff = countDiffs(oligo, temp);
-                        if (alnLength == 0) { numDiff = bdiffs + 1000; }
-                        
-                        
-                        if(numDiff < minDiff){
-                            minDiff = numDiff;
-                            minCount = 1;
-                            minRGroup.clear();
-                            minRGroup.push_back(it->second);
-                            int tempminRPos = 0;
-                            minRPos.clear();
-                            for(int i=0;i<alnLength;i++){
-                                if(temp[i] != '-'){
-                                    tempminRPos++;
-                                }
-                            }
-                            minRPos.push_back(tempminRPos);
-                        }else if(numDiff == minDiff){
-                            int tempminRPos = 0;
-                            for(int i=0;i<alnLength;i++){
-                                if(temp[i] != '-'){
-                                    tempminRPos++;
-                                }
-                            }
-                            minRPos.push_back(tempminRPos);
-                            minRGroup.push_back(it->second);
-                        }
-                    }else { //is a match
-                        minRPos.push_back(0);
-                        minRGroup.push_back(it->second);
-                        minDiff = 0;
-                    }
+                minDiff = rcBarcodeIndex.align(rawRSequence, false, tooShort, minOligos, minRPos);
+                if (tooShort) {	//let's just assume that the barcodes are the same length
+                    success[2] = rawRSequence.length();
+                    success[3] = bdiffs + 1000;
                 }
+                for (int i = 0; i < minOligos.size(); i++) { minRGroup.push_back(rBarcodeGroups[minOligos[i]]); }
 
                 if(minDiff > bdiffs)	{	success[2] = minDiff;  success[3] = MOTHURMAX;	}	//no good matches
                 else {
@@ -1551,7 +1168,6 @@ vector<int> TrimOligos::stripPairedBarcode(Sequence& seq, QualityScores& qual, i
             }
             rMinDiff = minDiff;
 
-            delete alignment;
         }
 
         return success;
@@ -1580,7 +1196,13 @@ vector<int> TrimOligos::stripPairedPrimers(Sequence& seq, QualityScores& qual, i
         if ((ifprimers.size() == 0) || (irprimers.size() == 0)) { return success; }
         
         //can you find the forward
-        for(map<int,oligosPair>::iterator it=ipprimers.begin();it!=ipprimers.end();it++){
+        vector<int> candidates = pairPrimerIndex.getCandidates(rawSeq, (rawSeq.length() < (maxFPrimerLength + maxRPrimerLength)));
+        int index = 0, next = 0;
+        for(map<int,oligosPair>::iterator it=ipprimers.begin();it!=ipprimers.end();it++, index++){
+            if (next == candidates.size()) { break; }
+            if (candidates[next] != index) { continue; }
+            next++;
+            
             string foligo = it->second.forward;
             string roligo = it->second.reverse;
             
@@ -1641,7 +1263,6 @@ vector<int> TrimOligos::stripPairedPrimers(Sequence& seq, QualityScores& qual, i
         //if you found the barcode or if you don't want to allow for diffs
         if ((pdiffs == 0) || (success[0] == 0)) { return success; }
         else { //try aligning and see if you can find it
-            Alignment* alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxFPrimerLength+pdiffs+1));
             
             //can you find the barcode
             int minDiff = MOTHURMAX;
@@ -1663,61 +1284,14 @@ vector<int> TrimOligos::stripPairedPrimers(Sequence& seq, QualityScores& qual, i
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             
-            for(map<string, vector<int> >::iterator it=ifprimers.begin();it!=ifprimers.end();it++){
-                string oligo = it->first;
-                
-                if(rawSeq.length() < maxFPrimerLength){	//let's just assume that the barcodes are the same length
-                    success[0] = rawSeq.length();
-                    success[1] = pdiffs + 1000;	//if the sequence is shorter than the primer then bail out
-                    break;
-                }
-                
-                if (oligo != "NONE") {
-                    //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                    alignment->alignPrimer(oligo, rawSeq.substr(0,oligo.length()+pdiffs));
-                    oligo = alignment->getSeqAAln();
-                    string temp = alignment->getSeqBAln();
-                    
-                    int alnLength = oligo.length();
-                    
-                    for(int i=oligo.length()-1;i>=0;i--){ if(oligo[i] != '-'){	alnLength = i+1;	break;	} }
-                    oligo = oligo.substr(0,alnLength);
-                    temp = temp.substr(0,alnLength);
-                    int numDiff = countDiffs(oligo, temp);
-                    
-                    if (alnLength == 0) { numDiff = pdiffs + 1000; }
-                    
-                    
-                    if(numDiff < minDiff){
-                        minDiff = numDiff;
-                        minCount = 1;
-                        minFGroup.clear();
-                        minFGroup.push_back(it->second);
-                        int tempminFPos = 0;
-                        minFPos.clear();
-                        for(int i=0;i<alnLength;i++){
-                            if(temp[i] != '-'){
-                                tempminFPos++;
-                            }
-                        }
-                        minFPos.push_back(tempminFPos);
-                    }else if(numDiff == minDiff){
-                        minFGroup.push_back(it->second);
-                        int tempminFPos = 0;
-                        for(int i=0;i<alnLength;i++){
-                            if(temp[i] != '-'){
-                                tempminFPos++;
-                            }
-                        }
-                        minFPos.push_back(tempminFPos);
-                    }
-                }else { //is a match
-                    minFGroup.push_back(it->second);
-                    minFPos.push_back(0);
-                    minDiff = 0;
-                }
-
+            bool tooShort = false;
+            vector<int> minOligos;
+            minDiff = fPrimerIndex.align(rawSeq, true, tooShort, minOligos, minFPos);
+            if (tooShort) {	//let's just assume that the barcodes are the same length
+                success[0] = rawSeq.length();
+                success[1] = pdiffs + 1000;	//if the sequence is shorter than the primer then bail out
             }
+            for (int i = 0; i < minOligos.size(); i++) { minFGroup.push_back(fPrimerGroups[minOligos[i]]); }
             
             fMinDiff = minDiff;
 
@@ -1727,8 +1301,6 @@ vector<int> TrimOligos::stripPairedPrimers(Sequence& seq, QualityScores& qual, i
                 success[0] = minDiff; //set forward primer diffs
                 
                 //check for reverse match
-                delete alignment;
-                alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxRPrimerLength+pdiffs+1));
                 
                 //can you find the barcode
                 minDiff = MOTHURMAX;
@@ -1738,59 +1310,12 @@ vector<int> TrimOligos::stripPairedPrimers(Sequence& seq, QualityScores& qual, i
                 
                 string rawRSequence = reverseOligo(seq.getUnaligned());
                 
-                for(map<string, vector<int> >::iterator it=irprimers.begin();it!=irprimers.end();it++){
-                    string oligo = it->first;
-                    if (oligo != "NONE") { oligo = reverseOligo(oligo); }
-                    
-                    if(rawRSequence.length() < maxRPrimerLength){	//let's just assume that the barcodes are the same length
-                        success[2] = rawRSequence.length();
-                        success[3] = pdiffs + 1000;
-                        break;
-                    }
-                    
-                    if (oligo != "NONE") {
-                        //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                        alignment->alignPrimer(oligo, rawRSequence.substr(0,oligo.length()+pdiffs));
-                        oligo = alignment->getSeqAAln();
-                        string temp = alignment->getSeqBAln();
-                        
-                        int alnLength = oligo.length();
-                        for(int i=oligo.length()-1;i>=0;i--){ if(oligo[i] != '-'){	alnLength = i+1;	break;	} }
-                        oligo = oligo.substr(0,alnLength);
-                        temp = temp.substr(0,alnLength);
-                        int numDiff = countDiffs(oligo, temp);
-                        if (alnLength == 0) { numDiff = pdiffs + 1000; }
-                        
-                        
-                        if(numDiff < minDiff){
-                            minDiff = numDiff;
-                            minCount = 1;
-                            minRGroup.clear();
-                            minRGroup.push_back(it->second);
-                            int tempminRPos = 0;
-                            minRPos.clear();
-                            for(int i=0;i<alnLength;i++){
-                                if(temp[i] != '-'){
-                                    tempminRPos++;
-                                }
-                            }
-                            minRPos.push_back(tempminRPos);
-                        }else if(numDiff == minDiff){
-                            int tempminRPos = 0;
-                            for(int i=0;i<alnLength;i++){
-                                if(temp[i] != '-'){
-                                    tempminRPos++;
-                                }
-                            }
-                            minRPos.push_back(tempminRPos);
-                            minRGroup.push_back(it->second);
-                        }
-                    }else { //is a match
-                        minRPos.push_back(0);
-                        minRGroup.push_back(it->second);
-                        minDiff = 0;
-                    }
+                minDiff = rcPrimerIndex.align(rawRSequence, true, tooShort, minOligos, minRPos);
+                if (tooShort) {	//let's just assume that the barcodes are the same length
+                    success[2] = rawRSequence.length();
+                    success[3] = pdiffs + 1000;
                 }
+                for (int i = 0; i < minOligos.size(); i++) { minRGroup.push_back(rPrimerGroups[minOligos[i]]); }
             
                 if(minDiff > pdiffs)	{	success[2] = minDiff;  success[3] = MOTHURMAX;	}	//no good matches
                 else {
@@ -1832,7 +1357,6 @@ vector<int> TrimOligos::stripPairedPrimers(Sequence& seq, QualityScores& qual, i
 
             rMinDiff = minDiff;
             
-            delete alignment;
         }
         
         return success;
@@ -1860,7 +1384,13 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
         if ((ifprimers.size() == 0) || (irprimers.size() == 0)) { return success; }
         
         //can you find the forward barcode
-        for(map<int,oligosPair>::iterator it=ipprimers.begin();it!=ipprimers.end();it++){
+        vector<int> candidates = pairPrimerIndex.getCandidates(rawFSequence, ((rawFSequence.length() < maxFPrimerLength) || (rawRSequence.length() < maxRPrimerLength)));
+        int index = 0, next = 0;
+        for(map<int,oligosPair>::iterator it=ipprimers.begin();it!=ipprimers.end();it++, index++){
+            if (next == candidates.size()) { break; }
+            if (candidates[next] != index) { continue; }
+            next++;
+            
             string foligo = it->second.forward;
             string roligo = it->second.reverse;
             
@@ -1905,7 +1435,6 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
         //if you found the barcode or if you don't want to allow for diffs
         if ((pdiffs == 0) || (success[0] == 0)) { return success; }
         else { //try aligning and see if you can find it
-            Alignment* alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxFPrimerLength+pdiffs+1));
             
             //can you find the barcode
             int minDiff = MOTHURMAX;
@@ -1927,62 +1456,14 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             
-            for(map<string, vector<int> >::iterator it=ifprimers.begin();it!=ifprimers.end();it++){
-                string oligo = it->first;
-                
-                if(rawFSequence.length() < maxFPrimerLength){	//let's just assume that the barcodes are the same length
-                    success[0] = rawFSequence.length();
-                    success[1] = pdiffs + 1000;	//if the sequence is shorter than the primer then bail out
-                    break;
-                }
-                
-                if (oligo != "NONE") {
-                    //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                    alignment->alignPrimer(oligo, rawFSequence.substr(0,oligo.length()+pdiffs));
-                    oligo = alignment->getSeqAAln();
-                    string temp = alignment->getSeqBAln();
-                    
-                    int alnLength = oligo.length();
-                    
-                    for(int i=oligo.length()-1;i>=0;i--){ if(oligo[i] != '-'){	alnLength = i+1;	break;	} }
-                    oligo = oligo.substr(0,alnLength);
-                    temp = temp.substr(0,alnLength);
-                    int numDiff = countDiffs(oligo, temp);
-                    
-                    if (alnLength == 0) { numDiff = pdiffs + 1000; }
-                    
-                    
-                    if (m->getDebug()) { m->mothurOut("[DEBUG]: forward " + forwardSeq.getName() + " aligned fragment=" + temp + ", primer=" + oligo + ", numDiffs=" + toString(numDiff) + ".\n");  }
-                    
-                    if(numDiff < minDiff){
-                        minDiff = numDiff;
-                        minCount = 1;
-                        minFGroup.clear();
-                        minFGroup.push_back(it->second);
-                        int tempminFPos = 0;
-                        minFPos.clear();
-                        for(int i=0;i<alnLength;i++){
-                            if(temp[i] != '-'){
-                                tempminFPos++;
-                            }
-                        }
-                        minFPos.push_back(tempminFPos);
-                    }else if(numDiff == minDiff){
-                        minFGroup.push_back(it->second);
-                        int tempminFPos = 0;
-                        for(int i=0;i<alnLength;i++){
-                            if(temp[i] != '-'){
-                                tempminFPos++;
-                            }
-                        }
-                        minFPos.push_back(tempminFPos);
-                    }
-                }else { //is a match
-                    minFGroup.push_back(it->second);
-                    minFPos.push_back(0);
-                    minDiff = 0;
-                }
+            bool tooShort = false;
+            vector<int> minOligos;
+            minDiff = fPrimerIndex.align(rawFSequence, true, tooShort, minOligos, minFPos);
+            if (tooShort) {	//let's just assume that the barcodes are the same length
+                success[0] = rawFSequence.length();
+                success[1] = pdiffs + 1000;	//if the sequence is shorter than the primer then bail out
             }
+            for (int i = 0; i < minOligos.size(); i++) { minFGroup.push_back(fPrimerGroups[minOligos[i]]); }
             
             
             if(minDiff > pdiffs)	{	success[0] = minDiff;  success[1] = MOTHURMAX;	}	//no good matches
@@ -1990,8 +1471,6 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
                 success[0] = minDiff; //set forward primer diffs
                 
                 //check for reverse match
-                delete alignment;
-                alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxRPrimerLength+pdiffs+1));
                 
                 //can you find the barcode
                 minDiff = MOTHURMAX;
@@ -1999,59 +1478,12 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
-                for(map<string, vector<int> >::iterator it=irprimers.begin();it!=irprimers.end();it++){
-                    string oligo = it->first;
-                    
-                    if(rawRSequence.length() < maxRPrimerLength){	//let's just assume that the barcodes are the same length
-                        success[2] = rawRSequence.length();
-                        success[3] = pdiffs + 1000;	//if the sequence is shorter than the primer then bail out
-                        break;
-                    }
-                    
-                    if (oligo != "NONE") {
-                        //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                        alignment->alignPrimer(oligo, rawRSequence.substr(0,oligo.length()+pdiffs));
-                        oligo = alignment->getSeqAAln();
-                        string temp = alignment->getSeqBAln();
-                        
-                        int alnLength = oligo.length();
-                        for(int i=oligo.length()-1;i>=0;i--){ if(oligo[i] != '-'){	alnLength = i+1;	break;	} }
-                        oligo = oligo.substr(0,alnLength);
-                        temp = temp.substr(0,alnLength);
-                        int numDiff = countDiffs(oligo, temp);
-                        if (alnLength == 0) { numDiff = pdiffs + 1000; }
-                        
-                        if (m->getDebug()) { m->mothurOut("[DEBUG]: reverse " + forwardSeq.getName() + " aligned fragment=" + temp + ", primer=" + oligo + ", numDiffs=" + toString(numDiff) + ".\n");  }
-                        
-                        if(numDiff < minDiff){
-                            minDiff = numDiff;
-                            minCount = 1;
-                            minRGroup.clear();
-                            minRGroup.push_back(it->second);
-                            int tempminRPos = 0;
-                            minRPos.clear();
-                            for(int i=0;i<alnLength;i++){
-                                if(temp[i] != '-'){
-                                    tempminRPos++;
-                                }
-                            }
-                            minRPos.push_back(tempminRPos);
-                        }else if(numDiff == minDiff){
-                            int tempminRPos = 0;
-                            for(int i=0;i<alnLength;i++){
-                                if(temp[i] != '-'){
-                                    tempminRPos++;
-                                }
-                            }
-                            minRPos.push_back(tempminRPos);
-                            minRGroup.push_back(it->second);
-                        }
-                    }else { //is a match
-                        minRPos.push_back(0);
-                        minRGroup.push_back(it->second);
-                        minDiff = 0;
-                    }
+                minDiff = rPrimerIndex.align(rawRSequence, true, tooShort, minOligos, minRPos);
+                if (tooShort) {	//let's just assume that the barcodes are the same length
+                    success[2] = rawRSequence.length();
+                    success[3] = pdiffs + 1000;	//if the sequence is shorter than the primer then bail out
                 }
+                for (int i = 0; i < minOligos.size(); i++) { minRGroup.push_back(rPrimerGroups[minOligos[i]]); }
                 
                 if(minDiff > pdiffs)	{	success[2] = minDiff;  success[3] = MOTHURMAX;	}	//no good matches
                 else {
@@ -2086,7 +1518,6 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
                 }
             }
             
-            delete alignment;
         }
         
         return success;
@@ -2113,7 +1544,13 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
         if ((ifprimers.size() == 0) || (irprimers.size() == 0)) { return success; }
         
         //can you find the forward barcode
-        for(map<int,oligosPair>::iterator it=ipprimers.begin();it!=ipprimers.end();it++){
+        vector<int> candidates = pairPrimerIndex.getCandidates(rawFSequence, ((rawFSequence.length() < maxFPrimerLength) || (rawRSequence.length() < maxRPrimerLength)));
+        int index = 0, next = 0;
+        for(map<int,oligosPair>::iterator it=ipprimers.begin();it!=ipprimers.end();it++, index++){
+            if (next == candidates.size()) { break; }
+            if (candidates[next] != index) { continue; }
+            next++;
+            
             string foligo = it->second.forward;
             string roligo = it->second.reverse;
             
@@ -2154,7 +1591,6 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
         //if you found the barcode or if you don't want to allow for diffs
         if ((pdiffs == 0) || (success[0] == 0)) { return success; }
         else { //try aligning and see if you can find it
-            Alignment* alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxFPrimerLength+pdiffs+1));
             
             //can you find the barcode
             int minDiff = MOTHURMAX;
@@ -2176,62 +1612,14 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             
-            for(map<string, vector<int> >::iterator it=ifprimers.begin();it!=ifprimers.end();it++){
-                string oligo = it->first;
-                
-                if(rawFSequence.length() < maxFPrimerLength){	//let's just assume that the barcodes are the same length
-                    success[0] = rawFSequence.length();
-                    success[1] = pdiffs + 1000;	//if the sequence is shorter than the primer then bail out
-                    break;
-                }
-                
-                if (oligo != "NONE") {
-                    //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                    alignment->alignPrimer(oligo, rawFSequence.substr(0,oligo.length()+pdiffs));
-                    oligo = alignment->getSeqAAln();
-                    string temp = alignment->getSeqBAln();
-                    
-                    int alnLength = oligo.length();
-                    
-                    for(int i=oligo.length()-1;i>=0;i--){ if(oligo[i] != '-'){	alnLength = i+1;	break;	} }
-                    oligo = oligo.substr(0,alnLength);
-                    temp = temp.substr(0,alnLength);
-                    int numDiff = countDiffs(oligo, temp);
-                    
-                    if (m->getDebug()) { m->mothurOut("[DEBUG]: forward " + forwardSeq.getName() + " aligned fragment=" + temp + ", primer=" + oligo + ", numDiffs=" + toString(numDiff) + ".\n");  }
-                    
-                    if (alnLength == 0) { numDiff = pdiffs + 1000; }
-                    
-                    
-                    if(numDiff < minDiff){
-                        minDiff = numDiff;
-                        minCount = 1;
-                        minFGroup.clear();
-                        minFGroup.push_back(it->second);
-                        int tempminFPos = 0;
-                        minFPos.clear();
-                        for(int i=0;i<alnLength;i++){
-                            if(temp[i] != '-'){
-                                tempminFPos++;
-                            }
-                        }
-                        minFPos.push_back(tempminFPos);
-                    }else if(numDiff == minDiff){
-                        minFGroup.push_back(it->second);
-                        int tempminFPos = 0;
-                        for(int i=0;i<alnLength;i++){
-                            if(temp[i] != '-'){
-                                tempminFPos++;
-                            }
-                        }
-                        minFPos.push_back(tempminFPos);
-                    }
-                }else { //is a match
-                    minFGroup.push_back(it->second);
-                    minFPos.push_back(0);
-                    minDiff = 0;
-                }
+            bool tooShort = false;
+            vector<int> minOligos;
+            minDiff = fPrimerIndex.align(rawFSequence, true, tooShort, minOligos, minFPos);
+            if (tooShort) {	//let's just assume that the barcodes are the same length
+                success[0] = rawFSequence.length();
+                success[1] = pdiffs + 1000;	//if the sequence is shorter than the primer then bail out
             }
+            for (int i = 0; i < minOligos.size(); i++) { minFGroup.push_back(fPrimerGroups[minOligos[i]]); }
             
             
             if(minDiff > pdiffs)	{	success[0] = minDiff;  success[1] = MOTHURMAX;	}	//no good matches
@@ -2239,8 +1627,6 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
                 success[0] = minDiff; //set forward primer diffs
                 
                 //check for reverse match
-                delete alignment;
-                alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxRPrimerLength+pdiffs+1));
                 
                 //can you find the barcode
                 minDiff = MOTHURMAX;
@@ -2248,62 +1634,12 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
-                for(map<string, vector<int> >::iterator it=irprimers.begin();it!=irprimers.end();it++){
-                    string oligo = it->first;
-                    
-                    if(rawRSequence.length() < maxRPrimerLength){	//let's just assume that the barcodes are the same length
-                        success[2] = rawRSequence.length();
-                        success[3] = pdiffs + 1000;	//if the sequence is shorter than the primer then bail out
-                        break;
-                    }
-                    
-                    if (oligo != "NONE") {
-                        //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                        alignment->alignPrimer(oligo, rawRSequence.substr(0,oligo.length()+pdiffs));
-                        oligo = alignment->getSeqAAln();
-                        string temp = alignment->getSeqBAln();
-                        
-                        int alnLength = oligo.length();
-                        for(int i=oligo.length()-1;i>=0;i--){ if(oligo[i] != '-'){	alnLength = i+1;	break;	} }
-                        oligo = oligo.substr(0,alnLength);
-                        temp = temp.substr(0,alnLength);
-                        int numDiff = countDiffs(oligo, temp);
-                        
-                        if (m->getDebug()) { m->mothurOut("[DEBUG]: reverse " + forwardSeq.getName() + " aligned fragment=" + temp + ", primer=" + oligo + ", numDiffs=" + toString(numDiff) + ".\n");  }
-                        
-                        if (alnLength == 0) { numDiff = pdiffs + 1000; }
-                        
-                        
-                        if(numDiff < minDiff){
-                            minDiff = numDiff;
-                            minCount = 1;
-                            minRGroup.clear();
-                            minRGroup.push_back(it->second);
-                            int tempminRPos = 0;
-                            minRPos.clear();
-                            for(int i=0;i<alnLength;i++){
-                                if(temp[i] != '-'){
-                                    tempminRPos++;
-                                }
-                            }
-                            minRPos.push_back(tempminRPos);
-                        }else if(numDiff == minDiff){
-                            int tempminRPos = 0;
-                            for(int i=0;i<alnLength;i++){
-                                if(temp[i] != '-'){
-                                    tempminRPos++;
-                                }
-                            }
-                            minRPos.push_back(tempminRPos);
-                            minRGroup.push_back(it->second);
-                        }
-                    }else { //is a match
-                        minRPos.push_back(0);
-                        minRGroup.push_back(it->second);
-                        minDiff = 0;
-                    }
-                    
+                minDiff = rPrimerIndex.align(rawRSequence, true, tooShort, minOligos, minRPos);
+                if (tooShort) {	//let's just assume that the barcodes are the same length
+                    success[2] = rawRSequence.length();
+                    success[3] = pdiffs + 1000;	//if the sequence is shorter than the primer then bail out
                 }
+                for (int i = 0; i < minOligos.size(); i++) { minRGroup.push_back(rPrimerGroups[minOligos[i]]); }
                 
                 if(minDiff > pdiffs)	{	success[2] = minDiff;  success[3] = MOTHURMAX;	}	//no good matches
                 else {
@@ -2335,7 +1671,6 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
                 }
             }
             
-            delete alignment; 
         }
         
         return success;
@@ -2358,7 +1693,13 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, int& group){
         success.push_back(MOTHURMAX);
         
         //can you find the barcode
-        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
+        vector<int> candidates = barcodeIndex.getCandidates(rawSequence, (rawSequence.length() < maxFBarcodeLength));
+        int index = 0, next = 0;
+        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++, index++){
+            if (next == candidates.size()) { break; }
+            if (candidates[next] != index) { continue; }
+            next++;
+            
             string oligo = it->first;
             if(rawSequence.length() < oligo.length()){	//let's just assume that the barcodes are the same length
                 success[0] = rawSequence.length();
@@ -2378,9 +1719,6 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, int& group){
         if ((bdiffs == 0) || (success[0] == 0)) { return success; }
         
         else { //try aligning and see if you can find it
-            Alignment* alignment;
-            if (barcodes.size() > 0) { alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxFBarcodeLength+bdiffs+1)); }
-            else{ alignment = nullptr; }
             
             //can you find the barcode
             int minDiff = MOTHURMAX;
@@ -2388,48 +1726,17 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, int& group){
             int minGroup = -1;
             int minPos = 0;
             
-            for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
-                string oligo = it->first;
-                // int length = oligo.length();
-                
-                if(rawSequence.length() < maxFBarcodeLength){	//let's just assume that the barcodes are the same length
-                    success[0] = rawSequence.length();
-                    success[1] = bdiffs + 1000;
-                    break;
-                }
-                
-                //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                alignment->alignPrimer(oligo, rawSequence.substr(0,oligo.length()+bdiffs));
-                oligo = alignment->getSeqAAln();
-                string temp = alignment->getSeqBAln();
-                
-                int alnLength = oligo.length();
-                
-                for(int i=oligo.length()-1;i>=0;i--){
-                    if(oligo[i] != '-'){	alnLength = i+1;	break;	}
-                }
-                oligo = oligo.substr(0,alnLength);
-                temp = temp.substr(0,alnLength);
-                
-                int numDiff = countDiffs(oligo, temp);
-                
-                if (m->getDebug()) { m->mothurOut("[DEBUG]: " + seq.getName() + " aligned fragment =" + temp + ", barcode =" + oligo + ", numDiffs = " + toString(numDiff) + "\n"); }
-                
-                if(numDiff < minDiff){
-                    minDiff = numDiff;
-                    minCount = 1;
-                    minGroup = it->second;
-                    minPos = 0;
-                    for(int i=0;i<alnLength;i++){
-                        if(temp[i] != '-'){
-                            minPos++;
-                        }
-                    }
-                }
-                else if(numDiff == minDiff){
-                    minCount++;
-                }
-                
+            bool tooShort = false;
+            vector<int> minOligos, minOligoPos;
+            minDiff = barcodeIndex.align(rawSequence, true, tooShort, minOligos, minOligoPos);
+            if (tooShort) {	//let's just assume that the barcodes are the same length
+                success[0] = rawSequence.length();
+                success[1] = bdiffs + 1000;
+            }
+            if (minOligos.size() != 0) {
+                minCount = minOligos.size();
+                minGroup = barcodeGroups[minOligos[0]];
+                minPos = minOligoPos[0];
             }
             
             if(minDiff > bdiffs)	{	success[0] = minDiff;  success[1] = MOTHURMAX;	}	//no good matches
@@ -2440,8 +1747,6 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, int& group){
                 success[0] = minDiff; success[1] = 0;
             }
             
-            if (alignment != nullptr) { delete alignment; }
-            
         }
         
         return success;
@@ -2463,7 +1768,13 @@ vector<int> TrimOligos::stripForward(Sequence& seq, int& group){
         success.push_back(MOTHURMAX);
         
         //can you find the primer
-        for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
+        vector<int> candidates = primerIndex.getCandidates(rawSequence, (rawSequence.length() < maxFPrimerLength));
+        int index = 0, next = 0;
+        for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++, index++){
+            if (next == candidates.size()) { break; }
+            if (candidates[next] != index) { continue; }
+            next++;
+            
             string oligo = it->first;
             if(rawSequence.length() < oligo.length()){	//let's just assume that the primers are the same length
                 success[0] = rawSequence.length();
@@ -2483,9 +1794,6 @@ vector<int> TrimOligos::stripForward(Sequence& seq, int& group){
         if ((pdiffs == 0) || (success[0] == 0)) {	return success; }
         
         else { //try aligning and see if you can find it
-            Alignment* alignment;
-            if (primers.size() > 0) { alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxFPrimerLength+pdiffs+1)); }
-            else{ alignment = nullptr; }
             
             //can you find the barcode
             int minDiff = MOTHURMAX;
@@ -2493,48 +1801,17 @@ vector<int> TrimOligos::stripForward(Sequence& seq, int& group){
             int minGroup = -1;
             int minPos = 0;
             
-            for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
-                string oligo = it->first;
-                // int length = oligo.length();
-                
-                if(rawSequence.length() < maxFPrimerLength){
-                    success[0] = rawSequence.length();
-                    success[1] = pdiffs + 1000;
-                    break;
-                }
-                
-                //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                alignment->alignPrimer(oligo, rawSequence.substr(0,oligo.length()+pdiffs));
-                oligo = alignment->getSeqAAln();
-                string temp = alignment->getSeqBAln();
-                
-                int alnLength = oligo.length();
-                
-                for(int i=oligo.length()-1;i>=0;i--){
-                    if(oligo[i] != '-'){	alnLength = i+1;	break;	}
-                }
-                oligo = oligo.substr(0,alnLength);
-                temp = temp.substr(0,alnLength);
-                
-                int numDiff = countDiffs(oligo, temp);
-                
-                if (m->getDebug()) { m->mothurOut("[DEBUG]: " + seq.getName() + " aligned fragment=" + temp + ", primer=" + oligo + ", numDiffs=" + toString(numDiff) + ".\n");  }
-                
-                if(numDiff < minDiff){
-                    minDiff = numDiff;
-                    minCount = 1;
-                    minGroup = it->second;
-                    minPos = 0;
-                    for(int i=0;i<alnLength;i++){
-                        if(temp[i] != '-'){
-                            minPos++;
-                        }
-                    }
-                }
-                else if(numDiff == minDiff){
-                    minCount++;
-                }
-                
+            bool tooShort = false;
+            vector<int> minOligos, minOligoPos;
+            minDiff = primerIndex.align(rawSequence, true, tooShort, minOligos, minOligoPos);
+            if (tooShort) {
+                success[0] = rawSequence.length();
+                success[1] = pdiffs + 1000;
+            }
+            if (minOligos.size() != 0) {
+                minCount = minOligos.size();
+                minGroup = primerGroups[minOligos[0]];
+                minPos = minOligoPos[0];
             }
             
             if(minDiff > pdiffs)	{	success[0] = minDiff;  success[1] = MOTHURMAX;	}	//no good matches
@@ -2545,8 +1822,6 @@ vector<int> TrimOligos::stripForward(Sequence& seq, int& group){
                 success[0] = minDiff; success[1] = 0;
             }
             
-            if (alignment != nullptr) { delete alignment; }
-            
         }
         
         return success;
@@ -2571,7 +1846,13 @@ vector<int> TrimOligos::stripForward(Sequence& seq, QualityScores& qual, int& gr
         string rawSequence = seq.getUnaligned();
         
         //can you find the primer
-        for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
+        vector<int> candidates = primerIndex.getCandidates(rawSequence, (rawSequence.length() < maxFPrimerLength));
+        int index = 0, next = 0;
+        for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++, index++){
+            if (next == candidates.size()) { break; }
+            if (candidates[next] != index) { continue; }
+            next++;
+            
             string oligo = it->first;
             if(rawSequence.length() < oligo.length()){	//let's just assume that the primers are the same length
                 success[0] = rawSequence.length();
@@ -2594,9 +1875,6 @@ vector<int> TrimOligos::stripForward(Sequence& seq, QualityScores& qual, int& gr
         if ((pdiffs == 0) || (success[0] == 0)) { return success; }
         
         else { //try aligning and see if you can find it
-            Alignment* alignment;
-            if (primers.size() > 0) { alignment = new NeedlemanOverlap(-1.0, 1.0, -1.0, (maxFPrimerLength+pdiffs+1)); }
-            else{ alignment = nullptr; }
             
             //can you find the barcode
             int minDiff = MOTHURMAX;
@@ -2604,48 +1882,17 @@ vector<int> TrimOligos::stripForward(Sequence& seq, QualityScores& qual, int& gr
             int minGroup = -1;
             int minPos = 0;
             
-            for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
-                string oligo = it->first;
-                // int length = oligo.length();
-                
-                if(rawSequence.length() < maxFPrimerLength){
-                    success[0] = rawSequence.length();
-                    success[1] = pdiffs + 1000;
-                    break;
-                }
-                
-                //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
-                alignment->alignPrimer(oligo, rawSequence.substr(0,oligo.length()+pdiffs));
-                oligo = alignment->getSeqAAln();
-                string temp = alignment->getSeqBAln();
-                
-                int alnLength = oligo.length();
-                
-                for(int i=oligo.length()-1;i>=0;i--){
-                    if(oligo[i] != '-'){	alnLength = i+1;	break;	}
-                }
-                oligo = oligo.substr(0,alnLength);
-                temp = temp.substr(0,alnLength);
-                
-                int numDiff = countDiffs(oligo, temp);
-                
-                if (m->getDebug()) { m->mothurOut("[DEBUG]: " + seq.getName() + " aligned fragment=" + temp + ", primer=" + oligo + ", numDiffs=" + toString(numDiff) + ".\n");  }
-                
-                if(numDiff < minDiff){
-                    minDiff = numDiff;
-                    minCount = 1;
-                    minGroup = it->second;
-                    minPos = 0;
-                    for(int i=0;i<alnLength;i++){
-                        if(temp[i] != '-'){
-                            minPos++;
-                        }
-                    }
-                }
-                else if(numDiff == minDiff){
-                    minCount++;
-                }
-                
+            bool tooShort = false;
+            vector<int> minOligos, minOligoPos;
+            minDiff = primerIndex.align(rawSequence, true, tooShort, minOligos, minOligoPos);
+            if (tooShort) {
+                success[0] = rawSequence.length();
+                success[1] = pdiffs + 1000;
+            }
+            if (minOligos.size() != 0) {
+                minCount = minOligos.size();
+                minGroup = primerGroups[minOligos[0]];
+                minPos = minOligoPos[0];
             }
             
             if(minDiff > pdiffs)	{	success[0] = minDiff;  success[1] = MOTHURMAX;	}	//no good matches
@@ -2659,8 +1906,6 @@ vector<int> TrimOligos::stripForward(Sequence& seq, QualityScores& qual, int& gr
                 success[0] = minDiff; success[1] = 0;
             }
             
-            if (alignment != nullptr) { delete alignment; }
-            
         }
         
         return success;
@@ -13,6 +13,7 @@
 #include "mothurout.h"
 #include "sequence.hpp"
 #include "qualityscores.h"
+#include "oligoindex.hpp"
 
 
 class TrimOligos {
@@ -77,6 +78,13 @@ class TrimOligos {
         map<int, oligosPair> ipprimers;
     
         int maxFBarcodeLength, maxRBarcodeLength, maxFPrimerLength, maxRPrimerLength, maxLinkerLength, maxSpacerLength;
+    
+        //same order as the maps, rc indexes hold the reverse complement of the reverse oligos
+        OligoIndex barcodeIndex, primerIndex;
+        OligoIndex fBarcodeIndex, rBarcodeIndex, rcBarcodeIndex, fPrimerIndex, rPrimerIndex, rcPrimerIndex;
+        OligoIndex pairBarcodeIndex, pairPrimerIndex; //forward oligo of each pair
+        vector<int> barcodeGroups, primerGroups;
+        vector< vector<int> > fBarcodeGroups, rBarcodeGroups, fPrimerGroups, rPrimerGroups;
 	
 		MothurOut* m;
 	
@@ -90,6 +98,7 @@ class TrimOligos {
     
         int preProcess(int,int, int, int, int, map<string, int>, map<string, int>, vector<string>, vector<string>, vector<string>); //pdiffs, bdiffs, ldiffs, sdiffs, primers, barcodes, revPrimers, linker, spacer
     int preProcess(int p, int b, int l, int s, map<int, oligosPair> pr, map<int, oligosPair> br, bool hi);
+        void buildPairedIndex(map<string, vector<int> >&, int, OligoIndex&, vector< vector<int> >&, bool); //oligos, diffs, index, groups, reverse complement
 
 };
 
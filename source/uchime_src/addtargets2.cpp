@@ -12,6 +12,14 @@ bool GlobalAlign(const SeqData &Query, const SeqData &Target, string &Path);
 double GetFractIdGivenPath(const byte *A, const byte *B, const char *Path);
 void USort(const SeqData &Query, const SeqDB &DB, vector<float> &WordCounts,
   vector<unsigned> &Order);
+unsigned GetWordsInCommon(const SeqData &Target);
+
+// Sequences that may be added to DB before this query, set for each thread
+// by UChime(). If one of them has more words in common with a chunk than the
+// top hit in DB, the targets could change, and g_PendingSeqsMatter is set.
+thread_local const SeqData *g_PendingSeqs;
+thread_local unsigned g_PendingSeqCount;
+thread_local bool g_PendingSeqsMatter;
 
 void AddTargets(SeqDB &DB, const SeqData &Query, set<unsigned> &TargetIndexes)
 	{
@@ -25,6 +33,9 @@ void AddTargets(SeqDB &DB, const SeqData &Query, set<unsigned> &TargetIndexes)
 	asserta(SIZE(Order) == SeqCount);
 	unsigned TopSeqIndex = Order[0];
 	float TopWordCount = WordCounts[TopSeqIndex];
+	for (unsigned i = 0; i < g_PendingSeqCount && !g_PendingSeqsMatter; ++i)
+		if ((float) GetWordsInCommon(g_PendingSeqs[i]) > TopWordCount)
+			g_PendingSeqsMatter = true;
 	for (unsigned i = 0; i < SeqCount; ++i)
 		{
 		unsigned SeqIndex = Order[i];
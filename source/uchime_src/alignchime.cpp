@@ -518,13 +518,6 @@ void AlignChimeGlobal3(const string &Q3, const string &A3, const string &B3,
 	//		Hit.Score *= Factor;
 	//		}
 	//	}
-
-	extern FILE *g_fUChimeAlns;
-	if (g_fUChimeAlns != 0 && Hit.Div > 0.0)
-		{
-		void WriteChimeHitX(FILE *f, const ChimeHit2 &Hit);
-		WriteChimeHitX(g_fUChimeAlns, Hit);
-		}
 	}
 
 void AlignChime3(const string &Q3, const string &A3, const string &B3,
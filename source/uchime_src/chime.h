@@ -99,6 +99,9 @@ void GetChunkInfo(unsigned L, unsigned &Length, vector<unsigned> &Los);
 float GetAbFromLabel(const string &Label);
 void WriteChimeHitCS(FILE *f, const ChimeHit2 &Hit);
 void WriteChimeHit(FILE *f, const ChimeHit2 &Hit);
+void WriteChimeHit(string &s, const ChimeHit2 &Hit);
+void WriteChimeHitX(FILE *f, const ChimeHit2 &Hit);
+void WriteChimeHitX(string &s, const ChimeHit2 &Hit);
 void WriteChimeFileHdr(FILE *f);
 
 #endif // chime_h
@@ -6,14 +6,17 @@
 static AlnParams g_AP;
 static bool g_APInitDone = false;
 
+// Call after the options change, and before aligning on several threads.
+void InitGlobalAlign()
+	{
+	g_AP.InitFromCmdLine(true);
+	g_APInitDone = true;
+	}
+
 bool GlobalAlign(const SeqData &Query, const SeqData &Target, PathData &PD)
 	{
 	if (!g_APInitDone)
-		{
-		g_AP.InitFromCmdLine(true);
-		g_APInitDone = true;
-		}
-
+		InitGlobalAlign();
 	ViterbiFast(Query.Seq, Query.L, Target.Seq, Target.L, g_AP, PD);
 	return true;
 	}
@@ -1,3 +1,4 @@
+#include <mutex>
 #include "myutils.h"
 #include "mx.h"
 #include "seqdb.h"
@@ -6,11 +7,14 @@
 char ProbToChar(float p);
 
 list<MxBase *> *MxBase::m_Matrices = 0;
-unsigned MxBase::m_AllocCount;
-unsigned MxBase::m_ZeroAllocCount;
-unsigned MxBase::m_GrowAllocCount;
-double MxBase::m_TotalBytes;
-double MxBase::m_MaxBytes;
+thread_local unsigned MxBase::m_AllocCount;
+thread_local unsigned MxBase::m_ZeroAllocCount;
+thread_local unsigned MxBase::m_GrowAllocCount;
+thread_local double MxBase::m_TotalBytes;
+thread_local double MxBase::m_MaxBytes;
+
+// Matrices are made on several threads when queries are searched in parallel.
+static mutex g_MatricesLock;
 
 static const char *LogizeStr(const char *s)
 	{
@@ -28,6 +32,7 @@ static const char *ExpizeStr(const char *s)
 
 void MxBase::OnCtor(MxBase *Mx)
 	{
+	lock_guard<mutex> Lock(g_MatricesLock);
 	if (m_Matrices == 0)
 		m_Matrices = new list<MxBase *>;
 	asserta(m_Matrices != 0);
@@ -36,6 +41,7 @@ void MxBase::OnCtor(MxBase *Mx)
 
 void MxBase::OnDtor(MxBase *Mx)
 	{
+	lock_guard<mutex> Lock(g_MatricesLock);
 	if (m_Matrices == 0)
 		{
 		Warning("MxBase::OnDtor, m_Matrices = 0");
@@ -48,7 +54,10 @@ void MxBase::OnDtor(MxBase *Mx)
 			{
 			m_Matrices->erase(p);
 			if (m_Matrices->empty())
+				{
 				delete m_Matrices;
+				m_Matrices = 0;
+				}
 			return;
 			}
 		}
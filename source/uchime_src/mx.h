@@ -132,11 +132,11 @@ public:
 	//static double **Getd(const string &Name);
 	//static char **Getc(const string &Name);
 
-	static unsigned m_AllocCount;
-	static unsigned m_ZeroAllocCount;
-	static unsigned m_GrowAllocCount;
-	static double m_TotalBytes;
-	static double m_MaxBytes;
+	static thread_local unsigned m_AllocCount;
+	static thread_local unsigned m_ZeroAllocCount;
+	static thread_local unsigned m_GrowAllocCount;
+	static thread_local double m_TotalBytes;
+	static thread_local double m_MaxBytes;
 
 	static void OnCtor(MxBase *Mx);
 	static void OnDtor(MxBase *Mx);
@@ -42,7 +42,7 @@ const unsigned MAX_FORMATTED_STRING_LENGTH = 64000;
 static char *g_IOBuffers[256];
 static time_t g_StartTime = time(0);
 static vector<string> g_Argv;
-static double g_PeakMemUseBytes;
+static thread_local double g_PeakMemUseBytes;
 
 #if	TEST_UTILS
 void TestUtils()
@@ -101,13 +101,14 @@ unsigned GetElapsedSecs()
 	return (unsigned) (time(0) - g_StartTime);
 	}
 
-static unsigned g_NewCalls;
-static unsigned g_FreeCalls;
-static double g_InitialMemUseBytes;
-static double g_TotalAllocBytes;
-static double g_TotalFreeBytes;
-static double g_NetBytes;
-static double g_MaxNetBytes;
+// Per thread, allocation is not locked.
+static thread_local unsigned g_NewCalls;
+static thread_local unsigned g_FreeCalls;
+static thread_local double g_InitialMemUseBytes;
+static thread_local double g_TotalAllocBytes;
+static thread_local double g_TotalFreeBytes;
+static thread_local double g_NetBytes;
+static thread_local double g_MaxNetBytes;
 
 void LogAllocStats()
 	{
@@ -514,7 +515,7 @@ void DeleteStdioFile(const string &FileName)
 
 void myvstrprintf(string &Str, const char *Format, va_list ArgList)
 	{
-	static char szStr[MAX_FORMATTED_STRING_LENGTH];
+	static thread_local char szStr[MAX_FORMATTED_STRING_LENGTH];
 	vsnprintf(szStr, MAX_FORMATTED_STRING_LENGTH-1, Format, ArgList);
 	szStr[MAX_FORMATTED_STRING_LENGTH - 1] = '\0';
 	Str.assign(szStr);
@@ -560,47 +561,16 @@ void Log(const char *Format, ...)
 
 void Die(const char *Format, ...)
 	{
-	static bool InDie = false;
-	if (InDie)
-		exit(1);
-	InDie = true;
 	string Msg;
 
-	if (g_fLog != 0)
-		setbuf(g_fLog, 0);
 	va_list ArgList;
 	va_start(ArgList, Format);
 	myvstrprintf(Msg, Format, ArgList);
 	va_end(ArgList);
 
-	fprintf(stderr, "\n\n");
-	Log("\n");
-	time_t t = time(0);
-	Log("%s", asctime(localtime(&t)));
-	for (unsigned i = 0; i < g_Argv.size(); i++)
-		{
-		fprintf(stderr, (i == 0) ? "%s" : " %s", g_Argv[i].c_str());
-		Log((i == 0) ? "%s" : " %s", g_Argv[i].c_str());
-		}
-	fprintf(stderr, "\n");
-	Log("\n");
-
-	time_t CurrentTime = time(0);
-	unsigned ElapsedSeconds = unsigned(CurrentTime - g_StartTime);
-	const char *sstr = SecsToStr(ElapsedSeconds);
-	Log("Elapsed time: %s\n", sstr);
-
-	const char *szStr = Msg.c_str();
-	fprintf(stderr, "\n---Fatal error---\n%s\n", szStr);
-	Log("\n---Fatal error---\n%s\n", szStr);
-
-#ifdef _MSC_VER
-	if (IsDebuggerPresent())
- 		__debugbreak();
-	_CrtSetDbgFlag(0);
-#endif
+	Log("\n---Fatal error---\n%s\n", Msg.c_str());
 
-	exit(1);
+	throw UChimeError(Msg);
 	}
 
 void Warning(const char *Format, ...)
@@ -638,8 +608,8 @@ double GetMemUseBytes()
 #elif	linux || __linux__
 double GetMemUseBytes()
 	{
-	static char statm[64];
-	static int PageSize = 1;
+	static thread_local char statm[64];
+	static thread_local int PageSize = 1;
 	if (0 == statm[0])
 		{
 		PageSize = sysconf(_SC_PAGESIZE);
@@ -1167,12 +1137,7 @@ void CmdLineErr(const char *Format, ...)
 	string Str;
 	myvstrprintf(Str, Format, ArgList);
 	va_end(ArgList);
-	fprintf(stderr, "\n");
-	fprintf(stderr, "Invalid command line\n");
-	fprintf(stderr, "%s\n", Str.c_str());
-	fprintf(stderr, "For list of command-line options use --help.\n");
-	fprintf(stderr, "\n");
-	exit(1);
+	throw UChimeError("Invalid uchime option: " + Str);
 	}
 
 static set<OptInfo>::iterator GetOptInfo(const string &LongName,
@@ -1521,18 +1486,62 @@ static void GetArgsFromFile(const string &FileName, vector<string> &Args)
 	CloseStdioFile(f);
 	}
 
+// Back to the defaults, for a second MyCmdLine() in the same process.
+static void ResetOpts()
+	{
+	for (set<OptInfo>::const_iterator p = g_Opts.begin(); p != g_Opts.end(); ++p)
+		{
+		const OptInfo &Opt = *p;
+		*Opt.OptSet = false;
+		switch (Opt.Type)
+			{
+		case OT_Flag:
+		case OT_Tog:
+			*(bool *) Opt.Value = Opt.bDefault;
+			break;
+		case OT_Int:
+		case OT_Enum:
+			*(int *) Opt.Value = Opt.iDefault;
+			break;
+		case OT_Uns:
+			*(unsigned *) Opt.Value = Opt.uDefault;
+			break;
+		case OT_Float:
+			*(double *) Opt.Value = Opt.dDefault;
+			break;
+		case OT_Str:
+			*(string *) Opt.Value = Opt.strDefault;
+			break;
+		default:
+			asserta(false);
+			}
+		}
+	}
+
 void MyCmdLine(int argc, char **argv)
 	{
 	static unsigned RecurseDepth = 0;
 	++RecurseDepth;
 
-	DefineFlagOpt("compilerinfo", "Write info about compiler types and #defines to stdout.",
-	  (void *) &opt_compilerinfo, &optset_compilerinfo);
-	DefineFlagOpt("quiet", "Turn off progress messages.", (void *) &opt_quiet, &optset_quiet);
-	DefineFlagOpt("version", "Show version and exit.", (void *) &opt_version, &optset_version);
-	DefineFlagOpt("logopts", "Log options.", (void *) &opt_logopts, &optset_logopts);
-	DefineFlagOpt("help", "Display command-line options.", (void *) &opt_help, &optset_help);
-	DefineStrOpt("log", "", "Log file name.", (void *) &opt_log, &optset_log);
+// Option errors throw UChimeError, so the depth is put back on the way out
+// or the next call would skip ResetOpts and keep the old options.
+	struct DepthGuard
+		{
+		unsigned &Depth;
+		bool Released;
+		~DepthGuard() { if (!Released) --Depth; }
+		} Guard = { RecurseDepth, false };
+
+// Defined once, a later call in the same process starts from the defaults.
+	if (g_Opts.empty())
+		{
+		DefineFlagOpt("compilerinfo", "Write info about compiler types and #defines to stdout.",
+		  (void *) &opt_compilerinfo, &optset_compilerinfo);
+		DefineFlagOpt("quiet", "Turn off progress messages.", (void *) &opt_quiet, &optset_quiet);
+		DefineFlagOpt("version", "Show version and exit.", (void *) &opt_version, &optset_version);
+		DefineFlagOpt("logopts", "Log options.", (void *) &opt_logopts, &optset_logopts);
+		DefineFlagOpt("help", "Display command-line options.", (void *) &opt_help, &optset_help);
+		DefineStrOpt("log", "", "Log file name.", (void *) &opt_log, &optset_log);
 
 #undef FLAG_OPT
 #undef TOG_OPT
@@ -1549,8 +1558,11 @@ void MyCmdLine(int argc, char **argv)
 #define STR_OPT(LongName, Default)				DefineStrOpt(#LongName, Default, "help", (void *) &opt_##LongName, &optset_##LongName);
 #define ENUM_OPT(LongName, Values, Default)		DefineEnumOpt(#LongName, Values, Default, "help", (void *) &opt_##LongName, &optset_##LongName);
 #include "myopts.h"
+		}
+	else if (RecurseDepth == 1)
+		ResetOpts();
 
-	if (RecurseDepth == 0)
+	if (RecurseDepth == 1)
 		g_Argv.clear();
 
 	for (int i = 0; i < argc; ++i) {
@@ -1622,6 +1634,7 @@ void MyCmdLine(int argc, char **argv)
 			CmdLineErr("Expected -option_name or --option_name, got '%s'", Arg.c_str());
 		}
 
+	Guard.Released = true;
 	--RecurseDepth;
 	if (RecurseDepth > 0)
 		return;
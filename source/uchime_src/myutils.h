@@ -13,6 +13,7 @@
 #include <stdarg.h>
 #include <cstdlib>
 #include <climits>
+#include <stdexcept>
 
 #ifndef _MSC_VER
 #include <inttypes.h>
@@ -190,6 +191,14 @@ void myvstrprintf(string &Str, const char *szFormat, ...);
 void SetLogFileName(const string &FileName);
 void Log(const char *szFormat, ...);
 
+// Die() throws UChimeError instead of exiting, so mothur can report the error
+// and carry on. UChimeSetOpts() and UChime() catch it.
+class UChimeError : public std::runtime_error
+	{
+public:
+	UChimeError(const string &Msg) : std::runtime_error(Msg) {}
+	};
+
 void Die(const char *szFormat, ...);
 void Warning(const char *szFormat, ...);
 
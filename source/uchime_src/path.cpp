@@ -14,8 +14,31 @@ struct PathBuffer
 	bool InUse;
 	};
 
-static PathBuffer **g_PathBuffers;
-static unsigned g_PathBufferSize;
+// One pool per thread, so queries can be aligned in parallel.
+// The buffers are freed when the thread exits.
+struct PathBufferPool
+	{
+	PathBuffer **Buffers;
+	unsigned Size;
+
+	PathBufferPool()
+		{
+		Buffers = 0;
+		Size = 0;
+		}
+
+	~PathBufferPool()
+		{
+		for (unsigned i = 0; i < Size; ++i)
+			{
+			MYFREE(Buffers[i]->Buffer, Buffers[i]->Size, Path);
+			MYFREE(Buffers[i], 1, Path);
+			}
+		MYFREE(Buffers, Size, Path);
+		}
+	};
+
+static thread_local PathBufferPool g_PathBufferPool;
 
 static char *AllocBuffer(unsigned Size)
 	{
@@ -23,9 +46,9 @@ static char *AllocBuffer(unsigned Size)
 		return 0;
 
 // Is a free buffer that is big enough?
-	for (unsigned i = 0; i < g_PathBufferSize; ++i)
+	for (unsigned i = 0; i < g_PathBufferPool.Size; ++i)
 		{
-		PathBuffer *PB = g_PathBuffers[i];
+		PathBuffer *PB = g_PathBufferPool.Buffers[i];
 		asserta(PB->Magic == PathMagic);
 		if (!PB->InUse)
 			{
@@ -45,14 +68,14 @@ static char *AllocBuffer(unsigned Size)
 			}
 		}
 
-// No available buffer, must expand g_PathBuffers[]
-	unsigned NewPathBufferSize = g_PathBufferSize + 1024;
+// No available buffer, must expand g_PathBufferPool.Buffers[]
+	unsigned NewPathBufferSize = g_PathBufferPool.Size + 1024;
 	PathBuffer **NewPathBuffers = MYALLOC(PathBuffer *, NewPathBufferSize, Path);
 	
-	for (unsigned i = 0; i < g_PathBufferSize; ++i)
-		NewPathBuffers[i] = g_PathBuffers[i];
+	for (unsigned i = 0; i < g_PathBufferPool.Size; ++i)
+		NewPathBuffers[i] = g_PathBufferPool.Buffers[i];
 
-	for (unsigned i = g_PathBufferSize; i < NewPathBufferSize; ++i)
+	for (unsigned i = g_PathBufferPool.Size; i < NewPathBufferSize; ++i)
 		{
 		PathBuffer *PB = MYALLOC(PathBuffer, 1, Path);
 		PB->Magic = PathMagic;
@@ -62,11 +85,11 @@ static char *AllocBuffer(unsigned Size)
 		NewPathBuffers[i] = PB;
 		}
 
-	PathBuffer *PB = NewPathBuffers[g_PathBufferSize];
+	PathBuffer *PB = NewPathBuffers[g_PathBufferPool.Size];
 
-	MYFREE(g_PathBuffers, g_PathBufferSize, Path);
-	g_PathBuffers = NewPathBuffers;
-	g_PathBufferSize = NewPathBufferSize;
+	MYFREE(g_PathBufferPool.Buffers, g_PathBufferPool.Size, Path);
+	g_PathBufferPool.Buffers = NewPathBuffers;
+	g_PathBufferPool.Size = NewPathBufferSize;
 
 	asserta(!PB->InUse && PB->Buffer == 0);
 
@@ -82,9 +105,9 @@ static void FreeBuffer(char *Buffer)
 	if (Buffer == 0)
 		return;
 
-	for (unsigned i = 0; i < g_PathBufferSize; ++i)
+	for (unsigned i = 0; i < g_PathBufferPool.Size; ++i)
 		{
-		PathBuffer *PB = g_PathBuffers[i];
+		PathBuffer *PB = g_PathBufferPool.Buffers[i];
 		if (PB->Buffer == Buffer)
 			{
 			asserta(PB->InUse);
@@ -142,10 +165,10 @@ void LogPathStats()
 	{
 	Log("\n");
 	unsigned Bytes = 0;
-	for (unsigned i = 0; i < g_PathBufferSize; ++i)
+	for (unsigned i = 0; i < g_PathBufferPool.Size; ++i)
 		{
-		const PathBuffer *PB = g_PathBuffers[i];
+		const PathBuffer *PB = g_PathBufferPool.Buffers[i];
 		Bytes += PB->Size;
 		}
-	Log("%u paths allocated, total memory %u bytes\n", g_PathBufferSize, Bytes);
+	Log("%u paths allocated, total memory %u bytes\n", g_PathBufferPool.Size, Bytes);
 	}
@@ -8,8 +8,6 @@
 
 #define TRACE	0
 
-extern FILE *g_fUChime;
-
 void GetCandidateParents(Ultra &U, const SeqData &QSD, float AbQ,
   vector<unsigned> &Parents);
 
@@ -113,9 +111,11 @@ static void GetSmoothedIdVec(const SeqData &QSD, const SeqData &PSD, const strin
 #endif
 	}
 
+// The alignments of the candidate chimeras are appended to Alns if it is
+// not null, in the format of --uchimealns.
 bool SearchChime(Ultra &U, const SeqData &QSD, float QAb, 
   const AlnParams &AP, const AlnHeuristics &AH, HSPFinder &HF,
-  float MinFractId, ChimeHit2 &Hit)
+  float MinFractId, ChimeHit2 &Hit, string *Alns)
 	{
 	Hit.Clear();
 	Hit.QLabel = QSD.Label;
@@ -289,6 +289,9 @@ bool SearchChime(Ultra &U, const SeqData &QSD, float QAb,
 			AlignChime(QSD, PSD1, PSD2, Path1, Path2, Hit2);
 			Hit2.PctIdQT = TopPctId;
 
+			if (Alns != 0 && !opt_ucl)
+				WriteChimeHitX(*Alns, Hit2);
+
 			if (Hit2.Accept())
 				Found = true;
 
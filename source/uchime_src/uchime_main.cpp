@@ -9,83 +9,14 @@
 
 bool SearchChime(Ultra &U, const SeqData &QSD, float QAb, 
   const AlnParams &AP, const AlnHeuristics &AH, HSPFinder &HF,
-  float MinFractId, ChimeHit2 &Hit);
+  float MinFractId, ChimeHit2 &Hit, string *Alns);
+void SortDescending(const vector<float> &Values, vector<unsigned> &Order);
+void Usage();
+
+extern bool g_UchimeDeNovo;
 
 FILE *g_fUChime;
 FILE *g_fUChimeAlns;
-const vector<float> *g_SortVecFloat;
-bool g_UchimeDeNovo = false;
-
-void Usage()
-	{
-	printf("\n");
-	printf("UCHIME %s by Robert C. Edgar\n", MY_VERSION);
-	printf("http://www.drive5.com/uchime\n");
-	printf("\n");
-	printf("This software is donated to the public domain\n");
-	printf("\n");
-
-	printf(
-#include "help.h"
-		);
-	}
-
-void SetBLOSUM62()
-	{
-	Die("SetBLOSUM62 not implemented");
-	}
-
-void ReadSubstMx(const string &/*FileName*/, Mx<float> &/*Mxf*/)
-	{
-	Die("ReadSubstMx not implemented");
-	}
-
-void LogAllocs()
-	{
-	/*empty*/
-	}
-
-static bool CmpDescVecFloat(unsigned i, unsigned j)
-	{
-	return (*g_SortVecFloat)[i] > (*g_SortVecFloat)[j];
-	}
-
-void Range(vector<unsigned> &v, unsigned N)
-	{
-	v.clear();
-	v.reserve(N);
-	for (unsigned i = 0; i < N; ++i)
-		v.push_back(i);
-	}
-
-void SortDescending(const vector<float> &Values, vector<unsigned> &Order)
-	{
-	StartTimer(Sort);
-	const unsigned N = SIZE(Values);
-	Range(Order, N);
-	g_SortVecFloat = &Values;
-	sort(Order.begin(), Order.end(), CmpDescVecFloat);
-	EndTimer(Sort);
-	}
-
-float GetAbFromLabel(const string &Label)
-	{
-	vector<string> Fields;
-	Split(Label, Fields, '/');
-	const unsigned N = SIZE(Fields);
-	for (unsigned i = 0; i < N; ++i)
-		{
-		const string &Field = Fields[i];
-		if (Field.substr(0, 3) == "ab=")
-			{
-			string a = Field.substr(3, string::npos);
-			return (float) atof(a.c_str());
-			}
-		}
-	if (g_UchimeDeNovo)
-		Die("Missing abundance /ab=xx/ in label >%s", Label.c_str());
-	return 0.0;
-	}
 
 int main(int argc, char *argv[])
 	{
@@ -186,7 +117,9 @@ int main(int argc, char *argv[])
 		AlnParams &AP = *(AlnParams *) 0;
 		AlnHeuristics &AH = *(AlnHeuristics *) 0;
 		HSPFinder &HF = *(HSPFinder *) 0;
-		bool Found = SearchChime(DB, QSD, QAb, AP, AH, HF, MinFractId, Hit);
+		string Alns;
+		bool Found = SearchChime(DB, QSD, QAb, AP, AH, HF, MinFractId, Hit,
+		  g_fUChimeAlns != 0 ? &Alns : 0);
 		if (Found)
 			++HitCount;
 		else
@@ -196,6 +129,8 @@ int main(int argc, char *argv[])
 			}
 
 		WriteChimeHit(g_fUChime, Hit);
+		if (g_fUChimeAlns != 0)
+			fputs(Alns.c_str(), g_fUChimeAlns);
 
 		ProgressStep(i, QuerySeqCount, "%u/%u chimeras found (%.1f%%)", HitCount, i, Pct(HitCount, i+1));
 		}
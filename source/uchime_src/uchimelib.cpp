@@ -0,0 +1,360 @@
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "myutils.h"
+#include "chime.h"
+#include "seqdb.h"
+#include "dp.h"
+#include "ultra.h"
+#include "hspfinder.h"
+#include "uchimelib.h"
+#include <algorithm>
+
+bool SearchChime(Ultra &U, const SeqData &QSD, float QAb,
+  const AlnParams &AP, const AlnHeuristics &AH, HSPFinder &HF,
+  float MinFractId, ChimeHit2 &Hit, string *Alns);
+void InitGlobalAlign();
+
+extern thread_local const SeqData *g_PendingSeqs;
+extern thread_local unsigned g_PendingSeqCount;
+extern thread_local bool g_PendingSeqsMatter;
+
+bool g_UchimeDeNovo = false;
+
+static void SetOpts(const vector<string> &Args);
+static void Search(const vector<UChimeSeq> &Queries, unsigned ThreadCount,
+  bool Alns, vector<UChimeHit> &Hits);
+
+void Usage()
+	{
+	printf("\n");
+	printf("UCHIME %s by Robert C. Edgar\n", MY_VERSION);
+	printf("http://www.drive5.com/uchime\n");
+	printf("\n");
+	printf("This software is donated to the public domain\n");
+	printf("\n");
+
+	printf(
+#include "help.h"
+		);
+	}
+
+void SetBLOSUM62()
+	{
+	Die("SetBLOSUM62 not implemented");
+	}
+
+void ReadSubstMx(const string &/*FileName*/, Mx<float> &/*Mxf*/)
+	{
+	Die("ReadSubstMx not implemented");
+	}
+
+void LogAllocs()
+	{
+	/*empty*/
+	}
+
+// A functor rather than a global vector, so threads can sort at the same time.
+struct CmpDescVecFloat
+	{
+	const vector<float> &Values;
+
+	CmpDescVecFloat(const vector<float> &v) : Values(v) {}
+
+	bool operator()(unsigned i, unsigned j) const
+		{
+		return Values[i] > Values[j];
+		}
+	};
+
+void Range(vector<unsigned> &v, unsigned N)
+	{
+	v.clear();
+	v.reserve(N);
+	for (unsigned i = 0; i < N; ++i)
+		v.push_back(i);
+	}
+
+void SortDescending(const vector<float> &Values, vector<unsigned> &Order)
+	{
+	StartTimer(Sort);
+	const unsigned N = SIZE(Values);
+	Range(Order, N);
+	sort(Order.begin(), Order.end(), CmpDescVecFloat(Values));
+	EndTimer(Sort);
+	}
+
+float GetAbFromLabel(const string &Label)
+	{
+	vector<string> Fields;
+	Split(Label, Fields, '/');
+	const unsigned N = SIZE(Fields);
+	for (unsigned i = 0; i < N; ++i)
+		{
+		const string &Field = Fields[i];
+		if (Field.substr(0, 3) == "ab=")
+			{
+			string a = Field.substr(3, string::npos);
+			return (float) atof(a.c_str());
+			}
+		}
+	if (g_UchimeDeNovo)
+		Die("Missing abundance /ab=xx/ in label >%s", Label.c_str());
+	return 0.0;
+	}
+
+bool UChimeSetOpts(const vector<string> &Args, string &Error)
+	{
+	try
+		{
+		SetOpts(Args);
+		}
+	catch (UChimeError &e)
+		{
+		Error = e.what();
+		return false;
+		}
+	return true;
+	}
+
+static void SetOpts(const vector<string> &Args)
+	{
+	vector<string> Argv;
+	Argv.push_back("uchime");
+	Argv.insert(Argv.end(), Args.begin(), Args.end());
+
+	vector<char *> argv;
+	for (unsigned i = 0; i < SIZE(Argv); ++i)
+		argv.push_back((char *) Argv[i].c_str());
+	argv.push_back(0);
+
+	MyCmdLine((int) SIZE(Argv), &argv[0]);
+
+	if (!optset_w)
+		opt_w = 8;
+	g_UchimeDeNovo = (opt_db == "");
+	InitGlobalAlign();
+	}
+
+// Same labels and letters as reading the queries with SFasta.
+static void AddQuery(SeqDB &Input, const UChimeSeq &Query)
+	{
+	string Label;
+	for (unsigned i = 0; i < SIZE(Query.Label); ++i)
+		{
+		char c = Query.Label[i];
+		if (c == '\r' || c == '\n')
+			break;
+		if (opt_trunclabels && isspace(c))
+			break;
+		Label.push_back(c == '\t' ? ' ' : c);
+		}
+
+	string Seq;
+	for (unsigned i = 0; i < SIZE(Query.Seq); ++i)
+		if (isalpha(Query.Seq[i]))
+			Seq.push_back(Query.Seq[i]);
+
+	const unsigned L = SIZE(Seq);
+	if (L < opt_minlen)
+		return;
+	if (L > opt_maxlen && opt_maxlen != 0)
+		return;
+
+	Input.AddSeq(Label.c_str(), (const byte *) Seq.c_str(), L);
+	}
+
+static bool SearchQuery(SeqDB &DB, const SeqData &QSD, float MinFractId,
+  bool Alns, UChimeHit &Hit)
+	{
+	float QAb = -1.0;
+	if (g_UchimeDeNovo)
+		QAb = GetAbFromLabel(QSD.Label);
+
+	ChimeHit2 Hit2;
+	AlnParams &AP = *(AlnParams *) 0;
+	AlnHeuristics &AH = *(AlnHeuristics *) 0;
+	HSPFinder &HF = *(HSPFinder *) 0;
+	Hit.Alns.clear();
+	bool Found = SearchChime(DB, QSD, QAb, AP, AH, HF, MinFractId, Hit2,
+	  Alns ? &Hit.Alns : 0);
+
+	Hit.Label = QSD.Label;
+	Hit.Line.clear();
+	WriteChimeHit(Hit.Line, Hit2);
+	Hit.Chimera = (Hit2.Div > 0.0 && Hit2.Accept());
+	return Found;
+	}
+
+// The first error of the threads searching a block, the others stop at their
+// next query.
+struct BlockError
+	{
+	mutex Lock;
+	atomic<bool> Failed;
+	string Msg;
+
+	BlockError() : Failed(false) {}
+	};
+
+// Searches the queries Order[Start+Offset], Order[Start+Offset+Step] ...
+// before Order[End]. De novo, the earlier queries of the block are pending,
+// they are added to DB later if they are not chimeras.
+static void SearchBlock(SeqDB *DB, const SeqDB *Input,
+  const vector<unsigned> *Order, const vector<SeqData> *BlockSeqs,
+  unsigned Start, unsigned End, unsigned Offset, unsigned Step,
+  float MinFractId, bool Alns, vector<UChimeHit> *Hits,
+  vector<char> *Found, vector<char> *Recheck, BlockError *Error)
+	{
+	try
+		{
+		for (unsigned i = Start + Offset; i < End; i += Step)
+			{
+			if (Error->Failed)
+				break;
+
+			SeqData QSD;
+			Input->GetSeqData((*Order)[i], QSD);
+
+			g_PendingSeqs = (BlockSeqs->empty() ? 0 : &(*BlockSeqs)[0]);
+			g_PendingSeqCount = (BlockSeqs->empty() ? 0 : i - Start);
+			g_PendingSeqsMatter = false;
+
+			(*Found)[i] = SearchQuery(*DB, QSD, MinFractId, Alns, (*Hits)[i]);
+			(*Recheck)[i] = g_PendingSeqsMatter;
+			}
+		}
+	catch (UChimeError &e)
+		{
+		lock_guard<mutex> Guard(Error->Lock);
+		if (!Error->Failed)
+			Error->Msg = e.what();
+		Error->Failed = true;
+		}
+	g_PendingSeqs = 0;
+	g_PendingSeqCount = 0;
+	}
+
+bool UChime(const vector<UChimeSeq> &Queries, unsigned ThreadCount,
+  bool Alns, vector<UChimeHit> &Hits, string &Error)
+	{
+	try
+		{
+		Search(Queries, ThreadCount, Alns, Hits);
+		}
+	catch (UChimeError &e)
+		{
+		Error = e.what();
+		Hits.clear();
+		return false;
+		}
+	return true;
+	}
+
+static void Search(const vector<UChimeSeq> &Queries, unsigned ThreadCount,
+  bool Alns, vector<UChimeHit> &Hits)
+	{
+	if (ThreadCount == 0)
+		ThreadCount = 1;
+
+	float MinFractId = 0.95f;
+	if (optset_id)
+		MinFractId = (float) opt_id;
+
+	SeqDB Input;
+	SeqDB DB;
+
+	Input.m_IsNucleoSet = true;
+	Input.m_IsNucleo = true;
+	for (unsigned i = 0; i < SIZE(Queries); ++i)
+		AddQuery(Input, Queries[i]);
+
+	const unsigned QuerySeqCount = Input.GetSeqCount();
+	vector<unsigned> Order;
+	Range(Order, QuerySeqCount);
+
+	vector<float> Abs;
+	if (g_UchimeDeNovo)
+		{
+		for (unsigned i = 0; i < QuerySeqCount; ++i)
+			{
+			const char *Label = Input.GetLabel(i);
+			float Ab = GetAbFromLabel(Label);
+			Abs.push_back(Ab);
+			}
+		SortDescending(Abs, Order);
+		DB.m_IsNucleoSet = true;
+		DB.m_IsNucleo = true;
+		}
+	else
+		{
+		DB.FromFasta(opt_db);
+		if (!DB.IsNucleo())
+			Die("Database contains amino acid sequences");
+		}
+
+	Hits.clear();
+	Hits.resize(QuerySeqCount);
+	vector<char> Found(QuerySeqCount, 0);
+	vector<char> Recheck(QuerySeqCount, 0);
+
+// De novo, a query is only a parent of queries at least abskew times less
+// abundant. The queries of a block are all less than abskew times as abundant
+// as the first, so they are searched at the same time, and added to DB in
+// order afterwards. A query is searched again if a pending query could have
+// changed its candidate parents.
+	const unsigned MaxBlock = (ThreadCount == 1 ? 1 : 100*ThreadCount);
+	unsigned Start = 0;
+	while (Start < QuerySeqCount)
+		{
+		unsigned End = Start + 1;
+		if (!g_UchimeDeNovo)
+			End = QuerySeqCount;
+		else
+			{
+			while (End < QuerySeqCount && End - Start < MaxBlock &&
+			  Abs[Order[End]] > 0.0f &&
+			  Abs[Order[Start]] < opt_abskew*Abs[Order[End]])
+				++End;
+			}
+
+		vector<SeqData> BlockSeqs;
+		if (g_UchimeDeNovo && End - Start > 1)
+			{
+			BlockSeqs.resize(End - Start);
+			for (unsigned i = Start; i < End; ++i)
+				Input.GetSeqData(Order[i], BlockSeqs[i - Start]);
+			}
+
+		const unsigned BlockThreadCount = min(ThreadCount, End - Start);
+		BlockError Error;
+		vector<thread *> Threads;
+		for (unsigned t = 1; t < BlockThreadCount; ++t)
+			Threads.push_back(new thread(SearchBlock, &DB, &Input, &Order,
+			  &BlockSeqs, Start, End, t, BlockThreadCount, MinFractId, Alns,
+			  &Hits, &Found, &Recheck, &Error));
+		SearchBlock(&DB, &Input, &Order, &BlockSeqs, Start, End, 0,
+		  BlockThreadCount, MinFractId, Alns, &Hits, &Found, &Recheck, &Error);
+		for (unsigned t = 0; t < SIZE(Threads); ++t)
+			{
+			Threads[t]->join();
+			delete Threads[t];
+			}
+		if (Error.Failed)
+			throw UChimeError(Error.Msg);
+
+		if (g_UchimeDeNovo)
+			{
+			for (unsigned i = Start; i < End; ++i)
+				{
+				SeqData QSD;
+				Input.GetSeqData(Order[i], QSD);
+				if (Recheck[i])
+					Found[i] = SearchQuery(DB, QSD, MinFractId, Alns, Hits[i]);
+				if (!Found[i])
+					DB.AddSeq(QSD.Label, QSD.Seq, QSD.L);
+				}
+			}
+		Start = End;
+		}
+	}
@@ -0,0 +1,36 @@
+#ifndef uchimelib_h
+#define uchimelib_h
+
+#include <string>
+#include <vector>
+
+// Runs UCHIME in the calling process, without temporary files.
+
+struct UChimeSeq
+	{
+	std::string Label;
+	std::string Seq;
+	};
+
+struct UChimeHit
+	{
+	std::string Label;
+	std::string Line;		// Line of --uchimeout
+	std::string Alns;		// Text of --uchimealns, if requested
+	bool Chimera;
+	};
+
+// Sets the options from command line arguments without the program name,
+// e.g. "--abskew", "1.9". Call once before UChime(), not while it is running.
+// Returns false with the message in Error if an option is invalid.
+bool UChimeSetOpts(const std::vector<std::string> &Args, std::string &Error);
+
+// Searches the queries with ThreadCount threads. With --db, the queries are
+// searched against the database; otherwise de novo, in order of decreasing
+// abundance (/ab=xx/ in the label). Hits are in the order of --uchimeout.
+// Returns false with the message in Error, and no hits, if uchime fails, e.g.
+// a query without /ab=xx/ de novo or a database of amino acid sequences.
+bool UChime(const std::vector<UChimeSeq> &Queries, unsigned ThreadCount,
+  bool Alns, std::vector<UChimeHit> &Hits, std::string &Error);
+
+#endif // uchimelib_h
@@ -7,8 +7,9 @@
 
 void SortDescending(const vector<float> &Values, vector<unsigned> &Order);
 
-static byte *g_QueryHasWord;
-static unsigned g_WordCount;
+// Per thread, so queries can be searched in parallel.
+static thread_local vector<byte> g_QueryHasWord;
+static thread_local unsigned g_WordCount;
 
 unsigned GetWord(const byte *Seq)
 	{
@@ -24,16 +25,16 @@ unsigned GetWord(const byte *Seq)
 
 static void SetQuery(const SeqData &Query)
 	{
-	if (g_QueryHasWord == 0)
+	if (g_QueryHasWord.empty())
 		{
 		g_WordCount = 4;
 		for (unsigned i = 1; i < opt_w; ++i)
 			g_WordCount *= 4;
 
-		g_QueryHasWord = myalloc(byte, g_WordCount);
+		g_QueryHasWord.resize(g_WordCount);
 		}
 
-	memset(g_QueryHasWord, 0, g_WordCount);
+	memset(&g_QueryHasWord[0], 0, g_WordCount);
 
 	if (Query.L <= opt_w)
 		return;
@@ -64,6 +65,13 @@ static unsigned GetUniqueWordsInCommon(const SeqData &Target)
 	return Count;
 	}
 
+// Words in common with the query of the last USort() on this thread,
+// for sequences that are not in the database.
+unsigned GetWordsInCommon(const SeqData &Target)
+	{
+	return GetUniqueWordsInCommon(Target);
+	}
+
 void USort(const SeqData &Query, const SeqDB &DB, vector<float> &WordCounts, 
   vector<unsigned> &Order)
 	{
@@ -43,6 +43,18 @@ Utils::Utils(){
     }
 }
 /***********************************************************************/
+void Utils::setRandomStream(long long stream){
+    try {
+        unsigned long long st = stream;
+        seed_seq seeds{ m->getRandomSeed(), (unsigned int)(st & 0xFFFFFFFF), (unsigned int)(st >> 32) };
+        mersenne_twister_engine.seed(seeds);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Utils", "setRandomStream");
+        exit(1);
+    }
+}
+/***********************************************************************/
 float Utils::randomUniform() {
     try {
         uniform_real_distribution<float> unif;
@@ -56,6 +56,7 @@ public:
     void mothurRandomShuffle(vector<SharedRAbundVector*>&);
     void mothurRandomShuffle(Tree* t, vector<string> g);
     void mothurRandomShuffle(vector<weightedSeq>&);
+    void setRandomStream(long long); //reseeds with the random seed and a stream number, so each stream is reproducible
     
     //checks
     bool isTrue(string);